@@ -0,0 +1,34 @@
+
+/**
+ * @file config.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __bench__include__bench__config_h__
+#define __bench__include__bench__config_h__
+
+#include "common/types.h"
+
+typedef enum
+{
+	bench_command_queue,
+} bench_command_e;
+
+typedef struct
+{
+	bench_command_e command;
+	uint16_t pairs;
+	uint64_t operations;
+	uint64_t batch;
+	uint64_t capacity;
+} bench_config_s;
+
+bench_config_s bench_config_from_cli(int32_t* const argc, const char_t*** const argv);
+
+#endif
@@ -0,0 +1,20 @@
+
+/**
+ * @file main.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __bench__include__bench__main_h__
+#define __bench__include__bench__main_h__
+
+#include "common/types.h"
+
+int32_t main(int32_t argc, const char_t** argv);
+
+#endif
@@ -0,0 +1,31 @@
+
+/**
+ * @file queue.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __bench__include__bench__queue_h__
+#define __bench__include__bench__queue_h__
+
+#include "common/types.h"
+
+#include "bench/config.h"
+
+/**
+ * @brief Measure the throughput of the spsc ring and the mpmc queue, one item
+ * at a time and in batches, for 1 up to the configured number of producer and
+ * consumer pairs, and report it in operations per second.
+ * 
+ * @param config benchmark configuration
+ * 
+ * @return bool_t
+ */
+bool_t bench_queue_run(const bench_config_s* const config);
+
+#endif
@@ -0,0 +1,306 @@
+
+/**
+ * @file config.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "bench/config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define pairs_default_value      "4"
+#define operations_default_value "1000000"
+#define batch_default_value      "32"
+#define capacity_default_value   "1024"
+
+static const char_t* _g_program = NULL;
+
+const char_t _g_usage_banner[] =
+	"usage: %s <command>\n"                                                                                                           \
+	"\n"                                                                                                                              \
+	"commands:\n"                                                                                                                     \
+	"    queue [options]                     measure the throughput of the spsc ring and the mpmc queue.\n"                           \
+	"        required:\n"                                                                                                             \
+	"            ---\n"                                                                                                               \
+	"        optional:\n"                                                                                                             \
+	"            -p, --pairs <N>             set the highest number of producer and consumer pairs to run. if not provided,\n"        \
+	"                                        defaults to %s.\n"                                                                       \
+	"            -n, --operations <N>        set the number of items every producer pushes. if not provided, defaults to %s.\n"       \
+	"            -b, --batch <N>             set the number of items moved at once in batch runs. if not provided, defaults to %s.\n" \
+	"            -c, --capacity <N>          set the capacity of the queues. if not provided, defaults to %s.\n"                      \
+	"\n"                                                                                                                              \
+	"    help                                print this help message banner.\n"                                                       \
+	"\n"                                                                                                                              \
+	"    version                             print the version of this executable.\n"                                                 \
+	"\n"                                                                                                                              \
+	"notice:\n"                                                                                                                       \
+	"    this executable is distributed under the \"mediantazy gplv1\" license.\n";
+
+static void _print_usage_banner(void);
+
+static const char_t* _shift_cli_args(int32_t* const argc, const char_t*** const argv);
+
+static bool_t _match_cli_option(const char_t* const option, const char_t* const long_name, const char_t* const short_name);
+
+static const char_t* _get_option_argument(const char_t* const option, int32_t* const argc, const char_t*** const argv);
+
+static uint64_t _parse_count(const char_t* const count_as_string, const char_t* const option_names);
+
+static bench_config_s _parse_queue_command(int32_t* const argc, const char_t*** const argv);
+
+bench_config_s bench_config_from_cli(int32_t* const argc, const char_t*** const argv)
+{
+	common_debug_assert(argc != NULL);
+	common_debug_assert(argv != NULL);
+
+	common_debug_assert(NULL == _g_program);
+	_g_program = _shift_cli_args(argc, argv);
+	common_debug_assert(_g_program != NULL);
+
+	if (*argc <= 0)
+	{
+		common_logger_error("no command was provided.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	const char_t* const command = _shift_cli_args(argc, argv);
+	common_debug_assert(command != NULL);
+
+	if (strcmp(command, "queue") == 0)
+	{
+		return _parse_queue_command(argc, argv);
+	}
+	else if (strcmp(command, "help") == 0)
+	{
+		_print_usage_banner();
+		exit(0);
+	}
+	else if (strcmp(command, "version") == 0)
+	{
+#if !defined(version_major)
+#	error "missing 'version_major' definition!"
+#endif
+
+#if !defined(version_minor)
+#	error "missing 'version_minor' definition!"
+#endif
+
+#if !defined(version_patch)
+#	error "missing 'version_patch' definition!"
+#endif
+
+		common_logger_log("%s v%u.%u.%u", _g_program, version_major, version_minor, version_patch);
+		exit(0);
+	}
+	else
+	{
+		common_logger_error("unknown or invalid command was provided: %s.", command);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	common_debug_assert(0);  // note: should not be reached.
+	return (const bench_config_s) {0};
+}
+
+static void _print_usage_banner(void)
+{
+	common_debug_assert(_g_usage_banner != NULL);
+	common_debug_assert(_g_program != NULL);
+	common_logger_log(_g_usage_banner, _g_program, pairs_default_value, operations_default_value, batch_default_value, capacity_default_value);
+}
+
+static const char_t* _shift_cli_args(int32_t* const argc, const char_t*** const argv)
+{
+	common_debug_assert(argc != NULL);
+	common_debug_assert(argv != NULL);
+
+	const char_t* argument = NULL;
+
+	if (*argc > 0)
+	{
+		argument = **argv;
+		++(*argv);
+		--(*argc);
+	}
+
+	return argument;
+}
+
+static bool_t _match_cli_option(const char_t* const option, const char_t* const long_name, const char_t* const short_name)
+{
+	common_debug_assert(option != NULL);
+	common_debug_assert(long_name != NULL);
+	common_debug_assert(short_name != NULL);
+
+	const uint64_t option_length     = strlen(option);
+	const uint64_t long_name_length  = strlen(long_name);
+	const uint64_t short_name_length = strlen(short_name);
+
+	return (
+		((option_length == long_name_length ) && (strncmp(option, long_name, option_length ) == 0)) || \
+		((option_length == short_name_length) && (strncmp(option, short_name, option_length) == 0))
+	);
+}
+
+static const char_t* _get_option_argument(const char_t* const option, int32_t* const argc, const char_t*** const argv)
+{
+	common_debug_assert(option != NULL);
+	common_debug_assert(argc != NULL);
+	common_debug_assert(argv != NULL);
+
+	const char_t* const argument = _shift_cli_args(argc, argv);
+
+	if (NULL == argument)
+	{
+		common_logger_error("option '%s' requires an argument, but none was provided.", option);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return argument;
+}
+
+static uint64_t _parse_count(const char_t* const count_as_string, const char_t* const option_names)
+{
+	common_debug_assert(count_as_string != NULL);
+	common_debug_assert(option_names != NULL);
+
+	char_t* end = NULL;
+	const uint64_t count = (uint64_t)strtoull(count_as_string, &end, 10);
+
+	if ((0 == count) || (end == count_as_string) || (*end != '\0'))
+	{
+		common_logger_error("invalid %s value provided in 'queue' command: %s.", option_names, count_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return count;
+}
+
+static bench_config_s _parse_queue_command(int32_t* const argc, const char_t*** const argv)
+{
+	common_debug_assert(argc != NULL);
+	common_debug_assert(argv != NULL);
+
+	const char_t* pairs_as_string      = NULL;
+	const char_t* operations_as_string = NULL;
+	const char_t* batch_as_string      = NULL;
+	const char_t* capacity_as_string   = NULL;
+
+	for (uint64_t index = 0; true; ++index)
+	{
+		const char_t* const option = _shift_cli_args(argc, argv);
+
+		if (NULL == option)
+		{
+			break;
+		}
+
+		if (_match_cli_option(option, "--pairs", "-p"))
+		{
+			if (pairs_as_string != NULL)
+			{
+				common_logger_error("multiple --pairs, -p arguments found in the command line arguments in 'queue' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			pairs_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(pairs_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--operations", "-n"))
+		{
+			if (operations_as_string != NULL)
+			{
+				common_logger_error("multiple --operations, -n arguments found in the command line arguments in 'queue' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			operations_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(operations_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--batch", "-b"))
+		{
+			if (batch_as_string != NULL)
+			{
+				common_logger_error("multiple --batch, -b arguments found in the command line arguments in 'queue' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			batch_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(batch_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--capacity", "-c"))
+		{
+			if (capacity_as_string != NULL)
+			{
+				common_logger_error("multiple --capacity, -c arguments found in the command line arguments in 'queue' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			capacity_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(capacity_as_string != NULL);
+		}
+		else
+		{
+			common_logger_error("invalid/unrecognized command line argument found in 'queue' command: %s.", option);
+			_print_usage_banner();
+			exit(1);
+		}
+	}
+
+	if (NULL == pairs_as_string)
+	{
+		pairs_as_string = pairs_default_value;
+	}
+
+	if (NULL == operations_as_string)
+	{
+		operations_as_string = operations_default_value;
+	}
+
+	if (NULL == batch_as_string)
+	{
+		batch_as_string = batch_default_value;
+	}
+
+	if (NULL == capacity_as_string)
+	{
+		capacity_as_string = capacity_default_value;
+	}
+
+	const uint64_t pairs = _parse_count(pairs_as_string, "--pairs, -p");
+
+	if (pairs > UINT16_MAX)
+	{
+		common_logger_error("invalid --pairs, -p value provided in 'queue' command: %s.", pairs_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (const bench_config_s)
+	{
+		.command    = bench_command_queue                                   ,
+		.pairs      = (const uint16_t)pairs                                 ,
+		.operations = _parse_count(operations_as_string, "--operations, -n"),
+		.batch      = _parse_count(batch_as_string, "--batch, -b")          ,
+		.capacity   = _parse_count(capacity_as_string, "--capacity, -c")    ,
+	};
+}
@@ -0,0 +1,309 @@
+
+/**
+ * @file queue.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/queue.h"
+
+#include "bench/queue.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum
+{
+	_kind_spsc,
+	_kind_mpmc,
+} _kind_e;
+
+typedef struct
+{
+	_kind_e kind;
+	void* queue;
+	uint64_t batch;
+	uint64_t operations;
+	uint64_t* remaining;
+	pthread_barrier_t* barrier;
+	uint64_t sum;
+} _thread_s;
+
+static bool_t _run(const bench_config_s* const config, const _kind_e kind, const uint64_t batch, const uint16_t pairs, double* const rate);
+
+static void* _produce(void* const argument);
+
+static void* _consume(void* const argument);
+
+static uint64_t _push(const _thread_s* const thread, void* const* const items, const uint64_t count);
+
+static uint64_t _pop(const _thread_s* const thread, void** const items, const uint64_t capacity);
+
+bool_t bench_queue_run(const bench_config_s* const config)
+{
+	common_debug_assert(config != NULL);
+
+	static const char_t* const names[] = { "spsc", "mpmc" };
+	const uint64_t batches[] = { 1, config->batch };
+
+	common_logger_log("%-6s %8s %8s %16s", "queue", "batch", "pairs", "ops/sec");
+
+	for (uint64_t kind = 0; kind < (sizeof(names) / sizeof(*names)); ++kind)
+	{
+		for (uint64_t batch = 0; batch < (sizeof(batches) / sizeof(*batches)); ++batch)
+		{
+			if ((batch > 0) && (batches[batch] == batches[0]))
+			{
+				continue;
+			}
+
+			for (uint16_t pairs = 1; pairs <= config->pairs; ++pairs)
+			{
+				double rate = 0;
+
+				if (!_run(config, (_kind_e)kind, batches[batch], pairs, &rate))
+				{
+					return false;
+				}
+
+				common_logger_log("%-6s %8lu %8u %16.0f", names[kind], batches[batch], pairs, rate);
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool_t _run(const bench_config_s* const config, const _kind_e kind, const uint64_t batch, const uint16_t pairs, double* const rate)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(rate != NULL);
+
+	// note: every pair gets its own ring, while all pairs share the one queue.
+	const uint64_t queues_count = (_kind_spsc == kind) ? pairs : 1;
+	const uint64_t queue_size   = (_kind_spsc == kind) ? sizeof(common_queue_spsc_s) : sizeof(common_queue_mpmc_s);
+	uint8_t* const queues       = aligned_alloc(common_queue_cache_line, queues_count * queue_size);
+	_thread_s* const threads    = calloc(2 * (uint64_t)pairs, sizeof(*threads));
+	pthread_t* const handles    = calloc(2 * (uint64_t)pairs, sizeof(*handles));
+	uint64_t remaining          = (uint64_t)pairs * config->operations;
+	uint64_t created            = 0;
+	uint64_t ready              = 0;
+	bool_t status               = false;
+	pthread_barrier_t barrier;
+
+	if ((NULL == queues) || (NULL == threads) || (NULL == handles))
+	{
+		common_logger_error("failed to allocate the benchmark of %u pairs.", pairs);
+		goto run_end;
+	}
+
+	for (; ready < queues_count; ++ready)
+	{
+		void* const queue = queues + ready * queue_size;
+		const bool_t created_queue = (_kind_spsc == kind) ?
+			common_queue_spsc_create(queue, config->capacity) : common_queue_mpmc_create(queue, config->capacity);
+
+		if (!created_queue)
+		{
+			goto run_end;
+		}
+	}
+
+	(void)pthread_barrier_init(&barrier, NULL, 2 * (uint32_t)pairs + 1);
+
+	for (uint64_t index = 0; index < (2 * (uint64_t)pairs); ++index)
+	{
+		threads[index] = (const _thread_s)
+		{
+			.kind       = kind,
+			.queue      = queues + ((_kind_spsc == kind) ? (index / 2) : 0) * queue_size,
+			.batch      = batch,
+			.operations = config->operations,
+			.remaining  = &remaining,
+			.barrier    = &barrier,
+		};
+
+		if (pthread_create(&handles[index], NULL, ((index % 2) == 0) ? _produce : _consume, &threads[index]) != 0)
+		{
+			// note: the threads already created are waiting on the barrier and
+			// can not be released without a full set, so there is no way back.
+			common_logger_error("failed to create a benchmark thread.");
+			abort();
+		}
+
+		++created;
+	}
+
+	struct timespec start = {0};
+	struct timespec end   = {0};
+
+	(void)pthread_barrier_wait(&barrier);
+	(void)clock_gettime(CLOCK_MONOTONIC, &start);
+
+	uint64_t produced = 0;
+	uint64_t consumed = 0;
+
+	for (uint64_t index = 0; index < created; ++index)
+	{
+		(void)pthread_join(handles[index], NULL);
+		*(((index % 2) == 0) ? &produced : &consumed) += threads[index].sum;
+	}
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &end);
+	(void)pthread_barrier_destroy(&barrier);
+
+	const double seconds = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) / 1e9);
+	*rate  = (double)((uint64_t)pairs * config->operations) / seconds;
+	status = produced == consumed;
+
+	if (!status)
+	{
+		common_logger_error("the consumers received other items than the producers pushed.");
+	}
+
+run_end:
+	for (uint64_t index = 0; index < ready; ++index)
+	{
+		void* const queue = queues + index * queue_size;
+
+		if (_kind_spsc == kind)
+		{
+			common_queue_spsc_destroy(queue);
+		}
+		else
+		{
+			common_queue_mpmc_destroy(queue);
+		}
+	}
+
+	free(handles);
+	free(threads);
+	free(queues);
+	return status;
+}
+
+static void* _produce(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+
+	_thread_s* const thread = argument;
+	void** const items = calloc(thread->batch, sizeof(*items));
+	common_debug_assert(items != NULL);
+
+	(void)pthread_barrier_wait(thread->barrier);
+
+	// note: items are non-null counters, summed on both sides to check that
+	// every item arrived exactly once.
+	for (uint64_t next = 1; next <= thread->operations;)
+	{
+		uint64_t count = 0;
+
+		for (; (count < thread->batch) && ((next + count) <= thread->operations); ++count)
+		{
+			items[count] = (void*)(uintptr_t)(next + count);
+		}
+
+		uint64_t pushed = 0;
+
+		while (pushed < count)
+		{
+			const uint64_t result = _push(thread, items + pushed, count - pushed);
+
+			if (0 == result)
+			{
+				(void)sched_yield();
+			}
+
+			pushed += result;
+		}
+
+		for (uint64_t index = 0; index < count; ++index)
+		{
+			thread->sum += next + index;
+		}
+
+		next += count;
+	}
+
+	free(items);
+	return NULL;
+}
+
+static void* _consume(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+
+	_thread_s* const thread = argument;
+	void** const items = calloc(thread->batch, sizeof(*items));
+	common_debug_assert(items != NULL);
+
+	(void)pthread_barrier_wait(thread->barrier);
+
+	// note: a ring consumer knows how many items its producer pushes, while the
+	// consumers of the shared queue count down the items left together.
+	uint64_t left = thread->operations;
+
+	while (true)
+	{
+		const bool_t done = (_kind_spsc == thread->kind) ? (0 == left) : (0 == __atomic_load_n(thread->remaining, __ATOMIC_RELAXED));
+
+		if (done)
+		{
+			break;
+		}
+
+		const uint64_t popped = _pop(thread, items, thread->batch);
+
+		if (0 == popped)
+		{
+			(void)sched_yield();
+			continue;
+		}
+
+		for (uint64_t index = 0; index < popped; ++index)
+		{
+			thread->sum += (uint64_t)(uintptr_t)items[index];
+		}
+
+		left -= (_kind_spsc == thread->kind) ? popped : 0;
+		(void)__atomic_sub_fetch(thread->remaining, popped, __ATOMIC_RELAXED);
+	}
+
+	free(items);
+	return NULL;
+}
+
+static uint64_t _push(const _thread_s* const thread, void* const* const items, const uint64_t count)
+{
+	common_debug_assert(thread != NULL);
+
+	if (_kind_spsc == thread->kind)
+	{
+		return (1 == count) ? (uint64_t)common_queue_spsc_push(thread->queue, items[0]) : common_queue_spsc_push_many(thread->queue, items, count);
+	}
+
+	return (1 == count) ? (uint64_t)common_queue_mpmc_push(thread->queue, items[0]) : common_queue_mpmc_push_many(thread->queue, items, count);
+}
+
+static uint64_t _pop(const _thread_s* const thread, void** const items, const uint64_t capacity)
+{
+	common_debug_assert(thread != NULL);
+
+	if (_kind_spsc == thread->kind)
+	{
+		return (1 == capacity) ? (uint64_t)common_queue_spsc_pop(thread->queue, items) : common_queue_spsc_pop_many(thread->queue, items, capacity);
+	}
+
+	return (1 == capacity) ? (uint64_t)common_queue_mpmc_pop(thread->queue, items) : common_queue_mpmc_pop_many(thread->queue, items, capacity);
+}
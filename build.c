@@ -26,24 +26,68 @@ static const char_t* const _g_common_defines[] =
 	"version_major="stringify(version_major),
 	"version_minor="stringify(version_minor),
 	"version_patch="stringify(version_patch),
+	"_GNU_SOURCE",
+};
+
+static const char_t* const _g_rel_server_defines[] =
+{
+	"server_zero_copy",
+	"common_logger_minimum_level=common_logger_level_note",
 };
 
 static const char_t* const _g_common_sources[] =
 {
+	"./common/source/common/arena.c",
+	"./common/source/common/binlog.c",
 	"./common/source/common/debug.c",
+	"./common/source/common/histogram.c",
 	"./common/source/common/logger.c",
+	"./common/source/common/pool.c",
+	"./common/source/common/protocol.c",
+	"./common/source/common/queue.c",
+	"./common/source/common/scheduler.c",
+	"./common/source/common/timer.c",
 };
 
 static const char_t* const _g_server_sources[] =
 {
+	"./server/source/server/backend.c",
+	"./server/source/server/backend_epoll.c",
+	"./server/source/server/backend_uring.c",
+	"./server/source/server/cache.c",
 	"./server/source/server/config.c",
+	"./server/source/server/connection.c",
+	"./server/source/server/library.c",
+	"./server/source/server/live.c",
 	"./server/source/server/main.c",
+	"./server/source/server/media.c",
+	"./server/source/server/reactor.c",
+	"./server/source/server/stats.c",
+	"./server/source/server/worker.c",
 };
 
 static const char_t* const _g_client_sources[] =
 {
+	"./client/source/client/bench.c",
 	"./client/source/client/config.c",
+	"./client/source/client/connection.c",
 	"./client/source/client/main.c",
+	"./client/source/client/pipeline.c",
+	"./client/source/client/reorder.c",
+};
+
+static const char_t* const _g_bench_sources[] =
+{
+	"./bench/source/bench/config.c",
+	"./bench/source/bench/main.c",
+	"./bench/source/bench/queue.c",
+};
+
+static const char_t* const _g_decoder_sources[] =
+{
+	"./decoder/source/decoder/config.c",
+	"./decoder/source/decoder/decode.c",
+	"./decoder/source/decoder/main.c",
 };
 
 static const char_t* const _g_server_includes[] =
@@ -58,12 +102,28 @@ static const char_t* const _g_client_includes[] =
 	"./client/include",
 };
 
+static const char_t* const _g_bench_includes[] =
+{
+	"./common/include",
+	"./bench/include",
+};
+
+static const char_t* const _g_decoder_includes[] =
+{
+	"./common/include",
+	"./decoder/include",
+};
+
 typedef enum
 {
 	build_conf_dev_server,
 	build_conf_rel_server,
 	build_conf_dev_client,
 	build_conf_rel_client,
+	build_conf_dev_bench,
+	build_conf_rel_bench,
+	build_conf_dev_decoder,
+	build_conf_rel_decoder,
 } build_conf_e;
 
 static void make_compiler_command(build_command_s* const command, const build_conf_e conf);
@@ -100,17 +160,37 @@ build_target(build_rel_client, "build the mediantazy client in the release confi
 	return build(build_conf_rel_client);
 }
 
-build_target(build_dev_all, "build the mediantazy server and client in the develop configuration.")
+build_target(build_dev_bench, "build the mediantazy benchmarks in the develop configuration.")
 {
-	return build_dev_server() && build_dev_client();
+	return build(build_conf_dev_bench);
 }
 
-build_target(build_rel_all, "build the mediantazy server and client in the release configuration.")
+build_target(build_rel_bench, "build the mediantazy benchmarks in the release configuration.")
 {
-	return build_rel_server() && build_rel_client();
+	return build(build_conf_rel_bench);
 }
 
-build_target(build_all, "build the mediantazy server and client in the develop and release configurations.")
+build_target(build_dev_decoder, "build the mediantazy binary log decoder in the develop configuration.")
+{
+	return build(build_conf_dev_decoder);
+}
+
+build_target(build_rel_decoder, "build the mediantazy binary log decoder in the release configuration.")
+{
+	return build(build_conf_rel_decoder);
+}
+
+build_target(build_dev_all, "build the mediantazy server, client, benchmarks and decoder in the develop configuration.")
+{
+	return build_dev_server() && build_dev_client() && build_dev_bench() && build_dev_decoder();
+}
+
+build_target(build_rel_all, "build the mediantazy server, client, benchmarks and decoder in the release configuration.")
+{
+	return build_rel_server() && build_rel_client() && build_rel_bench() && build_rel_decoder();
+}
+
+build_target(build_all, "build the mediantazy server, client, benchmarks and decoder in the develop and release configurations.")
 {
 	return build_dev_all() && build_rel_all();
 }
@@ -135,17 +215,37 @@ build_target(lint_rel_client, "lint the mediantazy client in the release configu
 	return lint(build_conf_rel_client);
 }
 
-build_target(lint_dev_all, "lint the mediantazy server and client in the develop configuration.")
+build_target(lint_dev_bench, "lint the mediantazy benchmarks in the develop configuration.")
+{
+	return lint(build_conf_dev_bench);
+}
+
+build_target(lint_rel_bench, "lint the mediantazy benchmarks in the release configuration.")
+{
+	return lint(build_conf_rel_bench);
+}
+
+build_target(lint_dev_decoder, "lint the mediantazy binary log decoder in the develop configuration.")
+{
+	return lint(build_conf_dev_decoder);
+}
+
+build_target(lint_rel_decoder, "lint the mediantazy binary log decoder in the release configuration.")
+{
+	return lint(build_conf_rel_decoder);
+}
+
+build_target(lint_dev_all, "lint the mediantazy server, client, benchmarks and decoder in the develop configuration.")
 {
-	return lint_dev_server() && lint_dev_client();
+	return lint_dev_server() && lint_dev_client() && lint_dev_bench() && lint_dev_decoder();
 }
 
-build_target(lint_rel_all, "lint the mediantazy server and client in the release configuration.")
+build_target(lint_rel_all, "lint the mediantazy server, client, benchmarks and decoder in the release configuration.")
 {
-	return lint_rel_server() && lint_rel_client();
+	return lint_rel_server() && lint_rel_client() && lint_rel_bench() && lint_rel_decoder();
 }
 
-build_target(lint_all, "lint the mediantazy server and client in the develop and release configurations.")
+build_target(lint_all, "lint the mediantazy server, client, benchmarks and decoder in the develop and release configurations.")
 {
 	return lint_dev_all() && lint_rel_all();
 }
@@ -160,38 +260,51 @@ build_target(docs, "generate the docs for the project.")
 }
 
 build_targets(
-	bind_target(clean           ),
-	bind_target(build_dev_server),
-	bind_target(build_rel_server),
-	bind_target(build_dev_client),
-	bind_target(build_rel_client),
-	bind_target(build_dev_all   ),
-	bind_target(build_rel_all   ),
-	bind_target(build_all       ),
-	bind_target(lint_dev_server ),
-	bind_target(lint_rel_server ),
-	bind_target(lint_dev_client ),
-	bind_target(lint_rel_client ),
-	bind_target(lint_dev_all    ),
-	bind_target(lint_rel_all    ),
-	bind_target(lint_all        ),
-	bind_target(docs            ),
+	bind_target(clean            ),
+	bind_target(build_dev_server ),
+	bind_target(build_rel_server ),
+	bind_target(build_dev_client ),
+	bind_target(build_rel_client ),
+	bind_target(build_dev_bench  ),
+	bind_target(build_rel_bench  ),
+	bind_target(build_dev_decoder),
+	bind_target(build_rel_decoder),
+	bind_target(build_dev_all    ),
+	bind_target(build_rel_all    ),
+	bind_target(build_all        ),
+	bind_target(lint_dev_server  ),
+	bind_target(lint_rel_server  ),
+	bind_target(lint_dev_client  ),
+	bind_target(lint_rel_client  ),
+	bind_target(lint_dev_bench   ),
+	bind_target(lint_rel_bench   ),
+	bind_target(lint_dev_decoder ),
+	bind_target(lint_rel_decoder ),
+	bind_target(lint_dev_all     ),
+	bind_target(lint_rel_all     ),
+	bind_target(lint_all         ),
+	bind_target(docs             ),
 );
 
 static void make_compiler_command(build_command_s* const command, const build_conf_e conf)
 {
 	build_command_append(command, "gcc", "-std=gnu11",
 		"-Wall", "-Wextra", "-Wpedantic", "-Werror", "-Wshadow", "-Wimplicit", "-Wreturn-type", "-Wunknown-pragmas", "-Wunused-variable",
-		"-Wunused-function", "-Wmissing-prototypes", "-Wstrict-prototypes", "-Wconversion", "-Wsign-conversion", "-Wunreachable-code"
+		"-Wunused-function", "-Wmissing-prototypes", "-Wstrict-prototypes", "-Wconversion", "-Wsign-conversion", "-Wunreachable-code",
+		"-pthread"
 	);
 
 	switch (conf)
 	{
-		case build_conf_dev_server: { build_command_append(command, "-O0", "-g3"     , "-o", "./build/mediantazy_dev_server"); } break;
-		case build_conf_rel_server: { build_command_append(command, "-O3", "-DNDEBUG", "-o", "./build/mediantazy_rel_server"); } break;
-		case build_conf_dev_client: { build_command_append(command, "-O0", "-g3"     , "-o", "./build/mediantazy_dev_client"); } break;
-		case build_conf_rel_client: { build_command_append(command, "-O3", "-DNDEBUG", "-o", "./build/mediantazy_rel_client"); } break;
-		default:                    { assert(0);                                                                               } break;
+		case build_conf_dev_server:  { build_command_append(command, "-O0", "-g3"     , "-o", "./build/mediantazy_dev_server" ); } break;
+		case build_conf_rel_server:  { build_command_append(command, "-O3", "-DNDEBUG", "-o", "./build/mediantazy_rel_server" ); } break;
+		case build_conf_dev_client:  { build_command_append(command, "-O0", "-g3"     , "-o", "./build/mediantazy_dev_client" ); } break;
+		case build_conf_rel_client:  { build_command_append(command, "-O3", "-DNDEBUG", "-o", "./build/mediantazy_rel_client" ); } break;
+		case build_conf_dev_bench:   { build_command_append(command, "-O0", "-g3"     , "-o", "./build/mediantazy_dev_bench"  ); } break;
+		case build_conf_rel_bench:   { build_command_append(command, "-O3", "-DNDEBUG", "-o", "./build/mediantazy_rel_bench"  ); } break;
+		case build_conf_dev_decoder: { build_command_append(command, "-O0", "-g3"     , "-o", "./build/mediantazy_dev_decoder"); } break;
+		case build_conf_rel_decoder: { build_command_append(command, "-O3", "-DNDEBUG", "-o", "./build/mediantazy_rel_decoder"); } break;
+		default:                     { assert(0);                                                                                } break;
 	}
 
 	for (uint64_t index = 0; index < static_array_length(_g_common_defines); ++index)
@@ -199,6 +312,11 @@ static void make_compiler_command(build_command_s* const command, const build_co
 		build_command_append(command, "-D", _g_common_defines[index]);
 	}
 
+	for (uint64_t index = 0; (build_conf_rel_server == conf) && (index < static_array_length(_g_rel_server_defines)); ++index)
+	{
+		build_command_append(command, "-D", _g_rel_server_defines[index]);
+	}
+
 	for (uint64_t index = 0; index < static_array_length(_g_common_sources); ++index)
 	{
 		build_command_append(command, _g_common_sources[index]);
@@ -232,6 +350,36 @@ static void make_compiler_command(build_command_s* const command, const build_co
 			{
 				build_command_append(command, _g_client_sources[index]);
 			}
+
+			build_command_append(command, "-lm");
+		} break;
+
+		case build_conf_dev_bench:
+		case build_conf_rel_bench:
+		{
+			for (uint64_t index = 0; index < static_array_length(_g_bench_includes); ++index)
+			{
+				build_command_append(command, "-I", _g_bench_includes[index]);
+			}
+
+			for (uint64_t index = 0; index < static_array_length(_g_bench_sources); ++index)
+			{
+				build_command_append(command, _g_bench_sources[index]);
+			}
+		} break;
+
+		case build_conf_dev_decoder:
+		case build_conf_rel_decoder:
+		{
+			for (uint64_t index = 0; index < static_array_length(_g_decoder_includes); ++index)
+			{
+				build_command_append(command, "-I", _g_decoder_includes[index]);
+			}
+
+			for (uint64_t index = 0; index < static_array_length(_g_decoder_sources); ++index)
+			{
+				build_command_append(command, _g_decoder_sources[index]);
+			}
 		} break;
 
 		default: { assert(0); } break;
@@ -279,11 +427,15 @@ static void make_linter_command(build_command_s* const command, const build_conf
 
 	switch (conf)
 	{
-		case build_conf_dev_server: {                                            } break;
-		case build_conf_rel_server: { build_command_append(command, "-DNDEBUG"); } break;
-		case build_conf_dev_client: {                                            } break;
-		case build_conf_rel_client: { build_command_append(command, "-DNDEBUG"); } break;
-		default:                    { assert(0);                                 } break;
+		case build_conf_dev_server:  {                                            } break;
+		case build_conf_rel_server:  { build_command_append(command, "-DNDEBUG"); } break;
+		case build_conf_dev_client:  {                                            } break;
+		case build_conf_rel_client:  { build_command_append(command, "-DNDEBUG"); } break;
+		case build_conf_dev_bench:   {                                            } break;
+		case build_conf_rel_bench:   { build_command_append(command, "-DNDEBUG"); } break;
+		case build_conf_dev_decoder: {                                            } break;
+		case build_conf_rel_decoder: { build_command_append(command, "-DNDEBUG"); } break;
+		default:                     { assert(0);                                 } break;
 	}
 
 	for (uint64_t index = 0; index < static_array_length(_g_common_defines); ++index)
@@ -291,6 +443,11 @@ static void make_linter_command(build_command_s* const command, const build_conf
 		build_command_append(command, "-D", _g_common_defines[index]);
 	}
 
+	for (uint64_t index = 0; (build_conf_rel_server == conf) && (index < static_array_length(_g_rel_server_defines)); ++index)
+	{
+		build_command_append(command, "-D", _g_rel_server_defines[index]);
+	}
+
 	for (uint64_t index = 0; index < static_array_length(_g_common_sources); ++index)
 	{
 		build_command_append(command, _g_common_sources[index]);
@@ -324,6 +481,36 @@ static void make_linter_command(build_command_s* const command, const build_conf
 			{
 				build_command_append(command, _g_client_sources[index]);
 			}
+
+			build_command_append(command, "-lm");
+		} break;
+
+		case build_conf_dev_bench:
+		case build_conf_rel_bench:
+		{
+			for (uint64_t index = 0; index < static_array_length(_g_bench_includes); ++index)
+			{
+				build_command_append(command, "-I", _g_bench_includes[index]);
+			}
+
+			for (uint64_t index = 0; index < static_array_length(_g_bench_sources); ++index)
+			{
+				build_command_append(command, _g_bench_sources[index]);
+			}
+		} break;
+
+		case build_conf_dev_decoder:
+		case build_conf_rel_decoder:
+		{
+			for (uint64_t index = 0; index < static_array_length(_g_decoder_includes); ++index)
+			{
+				build_command_append(command, "-I", _g_decoder_includes[index]);
+			}
+
+			for (uint64_t index = 0; index < static_array_length(_g_decoder_sources); ++index)
+			{
+				build_command_append(command, _g_decoder_sources[index]);
+			}
 		} break;
 
 		default: { assert(0); } break;
@@ -0,0 +1,38 @@
+
+/**
+ * @file bench.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __client__include__client__bench_h__
+#define __client__include__client__bench_h__
+
+#include "common/types.h"
+
+#include "client/config.h"
+
+#define client_bench_connections_limit ((uint32_t)1024)
+#define client_bench_rate_limit        ((uint64_t)100000000)
+
+/**
+ * @brief Put the load of the bench command on the server over all of its
+ * connections from a single event loop, each one keeping its window of
+ * requests in flight, until the duration is up or the requests are sent.
+ * Then report the throughput, the errors and the latency distribution of the
+ * requests, the latency of a request running from its send up to the end of
+ * its response.
+ * 
+ * @param config configuration of the bench command
+ * 
+ * @return bool_t false if the load could not be put on at all, or the report
+ * could not be written
+ */
+bool_t client_bench_run(const client_config_s* const config);
+
+#endif
@@ -13,12 +13,53 @@
 #ifndef __server__include__server__config_h__
 #define __server__include__server__config_h__
 
+#include "common/protocol.h"
 #include "common/types.h"
 
+typedef enum
+{
+	client_command_run,
+	client_command_bench,
+} client_command_e;
+
+/**
+ * @brief The load put on by the bench command, a weighted mix of requests for
+ * a segment picked at random out of the count from the segment on, and
+ * requests for the range.
+ * 
+ * @note Without a rate the load is a closed loop, in which a request goes out
+ * as soon as another one finished. With one it is an open loop, in which the
+ * requests go out on a schedule whatever the server does.
+ */
 typedef struct
 {
+	uint32_t segment_weight;
+	uint32_t range_weight;
+	uint64_t duration_ms;
+	uint64_t requests;
+	uint64_t rate;
+	bool_t poisson;
+	const char_t* json;
+} client_config_bench_s;
+
+typedef struct
+{
+	client_command_e command;
 	const char_t* address;
 	uint16_t port;
+	uint64_t media_id;
+	uint32_t segment;
+	uint32_t count;
+	uint32_t inflight;
+	uint32_t connections;
+
+	// note: either a plain request for the segment, or a byte or time range
+	// request for the range of the media.
+	common_protocol_frame_e request_type;
+	common_protocol_range_s range;
+
+	const char_t* output;
+	client_config_bench_s bench;
 } client_config_s;
 
 client_config_s client_config_from_cli(int32_t* const argc, const char_t*** const argv);
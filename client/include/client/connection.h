@@ -0,0 +1,135 @@
+
+/**
+ * @file connection.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __client__include__client__connection_h__
+#define __client__include__client__connection_h__
+
+#include "common/protocol.h"
+#include "common/types.h"
+
+#define client_connection_buffer_size ((uint64_t)65536)
+
+typedef enum
+{
+	client_connection_status_ready,
+	client_connection_status_pending,
+	client_connection_status_failed,
+} client_connection_status_e;
+
+typedef struct
+{
+	int32_t fd;
+	bool_t nonblocking;
+
+	// note: a pong owed to the server by a non-blocking connection, which it
+	// leaves to its owner to send, after whatever it is in the middle of.
+	bool_t pong_owed;
+
+	uint8_t input[client_connection_buffer_size];
+	uint64_t input_offset;
+	uint64_t input_count;
+
+	common_protocol_reader_s reader;
+} client_connection_s;
+
+/**
+ * @brief Open a connection to the server.
+ * 
+ * @param connection connection to open
+ * @param address    address of the server
+ * @param port       port of the server
+ * 
+ * @return bool_t
+ */
+bool_t client_connection_open(client_connection_s* const connection, const char_t* const address, const uint16_t port);
+
+/**
+ * @brief Close the connection.
+ * 
+ * @param connection connection to close
+ */
+void client_connection_close(client_connection_s* const connection);
+
+/**
+ * @brief Switch the connection to non-blocking mode, for it to be driven by an
+ * event loop through client_connection_try_send and
+ * client_connection_try_receive.
+ * 
+ * @param connection connection to switch
+ * 
+ * @return bool_t
+ */
+bool_t client_connection_set_nonblocking(client_connection_s* const connection);
+
+/**
+ * @brief Send bytes over the connection, blocking until all of them are sent.
+ * The connection must not be in non-blocking mode.
+ * 
+ * @param connection connection to send over
+ * @param data       bytes to send
+ * @param size       number of bytes to send
+ * 
+ * @return bool_t
+ */
+bool_t client_connection_send(client_connection_s* const connection, const uint8_t* const data, const uint64_t size);
+
+/**
+ * @brief Send as many bytes over a non-blocking connection as its socket takes,
+ * without blocking.
+ * 
+ * @param connection connection to send over
+ * @param data       bytes to send
+ * @param size       number of bytes to send
+ * @param sent       number of bytes sent
+ * 
+ * @return client_connection_status_e pending if the socket is full before all
+ * of them are sent, and failed if the send failed
+ */
+client_connection_status_e client_connection_try_send(client_connection_s* const connection, const uint8_t* const data, const uint64_t size, uint64_t* const sent);
+
+/**
+ * @brief Receive the next chunk of a frame, blocking until one arrives.
+ * 
+ * @note The chunk points into the connection input buffer and stays valid
+ * until the next call.
+ * 
+ * @note Pings from the server are answered while waiting, and are never
+ * handed out.
+ * 
+ * @param connection connection to receive from
+ * @param chunk      received chunk
+ * 
+ * @return bool_t false if the connection was closed or the server sent an
+ * invalid frame
+ */
+bool_t client_connection_receive(client_connection_s* const connection, common_protocol_chunk_s* const chunk);
+
+/**
+ * @brief Receive the next chunk of a frame if the bytes for it are at hand,
+ * without blocking in non-blocking mode.
+ * 
+ * @note The chunk points into the connection input buffer and stays valid
+ * until the next call.
+ * 
+ * @note In non-blocking mode pings from the server are not answered right
+ * away, but leave a pong owed for the owner of the connection to send.
+ * 
+ * @param connection connection to receive from
+ * @param chunk      received chunk
+ * 
+ * @return client_connection_status_e pending if more bytes have to arrive
+ * first, and failed if the connection was closed or the server sent an
+ * invalid frame
+ */
+client_connection_status_e client_connection_try_receive(client_connection_s* const connection, common_protocol_chunk_s* const chunk);
+
+#endif
@@ -0,0 +1,124 @@
+
+/**
+ * @file pipeline.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __client__include__client__pipeline_h__
+#define __client__include__client__pipeline_h__
+
+#include "common/types.h"
+#include "common/arena.h"
+
+#include "client/connection.h"
+
+#define client_pipeline_inflight_limit ((uint32_t)4096)
+
+typedef struct client_pipeline_piece_s client_pipeline_piece_s;
+
+/**
+ * @brief A segment request in flight. Its stream id is its sequence number,
+ * so that a response is matched to its request by the id alone.
+ */
+typedef struct
+{
+	uint32_t stream_id;
+	uint32_t chunk;
+	bool_t complete;
+	bool_t missing;
+
+	// note: the payload of a response that arrives ahead of the responses to
+	// earlier requests, held piece by piece until those are delivered, in an
+	// arena that is reset once it is.
+	common_arena_s arena;
+	client_pipeline_piece_s* first;
+	client_pipeline_piece_s* last;
+	uint64_t size;
+} client_pipeline_request_s;
+
+typedef struct
+{
+	uint64_t segments;
+	uint64_t bytes;
+	uint64_t buffered;
+} client_pipeline_stats_s;
+
+/**
+ * @brief Fetcher of a run of evenly spaced segments of a media over a single
+ * connection, which keeps a window of requests in flight so that the run is
+ * not fetched at one segment per round trip. The segments are delivered in
+ * order whatever order the responses come in.
+ */
+typedef struct
+{
+	client_connection_s* connection;
+	uint64_t media_id;
+	uint32_t next_chunk;
+	uint32_t stride;
+	uint64_t unsent;
+	bool_t open_ended;
+	bool_t ended;
+
+	// note: index of the first segment found missing, once the pipeline ended.
+	uint32_t end_chunk;
+
+	bool_t (*deliver)(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last);
+	void* argument;
+
+	// note: the requests in flight, oldest first from the head of the ring.
+	client_pipeline_request_s* requests;
+	uint32_t capacity;
+	uint32_t head;
+	uint32_t count;
+	uint32_t next_stream_id;
+
+	uint8_t* outgoing;
+	client_pipeline_stats_s stats;
+} client_pipeline_s;
+
+/**
+ * @brief Create a pipeline over an open connection.
+ * 
+ * @param pipeline   pipeline to create
+ * @param connection connection to fetch the segments over
+ * @param media_id   id of the media
+ * @param first      index of the first segment to fetch
+ * @param stride     distance between two segments to fetch, 1 for a run of
+ *                   consecutive segments
+ * @param count      number of segments to fetch, or 0 to fetch up to the end
+ *                   of the media, which is the first segment not found
+ * @param inflight   number of requests kept in flight
+ * @param deliver    function the segments are handed to in order, piece by
+ *                   piece, with the last piece of a segment flagged, and which
+ *                   returns false to abort the fetch
+ * @param argument   argument to pass to the function
+ * 
+ * @return bool_t
+ */
+bool_t client_pipeline_create(client_pipeline_s* const pipeline, client_connection_s* const connection, const uint64_t media_id, const uint32_t first, const uint32_t stride,
+	const uint64_t count, const uint32_t inflight, bool_t (*deliver)(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last), void* const argument);
+
+/**
+ * @brief Destroy the pipeline.
+ * 
+ * @param pipeline pipeline to destroy
+ */
+void client_pipeline_destroy(client_pipeline_s* const pipeline);
+
+/**
+ * @brief Fetch all segments of the pipeline.
+ * 
+ * @param pipeline pipeline to run
+ * 
+ * @return bool_t false if the connection failed, the server failed to serve a
+ * segment, or the delivery was aborted
+ */
+bool_t client_pipeline_run(client_pipeline_s* const pipeline);
+
+#endif
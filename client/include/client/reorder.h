@@ -0,0 +1,161 @@
+
+/**
+ * @file reorder.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __client__include__client__reorder_h__
+#define __client__include__client__reorder_h__
+
+#include "common/types.h"
+
+#include <pthread.h>
+
+#define client_reorder_producers_limit ((uint32_t)64)
+
+typedef struct
+{
+	uint8_t* data;
+	uint64_t size;
+	uint64_t capacity;
+	bool_t present;
+} client_reorder_slot_s;
+
+typedef struct
+{
+	uint64_t segments;
+	uint64_t peak;
+	uint64_t stalls;
+} client_reorder_stats_s;
+
+/**
+ * @brief Bounded buffer that puts segments fetched out of order by several
+ * producers back in order for a single consumer. A segment is only taken in
+ * once it is less than the capacity ahead of the next one to hand out, so
+ * that a producer which runs ahead waits for the others instead of growing
+ * the buffer without limit.
+ * 
+ * @note The producer of the next segment to hand out is never held up, so
+ * the producers can not deadlock as long as each of them puts its segments
+ * in order.
+ * 
+ * @note The payloads go around in a circle: the one taken last goes back to
+ * the buffer on the next take, and a producer gets one back for every one it
+ * puts in, so that the fetch stops allocating once every payload has grown
+ * to the size of the largest segment.
+ */
+typedef struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t readable;
+	pthread_cond_t writable;
+
+	client_reorder_slot_s* slots;
+	uint32_t capacity;
+
+	// note: the payload handed out last and the ones given back for reuse.
+	client_reorder_slot_s taken;
+	client_reorder_slot_s* spares;
+	uint32_t spare_count;
+
+	uint64_t next;
+	uint64_t end;
+	uint32_t held;
+	uint32_t producers;
+	bool_t failed;
+
+	client_reorder_stats_s stats;
+} client_reorder_s;
+
+/**
+ * @brief Create an empty reorder buffer.
+ * 
+ * @param reorder   reorder buffer to create
+ * @param first     index of the first segment to hand out
+ * @param end       index past the last segment to hand out, or UINT64_MAX if
+ *                  it is only known once a producer runs into it
+ * @param capacity  number of segments the buffer may hold
+ * @param producers number of producers putting segments into the buffer
+ * 
+ * @return bool_t
+ */
+bool_t client_reorder_create(client_reorder_s* const reorder, const uint64_t first, const uint64_t end, const uint32_t capacity, const uint32_t producers);
+
+/**
+ * @brief Destroy the reorder buffer, the segments it still holds and the
+ * payloads given back for reuse.
+ * 
+ * @param reorder reorder buffer to destroy
+ */
+void client_reorder_destroy(client_reorder_s* const reorder);
+
+/**
+ * @brief Put a complete segment into the buffer, waiting for room for it.
+ * 
+ * @param reorder  reorder buffer to put the segment into
+ * @param chunk    index of the segment
+ * @param data     payload of the segment, allocated with malloc, which passes
+ *                 to the buffer either way, and which is set to a payload to
+ *                 reuse, or NULL if there is none
+ * @param capacity number of bytes allocated for the payload, which is set to
+ *                 the capacity of the payload to reuse
+ * @param size     size of the segment
+ * 
+ * @return bool_t false if the segment lies past the end, or the buffer was
+ * aborted
+ */
+bool_t client_reorder_put(client_reorder_s* const reorder, const uint64_t chunk, uint8_t** const data, uint64_t* const capacity, const uint64_t size);
+
+/**
+ * @brief Mark the end of the segments, once a producer found that a segment
+ * does not exist. Segments from it on are never handed out.
+ * 
+ * @param reorder reorder buffer to mark the end of
+ * @param end     index of the first segment that does not exist
+ */
+void client_reorder_end(client_reorder_s* const reorder, const uint64_t end);
+
+/**
+ * @brief Mark that a producer is done putting segments into the buffer.
+ * 
+ * @param reorder reorder buffer the producer put its segments into
+ * @param status  false if the producer failed, which aborts the buffer
+ */
+void client_reorder_finish(client_reorder_s* const reorder, const bool_t status);
+
+/**
+ * @brief Abort the buffer, waking up every producer and the consumer.
+ * 
+ * @param reorder reorder buffer to abort
+ */
+void client_reorder_abort(client_reorder_s* const reorder);
+
+/**
+ * @brief Take the next segment out of the buffer, waiting for it to arrive.
+ * 
+ * @param reorder reorder buffer to take the segment from
+ * @param data    payload of the segment, which stays with the buffer and is
+ *                valid until the next take
+ * @param size    size of the segment
+ * 
+ * @return bool_t false once there are no more segments to hand out, either
+ * because the end was reached or the buffer was aborted
+ */
+bool_t client_reorder_take(client_reorder_s* const reorder, uint8_t** const data, uint64_t* const size);
+
+/**
+ * @brief Check if the buffer was aborted.
+ * 
+ * @param reorder reorder buffer to check
+ * 
+ * @return bool_t
+ */
+bool_t client_reorder_has_failed(client_reorder_s* const reorder);
+
+#endif
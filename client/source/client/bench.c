@@ -0,0 +1,806 @@
+
+/**
+ * @file bench.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/protocol.h"
+#include "common/histogram.h"
+#include "common/timer.h"
+
+#include "client/connection.h"
+#include "client/bench.h"
+
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#define _events_capacity  ((uint32_t)256)
+#define _drain_timeout_ms ((uint64_t)5000)
+#define _errors_count     ((uint64_t)common_protocol_error_out_of_range + 1)
+#define _timer_token      UINT32_MAX
+
+/**
+ * @brief A request in flight, whose stream id is its slot on the connection
+ * plus one, so that a slot is only ever reused once its response ended.
+ * 
+ * @note In open loop a request is timed from when the schedule meant it to go
+ * out rather than from when it did, so that a server stall which holds up the
+ * requests behind it is not hidden from their latency. For the same reason, a
+ * request that never finishes is timed up to when it was given up on, and so
+ * is one that was due but never went out.
+ */
+typedef struct
+{
+	uint64_t sent_ns;
+	bool_t busy;
+} _request_s;
+
+typedef struct
+{
+	client_connection_s connection;
+	bool_t open;
+
+	_request_s* requests;
+	uint32_t* idle;
+	uint32_t idle_count;
+	uint32_t inflight;
+
+	// note: the bytes the socket did not take yet, which go out ahead of any
+	// queued after them once it has room again. only busy requests have bytes
+	// in here, along with at most one pong, so a window of the largest frames
+	// and a pong always fit.
+	uint8_t* outgoing;
+	uint64_t outgoing_size;
+	bool_t blocked;
+} _peer_s;
+
+typedef struct
+{
+	const client_config_s* config;
+	int32_t epoll_fd;
+	int32_t timer_fd;
+	_peer_s* peers;
+	uint32_t peers_count;
+	uint32_t open_count;
+	uint64_t seed;
+	bool_t stopping;
+
+	// note: the schedule of the open loop, the time the next request is meant
+	// to go out at, and the connection to try it on first.
+	uint64_t start_ns;
+	uint64_t next_ns;
+	uint64_t scheduled;
+	uint32_t cursor;
+	uint64_t lag_max_ns;
+	uint64_t unsent;
+
+	uint64_t sent;
+	uint64_t completed;
+	uint64_t inflight;
+	uint64_t bytes;
+	uint64_t errors[_errors_count];
+	uint64_t lost;
+	uint64_t unfinished;
+	uint64_t failed_connections;
+
+	// note: the latency of every successful request, and of every request
+	// given up on, in nanoseconds, kept in a histogram so that a long run
+	// takes no more memory than a short one.
+	common_histogram_s latency;
+} _bench_s;
+
+static bool_t _open_peers(_bench_s* const bench);
+
+static void _close_peers(_bench_s* const bench);
+
+static bool_t _fill(_bench_s* const bench, _peer_s* const peer);
+
+static void _schedule(_bench_s* const bench, const uint64_t now);
+
+static void _record_unsent(_bench_s* const bench, const uint64_t until, const uint64_t stopped);
+
+static void _record_outstanding(_bench_s* const bench, const _peer_s* const peer, const uint64_t now);
+
+static void _issue(_bench_s* const bench, _peer_s* const peer, const uint64_t sent_ns);
+
+static bool_t _flush(_bench_s* const bench, _peer_s* const peer);
+
+static bool_t _may_send(const _bench_s* const bench);
+
+static uint64_t _next_arrival(_bench_s* const bench);
+
+static void _arm_timer(const _bench_s* const bench, const uint64_t at_ns);
+
+static bool_t _drain(_bench_s* const bench, _peer_s* const peer);
+
+static bool_t _handle_chunk(_bench_s* const bench, _peer_s* const peer, const common_protocol_chunk_s* const chunk);
+
+static void _complete(_bench_s* const bench, _peer_s* const peer, _request_s* const request, const bool_t succeeded);
+
+static void _fail_peer(_bench_s* const bench, _peer_s* const peer);
+
+static bool_t _report(const _bench_s* const bench, const uint64_t elapsed_ns);
+
+static bool_t _write_json(const _bench_s* const bench, const uint64_t elapsed_ns, const double* const percentiles);
+
+static double _percentile_ms(const _bench_s* const bench, const double percentile);
+
+static const char_t* _arrivals_name(const client_config_s* const config);
+
+static uint64_t _next_random(_bench_s* const bench);
+
+bool_t client_bench_run(const client_config_s* const config)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(client_command_bench == config->command);
+
+	_bench_s bench =
+	{
+		.config      = config,
+		.epoll_fd    = -1,
+		.timer_fd    = -1,
+		.peers_count = config->connections,
+		.seed        = common_timer_now_ns() | 1,
+	};
+
+	common_histogram_create(&bench.latency);
+
+	const bool_t open_loop = (config->bench.rate > 0);
+
+	bool_t status = false;
+
+	if (!_open_peers(&bench))
+	{
+		goto client_bench_run_end;
+	}
+
+	const uint64_t start    = common_timer_now_ns();
+	const uint64_t deadline = (config->bench.duration_ms > 0) ? (start + (config->bench.duration_ms * 1000000)) : UINT64_MAX;
+	uint64_t stopped        = 0;
+
+	bench.start_ns = start;
+	bench.next_ns  = start;
+
+	for (uint32_t index = 0; (index < bench.peers_count) && !open_loop; ++index)
+	{
+		if (!_fill(&bench, &bench.peers[index]))
+		{
+			_fail_peer(&bench, &bench.peers[index]);
+		}
+	}
+
+	struct epoll_event events[_events_capacity];
+
+	while (true)
+	{
+		const uint64_t now = common_timer_now_ns();
+
+		if (!bench.stopping && ((now >= deadline) || !_may_send(&bench)))
+		{
+			bench.stopping = true;
+			stopped        = now;
+
+			if (open_loop)
+			{
+				_record_unsent(&bench, (stopped < deadline) ? stopped : deadline, stopped);
+			}
+		}
+
+		if (open_loop && !bench.stopping)
+		{
+			_schedule(&bench, now);
+		}
+
+		if ((0 == bench.inflight) && (bench.stopping || (0 == bench.open_count)))
+		{
+			break;
+		}
+
+		// note: once the load is off, the requests still in flight are given
+		// a while to finish, and are reported as unfinished past it.
+		if (bench.stopping && (now >= (stopped + (_drain_timeout_ms * 1000000))))
+		{
+			for (uint32_t index = 0; index < bench.peers_count; ++index)
+			{
+				_record_outstanding(&bench, &bench.peers[index], now);
+			}
+
+			bench.unfinished = bench.inflight;
+			break;
+		}
+
+		// note: a schedule that fell behind for lack of room in the windows
+		// goes on once responses make room, not on a timer.
+		uint64_t wakeup = bench.stopping ? (stopped + (_drain_timeout_ms * 1000000)) : deadline;
+
+		if (open_loop && !bench.stopping && (bench.next_ns > now) && (bench.next_ns < wakeup))
+		{
+			wakeup = bench.next_ns;
+		}
+
+		_arm_timer(&bench, wakeup);
+		const int32_t count = epoll_wait(bench.epoll_fd, events, _events_capacity, -1);
+
+		if (count < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			common_logger_error("failed to wait for the bench connections: %s.", strerror(errno));
+			goto client_bench_run_end;
+		}
+
+		for (int32_t index = 0; index < count; ++index)
+		{
+			if (_timer_token == events[index].data.u32)
+			{
+				uint64_t expirations = 0;
+				(void)!read(bench.timer_fd, &expirations, sizeof(expirations));
+				continue;
+			}
+
+			_peer_s* const peer = &bench.peers[events[index].data.u32];
+
+			if (peer->open && (!_drain(&bench, peer) || (open_loop ? !_flush(&bench, peer) : !_fill(&bench, peer))))
+			{
+				_fail_peer(&bench, peer);
+			}
+		}
+	}
+
+	status = _report(&bench, common_timer_now_ns() - start);
+
+client_bench_run_end:
+	_close_peers(&bench);
+	return status;
+}
+
+static bool_t _open_peers(_bench_s* const bench)
+{
+	common_debug_assert(bench != NULL);
+
+	const client_config_s* const config = bench->config;
+	bench->peers    = calloc(bench->peers_count, sizeof(*bench->peers));
+	bench->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	bench->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+	if ((NULL == bench->peers) || (bench->epoll_fd < 0) || (bench->timer_fd < 0))
+	{
+		common_logger_error("failed to set up %u bench connections: %s.", bench->peers_count, strerror(errno));
+		return false;
+	}
+
+	struct epoll_event timer_event = { .events = EPOLLIN, .data.u32 = _timer_token };
+
+	if (epoll_ctl(bench->epoll_fd, EPOLL_CTL_ADD, bench->timer_fd, &timer_event) < 0)
+	{
+		common_logger_error("failed to watch the bench timer: %s.", strerror(errno));
+		return false;
+	}
+
+	for (uint32_t index = 0; index < bench->peers_count; ++index)
+	{
+		_peer_s* const peer = &bench->peers[index];
+		peer->requests = calloc(config->inflight, sizeof(*peer->requests));
+		peer->idle     = calloc(config->inflight, sizeof(*peer->idle));
+		peer->outgoing = malloc((config->inflight * common_protocol_range_frame_size) + common_protocol_ping_frame_size);
+
+		if ((NULL == peer->requests) || (NULL == peer->idle) || (NULL == peer->outgoing))
+		{
+			common_logger_error("failed to allocate bench connection %u.", index);
+			return false;
+		}
+
+		for (uint32_t slot = 0; slot < config->inflight; ++slot)
+		{
+			peer->idle[slot] = config->inflight - 1 - slot;
+		}
+
+		peer->idle_count = config->inflight;
+
+		if (!client_connection_open(&peer->connection, config->address, config->port))
+		{
+			return false;
+		}
+
+		peer->open = true;
+		++bench->open_count;
+
+		struct epoll_event event = { .events = EPOLLIN, .data.u32 = index };
+
+		if (!client_connection_set_nonblocking(&peer->connection) || (epoll_ctl(bench->epoll_fd, EPOLL_CTL_ADD, peer->connection.fd, &event) < 0))
+		{
+			common_logger_error("failed to watch bench connection %u: %s.", index, strerror(errno));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void _close_peers(_bench_s* const bench)
+{
+	common_debug_assert(bench != NULL);
+
+	if (bench->peers != NULL)
+	{
+		for (uint32_t index = 0; index < bench->peers_count; ++index)
+		{
+			_peer_s* const peer = &bench->peers[index];
+
+			if (peer->open)
+			{
+				client_connection_close(&peer->connection);
+			}
+
+			free(peer->outgoing);
+			free(peer->idle);
+			free(peer->requests);
+		}
+	}
+
+	if (bench->timer_fd >= 0)
+	{
+		(void)close(bench->timer_fd);
+	}
+
+	if (bench->epoll_fd >= 0)
+	{
+		(void)close(bench->epoll_fd);
+	}
+
+	free(bench->peers);
+	bench->peers = NULL;
+}
+
+static bool_t _fill(_bench_s* const bench, _peer_s* const peer)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+
+	const uint64_t now = common_timer_now_ns();
+
+	// note: the requests that fill up the window go out in a single send.
+	while (!bench->stopping && (peer->idle_count > 0) && _may_send(bench))
+	{
+		_issue(bench, peer, now);
+	}
+
+	return _flush(bench, peer);
+}
+
+static void _schedule(_bench_s* const bench, const uint64_t now)
+{
+	common_debug_assert(bench != NULL);
+
+	// note: every request that is due goes out on the next connection with
+	// room in its window, and the ones that find no room stay due, so that
+	// their wait is part of their latency.
+	while ((bench->next_ns <= now) && _may_send(bench))
+	{
+		_peer_s* peer = NULL;
+
+		for (uint32_t tried = 0; (tried < bench->peers_count) && (NULL == peer); ++tried)
+		{
+			_peer_s* const candidate = &bench->peers[bench->cursor];
+			bench->cursor = (bench->cursor + 1) % bench->peers_count;
+			peer = (candidate->open && (candidate->idle_count > 0)) ? candidate : NULL;
+		}
+
+		if (NULL == peer)
+		{
+			break;
+		}
+
+		const uint64_t lag = now - bench->next_ns;
+		bench->lag_max_ns  = (lag > bench->lag_max_ns) ? lag : bench->lag_max_ns;
+
+		_issue(bench, peer, bench->next_ns);
+		bench->next_ns = _next_arrival(bench);
+	}
+
+	for (uint32_t index = 0; index < bench->peers_count; ++index)
+	{
+		_peer_s* const peer = &bench->peers[index];
+
+		if (peer->open && !_flush(bench, peer))
+		{
+			_fail_peer(bench, peer);
+		}
+	}
+}
+
+static void _record_unsent(_bench_s* const bench, const uint64_t until, const uint64_t stopped)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(until <= stopped);
+
+	// note: the requests the schedule meant to send before the deadline, but
+	// which found no room in any window by the time the load was taken off,
+	// are timed up to then, as if they were sent and lost, rather than left
+	// out of the latency.
+	while ((bench->next_ns < until) && ((0 == bench->config->bench.requests) || ((bench->sent + bench->unsent) < bench->config->bench.requests)))
+	{
+		common_histogram_record(&bench->latency, stopped - bench->next_ns);
+		++bench->unsent;
+		bench->next_ns = _next_arrival(bench);
+	}
+}
+
+static void _record_outstanding(_bench_s* const bench, const _peer_s* const peer, const uint64_t now)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+
+	for (uint32_t slot = 0; (slot < bench->config->inflight) && (peer->inflight > 0); ++slot)
+	{
+		if (peer->requests[slot].busy)
+		{
+			common_histogram_record(&bench->latency, now - peer->requests[slot].sent_ns);
+		}
+	}
+}
+
+static void _issue(_bench_s* const bench, _peer_s* const peer, const uint64_t sent_ns)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+	common_debug_assert(peer->idle_count > 0);
+
+	const client_config_s* const config = bench->config;
+	const uint64_t weights = (uint64_t)config->bench.segment_weight + config->bench.range_weight;
+	const uint32_t slot = peer->idle[--peer->idle_count];
+	const uint32_t stream_id = slot + 1;
+
+	if ((_next_random(bench) % weights) < config->bench.segment_weight)
+	{
+		const common_protocol_request_s request =
+		{
+			.media_id = config->media_id,
+			.chunk    = config->segment + (uint32_t)(_next_random(bench) % config->count),
+		};
+
+		common_protocol_encode_request(peer->outgoing + peer->outgoing_size, stream_id, &request);
+		peer->outgoing_size += common_protocol_request_frame_size;
+	}
+	else
+	{
+		common_protocol_encode_range(peer->outgoing + peer->outgoing_size, stream_id, config->request_type, &config->range);
+		peer->outgoing_size += common_protocol_range_frame_size;
+	}
+
+	peer->requests[slot] = (const _request_s) { .sent_ns = sent_ns, .busy = true };
+	++peer->inflight;
+	++bench->inflight;
+	++bench->sent;
+}
+
+static bool_t _flush(_bench_s* const bench, _peer_s* const peer)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+
+	client_connection_s* const connection = &peer->connection;
+	client_connection_status_e status = client_connection_status_ready;
+
+	while (client_connection_status_ready == status)
+	{
+		// note: an owed pong only goes in once everything ahead of it is out,
+		// which keeps it to one in the buffer.
+		if ((0 == peer->outgoing_size) && connection->pong_owed)
+		{
+			common_protocol_encode_ping(peer->outgoing, common_protocol_frame_pong);
+			peer->outgoing_size   = common_protocol_ping_frame_size;
+			connection->pong_owed = false;
+		}
+
+		if (0 == peer->outgoing_size)
+		{
+			break;
+		}
+
+		uint64_t sent = 0;
+		status = client_connection_try_send(connection, peer->outgoing, peer->outgoing_size, &sent);
+
+		if (client_connection_status_failed == status)
+		{
+			return false;
+		}
+
+		(void)memmove(peer->outgoing, peer->outgoing + sent, peer->outgoing_size - sent);
+		peer->outgoing_size -= sent;
+	}
+
+	// note: the connection is only watched for room in its socket while it
+	// has bytes waiting for it, as the watch is level-triggered.
+	const bool_t blocked = client_connection_status_pending == status;
+
+	if (blocked != peer->blocked)
+	{
+		struct epoll_event event = { .events = EPOLLIN | (blocked ? EPOLLOUT : 0), .data.u32 = (uint32_t)(peer - bench->peers) };
+
+		if (epoll_ctl(bench->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event) < 0)
+		{
+			common_logger_error("failed to watch bench connection %u: %s.", event.data.u32, strerror(errno));
+			return false;
+		}
+
+		peer->blocked = blocked;
+	}
+
+	return true;
+}
+
+static bool_t _may_send(const _bench_s* const bench)
+{
+	common_debug_assert(bench != NULL);
+	return (0 == bench->config->bench.requests) || (bench->sent < bench->config->bench.requests);
+}
+
+static uint64_t _next_arrival(_bench_s* const bench)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(bench->config->bench.rate > 0);
+
+	const double rate = (double)bench->config->bench.rate;
+	++bench->scheduled;
+
+	// note: poisson arrivals are apart by exponentially distributed gaps, drawn
+	// by inverting the distribution on a uniform variate in (0, 1], while even
+	// ones are laid out from the start so that rounding does not add up.
+	if (bench->config->bench.poisson)
+	{
+		const double uniform = ((double)(_next_random(bench) >> 11) + 1.0) / 9007199254740992.0;
+		return bench->next_ns + (uint64_t)((-log(uniform) / rate) * 1e9);
+	}
+
+	return bench->start_ns + (uint64_t)(((double)bench->scheduled / rate) * 1e9);
+}
+
+static void _arm_timer(const _bench_s* const bench, const uint64_t at_ns)
+{
+	common_debug_assert(bench != NULL);
+
+	// note: a zero time disarms the timer, so a time that lies in the past is
+	// nudged to the earliest one, which fires right away.
+	struct itimerspec timer = {0};
+
+	if (at_ns != UINT64_MAX)
+	{
+		timer.it_value.tv_sec  = (time_t)(at_ns / 1000000000);
+		timer.it_value.tv_nsec = (long)(at_ns % 1000000000);
+		timer.it_value.tv_nsec = ((0 == timer.it_value.tv_sec) && (0 == timer.it_value.tv_nsec)) ? 1 : timer.it_value.tv_nsec;
+	}
+
+	(void)timerfd_settime(bench->timer_fd, TFD_TIMER_ABSTIME, &timer, NULL);
+}
+
+static bool_t _drain(_bench_s* const bench, _peer_s* const peer)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+
+	while (true)
+	{
+		common_protocol_chunk_s chunk = {0};
+		const client_connection_status_e status = client_connection_try_receive(&peer->connection, &chunk);
+
+		if (client_connection_status_pending == status)
+		{
+			return true;
+		}
+
+		if ((client_connection_status_failed == status) || !_handle_chunk(bench, peer, &chunk))
+		{
+			return false;
+		}
+	}
+}
+
+static bool_t _handle_chunk(_bench_s* const bench, _peer_s* const peer, const common_protocol_chunk_s* const chunk)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+	common_debug_assert(chunk != NULL);
+
+	const uint32_t stream_id = chunk->header.stream_id;
+
+	if ((0 == stream_id) || (stream_id > bench->config->inflight) || !peer->requests[stream_id - 1].busy)
+	{
+		common_logger_error("the server responded on an unexpected stream %u.", stream_id);
+		return false;
+	}
+
+	_request_s* const request = &peer->requests[stream_id - 1];
+
+	if (common_protocol_frame_error == chunk->header.type)
+	{
+		common_protocol_error_e error = common_protocol_error_invalid;
+		(void)common_protocol_decode_error(chunk->data, chunk->size, &error);
+		++bench->errors[((uint64_t)error < _errors_count) ? error : common_protocol_error_invalid];
+		_complete(bench, peer, request, false);
+		return true;
+	}
+
+	if (chunk->header.type != common_protocol_frame_segment)
+	{
+		common_logger_error("the server responded with an unexpected frame type %u.", chunk->header.type);
+		return false;
+	}
+
+	bench->bytes += chunk->size;
+
+	if (chunk->last && ((chunk->header.flags & common_protocol_flag_end) != 0))
+	{
+		common_histogram_record(&bench->latency, common_timer_now_ns() - request->sent_ns);
+		_complete(bench, peer, request, true);
+	}
+
+	return true;
+}
+
+static void _complete(_bench_s* const bench, _peer_s* const peer, _request_s* const request, const bool_t succeeded)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+	common_debug_assert(request != NULL);
+
+	request->busy = false;
+	peer->idle[peer->idle_count++] = (uint32_t)(request - peer->requests);
+	--peer->inflight;
+	--bench->inflight;
+	bench->completed += succeeded ? 1 : 0;
+}
+
+static void _fail_peer(_bench_s* const bench, _peer_s* const peer)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(peer != NULL);
+
+	if (!peer->open)
+	{
+		return;
+	}
+
+	// note: the requests in flight on a failed connection never finish, and
+	// are counted as lost rather than as errors of the server.
+	(void)epoll_ctl(bench->epoll_fd, EPOLL_CTL_DEL, peer->connection.fd, NULL);
+	client_connection_close(&peer->connection);
+	_record_outstanding(bench, peer, common_timer_now_ns());
+
+	bench->lost     += peer->inflight;
+	bench->inflight -= peer->inflight;
+	peer->inflight   = 0;
+	peer->open       = false;
+
+	--bench->open_count;
+	++bench->failed_connections;
+}
+
+static bool_t _report(const _bench_s* const bench, const uint64_t elapsed_ns)
+{
+	common_debug_assert(bench != NULL);
+
+	static const char_t* const names[] = { "p50", "p90", "p99", "p99.9", "max" };
+	static const double ranks[] = { 50, 90, 99, 99.9, 100 };
+	double percentiles[sizeof(ranks) / sizeof(*ranks)] = {0};
+
+	const double seconds = (double)elapsed_ns / 1e9;
+	uint64_t errors = 0;
+
+	for (uint64_t index = 0; index < _errors_count; ++index)
+	{
+		errors += bench->errors[index];
+	}
+
+	common_logger_info("sent %lu requests over %u connections in %.3f s: %lu succeeded, %lu answered with an error, %lu lost on %lu failed connections and %lu unfinished.", bench->sent,
+		bench->peers_count, seconds, bench->completed, errors, bench->lost, bench->failed_connections, bench->unfinished);
+	common_logger_info("throughput: %.1f requests/sec, %.2f MiB/sec.", (double)bench->completed / seconds, ((double)bench->bytes / (1024.0 * 1024.0)) / seconds);
+	common_logger_info("errors: invalid=%lu, not_found=%lu, unavailable=%lu, out_of_range=%lu.", bench->errors[common_protocol_error_invalid],
+		bench->errors[common_protocol_error_not_found], bench->errors[common_protocol_error_unavailable], bench->errors[common_protocol_error_out_of_range]);
+
+	// note: a schedule that ran far behind means the windows were too small
+	// for the rate, or the server fell behind it, which the latency shows too.
+	if (bench->config->bench.rate > 0)
+	{
+		common_logger_info("schedule: %lu requests/sec with %s arrivals, at most %.3f ms behind, %lu due but never sent.", bench->config->bench.rate,
+			_arrivals_name(bench->config), (double)bench->lag_max_ns / 1e6, bench->unsent);
+	}
+
+	common_logger_log("%-10s %12s", "latency", "ms");
+
+	for (uint64_t index = 0; index < (sizeof(ranks) / sizeof(*ranks)); ++index)
+	{
+		percentiles[index] = _percentile_ms(bench, ranks[index]);
+		common_logger_log("%-10s %12.3f", names[index], percentiles[index]);
+	}
+
+	return (NULL == bench->config->bench.json) || _write_json(bench, elapsed_ns, percentiles);
+}
+
+static bool_t _write_json(const _bench_s* const bench, const uint64_t elapsed_ns, const double* const percentiles)
+{
+	common_debug_assert(bench != NULL);
+	common_debug_assert(percentiles != NULL);
+
+	const char_t* const path = bench->config->bench.json;
+	const bool_t standard = (strcmp(path, "-") == 0);
+	FILE* const file = standard ? stdout : fopen(path, "w");
+
+	if (NULL == file)
+	{
+		common_logger_error("failed to open json report file %s: %s.", path, strerror(errno));
+		return false;
+	}
+
+	const double seconds = (double)elapsed_ns / 1e9;
+
+	(void)fprintf(file,
+		"{\"connections\":%u,\"inflight\":%u,\"rate\":%lu,\"arrivals\":\"%s\",\"schedule_lag_ms\":%.6f,\"seconds\":%.6f,"
+		"\"requests\":{\"sent\":%lu,\"completed\":%lu,\"lost\":%lu,\"unfinished\":%lu,\"unsent\":%lu},"
+		"\"throughput\":{\"requests_per_sec\":%.3f,\"bytes_per_sec\":%.3f},"
+		"\"errors\":{\"invalid\":%lu,\"not_found\":%lu,\"unavailable\":%lu,\"out_of_range\":%lu,\"connections\":%lu},"
+		"\"latency_ms\":{\"p50\":%.6f,\"p90\":%.6f,\"p99\":%.6f,\"p99.9\":%.6f,\"max\":%.6f}}\n",
+		bench->peers_count, bench->config->inflight, bench->config->bench.rate, _arrivals_name(bench->config), (double)bench->lag_max_ns / 1e6, seconds, bench->sent, bench->completed, bench->lost, bench->unfinished, bench->unsent,
+		(double)bench->completed / seconds, (double)bench->bytes / seconds, bench->errors[common_protocol_error_invalid],
+		bench->errors[common_protocol_error_not_found], bench->errors[common_protocol_error_unavailable], bench->errors[common_protocol_error_out_of_range],
+		bench->failed_connections, percentiles[0], percentiles[1], percentiles[2], percentiles[3], percentiles[4]);
+
+	const bool_t failed = (ferror(file) != 0);
+
+	if ((standard ? fflush(file) : fclose(file)) != 0 || failed)
+	{
+		common_logger_error("failed to write json report file %s.", path);
+		return false;
+	}
+
+	return true;
+}
+
+static double _percentile_ms(const _bench_s* const bench, const double percentile)
+{
+	common_debug_assert(bench != NULL);
+	return (double)common_histogram_percentile(&bench->latency, percentile) / 1e6;
+}
+
+static const char_t* _arrivals_name(const client_config_s* const config)
+{
+	common_debug_assert(config != NULL);
+
+	if (0 == config->bench.rate)
+	{
+		return "closed";
+	}
+
+	return config->bench.poisson ? "poisson" : "uniform";
+}
+
+static uint64_t _next_random(_bench_s* const bench)
+{
+	common_debug_assert(bench != NULL);
+
+	bench->seed ^= bench->seed << 13;
+	bench->seed ^= bench->seed >> 7;
+	bench->seed ^= bench->seed << 17;
+	return bench->seed;
+}
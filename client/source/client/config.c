@@ -13,33 +13,101 @@
 #include "common/debug.h"
 #include "common/logger.h"
 
+#include "client/pipeline.h"
+#include "client/reorder.h"
+#include "client/bench.h"
 #include "client/config.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 
-#define address_default_value "127.0.0.1"
-#define port_default_value    "25505"
+#define address_default_value     "127.0.0.1"
+#define port_default_value        "25505"
+#define media_default_value       "0"
+#define segment_default_value     "0"
+#define count_default_value       "1"
+#define inflight_default_value    "8"
+#define connections_default_value "1"
+
+#define bench_count_default_value       "16"
+#define bench_inflight_default_value    "1"
+#define bench_connections_default_value "16"
+#define duration_default_value          "10"
+#define requests_default_value          "0"
+#define rate_default_value              "0"
+#define arrivals_default_value          "uniform"
 
 static const char_t* _g_program = NULL;
+static const char_t* _g_command = NULL;
 
 const char_t _g_usage_banner[] =
-	"usage: %s <command>\n"                                                                                            \
-	"\n"                                                                                                               \
-	"commands:\n"                                                                                                      \
-	"    run <address> <port>                run the server with provided settings and configuration.\n"               \
-	"        required:\n"                                                                                              \
-	"            <address>                   set the server address to connect to. if not provided, defaults to %s.\n" \
-	"            <port>                      set the server port to bind to. if not provided, defaults to %s.\n"       \
-	"        optional:\n"                                                                                              \
-	"            ---\n"                                                                                                \
-	"\n"                                                                                                               \
-	"    help                                print this help message banner.\n"                                        \
-	"\n"                                                                                                               \
-	"    version                             print the version of this executable.\n"                                  \
-	"\n"                                                                                                               \
-	"notice:\n"                                                                                                        \
+	"usage: %s <command>\n"                                                                                                       \
+	"\n"                                                                                                                          \
+	"commands:\n"                                                                                                                 \
+	"    run [options]                       fetch media segments from the server.\n"                                             \
+	"        required:\n"                                                                                                         \
+	"            ---\n"                                                                                                           \
+	"        optional:\n"                                                                                                         \
+	"            -a, --address <ADDRESS>     set the server address to connect to. if not provided, defaults to %s.\n"            \
+	"            -p, --port    <PORT>        set the server port to connect to. if not provided, defaults to %s.\n"               \
+	"            -m, --media <ID>            set the id of the media to fetch. if not provided, defaults to %s.\n"                \
+	"            -s, --segment <INDEX>       set the index of the segment to fetch. if not provided, defaults to %s.\n"           \
+	"            -n, --count <COUNT>         set the number of consecutive segments to fetch from the segment on.\n"              \
+	"                                        0 fetches all of them up to the end of the media. if not provided,\n"                \
+	"                                        defaults to %s.\n"                                                                   \
+	"            -i, --inflight <N>          set the number of segment requests kept in flight on the connection,\n"              \
+	"                                        so that segments are not fetched at one per round trip. if not\n"                    \
+	"                                        provided, defaults to %s.\n"                                                         \
+	"            -c, --connections <N>       set the number of connections the segments are fetched over in parallel,\n"          \
+	"                                        each one fetching every n-th segment, which are put back in order. if not\n"         \
+	"                                        provided, defaults to %s.\n"                                                         \
+	"            -O, --offset <POSITION>     fetch the media from a position to its end rather than a segment. a\n"               \
+	"                                        position is a byte offset into the segments laid end to end, or playback\n"          \
+	"                                        time if suffixed with ms or s, starting at the segment it falls into.\n"             \
+	"            -r, --range <START>-<END>   fetch the media from a position up to another, excluded one rather than a\n"         \
+	"                                        segment. both positions have to be of the same kind.\n"                              \
+	"            -o, --output <PATH>         set the file the media is written to. if not provided, it is discarded.";
+
+// note: the banner is split in two, as iso c only guarantees support for string
+// literals of up to 4095 characters.
+const char_t _g_usage_banner_continued[] =
+	"\n"                                                                                                                          \
+	"    bench [options]                     put load on the server and report its throughput, errors and latency.\n"             \
+	"        required:\n"                                                                                                         \
+	"            ---\n"                                                                                                           \
+	"        optional:\n"                                                                                                         \
+	"            -a, --address <ADDRESS>     set the server address to connect to. if not provided, defaults to %s.\n"            \
+	"            -p, --port    <PORT>        set the server port to connect to. if not provided, defaults to %s.\n"               \
+	"            -m, --media <ID>            set the id of the media to request. if not provided, defaults to %s.\n"              \
+	"            -s, --segment <INDEX>       set the index of the first segment to request. if not provided, defaults to %s.\n"   \
+	"            -n, --count <COUNT>         set the number of segments from the segment on that each segment request\n"          \
+	"                                        picks one of at random. if not provided, defaults to %s.\n"                          \
+	"            -O, --offset <POSITION>     set the position from which range requests fetch the media to its end, as in run.\n" \
+	"            -r, --range <START>-<END>   set the range of the media that range requests fetch, as in run.\n"                  \
+	"            -x, --mix <S>:<R>           set the ratio of segment requests to range requests. if not provided,\n"             \
+	"                                        defaults to 1:1 if a range is set, and to 1:0 otherwise.\n"                          \
+	"            -c, --connections <N>       set the number of connections the load is put on over. if not provided,\n"           \
+	"                                        defaults to %s.\n"                                                                   \
+	"            -i, --inflight <N>          set the number of requests kept in flight on each connection. if not\n"              \
+	"                                        provided, defaults to %s.\n"                                                         \
+	"            -d, --duration <SECONDS>    set how long the load is put on for, 0 for no limit. if not provided,\n"             \
+	"                                        defaults to %s.\n"                                                                   \
+	"            -t, --requests <COUNT>      set the number of requests sent at most, 0 for no limit. if not\n"                   \
+	"                                        provided, defaults to %s.\n"                                                         \
+	"            -R, --rate <RATE>[/s]       send requests on a schedule at a rate per second over all connections,\n"            \
+	"                                        whatever the server does, timing each from when it was meant to go out.\n"           \
+	"                                        0 sends one as soon as another finished. if not provided, defaults to %s.\n"         \
+	"            -A, --arrivals <KIND>       set how scheduled requests are spread out, evenly with uniform, or at random\n"      \
+	"                                        with poisson. if not provided, defaults to %s.\n"                                    \
+	"            -j, --json <PATH>           also write the report as json to a file, or to the standard output for -.\n"         \
+	"\n"                                                                                                                          \
+	"    help                                print this help message banner.\n"                                                   \
+	"\n"                                                                                                                          \
+	"    version                             print the version of this executable.\n"                                             \
+	"\n"                                                                                                                          \
+	"notice:\n"                                                                                                                   \
 	"    this executable is distributed under the \"mediantazy gplv1\" license.\n";
 
 static void _print_usage_banner(void);
@@ -50,8 +118,30 @@ static bool_t _match_cli_option(const char_t* const option, const char_t* const
 
 static const char_t* _get_option_argument(const char_t* const option, int32_t* const argc, const char_t*** const argv);
 
+static const char_t* _parse_position(const char_t* const position_as_string, const char_t* const option_names, uint64_t* const position, bool_t* const timed);
+
+static common_protocol_frame_e _parse_range(const char_t* const offset_as_string, const char_t* const range_as_string, common_protocol_range_s* const range);
+
+static uint32_t _parse_count(const char_t* const count_as_string);
+
+static uint32_t _parse_inflight(const char_t* const inflight_as_string);
+
+static uint32_t _parse_connections(const char_t* const connections_as_string, const uint32_t limit);
+
+static void _parse_mix(const char_t* const mix_as_string, const bool_t ranged, client_config_bench_s* const bench);
+
+static uint64_t _parse_duration(const char_t* const duration_as_string);
+
+static uint64_t _parse_requests(const char_t* const requests_as_string);
+
+static uint64_t _parse_rate(const char_t* const rate_as_string);
+
+static bool_t _parse_arrivals(const char_t* const arrivals_as_string);
+
 static client_config_s _parse_run_command(int32_t* const argc, const char_t*** const argv);
 
+static client_config_s _parse_bench_command(int32_t* const argc, const char_t*** const argv);
+
 client_config_s client_config_from_cli(int32_t* const argc, const char_t*** const argv)
 {
 	common_debug_assert(argc != NULL);
@@ -71,10 +161,16 @@ client_config_s client_config_from_cli(int32_t* const argc, const char_t*** cons
 	const char_t* const command = _shift_cli_args(argc, argv);
 	common_debug_assert(command != NULL);
 
+	_g_command = command;
+
 	if (strcmp(command, "run") == 0)
 	{
 		return _parse_run_command(argc, argv);
 	}
+	else if (strcmp(command, "bench") == 0)
+	{
+		return _parse_bench_command(argc, argv);
+	}
 	else if (strcmp(command, "help") == 0)
 	{
 		_print_usage_banner();
@@ -112,7 +208,9 @@ static void _print_usage_banner(void)
 {
 	common_debug_assert(_g_usage_banner != NULL);
 	common_debug_assert(_g_program != NULL);
-	common_logger_log(_g_usage_banner, _g_program, address_default_value, port_default_value);
+	common_logger_log(_g_usage_banner, _g_program, address_default_value, port_default_value, media_default_value, segment_default_value, count_default_value, inflight_default_value, connections_default_value);
+	common_logger_log(_g_usage_banner_continued, address_default_value, port_default_value, media_default_value, segment_default_value, bench_count_default_value, bench_connections_default_value,
+		bench_inflight_default_value, duration_default_value, requests_default_value, rate_default_value, arrivals_default_value);
 }
 
 static const char_t* _shift_cli_args(int32_t* const argc, const char_t*** const argv)
@@ -166,13 +264,265 @@ static const char_t* _get_option_argument(const char_t* const option, int32_t* c
 	return argument;
 }
 
+static const char_t* _parse_position(const char_t* const position_as_string, const char_t* const option_names, uint64_t* const position, bool_t* const timed)
+{
+	common_debug_assert(position_as_string != NULL);
+	common_debug_assert(option_names != NULL);
+	common_debug_assert(position != NULL);
+	common_debug_assert(timed != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long value = strtoull(position_as_string, &end, 10);
+
+	if ((end == position_as_string) || (errno != 0) || (position_as_string[0] == '-'))
+	{
+		common_logger_error("invalid %s value provided in '%s' command: %s.", option_names, _g_command, position_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	*position = (uint64_t)value;
+	*timed    = false;
+
+	if (strncmp(end, "ms", 2) == 0)
+	{
+		*timed = true;
+		end   += 2;
+	}
+	else if ((end[0] == 's') && (value <= (UINT64_MAX / 1000)))
+	{
+		*position *= 1000;
+		*timed     = true;
+		end       += 1;
+	}
+
+	return end;
+}
+
+static common_protocol_frame_e _parse_range(const char_t* const offset_as_string, const char_t* const range_as_string, common_protocol_range_s* const range)
+{
+	common_debug_assert(range != NULL);
+
+	if (offset_as_string != NULL)
+	{
+		bool_t timed = false;
+
+		if (*_parse_position(offset_as_string, "--offset, -O", &range->start, &timed) != '\0')
+		{
+			common_logger_error("invalid --offset, -O value provided in '%s' command: %s.", _g_command, offset_as_string);
+			_print_usage_banner();
+			exit(1);
+		}
+
+		range->length = 0;
+		return timed ? common_protocol_frame_time_range : common_protocol_frame_byte_range;
+	}
+
+	common_debug_assert(range_as_string != NULL);
+
+	bool_t start_timed = false;
+	bool_t end_timed   = false;
+	uint64_t end       = 0;
+
+	const char_t* const separator = _parse_position(range_as_string, "--range, -r", &range->start, &start_timed);
+
+	if ((separator[0] != '-') || (*_parse_position(separator + 1, "--range, -r", &end, &end_timed) != '\0') ||
+		(start_timed != end_timed) || (end <= range->start))
+	{
+		common_logger_error("invalid --range, -r value provided in '%s' command: %s.", _g_command, range_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	range->length = end - range->start;
+	return start_timed ? common_protocol_frame_time_range : common_protocol_frame_byte_range;
+}
+
+static uint32_t _parse_count(const char_t* const count_as_string)
+{
+	common_debug_assert(count_as_string != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long count = strtoull(count_as_string, &end, 10);
+
+	if ((end == count_as_string) || (*end != '\0') || (errno != 0) || (count_as_string[0] == '-') || (count > UINT32_MAX))
+	{
+		common_logger_error("invalid --count, -n value provided in '%s' command: %s.", _g_command, count_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)count;
+}
+
+static uint32_t _parse_inflight(const char_t* const inflight_as_string)
+{
+	common_debug_assert(inflight_as_string != NULL);
+
+	char_t* end = NULL;
+	const long inflight = strtol(inflight_as_string, &end, 10);
+
+	if ((end == inflight_as_string) || (*end != '\0') || (inflight <= 0) || (inflight > (long)client_pipeline_inflight_limit))
+	{
+		common_logger_error("invalid --inflight, -i value provided in '%s' command: %s, expected 1 to %u.", _g_command, inflight_as_string, client_pipeline_inflight_limit);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)inflight;
+}
+
+static uint32_t _parse_connections(const char_t* const connections_as_string, const uint32_t limit)
+{
+	common_debug_assert(connections_as_string != NULL);
+
+	char_t* end = NULL;
+	const long connections = strtol(connections_as_string, &end, 10);
+
+	if ((end == connections_as_string) || (*end != '\0') || (connections <= 0) || (connections > (long)limit))
+	{
+		common_logger_error("invalid --connections, -c value provided in '%s' command: %s, expected 1 to %u.", _g_command, connections_as_string, limit);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)connections;
+}
+
+static void _parse_mix(const char_t* const mix_as_string, const bool_t ranged, client_config_bench_s* const bench)
+{
+	common_debug_assert(bench != NULL);
+
+	if (NULL == mix_as_string)
+	{
+		bench->segment_weight = 1;
+		bench->range_weight   = ranged ? 1 : 0;
+		return;
+	}
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long segment_weight = strtoull(mix_as_string, &end, 10);
+	unsigned long long range_weight = 0;
+	bool_t valid = (end != mix_as_string) && (':' == *end) && (mix_as_string[0] != '-');
+
+	if (valid)
+	{
+		const char_t* const start = end + 1;
+		range_weight = strtoull(start, &end, 10);
+		valid = (end != start) && ('\0' == *end) && (start[0] != '-');
+	}
+
+	if (!valid || (errno != 0) || (segment_weight > UINT32_MAX) || (range_weight > UINT32_MAX) || ((0 == segment_weight) && (0 == range_weight)))
+	{
+		common_logger_error("invalid --mix, -x value provided in 'bench' command: %s.", mix_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	if ((range_weight > 0) && !ranged)
+	{
+		common_logger_error("--mix, -x argument asks for range requests, but neither --offset, -O nor --range, -r is set in 'bench' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	bench->segment_weight = (uint32_t)segment_weight;
+	bench->range_weight   = (uint32_t)range_weight;
+}
+
+static uint64_t _parse_duration(const char_t* const duration_as_string)
+{
+	common_debug_assert(duration_as_string != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long duration = strtoull(duration_as_string, &end, 10);
+
+	if ((end == duration_as_string) || (*end != '\0') || (errno != 0) || (duration_as_string[0] == '-') || (duration > (UINT64_MAX / 1000)))
+	{
+		common_logger_error("invalid --duration, -d value provided in 'bench' command: %s.", duration_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint64_t)duration * 1000;
+}
+
+static uint64_t _parse_requests(const char_t* const requests_as_string)
+{
+	common_debug_assert(requests_as_string != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long requests = strtoull(requests_as_string, &end, 10);
+
+	if ((end == requests_as_string) || (*end != '\0') || (errno != 0) || (requests_as_string[0] == '-'))
+	{
+		common_logger_error("invalid --requests, -t value provided in 'bench' command: %s.", requests_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint64_t)requests;
+}
+
+static uint64_t _parse_rate(const char_t* const rate_as_string)
+{
+	common_debug_assert(rate_as_string != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long rate = strtoull(rate_as_string, &end, 10);
+
+	// note: the rate is in requests per second, which may be spelled out.
+	if ((end == rate_as_string) || ((*end != '\0') && (strcmp(end, "/s") != 0)) || (errno != 0) || (rate_as_string[0] == '-') ||
+		(rate > client_bench_rate_limit))
+	{
+		common_logger_error("invalid --rate, -R value provided in 'bench' command: %s, expected 0 to %lu requests per second.", rate_as_string, client_bench_rate_limit);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint64_t)rate;
+}
+
+static bool_t _parse_arrivals(const char_t* const arrivals_as_string)
+{
+	common_debug_assert(arrivals_as_string != NULL);
+
+	if (strcmp(arrivals_as_string, "uniform") == 0)
+	{
+		return false;
+	}
+
+	if (strcmp(arrivals_as_string, "poisson") == 0)
+	{
+		return true;
+	}
+
+	common_logger_error("invalid --arrivals, -A value provided in 'bench' command: %s.", arrivals_as_string);
+	_print_usage_banner();
+	exit(1);
+}
+
 static client_config_s _parse_run_command(int32_t* const argc, const char_t*** const argv)
 {
 	common_debug_assert(argc != NULL);
 	common_debug_assert(argv != NULL);
 
-	const char_t* address_as_string = NULL;
-	const char_t* port_as_string    = NULL;
+	const char_t* address_as_string     = NULL;
+	const char_t* port_as_string        = NULL;
+	const char_t* media_as_string       = NULL;
+	const char_t* segment_as_string     = NULL;
+	const char_t* count_as_string       = NULL;
+	const char_t* inflight_as_string    = NULL;
+	const char_t* connections_as_string = NULL;
+	const char_t* offset_as_string      = NULL;
+	const char_t* range_as_string       = NULL;
+	const char_t* output_path           = NULL;
 
 	for (uint64_t index = 0; true; ++index)
 	{
@@ -207,6 +557,102 @@ static client_config_s _parse_run_command(int32_t* const argc, const char_t*** c
 			port_as_string = _get_option_argument(option, argc, argv);
 			common_debug_assert(port_as_string != NULL);
 		}
+		else if (_match_cli_option(option, "--media", "-m"))
+		{
+			if (media_as_string != NULL)
+			{
+				common_logger_error("multiple --media, -m arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			media_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(media_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--segment", "-s"))
+		{
+			if (segment_as_string != NULL)
+			{
+				common_logger_error("multiple --segment, -s arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			segment_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(segment_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--offset", "-O"))
+		{
+			if (offset_as_string != NULL)
+			{
+				common_logger_error("multiple --offset, -O arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			offset_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(offset_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--range", "-r"))
+		{
+			if (range_as_string != NULL)
+			{
+				common_logger_error("multiple --range, -r arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			range_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(range_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--output", "-o"))
+		{
+			if (output_path != NULL)
+			{
+				common_logger_error("multiple --output, -o arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			output_path = _get_option_argument(option, argc, argv);
+			common_debug_assert(output_path != NULL);
+		}
+		else if (_match_cli_option(option, "--count", "-n"))
+		{
+			if (count_as_string != NULL)
+			{
+				common_logger_error("multiple --count, -n arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			count_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(count_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--inflight", "-i"))
+		{
+			if (inflight_as_string != NULL)
+			{
+				common_logger_error("multiple --inflight, -i arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			inflight_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(inflight_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--connections", "-c"))
+		{
+			if (connections_as_string != NULL)
+			{
+				common_logger_error("multiple --connections, -c arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			connections_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(connections_as_string != NULL);
+		}
 		else
 		{
 			common_logger_error("invalid/unrecognized command line argument found in 'run' command: %s.", option);
@@ -215,6 +661,320 @@ static client_config_s _parse_run_command(int32_t* const argc, const char_t*** c
 		}
 	}
 
+	if (((segment_as_string != NULL) + (offset_as_string != NULL) + (range_as_string != NULL)) > 1)
+	{
+		common_logger_error("--segment, -s, --offset, -O and --range, -r arguments are mutually exclusive in 'run' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	if ((count_as_string != NULL) && ((offset_as_string != NULL) || (range_as_string != NULL)))
+	{
+		common_logger_error("--count, -n argument only applies to segments, not to --offset, -O or --range, -r in 'run' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	if ((connections_as_string != NULL) && ((offset_as_string != NULL) || (range_as_string != NULL)))
+	{
+		common_logger_error("--connections, -c argument only applies to segments, not to --offset, -O or --range, -r in 'run' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	if (NULL == address_as_string)
+	{
+		address_as_string = address_default_value;
+	}
+
+	if (NULL == port_as_string)
+	{
+		port_as_string = port_default_value;
+	}
+
+	if (NULL == media_as_string)
+	{
+		media_as_string = media_default_value;
+	}
+
+	if (NULL == segment_as_string)
+	{
+		segment_as_string = segment_default_value;
+	}
+
+	if (NULL == count_as_string)
+	{
+		count_as_string = count_default_value;
+	}
+
+	if (NULL == inflight_as_string)
+	{
+		inflight_as_string = inflight_default_value;
+	}
+
+	if (NULL == connections_as_string)
+	{
+		connections_as_string = connections_default_value;
+	}
+
+	common_protocol_range_s range = {0};
+	common_protocol_frame_e request_type = common_protocol_frame_request;
+
+	if ((offset_as_string != NULL) || (range_as_string != NULL))
+	{
+		request_type = _parse_range(offset_as_string, range_as_string, &range);
+	}
+
+	range.media_id = (const uint64_t)strtoull(media_as_string, NULL, 10);
+
+	return (const client_config_s)
+	{
+		.command      = client_command_run                                                       ,
+		.address      = address_as_string                                                        ,
+		.port         = (const uint16_t)atoi(port_as_string)                                     ,
+		.media_id     = range.media_id                                                           ,
+		.segment      = (const uint32_t)strtoul(segment_as_string, NULL, 10)                     ,
+		.request_type = request_type                                                             ,
+		.range        = range                                                                    ,
+		.output       = output_path                                                              ,
+		.count        = _parse_count(count_as_string)                                            ,
+		.inflight     = _parse_inflight(inflight_as_string)                                      ,
+		.connections  = _parse_connections(connections_as_string, client_reorder_producers_limit),
+	};
+}
+
+static client_config_s _parse_bench_command(int32_t* const argc, const char_t*** const argv)
+{
+	common_debug_assert(argc != NULL);
+	common_debug_assert(argv != NULL);
+
+	const char_t* address_as_string     = NULL;
+	const char_t* port_as_string        = NULL;
+	const char_t* media_as_string       = NULL;
+	const char_t* segment_as_string     = NULL;
+	const char_t* count_as_string       = NULL;
+	const char_t* offset_as_string      = NULL;
+	const char_t* range_as_string       = NULL;
+	const char_t* mix_as_string         = NULL;
+	const char_t* connections_as_string = NULL;
+	const char_t* inflight_as_string    = NULL;
+	const char_t* duration_as_string    = NULL;
+	const char_t* requests_as_string    = NULL;
+	const char_t* rate_as_string        = NULL;
+	const char_t* arrivals_as_string    = NULL;
+	const char_t* json_path             = NULL;
+
+	for (uint64_t index = 0; true; ++index)
+	{
+		const char_t* const option = _shift_cli_args(argc, argv);
+
+		if (NULL == option)
+		{
+			break;
+		}
+
+		if (_match_cli_option(option, "--address", "-a"))
+		{
+			if (address_as_string != NULL)
+			{
+				common_logger_error("multiple --address, -a arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			address_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(address_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--port", "-p"))
+		{
+			if (port_as_string != NULL)
+			{
+				common_logger_error("multiple --port, -p arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			port_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(port_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--media", "-m"))
+		{
+			if (media_as_string != NULL)
+			{
+				common_logger_error("multiple --media, -m arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			media_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(media_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--segment", "-s"))
+		{
+			if (segment_as_string != NULL)
+			{
+				common_logger_error("multiple --segment, -s arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			segment_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(segment_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--count", "-n"))
+		{
+			if (count_as_string != NULL)
+			{
+				common_logger_error("multiple --count, -n arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			count_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(count_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--offset", "-O"))
+		{
+			if (offset_as_string != NULL)
+			{
+				common_logger_error("multiple --offset, -O arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			offset_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(offset_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--range", "-r"))
+		{
+			if (range_as_string != NULL)
+			{
+				common_logger_error("multiple --range, -r arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			range_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(range_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--mix", "-x"))
+		{
+			if (mix_as_string != NULL)
+			{
+				common_logger_error("multiple --mix, -x arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			mix_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(mix_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--connections", "-c"))
+		{
+			if (connections_as_string != NULL)
+			{
+				common_logger_error("multiple --connections, -c arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			connections_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(connections_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--inflight", "-i"))
+		{
+			if (inflight_as_string != NULL)
+			{
+				common_logger_error("multiple --inflight, -i arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			inflight_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(inflight_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--duration", "-d"))
+		{
+			if (duration_as_string != NULL)
+			{
+				common_logger_error("multiple --duration, -d arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			duration_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(duration_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--requests", "-t"))
+		{
+			if (requests_as_string != NULL)
+			{
+				common_logger_error("multiple --requests, -t arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			requests_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(requests_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--rate", "-R"))
+		{
+			if (rate_as_string != NULL)
+			{
+				common_logger_error("multiple --rate, -R arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			rate_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(rate_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--arrivals", "-A"))
+		{
+			if (arrivals_as_string != NULL)
+			{
+				common_logger_error("multiple --arrivals, -A arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			arrivals_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(arrivals_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--json", "-j"))
+		{
+			if (json_path != NULL)
+			{
+				common_logger_error("multiple --json, -j arguments found in the command line arguments in 'bench' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			json_path = _get_option_argument(option, argc, argv);
+			common_debug_assert(json_path != NULL);
+		}
+		else
+		{
+			common_logger_error("invalid/unrecognized command line argument found in 'bench' command: %s.", option);
+			_print_usage_banner();
+			exit(1);
+		}
+	}
+
+	if ((offset_as_string != NULL) && (range_as_string != NULL))
+	{
+		common_logger_error("--offset, -O and --range, -r arguments are mutually exclusive in 'bench' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	if ((arrivals_as_string != NULL) && (NULL == rate_as_string))
+	{
+		common_logger_error("--arrivals, -A argument only applies with a --rate, -R in 'bench' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
 	if (NULL == address_as_string)
 	{
 		address_as_string = address_default_value;
@@ -225,9 +985,102 @@ static client_config_s _parse_run_command(int32_t* const argc, const char_t*** c
 		port_as_string = port_default_value;
 	}
 
+	if (NULL == media_as_string)
+	{
+		media_as_string = media_default_value;
+	}
+
+	if (NULL == segment_as_string)
+	{
+		segment_as_string = segment_default_value;
+	}
+
+	if (NULL == count_as_string)
+	{
+		count_as_string = bench_count_default_value;
+	}
+
+	if (NULL == connections_as_string)
+	{
+		connections_as_string = bench_connections_default_value;
+	}
+
+	if (NULL == inflight_as_string)
+	{
+		inflight_as_string = bench_inflight_default_value;
+	}
+
+	if (NULL == duration_as_string)
+	{
+		duration_as_string = duration_default_value;
+	}
+
+	if (NULL == requests_as_string)
+	{
+		requests_as_string = requests_default_value;
+	}
+
+	if (NULL == rate_as_string)
+	{
+		rate_as_string = rate_default_value;
+	}
+
+	if (NULL == arrivals_as_string)
+	{
+		arrivals_as_string = arrivals_default_value;
+	}
+
+	common_protocol_range_s range = {0};
+	common_protocol_frame_e request_type = common_protocol_frame_request;
+
+	if ((offset_as_string != NULL) || (range_as_string != NULL))
+	{
+		request_type = _parse_range(offset_as_string, range_as_string, &range);
+	}
+
+	range.media_id = (const uint64_t)strtoull(media_as_string, NULL, 10);
+
+	// note: a segment request picks out of the count, so there has to be at
+	// least one segment to pick.
+	const uint32_t count = _parse_count(count_as_string);
+
+	if (0 == count)
+	{
+		common_logger_error("invalid --count, -n value provided in 'bench' command: %s, expected at least 1.", count_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	client_config_bench_s bench =
+	{
+		.duration_ms = _parse_duration(duration_as_string),
+		.requests    = _parse_requests(requests_as_string),
+		.rate        = _parse_rate(rate_as_string),
+		.poisson     = _parse_arrivals(arrivals_as_string),
+		.json        = json_path,
+	};
+
+	_parse_mix(mix_as_string, request_type != common_protocol_frame_request, &bench);
+
+	if ((0 == bench.duration_ms) && (0 == bench.requests))
+	{
+		common_logger_error("either --duration, -d or --requests, -t has to set a limit in 'bench' command.");
+		_print_usage_banner();
+		exit(1);
+	}
+
 	return (const client_config_s)
 	{
-		.address = address_as_string                   ,
-		.port    = (const uint16_t)atoi(port_as_string),
+		.command      = client_command_bench                                                     ,
+		.address      = address_as_string                                                        ,
+		.port         = (const uint16_t)atoi(port_as_string)                                     ,
+		.media_id     = range.media_id                                                           ,
+		.segment      = (const uint32_t)strtoul(segment_as_string, NULL, 10)                     ,
+		.request_type = request_type                                                             ,
+		.range        = range                                                                    ,
+		.count        = count                                                                    ,
+		.inflight     = _parse_inflight(inflight_as_string)                                      ,
+		.connections  = _parse_connections(connections_as_string, client_bench_connections_limit),
+		.bench        = bench                                                                    ,
 	};
 }
@@ -0,0 +1,253 @@
+
+/**
+ * @file connection.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "client/connection.h"
+
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+bool_t client_connection_open(client_connection_s* const connection, const char_t* const address, const uint16_t port)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(address != NULL);
+
+	connection->fd           = -1;
+	connection->nonblocking  = false;
+	connection->pong_owed    = false;
+	connection->input_offset = 0;
+	connection->input_count  = 0;
+	common_protocol_reader_reset(&connection->reader);
+
+	char_t service[8] = {0};
+	(void)snprintf(service, sizeof(service), "%u", port);
+
+	const struct addrinfo hints =
+	{
+		.ai_family   = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+		.ai_flags    = AI_NUMERICHOST | AI_NUMERICSERV,
+	};
+
+	struct addrinfo* resolved = NULL;
+	const int32_t status = getaddrinfo(address, service, &hints, &resolved);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to resolve address %s:%s: %s.", address, service, gai_strerror(status));
+		return false;
+	}
+
+	connection->fd = socket(resolved->ai_family, resolved->ai_socktype | SOCK_CLOEXEC, resolved->ai_protocol);
+
+	if (connection->fd < 0)
+	{
+		common_logger_error("failed to create a socket: %s.", strerror(errno));
+		freeaddrinfo(resolved);
+		return false;
+	}
+
+	if (connect(connection->fd, resolved->ai_addr, resolved->ai_addrlen) < 0)
+	{
+		common_logger_error("failed to connect to %s:%s: %s.", address, service, strerror(errno));
+		freeaddrinfo(resolved);
+		client_connection_close(connection);
+		return false;
+	}
+
+	freeaddrinfo(resolved);
+
+	const int32_t enable = 1;
+	(void)setsockopt(connection->fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+	return true;
+}
+
+void client_connection_close(client_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (connection->fd >= 0)
+	{
+		(void)close(connection->fd);
+		connection->fd = -1;
+	}
+}
+
+bool_t client_connection_set_nonblocking(client_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	const int32_t flags = fcntl(connection->fd, F_GETFL);
+
+	if ((flags < 0) || (fcntl(connection->fd, F_SETFL, flags | O_NONBLOCK) < 0))
+	{
+		common_logger_error("failed to switch the connection to non-blocking mode: %s.", strerror(errno));
+		return false;
+	}
+
+	connection->nonblocking = true;
+	return true;
+}
+
+bool_t client_connection_send(client_connection_s* const connection, const uint8_t* const data, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(data != NULL);
+	common_debug_assert(!connection->nonblocking);
+
+	// note: a blocking socket only comes back short of the whole size when
+	// interrupted, so the send only ever ends with all of it or a failure.
+	uint64_t sent = 0;
+	return client_connection_status_ready == client_connection_try_send(connection, data, size, &sent);
+}
+
+client_connection_status_e client_connection_try_send(client_connection_s* const connection, const uint8_t* const data, const uint64_t size, uint64_t* const sent)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(data != NULL);
+	common_debug_assert(sent != NULL);
+
+	*sent = 0;
+
+	while (*sent < size)
+	{
+		const ssize_t result = send(connection->fd, data + *sent, size - *sent, MSG_NOSIGNAL);
+
+		if (result < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+			{
+				return client_connection_status_pending;
+			}
+
+			common_logger_error("failed to send to the server: %s.", strerror(errno));
+			return client_connection_status_failed;
+		}
+
+		*sent += (uint64_t)result;
+	}
+
+	return client_connection_status_ready;
+}
+
+bool_t client_connection_receive(client_connection_s* const connection, common_protocol_chunk_s* const chunk)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(chunk != NULL);
+
+	// note: a blocking socket never runs dry, so the receive only ever comes
+	// back with a chunk or a failure.
+	return client_connection_status_ready == client_connection_try_receive(connection, chunk);
+}
+
+client_connection_status_e client_connection_try_receive(client_connection_s* const connection, common_protocol_chunk_s* const chunk)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(chunk != NULL);
+
+	while (true)
+	{
+		uint64_t consumed = 0;
+		const common_protocol_status_e status = common_protocol_reader_feed(&connection->reader,
+			connection->input + connection->input_offset, connection->input_count - connection->input_offset, chunk, &consumed);
+
+		connection->input_offset += consumed;
+
+		// note: keepalive pings are never handed out, as they do not belong to
+		// any request. a blocking connection answers them right away, and a
+		// non-blocking one, which may be in the middle of sending a request,
+		// leaves the pong to its owner.
+		if ((common_protocol_status_complete == status) && (common_protocol_frame_ping == chunk->header.type))
+		{
+			uint8_t pong[common_protocol_ping_frame_size];
+			common_protocol_encode_ping(pong, common_protocol_frame_pong);
+
+			if (connection->nonblocking)
+			{
+				connection->pong_owed = true;
+			}
+			else if (!client_connection_send(connection, pong, sizeof(pong)))
+			{
+				return client_connection_status_failed;
+			}
+
+			continue;
+		}
+
+		if ((common_protocol_status_complete == status) && (common_protocol_frame_pong == chunk->header.type))
+		{
+			continue;
+		}
+
+		if (common_protocol_status_complete == status)
+		{
+			return client_connection_status_ready;
+		}
+
+		if (common_protocol_status_invalid == status)
+		{
+			common_logger_error("the server sent an invalid frame.");
+			return client_connection_status_failed;
+		}
+
+		// note: segment payloads are handed out as they arrive, so only a partial
+		// header or control frame is ever carried over to the next read.
+		const uint64_t leftover = connection->input_count - connection->input_offset;
+		(void)memmove(connection->input, connection->input + connection->input_offset, leftover);
+		connection->input_offset = 0;
+		connection->input_count  = leftover;
+
+		const ssize_t result = recv(connection->fd, connection->input + connection->input_count,
+			client_connection_buffer_size - connection->input_count, 0);
+
+		if (result < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+			{
+				return client_connection_status_pending;
+			}
+
+			common_logger_error("failed to receive from the server: %s.", strerror(errno));
+			return client_connection_status_failed;
+		}
+
+		if (0 == result)
+		{
+			common_logger_error("the server closed the connection.");
+			return client_connection_status_failed;
+		}
+
+		connection->input_count += (uint64_t)result;
+	}
+}
@@ -10,18 +10,502 @@
  * @date 2024-07-25
  */
 
+#include "common/debug.h"
 #include "common/logger.h"
+#include "common/protocol.h"
+#include "common/arena.h"
 
+#include "client/connection.h"
+#include "client/pipeline.h"
+#include "client/reorder.h"
+#include "client/bench.h"
 #include "client/config.h"
 #include "client/main.h"
 
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
+
+#define _stream_id ((uint32_t)1)
+
+/**
+ * @brief A connection of a striped fetch, which fetches every n-th segment
+ * from its own offset on and hands them to the reorder buffer whole.
+ */
+typedef struct
+{
+	const client_config_s* config;
+	client_reorder_s* reorder;
+	uint32_t index;
+	uint32_t stripes;
+	uint64_t count;
+	pthread_t thread;
+
+	// note: the segment being received, which passes to the reorder buffer
+	// once complete in exchange for a buffer to receive the next one into.
+	uint8_t* data;
+	uint64_t size;
+	uint64_t capacity;
+	bool_t rejected;
+
+	client_pipeline_stats_s stats;
+	bool_t status;
+} _stripe_s;
+
+static bool_t _fetch_segments(const client_config_s* const config, client_connection_s* const connection, const int32_t output);
+
+static bool_t _fetch_striped(const client_config_s* const config, const uint32_t stripes, const int32_t output);
+
+static void* _stripe_main(void* const argument);
+
+static bool_t _collect(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last);
+
+static bool_t _fetch_range(const client_config_s* const config, client_connection_s* const connection, const int32_t output);
+
+static bool_t _deliver(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last);
+
+static bool_t _write_output(const int32_t output, const uint8_t* const data, const uint64_t size);
+
+static double _elapsed_ms(const struct timespec* const start);
+
+static const char_t* _range_name(const common_protocol_frame_e request_type);
 
 int32_t main(int32_t argc, const char_t** argv)
 {
 	client_config_s config = client_config_from_cli(&argc, &argv);
-	common_logger_info("config=[address=%s, port=%u]", config.address, config.port);
 
-	(void)printf("hello, from client!\n");
-	return 0;
+	if (client_command_bench == config.command)
+	{
+		common_logger_info("config=[address=%s, port=%u, media=%lu, segment=%u, count=%u, mix=%u:%u, connections=%u, inflight=%u, duration=%lu ms, requests=%lu, "
+			"rate=%lu/s, arrivals=%s, range=%s:%lu+%lu]", config.address, config.port, config.media_id, config.segment, config.count, config.bench.segment_weight,
+			config.bench.range_weight, config.connections, config.inflight, config.bench.duration_ms, config.bench.requests, config.bench.rate,
+			config.bench.poisson ? "poisson" : "uniform", _range_name(config.request_type), config.range.start, config.range.length);
+		return client_bench_run(&config) ? 0 : 1;
+	}
+
+	common_logger_info("config=[address=%s, port=%u, media=%lu, segment=%u, count=%u, inflight=%u, connections=%u, range=%s:%lu+%lu]", config.address, config.port,
+		config.media_id, config.segment, config.count, config.inflight, config.connections, _range_name(config.request_type), config.range.start, config.range.length);
+
+	int32_t output = -1;
+
+	if (config.output != NULL)
+	{
+		output = open(config.output, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+		if (output < 0)
+		{
+			common_logger_error("failed to open output file %s: %s.", config.output, strerror(errno));
+			return 1;
+		}
+	}
+
+	// note: there is no point in more connections than segments to fetch.
+	const uint32_t stripes = ((config.count > 0) && (config.count < config.connections)) ? config.count : config.connections;
+	client_connection_s* connection = NULL;
+	bool_t status = false;
+
+	if ((common_protocol_frame_request == config.request_type) && (stripes > 1))
+	{
+		status = _fetch_striped(&config, stripes, output);
+	}
+	else if (NULL == (connection = malloc(sizeof(*connection))))
+	{
+		common_logger_error("failed to allocate the connection.");
+	}
+	else if (client_connection_open(connection, config.address, config.port))
+	{
+		status = (common_protocol_frame_request == config.request_type) ? _fetch_segments(&config, connection, output) :
+			_fetch_range(&config, connection, output);
+		client_connection_close(connection);
+	}
+
+	free(connection);
+
+	if (output >= 0)
+	{
+		(void)close(output);
+	}
+
+	common_arena_release_cache();
+	return status ? 0 : 1;
+}
+
+static bool_t _fetch_segments(const client_config_s* const config, client_connection_s* const connection, const int32_t output)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(connection != NULL);
+
+	struct timespec start = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &start);
+
+	client_pipeline_s pipeline = {0};
+	int32_t sink = output;
+
+	if (!client_pipeline_create(&pipeline, connection, config->media_id, config->segment, 1, config->count, config->inflight, _deliver, &sink))
+	{
+		return false;
+	}
+
+	const bool_t status = client_pipeline_run(&pipeline);
+	const client_pipeline_stats_s stats = pipeline.stats;
+	client_pipeline_destroy(&pipeline);
+
+	if (!status)
+	{
+		return false;
+	}
+
+	if (0 == stats.segments)
+	{
+		common_logger_error("the server failed to serve media %lu segment %u: %s.", config->media_id, config->segment,
+			common_protocol_error_to_string(common_protocol_error_not_found));
+		return false;
+	}
+
+	if (1 == config->count)
+	{
+		common_logger_info("received media %lu segment %u: %lu bytes in %.3f ms.", config->media_id, config->segment, stats.bytes, _elapsed_ms(&start));
+	}
+	else
+	{
+		common_logger_info("received media %lu segments %u-%lu: %lu bytes in %.3f ms, with %u requests in flight and %lu bytes held out of order.", config->media_id,
+			config->segment, (uint64_t)config->segment + stats.segments - 1, stats.bytes, _elapsed_ms(&start), config->inflight, stats.buffered);
+	}
+
+	return true;
+}
+
+static bool_t _fetch_striped(const client_config_s* const config, const uint32_t stripes, const int32_t output)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(stripes > 1);
+
+	struct timespec start = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &start);
+
+	// note: the buffer holds as many segments as there are requests in flight
+	// over all connections, so that it only holds a connection up once it
+	// runs that far ahead of the slowest one.
+	client_reorder_s reorder = {0};
+	const uint64_t end = (config->count > 0) ? ((uint64_t)config->segment + config->count) : UINT64_MAX;
+
+	if (!client_reorder_create(&reorder, config->segment, end, stripes * config->inflight, stripes))
+	{
+		return false;
+	}
+
+	_stripe_s* const stripe = calloc(stripes, sizeof(*stripe));
+	uint32_t spawned = 0;
+
+	if (NULL == stripe)
+	{
+		common_logger_error("failed to allocate %u connections.", stripes);
+		client_reorder_destroy(&reorder);
+		return false;
+	}
+
+	for (; spawned < stripes; ++spawned)
+	{
+		stripe[spawned] = (const _stripe_s)
+		{
+			.config  = config,
+			.reorder = &reorder,
+			.index   = spawned,
+			.stripes = stripes,
+			.count   = (config->count > 0) ? ((config->count - spawned + stripes - 1) / stripes) : 0,
+		};
+
+		const int32_t status = pthread_create(&stripe[spawned].thread, NULL, _stripe_main, &stripe[spawned]);
+
+		if (status != 0)
+		{
+			common_logger_error("failed to spawn connection %u: %s.", spawned, strerror(status));
+			client_reorder_abort(&reorder);
+			break;
+		}
+
+		char_t name[16] = {0};
+		(void)snprintf(name, sizeof(name), "mediantazy/%u", spawned % client_reorder_producers_limit);
+		(void)pthread_setname_np(stripe[spawned].thread, name);
+	}
+
+	uint64_t bytes = 0;
+	uint8_t* data = NULL;
+	uint64_t size = 0;
+
+	while (client_reorder_take(&reorder, &data, &size))
+	{
+		if (!_write_output(output, data, size))
+		{
+			client_reorder_abort(&reorder);
+			break;
+		}
+
+		bytes += size;
+	}
+
+	bool_t status = (stripes == spawned);
+
+	for (uint32_t index = 0; index < spawned; ++index)
+	{
+		(void)pthread_join(stripe[index].thread, NULL);
+		status = status && stripe[index].status;
+	}
+
+	status = status && !client_reorder_has_failed(&reorder);
+	const client_reorder_stats_s stats = reorder.stats;
+	free(stripe);
+	client_reorder_destroy(&reorder);
+
+	if (!status)
+	{
+		return false;
+	}
+
+	if (0 == stats.segments)
+	{
+		common_logger_error("the server failed to serve media %lu segment %u: %s.", config->media_id, config->segment,
+			common_protocol_error_to_string(common_protocol_error_not_found));
+		return false;
+	}
+
+	common_logger_info("received media %lu segments %u-%lu: %lu bytes in %.3f ms, over %u connections with %u requests in flight each, %lu segments held out of order at "
+		"most and %lu hold-ups of a connection running ahead.", config->media_id, config->segment, (uint64_t)config->segment + stats.segments - 1, bytes,
+		_elapsed_ms(&start), stripes, config->inflight, stats.peak, stats.stalls);
+	return true;
+}
+
+static void* _stripe_main(void* const argument)
+{
+	_stripe_s* const stripe = (_stripe_s*)argument;
+	common_debug_assert(stripe != NULL);
+
+	const client_config_s* const config = stripe->config;
+	client_connection_s* const connection = malloc(sizeof(*connection));
+	bool_t status = false;
+
+	if (NULL == connection)
+	{
+		common_logger_error("failed to allocate connection %u.", stripe->index);
+	}
+	else if (client_connection_open(connection, config->address, config->port))
+	{
+		client_pipeline_s pipeline = {0};
+
+		if (client_pipeline_create(&pipeline, connection, config->media_id, config->segment + stripe->index, stripe->stripes, stripe->count, config->inflight,
+			_collect, stripe))
+		{
+			status = client_pipeline_run(&pipeline);
+			stripe->stats = pipeline.stats;
+
+			if (status && pipeline.ended)
+			{
+				client_reorder_end(stripe->reorder, pipeline.end_chunk);
+			}
+
+			client_pipeline_destroy(&pipeline);
+		}
+
+		client_connection_close(connection);
+	}
+
+	free(connection);
+	free(stripe->data);
+	stripe->data = NULL;
+	common_arena_release_cache();
+
+	// note: a segment turned away by the reorder buffer lies past the end of
+	// the media another connection found, which ends this one just as well,
+	// unless it was turned away because the fetch failed.
+	stripe->status = status || (stripe->rejected && !client_reorder_has_failed(stripe->reorder));
+	client_reorder_finish(stripe->reorder, stripe->status);
+	return NULL;
+}
+
+static bool_t _collect(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last)
+{
+	_stripe_s* const stripe = (_stripe_s*)argument;
+	common_debug_assert(stripe != NULL);
+	common_debug_assert((data != NULL) || (0 == size));
+
+	if ((stripe->size + size) > stripe->capacity)
+	{
+		uint64_t capacity = (stripe->capacity > 0) ? stripe->capacity : client_connection_buffer_size;
+
+		while ((stripe->size + size) > capacity)
+		{
+			capacity *= 2;
+		}
+
+		uint8_t* const grown = realloc(stripe->data, capacity);
+
+		if (NULL == grown)
+		{
+			common_logger_error("failed to buffer %lu bytes of segment %u.", stripe->size + size, chunk);
+			return false;
+		}
+
+		stripe->data     = grown;
+		stripe->capacity = capacity;
+	}
+
+	if (size > 0)
+	{
+		(void)memcpy(stripe->data + stripe->size, data, size);
+		stripe->size += size;
+	}
+
+	if (!last)
+	{
+		return true;
+	}
+
+	// note: the buffer passes to the reorder buffer along with the segment,
+	// and the next segment is received into one the writer is done with.
+	const uint64_t segment_size = stripe->size;
+	stripe->size = 0;
+
+	if (!client_reorder_put(stripe->reorder, chunk, &stripe->data, &stripe->capacity, segment_size))
+	{
+		stripe->rejected = true;
+		return false;
+	}
+
+	return true;
+}
+
+static bool_t _fetch_range(const client_config_s* const config, client_connection_s* const connection, const int32_t output)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(connection != NULL);
+	common_debug_assert(config->request_type != common_protocol_frame_request);
+
+	struct timespec start = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &start);
+
+	// note: a range is answered with a segment frame per segment it covers,
+	// all on the stream of the request and the last one flagged as the end.
+	uint8_t encoded[common_protocol_range_frame_size];
+	common_protocol_encode_range(encoded, _stream_id, config->request_type, &config->range);
+
+	if (!client_connection_send(connection, encoded, sizeof(encoded)))
+	{
+		return false;
+	}
+
+	uint64_t received = 0;
+	uint64_t segments = 0;
+
+	while (true)
+	{
+		common_protocol_chunk_s chunk = {0};
+
+		if (!client_connection_receive(connection, &chunk))
+		{
+			return false;
+		}
+
+		if (chunk.header.stream_id != _stream_id)
+		{
+			common_logger_error("the server responded on an unexpected stream %u.", chunk.header.stream_id);
+			return false;
+		}
+
+		if (common_protocol_frame_error == chunk.header.type)
+		{
+			common_protocol_error_e error = common_protocol_error_invalid;
+			(void)common_protocol_decode_error(chunk.data, chunk.size, &error);
+			common_logger_error("the server failed to serve media %lu %s range %lu+%lu: %s.", config->media_id,
+				_range_name(config->request_type), config->range.start, config->range.length, common_protocol_error_to_string(error));
+			return false;
+		}
+
+		if (chunk.header.type != common_protocol_frame_segment)
+		{
+			common_logger_error("the server responded with an unexpected frame type %u.", chunk.header.type);
+			return false;
+		}
+
+		if (!_write_output(output, chunk.data, chunk.size))
+		{
+			return false;
+		}
+
+		received += chunk.size;
+		segments += chunk.last ? 1 : 0;
+
+		if (chunk.last && ((chunk.header.flags & common_protocol_flag_end) != 0))
+		{
+			break;
+		}
+	}
+
+	common_logger_info("received media %lu %s range %lu+%lu: %lu bytes over %lu segments in %.3f ms.", config->media_id,
+		_range_name(config->request_type), config->range.start, config->range.length, received, segments, _elapsed_ms(&start));
+	return true;
+}
+
+static bool_t _deliver(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last)
+{
+	common_debug_assert(argument != NULL);
+	(void)chunk;
+	(void)last;
+	return _write_output(*(const int32_t*)argument, data, size);
+}
+
+static bool_t _write_output(const int32_t output, const uint8_t* const data, const uint64_t size)
+{
+	common_debug_assert((data != NULL) || (0 == size));
+
+	if (output < 0)
+	{
+		return true;
+	}
+
+	uint64_t written = 0;
+
+	while (written < size)
+	{
+		const ssize_t result = write(output, data + written, size - written);
+
+		if (result < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			common_logger_error("failed to write the output: %s.", strerror(errno));
+			return false;
+		}
+
+		written += (uint64_t)result;
+	}
+
+	return true;
+}
+
+static double _elapsed_ms(const struct timespec* const start)
+{
+	common_debug_assert(start != NULL);
+
+	struct timespec now = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)(now.tv_sec - start->tv_sec) * 1000.0) + ((double)(now.tv_nsec - start->tv_nsec) / 1000000.0);
+}
+
+static const char_t* _range_name(const common_protocol_frame_e request_type)
+{
+	switch (request_type)
+	{
+		case common_protocol_frame_byte_range: { return "byte"; }
+		case common_protocol_frame_time_range: { return "time"; }
+		default:                               { return "none"; }
+	}
 }
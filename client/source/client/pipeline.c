@@ -0,0 +1,355 @@
+
+/**
+ * @file pipeline.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/protocol.h"
+
+#include "client/pipeline.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct client_pipeline_piece_s
+{
+	client_pipeline_piece_s* next;
+	uint64_t size;
+	uint8_t data[];
+};
+
+// note: small enough for four pieces to fit a chunk of the arena, so that
+// holding a segment back never takes a chunk of its own from malloc.
+#define _piece_capacity ((common_arena_chunk_size / 4) - 64)
+
+static bool_t _send_requests(client_pipeline_s* const pipeline);
+
+static client_pipeline_request_s* _match(client_pipeline_s* const pipeline, const uint32_t stream_id);
+
+static bool_t _handle_chunk(client_pipeline_s* const pipeline, client_pipeline_request_s* const request, const common_protocol_chunk_s* const chunk);
+
+static bool_t _buffer(client_pipeline_request_s* const request, const uint8_t* const data, const uint64_t size);
+
+static bool_t _advance(client_pipeline_s* const pipeline);
+
+static bool_t _deliver_held(client_pipeline_s* const pipeline, client_pipeline_request_s* const request);
+
+bool_t client_pipeline_create(client_pipeline_s* const pipeline, client_connection_s* const connection, const uint64_t media_id, const uint32_t first, const uint32_t stride,
+	const uint64_t count, const uint32_t inflight, bool_t (*deliver)(void* const argument, const uint32_t chunk, const uint8_t* const data, const uint64_t size, const bool_t last), void* const argument)
+{
+	common_debug_assert(pipeline != NULL);
+	common_debug_assert(connection != NULL);
+	common_debug_assert(stride > 0);
+	common_debug_assert((inflight > 0) && (inflight <= client_pipeline_inflight_limit));
+	common_debug_assert(deliver != NULL);
+
+	*pipeline = (const client_pipeline_s)
+	{
+		.connection     = connection,
+		.media_id       = media_id,
+		.next_chunk     = first,
+		.stride         = stride,
+		.unsent         = (count > 0) ? count : UINT64_MAX,
+		.open_ended     = (0 == count),
+		.deliver        = deliver,
+		.argument       = argument,
+		.capacity       = inflight,
+		.next_stream_id = 1,
+	};
+
+	pipeline->requests = calloc(inflight, sizeof(*pipeline->requests));
+	pipeline->outgoing = malloc(inflight * common_protocol_request_frame_size);
+
+	if ((NULL == pipeline->requests) || (NULL == pipeline->outgoing))
+	{
+		common_logger_error("failed to allocate a pipeline of %u requests.", inflight);
+		client_pipeline_destroy(pipeline);
+		return false;
+	}
+
+	for (uint32_t index = 0; index < inflight; ++index)
+	{
+		common_arena_create(&pipeline->requests[index].arena);
+	}
+
+	return true;
+}
+
+void client_pipeline_destroy(client_pipeline_s* const pipeline)
+{
+	common_debug_assert(pipeline != NULL);
+
+	if (pipeline->requests != NULL)
+	{
+		for (uint32_t index = 0; index < pipeline->capacity; ++index)
+		{
+			common_arena_destroy(&pipeline->requests[index].arena);
+		}
+	}
+
+	free(pipeline->requests);
+	free(pipeline->outgoing);
+	pipeline->requests = NULL;
+	pipeline->outgoing = NULL;
+}
+
+bool_t client_pipeline_run(client_pipeline_s* const pipeline)
+{
+	common_debug_assert(pipeline != NULL);
+
+	while (true)
+	{
+		if (!_send_requests(pipeline))
+		{
+			return false;
+		}
+
+		if (0 == pipeline->count)
+		{
+			return true;
+		}
+
+		common_protocol_chunk_s chunk = {0};
+
+		if (!client_connection_receive(pipeline->connection, &chunk))
+		{
+			return false;
+		}
+
+		client_pipeline_request_s* const request = _match(pipeline, chunk.header.stream_id);
+
+		if (NULL == request)
+		{
+			common_logger_error("the server responded on an unexpected stream %u.", chunk.header.stream_id);
+			return false;
+		}
+
+		if (!_handle_chunk(pipeline, request, &chunk) || !_advance(pipeline))
+		{
+			return false;
+		}
+
+		// note: past the end of the media there is nothing left to deliver,
+		// so the responses still in flight are not waited for.
+		if (pipeline->ended && (pipeline->count > 0) && pipeline->requests[pipeline->head].missing)
+		{
+			pipeline->end_chunk = pipeline->requests[pipeline->head].chunk;
+			return true;
+		}
+	}
+}
+
+static bool_t _send_requests(client_pipeline_s* const pipeline)
+{
+	common_debug_assert(pipeline != NULL);
+
+	uint64_t size = 0;
+
+	// note: the requests that fill up the window go out in a single send.
+	while (!pipeline->ended && (pipeline->unsent > 0) && (pipeline->count < pipeline->capacity))
+	{
+		client_pipeline_request_s* const request = &pipeline->requests[(pipeline->head + pipeline->count) % pipeline->capacity];
+		request->stream_id = pipeline->next_stream_id++;
+		request->chunk     = pipeline->next_chunk;
+		request->complete  = false;
+		request->missing   = false;
+		request->first     = NULL;
+		request->last      = NULL;
+		request->size      = 0;
+
+		const common_protocol_request_s encoded =
+		{
+			.media_id = pipeline->media_id,
+			.chunk    = request->chunk,
+		};
+
+		common_protocol_encode_request(pipeline->outgoing + size, request->stream_id, &encoded);
+		size += common_protocol_request_frame_size;
+		pipeline->next_chunk += pipeline->stride;
+		++pipeline->count;
+
+		if (!pipeline->open_ended)
+		{
+			--pipeline->unsent;
+		}
+	}
+
+	return (0 == size) || client_connection_send(pipeline->connection, pipeline->outgoing, size);
+}
+
+static client_pipeline_request_s* _match(client_pipeline_s* const pipeline, const uint32_t stream_id)
+{
+	common_debug_assert(pipeline != NULL);
+
+	if ((0 == stream_id) || (0 == pipeline->count))
+	{
+		return NULL;
+	}
+
+	client_pipeline_request_s* const request = &pipeline->requests[(stream_id - 1) % pipeline->capacity];
+	const uint32_t oldest = pipeline->requests[pipeline->head].stream_id;
+
+	if ((request->stream_id != stream_id) || ((stream_id - oldest) >= pipeline->count) || request->complete)
+	{
+		return NULL;
+	}
+
+	return request;
+}
+
+static bool_t _handle_chunk(client_pipeline_s* const pipeline, client_pipeline_request_s* const request, const common_protocol_chunk_s* const chunk)
+{
+	common_debug_assert(pipeline != NULL);
+	common_debug_assert(request != NULL);
+	common_debug_assert(chunk != NULL);
+
+	if (common_protocol_frame_error == chunk->header.type)
+	{
+		common_protocol_error_e error = common_protocol_error_invalid;
+		(void)common_protocol_decode_error(chunk->data, chunk->size, &error);
+
+		// note: a media of unknown length is fetched until its first segment
+		// that is not found, and it is up to the caller whether it is fine to
+		// find none at all.
+		if (pipeline->open_ended && (common_protocol_error_not_found == error))
+		{
+			request->complete = true;
+			request->missing  = true;
+			pipeline->ended   = true;
+			return true;
+		}
+
+		common_logger_error("the server failed to serve media %lu segment %u: %s.", pipeline->media_id, request->chunk,
+			common_protocol_error_to_string(error));
+		return false;
+	}
+
+	if (chunk->header.type != common_protocol_frame_segment)
+	{
+		common_logger_error("the server responded with an unexpected frame type %u.", chunk->header.type);
+		return false;
+	}
+
+	const bool_t last = chunk->last && ((chunk->header.flags & common_protocol_flag_end) != 0);
+	pipeline->stats.bytes += chunk->size;
+
+	// note: the oldest request streams straight through, while any later one
+	// is held until every request before it is delivered.
+	if (request == &pipeline->requests[pipeline->head])
+	{
+		if (!pipeline->deliver(pipeline->argument, request->chunk, chunk->data, chunk->size, last))
+		{
+			return false;
+		}
+	}
+	else if (!_buffer(request, chunk->data, chunk->size))
+	{
+		return false;
+	}
+	else
+	{
+		pipeline->stats.buffered += chunk->size;
+	}
+
+	request->complete = last;
+	return true;
+}
+
+static bool_t _buffer(client_pipeline_request_s* const request, const uint8_t* const data, const uint64_t size)
+{
+	common_debug_assert(request != NULL);
+	common_debug_assert((data != NULL) || (0 == size));
+
+	for (uint64_t offset = 0; offset < size;)
+	{
+		const uint64_t length = ((size - offset) < _piece_capacity) ? (size - offset) : _piece_capacity;
+		client_pipeline_piece_s* const piece = common_arena_alloc(&request->arena, sizeof(client_pipeline_piece_s) + length);
+
+		if (NULL == piece)
+		{
+			common_logger_error("failed to buffer %lu bytes of segment %u.", request->size + size - offset, request->chunk);
+			return false;
+		}
+
+		piece->next = NULL;
+		piece->size = length;
+		(void)memcpy(piece->data, data + offset, length);
+
+		if (NULL == request->last)
+		{
+			request->first = piece;
+		}
+		else
+		{
+			request->last->next = piece;
+		}
+
+		request->last  = piece;
+		request->size += length;
+		offset        += length;
+	}
+
+	return true;
+}
+
+static bool_t _advance(client_pipeline_s* const pipeline)
+{
+	common_debug_assert(pipeline != NULL);
+
+	while ((pipeline->count > 0) && pipeline->requests[pipeline->head].complete && !pipeline->requests[pipeline->head].missing)
+	{
+		++pipeline->stats.segments;
+		pipeline->head = (pipeline->head + 1) % pipeline->capacity;
+		--pipeline->count;
+
+		if (0 == pipeline->count)
+		{
+			break;
+		}
+
+		// note: what the new oldest request holds already is delivered at
+		// once, and the rest of it streams straight through from now on.
+		client_pipeline_request_s* const request = &pipeline->requests[pipeline->head];
+
+		if (((request->size > 0) || request->complete) && !request->missing && !_deliver_held(pipeline, request))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool_t _deliver_held(client_pipeline_s* const pipeline, client_pipeline_request_s* const request)
+{
+	common_debug_assert(pipeline != NULL);
+	common_debug_assert(request != NULL);
+
+	bool_t status = true;
+
+	if (NULL == request->first)
+	{
+		status = pipeline->deliver(pipeline->argument, request->chunk, NULL, 0, request->complete);
+	}
+
+	for (const client_pipeline_piece_s* piece = request->first; status && (piece != NULL); piece = piece->next)
+	{
+		status = pipeline->deliver(pipeline->argument, request->chunk, piece->data, piece->size, request->complete && (NULL == piece->next));
+	}
+
+	request->first = NULL;
+	request->last  = NULL;
+	request->size  = 0;
+	common_arena_reset(&request->arena);
+	return status;
+}
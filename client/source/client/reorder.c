@@ -0,0 +1,265 @@
+
+/**
+ * @file reorder.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "client/reorder.h"
+
+#include <stdlib.h>
+
+static client_reorder_slot_s* _slot_of(client_reorder_s* const reorder, const uint64_t chunk);
+
+static void _give_back(client_reorder_s* const reorder, client_reorder_slot_s* const slot);
+
+bool_t client_reorder_create(client_reorder_s* const reorder, const uint64_t first, const uint64_t end, const uint32_t capacity, const uint32_t producers)
+{
+	common_debug_assert(reorder != NULL);
+	common_debug_assert(capacity > 0);
+	common_debug_assert(producers > 0);
+
+	*reorder = (const client_reorder_s)
+	{
+		.capacity  = capacity,
+		.next      = first,
+		.end       = end,
+		.producers = producers,
+	};
+
+	reorder->slots  = calloc(capacity, sizeof(*reorder->slots));
+	reorder->spares = calloc(capacity, sizeof(*reorder->spares));
+
+	if ((NULL == reorder->slots) || (NULL == reorder->spares))
+	{
+		free(reorder->slots);
+		free(reorder->spares);
+		reorder->slots  = NULL;
+		reorder->spares = NULL;
+		common_logger_error("failed to allocate a reorder buffer of %u segments.", capacity);
+		return false;
+	}
+
+	(void)pthread_mutex_init(&reorder->lock, NULL);
+	(void)pthread_cond_init(&reorder->readable, NULL);
+	(void)pthread_cond_init(&reorder->writable, NULL);
+	return true;
+}
+
+void client_reorder_destroy(client_reorder_s* const reorder)
+{
+	common_debug_assert(reorder != NULL);
+
+	for (uint32_t index = 0; index < reorder->capacity; ++index)
+	{
+		free(reorder->slots[index].data);
+	}
+
+	for (uint32_t index = 0; index < reorder->spare_count; ++index)
+	{
+		free(reorder->spares[index].data);
+	}
+
+	free(reorder->taken.data);
+	free(reorder->slots);
+	free(reorder->spares);
+	reorder->slots  = NULL;
+	reorder->spares = NULL;
+
+	(void)pthread_cond_destroy(&reorder->writable);
+	(void)pthread_cond_destroy(&reorder->readable);
+	(void)pthread_mutex_destroy(&reorder->lock);
+}
+
+bool_t client_reorder_put(client_reorder_s* const reorder, const uint64_t chunk, uint8_t** const data, uint64_t* const capacity, const uint64_t size)
+{
+	common_debug_assert(reorder != NULL);
+	common_debug_assert(data != NULL);
+	common_debug_assert(capacity != NULL);
+
+	(void)pthread_mutex_lock(&reorder->lock);
+	common_debug_assert(chunk >= reorder->next);
+
+	bool_t stalled = false;
+
+	while (!reorder->failed && (chunk < reorder->end) && (chunk >= (reorder->next + reorder->capacity)))
+	{
+		stalled = true;
+		(void)pthread_cond_wait(&reorder->writable, &reorder->lock);
+	}
+
+	if (reorder->failed || (chunk >= reorder->end))
+	{
+		(void)pthread_mutex_unlock(&reorder->lock);
+		free(*data);
+		*data     = NULL;
+		*capacity = 0;
+		return false;
+	}
+
+	client_reorder_slot_s* const slot = _slot_of(reorder, chunk);
+	common_debug_assert(!slot->present);
+
+	slot->data     = *data;
+	slot->size     = size;
+	slot->capacity = *capacity;
+	slot->present  = true;
+
+	*data     = NULL;
+	*capacity = 0;
+
+	if (reorder->spare_count > 0)
+	{
+		const client_reorder_slot_s* const spare = &reorder->spares[--reorder->spare_count];
+		*data     = spare->data;
+		*capacity = spare->capacity;
+	}
+
+	++reorder->held;
+	reorder->stats.peak    = (reorder->held > reorder->stats.peak) ? reorder->held : reorder->stats.peak;
+	reorder->stats.stalls += stalled ? 1 : 0;
+
+	if (chunk == reorder->next)
+	{
+		(void)pthread_cond_signal(&reorder->readable);
+	}
+
+	(void)pthread_mutex_unlock(&reorder->lock);
+	return true;
+}
+
+void client_reorder_end(client_reorder_s* const reorder, const uint64_t end)
+{
+	common_debug_assert(reorder != NULL);
+
+	(void)pthread_mutex_lock(&reorder->lock);
+
+	if (end < reorder->end)
+	{
+		reorder->end = end;
+		(void)pthread_cond_broadcast(&reorder->writable);
+		(void)pthread_cond_signal(&reorder->readable);
+	}
+
+	(void)pthread_mutex_unlock(&reorder->lock);
+}
+
+void client_reorder_finish(client_reorder_s* const reorder, const bool_t status)
+{
+	common_debug_assert(reorder != NULL);
+
+	(void)pthread_mutex_lock(&reorder->lock);
+	common_debug_assert(reorder->producers > 0);
+
+	--reorder->producers;
+
+	if (!status)
+	{
+		reorder->failed = true;
+		(void)pthread_cond_broadcast(&reorder->writable);
+	}
+
+	(void)pthread_cond_signal(&reorder->readable);
+	(void)pthread_mutex_unlock(&reorder->lock);
+}
+
+void client_reorder_abort(client_reorder_s* const reorder)
+{
+	common_debug_assert(reorder != NULL);
+
+	(void)pthread_mutex_lock(&reorder->lock);
+	reorder->failed = true;
+	(void)pthread_cond_broadcast(&reorder->writable);
+	(void)pthread_cond_signal(&reorder->readable);
+	(void)pthread_mutex_unlock(&reorder->lock);
+}
+
+bool_t client_reorder_take(client_reorder_s* const reorder, uint8_t** const data, uint64_t* const size)
+{
+	common_debug_assert(reorder != NULL);
+	common_debug_assert(data != NULL);
+	common_debug_assert(size != NULL);
+
+	(void)pthread_mutex_lock(&reorder->lock);
+	client_reorder_slot_s* const slot = _slot_of(reorder, reorder->next);
+	_give_back(reorder, &reorder->taken);
+
+	// note: once every producer is done, a segment that is not in yet never
+	// arrives anymore, which marks the end just as well.
+	while (!reorder->failed && (reorder->next < reorder->end) && !slot->present && (reorder->producers > 0))
+	{
+		(void)pthread_cond_wait(&reorder->readable, &reorder->lock);
+	}
+
+	if (reorder->failed || (reorder->next >= reorder->end) || !slot->present)
+	{
+		(void)pthread_mutex_unlock(&reorder->lock);
+		return false;
+	}
+
+	*data = slot->data;
+	*size = slot->size;
+
+	reorder->taken = *slot;
+	*slot = (const client_reorder_slot_s) {0};
+
+	++reorder->next;
+	--reorder->held;
+	++reorder->stats.segments;
+
+	(void)pthread_cond_broadcast(&reorder->writable);
+	(void)pthread_mutex_unlock(&reorder->lock);
+	return true;
+}
+
+bool_t client_reorder_has_failed(client_reorder_s* const reorder)
+{
+	common_debug_assert(reorder != NULL);
+
+	(void)pthread_mutex_lock(&reorder->lock);
+	const bool_t failed = reorder->failed;
+	(void)pthread_mutex_unlock(&reorder->lock);
+	return failed;
+}
+
+static client_reorder_slot_s* _slot_of(client_reorder_s* const reorder, const uint64_t chunk)
+{
+	common_debug_assert(reorder != NULL);
+	return &reorder->slots[chunk % reorder->capacity];
+}
+
+static void _give_back(client_reorder_s* const reorder, client_reorder_slot_s* const slot)
+{
+	common_debug_assert(reorder != NULL);
+	common_debug_assert(slot != NULL);
+
+	if (NULL == slot->data)
+	{
+		return;
+	}
+
+	// note: there are never more payloads around than segments the buffer
+	// holds plus one per producer, so the spares rarely overflow.
+	if (reorder->spare_count < reorder->capacity)
+	{
+		reorder->spares[reorder->spare_count++] = (const client_reorder_slot_s)
+		{
+			.data     = slot->data,
+			.capacity = slot->capacity,
+		};
+	}
+	else
+	{
+		free(slot->data);
+	}
+
+	*slot = (const client_reorder_slot_s) {0};
+}
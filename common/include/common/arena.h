@@ -0,0 +1,82 @@
+
+/**
+ * @file arena.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__arena_h__
+#define __common__include__common__arena_h__
+
+#include "common/types.h"
+
+#define common_arena_chunk_size   ((uint64_t)16384)
+#define common_arena_cache_limit  ((uint64_t)64)
+
+typedef struct common_arena_chunk_s common_arena_chunk_s;
+
+/**
+ * @brief Bump allocator for transient objects that share a lifetime, e.g.
+ * everything allocated while serving a request.
+ * 
+ * @note Memory comes in fixed-size chunks taken from a free list kept by the
+ * calling thread, and goes back to that list on reset, so that allocations
+ * only reach malloc while the free list warms up. Allocations larger than a
+ * chunk get a dedicated chunk, which goes back to malloc on reset.
+ */
+typedef struct
+{
+	common_arena_chunk_s* first;
+	common_arena_chunk_s* current;
+	common_arena_chunk_s* large;
+	uint64_t chunks;
+	uint64_t used;
+} common_arena_s;
+
+/**
+ * @brief Create an empty arena. It does not take any memory until the first
+ * allocation.
+ * 
+ * @param arena arena to create
+ */
+void common_arena_create(common_arena_s* const arena);
+
+/**
+ * @brief Destroy the arena, returning all of its chunks.
+ * 
+ * @param arena arena to destroy
+ */
+void common_arena_destroy(common_arena_s* const arena);
+
+/**
+ * @brief Allocate memory from the arena, aligned for any object type.
+ * 
+ * @param arena arena to allocate from
+ * @param size  number of bytes to allocate
+ * 
+ * @return void* NULL if the memory could not be allocated
+ */
+void* common_arena_alloc(common_arena_s* const arena, const uint64_t size);
+
+/**
+ * @brief Release everything allocated from the arena at once.
+ * 
+ * @note The first chunk stays with the arena, so the reset is O(1) unless the
+ * arena has grown past one chunk or holds large allocations.
+ * 
+ * @param arena arena to reset
+ */
+void common_arena_reset(common_arena_s* const arena);
+
+/**
+ * @brief Free the chunks cached by the calling thread. It is meant to be
+ * called before the thread exits.
+ */
+void common_arena_release_cache(void);
+
+#endif
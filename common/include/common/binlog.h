@@ -0,0 +1,118 @@
+
+/**
+ * @file binlog.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__binlog_h__
+#define __common__include__common__binlog_h__
+
+#include "common/types.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/**
+ * @brief Layout of a binary log, all fields little-endian:
+ * 
+ *     file:        magic (8 bytes), then records
+ *     definition:  kind (1), format id (4), length (4), format string
+ *     message:     kind (1), level (1), format id (4), timestamp in
+ *                  nanoseconds (8), length (4), arguments
+ * 
+ * A format string is defined once, before the first message that uses it. The
+ * arguments of a message are stored in the order of the conversions of its
+ * format: integers, characters, pointers and floating point numbers as 8 bytes
+ * each, strings as a 4 byte length followed by their bytes.
+ */
+#define common_binlog_magic              "mtzblog1"
+#define common_binlog_magic_size         ((uint64_t)8)
+#define common_binlog_definition_size    ((uint64_t)9)
+#define common_binlog_message_size       ((uint64_t)18)
+#define common_binlog_string_limit       ((uint64_t)128)
+#define common_binlog_record_limit       ((uint64_t)1 << 20)
+#define common_binlog_none               UINT32_MAX
+
+typedef enum
+{
+	common_binlog_record_definition = 1,
+	common_binlog_record_message,
+} common_binlog_record_e;
+
+/**
+ * @brief A record decoded in place: the data points into the buffer the record
+ * was parsed from and holds the format string of a definition or the arguments
+ * of a message.
+ */
+typedef struct
+{
+	uint8_t kind;
+	uint8_t level;
+	uint32_t id;
+	uint64_t timestamp;
+	const uint8_t* data;
+	uint32_t size;
+} common_binlog_record_s;
+
+/**
+ * @brief Encode the header of a format definition, which is followed by the
+ * format string itself.
+ * 
+ * @param buffer buffer of at least @ref common_binlog_definition_size bytes
+ * @param id     id of the format
+ * @param length length of the format string
+ */
+void common_binlog_encode_definition(uint8_t* const buffer, const uint32_t id, const uint32_t length);
+
+/**
+ * @brief Encode a message, recording the raw arguments of its format.
+ * 
+ * @note Strings are cut short at @ref common_binlog_string_limit bytes, and
+ * formats with a conversion that cannot be recorded, such as a wide character
+ * or string, are refused.
+ * 
+ * @param buffer    buffer to encode into
+ * @param capacity  capacity of the buffer
+ * @param level     level of the message
+ * @param id        id of the format
+ * @param timestamp time of the message in nanoseconds
+ * @param format    format of the message
+ * @param args      arguments of the format
+ * 
+ * @return uint64_t size of the record, or 0 if it does not fit or the format
+ * is refused
+ */
+uint64_t common_binlog_encode_message(uint8_t* const buffer, const uint64_t capacity, const uint8_t level, const uint32_t id, const uint64_t timestamp, const char_t* const format, va_list args);
+
+/**
+ * @brief Decode a complete record in place.
+ * 
+ * @param data     received bytes
+ * @param size     number of received bytes
+ * @param record   decoded record, pointing into data
+ * @param consumed number of bytes the record takes up, 0 if it is incomplete
+ * 
+ * @return bool_t false if the record is malformed, or larger than
+ * @ref common_binlog_record_limit
+ */
+bool_t common_binlog_decode_record(const uint8_t* const data, const uint64_t size, common_binlog_record_s* const record, uint64_t* const consumed);
+
+/**
+ * @brief Format the arguments of a message with its format.
+ * 
+ * @param stream    stream to print to
+ * @param format    format of the message
+ * @param arguments encoded arguments of the message
+ * @param size      size of the encoded arguments
+ * 
+ * @return bool_t false if the arguments do not match the format
+ */
+bool_t common_binlog_print(FILE* const stream, const char_t* const format, const uint8_t* const arguments, const uint64_t size);
+
+#endif
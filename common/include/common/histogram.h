@@ -0,0 +1,98 @@
+
+/**
+ * @file histogram.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__histogram_h__
+#define __common__include__common__histogram_h__
+
+#include "common/types.h"
+
+#define common_histogram_precision_bits ((uint64_t)7)
+#define common_histogram_half_count     ((uint64_t)1 << (common_histogram_precision_bits - 1))
+#define common_histogram_buckets_count  (((uint64_t)66 - common_histogram_precision_bits) * common_histogram_half_count)
+
+/**
+ * @brief Log-linear histogram of 64-bit values, after the HDR histogram. Values
+ * below 128 get a bucket each, and every power of two above is split into 64
+ * linear buckets, so that any value is kept within 1/64 of itself over the
+ * whole range in a fixed set of buckets.
+ * 
+ * @note A histogram has a single writer, usually the thread it belongs to,
+ * which records without locks or read-modify-write instructions. Any other
+ * thread may take a snapshot of it at any time, which may miss the values
+ * being recorded while it is taken but is never torn.
+ */
+typedef struct
+{
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+	uint64_t buckets[common_histogram_buckets_count];
+} common_histogram_s;
+
+/**
+ * @brief Create an empty histogram.
+ * 
+ * @param histogram histogram to create
+ */
+void common_histogram_create(common_histogram_s* const histogram);
+
+/**
+ * @brief Record a value. Only the writer of the histogram may call it.
+ * 
+ * @param histogram histogram to record the value in
+ * @param value     value to record
+ */
+void common_histogram_record(common_histogram_s* const histogram, const uint64_t value);
+
+/**
+ * @brief Take a snapshot of a histogram that may be recorded in concurrently.
+ * 
+ * @note The count of the snapshot is that of its buckets, while its sum, min
+ * and max may already include a value that is not in its buckets yet.
+ * 
+ * @param histogram histogram to take the snapshot of
+ * @param snapshot  histogram to hold the snapshot
+ */
+void common_histogram_snapshot(const common_histogram_s* const histogram, common_histogram_s* const snapshot);
+
+/**
+ * @brief Merge the values of a histogram into another one.
+ * 
+ * @param target histogram to merge the values into
+ * @param source histogram to merge the values of, which is not recorded in
+ *               concurrently, such as a snapshot
+ */
+void common_histogram_merge(common_histogram_s* const target, const common_histogram_s* const source);
+
+/**
+ * @brief Get the value at a percentile: the highest value of the bucket that
+ * holds the nearest rank, so that it never understates a tail, capped by the
+ * maximum, so that the 100th percentile is the maximum.
+ * 
+ * @param histogram  histogram to query, which is not recorded in concurrently
+ * @param percentile percentile in the range (0, 100]
+ * 
+ * @return uint64_t 0 if the histogram is empty
+ */
+uint64_t common_histogram_percentile(const common_histogram_s* const histogram, const double percentile);
+
+/**
+ * @brief Get the mean of the recorded values.
+ * 
+ * @param histogram histogram to query, which is not recorded in concurrently
+ * 
+ * @return double 0 if the histogram is empty
+ */
+double common_histogram_mean(const common_histogram_s* const histogram);
+
+#endif
@@ -23,64 +23,191 @@
 #define common_cyan    "\033[36m"
 #define common_reset   "\033[0m"
 
+typedef enum
+{
+	common_logger_level_log,
+	common_logger_level_debug,
+	common_logger_level_info,
+	common_logger_level_note,
+	common_logger_level_warn,
+	common_logger_level_error,
+} common_logger_level_e;
+
 /**
- * @brief Log tagless level formattable messages.
+ * @brief Subsystems messages are attributed to. A translation unit picks its
+ * category by defining common_logger_category before including this header.
+ */
+typedef enum
+{
+	common_logger_category_general,
+	common_logger_category_network,
+	common_logger_category_storage,
+	common_logger_category_runtime,
+} common_logger_category_e;
+
+#define common_logger_mask_level(_level)       ((uint32_t)1 << (uint32_t)(_level))
+#define common_logger_mask_category(_category) ((uint32_t)1 << (8 + (uint32_t)(_category)))
+#define common_logger_mask_levels              ((uint32_t)0x00ff)
+#define common_logger_mask_categories          ((uint32_t)0xff00)
+
+#ifndef common_logger_category
+#	define common_logger_category common_logger_category_general
+#endif
+
+/**
+ * @brief Lowest level compiled in. Builds may raise it, for example with
+ * -D common_logger_minimum_level=common_logger_level_note.
+ */
+#ifndef common_logger_minimum_level
+#	ifndef NDEBUG
+#		define common_logger_minimum_level common_logger_level_debug
+#	else
+#		define common_logger_minimum_level common_logger_level_info
+#	endif
+#endif
+
+/**
+ * @brief Mask of the categories compiled in, built with
+ * @ref common_logger_mask_category.
+ */
+#ifndef common_logger_compiled_categories
+#	define common_logger_compiled_categories common_logger_mask_categories
+#endif
+
+/**
+ * @brief Runtime mask of the enabled levels and categories. Use the setters
+ * below instead of touching it directly.
+ */
+extern uint32_t _common_logger_mask;
+
+/**
+ * @brief Switch the logger to asynchronous mode: every thread formats its
+ * messages into a ring of its own, which a background thread drains and writes
+ * out in batches. Until it is called, messages are written synchronously.
  * 
- * @param format format of the log
- * @param ...    arguments of the log
+ * @note Messages that do not fit into a full ring are dropped rather than
+ * blocking the logging thread, and the number of dropped messages is reported
+ * by the background thread. Messages keep their order within a thread, but not
+ * across threads.
+ * 
+ * @return bool_t
  */
-void common_logger_log(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
+bool_t common_logger_start(void);
 
-#ifndef NDEBUG
 /**
- * @brief Log debug level formattable messages.
+ * @brief Switch the logger to asynchronous binary mode: instead of formatting
+ * them, the threads record the id of the format and the raw arguments of their
+ * messages, and the background thread writes them to a binary log, to be
+ * formatted offline by the decoder.
  * 
- * @param format format of the log
- * @param ...    arguments of the log
+ * @param path path of the binary log, which gets truncated
+ * 
+ * @return bool_t
  */
-void _common_logger_debug_impl(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
+bool_t common_logger_start_binary(const char_t* const path);
 
-#	define common_logger_debug(_format, ...)                                   \
-		_common_logger_debug_impl(_format, ##__VA_ARGS__)
-#else
-#	define common_logger_debug(_format, ...)                                   \
-		do                                                                     \
-		{                                                                      \
-			(void)(_format);                                                   \
-			(void)(__VA_ARGS__);                                               \
-		} while (0)
-#endif
+/**
+ * @brief Write out the pending messages and switch the logger back to
+ * synchronous mode.
+ * 
+ * @note No other thread may be logging while the logger is being stopped.
+ */
+void common_logger_stop(void);
 
 /**
- * @brief Log info level formattable messages.
+ * @brief Enable the levels from the given one up, at runtime.
  * 
- * @param format format of the log
- * @param ...    arguments of the log
+ * @param level lowest level to enable
  */
-void common_logger_info(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
+void common_logger_set_level(const common_logger_level_e level);
 
 /**
- * @brief Log note level formattable messages.
+ * @brief Enable or disable a category, at runtime.
  * 
- * @param format format of the log
- * @param ...    arguments of the log
+ * @param category category to toggle
+ * @param enabled  whether its messages are logged
  */
-void common_logger_note(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
+void common_logger_set_category(const common_logger_category_e category, const bool_t enabled);
 
 /**
- * @brief Log warn level formattable messages.
+ * @brief Convert a level to the tag its messages are prefixed with.
+ * 
+ * @param level level to convert
+ * 
+ * @return const char_t* NULL for tagless messages
+ */
+const char_t* common_logger_level_to_tag(const common_logger_level_e level);
+
+/**
+ * @brief Log tagless level formattable messages.
+ * 
+ * @note Tagless messages are the output of the programs themselves, so they
+ * are never filtered.
  * 
  * @param format format of the log
  * @param ...    arguments of the log
  */
-void common_logger_warn(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
+void common_logger_log(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
 
 /**
- * @brief Log error level formattable messages.
+ * @brief Log formattable messages of a level. Use the level macros below, which
+ * filter the messages before their arguments are evaluated.
  * 
+ * @param level  level of the log
  * @param format format of the log
  * @param ...    arguments of the log
  */
-void common_logger_error(const char_t* const format, ...) __attribute__ ((format (printf, 1, 2)));
+void _common_logger_impl(const common_logger_level_e level, const char_t* const format, ...) __attribute__ ((format (printf, 2, 3)));
+
+/**
+ * @brief Check the runtime mask for a level and a category.
+ * 
+ * @param level    level to check
+ * @param category category to check
+ * 
+ * @return bool_t
+ */
+static inline bool_t _common_logger_is_enabled(const common_logger_level_e level, const common_logger_category_e category);
+
+static inline bool_t _common_logger_is_enabled(const common_logger_level_e level, const common_logger_category_e category)
+{
+	const uint32_t mask = common_logger_mask_level(level) | common_logger_mask_category(category);
+	return (__atomic_load_n(&_common_logger_mask, __ATOMIC_RELAXED) & mask) == mask;
+}
+
+/**
+ * @brief Log formattable messages of a level in the category of the calling
+ * translation unit.
+ * 
+ * @note Levels below @ref common_logger_minimum_level and categories missing
+ * from @ref common_logger_compiled_categories fold into dead code, which is
+ * still type-checked. The rest cost a load of the runtime mask when disabled.
+ */
+#define _common_logger_dispatch(_level, _format, ...)                          \
+	do                                                                         \
+	{                                                                          \
+		if (((_level) >= common_logger_minimum_level) &&                       \
+			((common_logger_compiled_categories &                              \
+				common_logger_mask_category(common_logger_category)) != 0) &&  \
+			_common_logger_is_enabled((_level), common_logger_category))       \
+		{                                                                      \
+			_common_logger_impl((_level), _format, ##__VA_ARGS__);             \
+		}                                                                      \
+	} while (0)
+
+#define common_logger_debug(_format, ...)                                      \
+	_common_logger_dispatch(common_logger_level_debug, _format, ##__VA_ARGS__)
+
+#define common_logger_info(_format, ...)                                       \
+	_common_logger_dispatch(common_logger_level_info, _format, ##__VA_ARGS__)
+
+#define common_logger_note(_format, ...)                                       \
+	_common_logger_dispatch(common_logger_level_note, _format, ##__VA_ARGS__)
+
+#define common_logger_warn(_format, ...)                                       \
+	_common_logger_dispatch(common_logger_level_warn, _format, ##__VA_ARGS__)
+
+#define common_logger_error(_format, ...)                                      \
+	_common_logger_dispatch(common_logger_level_error, _format, ##__VA_ARGS__)
 
 #endif
@@ -0,0 +1,155 @@
+
+/**
+ * @file pool.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__pool_h__
+#define __common__include__common__pool_h__
+
+#include "common/types.h"
+
+#include <sys/uio.h>
+
+#define common_pool_none ((uint32_t)UINT32_MAX)
+
+typedef struct common_pool_s common_pool_s;
+
+typedef struct
+{
+	common_pool_s* pool;
+	uint32_t index;
+	uint32_t next;
+	uint32_t references;
+} common_pool_buffer_s;
+
+/**
+ * @brief A range of a pooled buffer. Every slice holds a reference to its
+ * buffer, so one buffer can back several pieces of output without copying.
+ */
+typedef struct
+{
+	common_pool_buffer_s* buffer;
+	uint8_t* data;
+	uint64_t size;
+} common_pool_slice_s;
+
+/**
+ * @brief Pool of fixed-size, page-aligned i/o buffers carved out of a single
+ * mapping, so that the whole pool can be registered with io_uring, where the
+ * index of a buffer is its fixed buffer index.
+ * 
+ * @note The pool is owned by one thread, which is the only one acquiring
+ * buffers. Buffers released on other threads go through a lock-free return
+ * list, which the owner drains once it runs out of buffers. The list is
+ * bounded by the size of the pool, as a buffer is on it at most once.
+ */
+struct common_pool_s
+{
+	uint8_t* region;
+	uint64_t region_size;
+	uint64_t buffer_size;
+	uint32_t count;
+	common_pool_buffer_s* buffers;
+
+	uint32_t free_head;
+	uint32_t free_count;
+	const void* owner;
+
+	// note: the return list is kept off the cache lines the owner works on.
+	uint8_t padding[64];
+	uint32_t remote_head;
+};
+
+/**
+ * @brief Create the pool, owned by the calling thread.
+ * 
+ * @param pool        pool to create
+ * @param count       number of buffers
+ * @param buffer_size size of each buffer, rounded up to a multiple of the page size
+ * 
+ * @return bool_t
+ */
+bool_t common_pool_create(common_pool_s* const pool, const uint32_t count, const uint64_t buffer_size);
+
+/**
+ * @brief Destroy the pool. All of its buffers must have been released.
+ * 
+ * @param pool pool to destroy
+ */
+void common_pool_destroy(common_pool_s* const pool);
+
+/**
+ * @brief Make the calling thread the owner of the pool.
+ * 
+ * @param pool pool to adopt
+ */
+void common_pool_adopt(common_pool_s* const pool);
+
+/**
+ * @brief Acquire a buffer holding a single reference. Only the owner thread
+ * may acquire buffers.
+ * 
+ * @param pool pool to acquire the buffer from
+ * 
+ * @return common_pool_buffer_s* NULL if the pool is exhausted
+ */
+common_pool_buffer_s* common_pool_acquire(common_pool_s* const pool);
+
+/**
+ * @brief Get the memory of a buffer.
+ * 
+ * @param buffer buffer to get the memory of
+ * 
+ * @return uint8_t*
+ */
+uint8_t* common_pool_data(const common_pool_buffer_s* const buffer);
+
+/**
+ * @brief Add a reference to a buffer.
+ * 
+ * @param buffer buffer to reference
+ */
+void common_pool_retain(common_pool_buffer_s* const buffer);
+
+/**
+ * @brief Drop a reference to a buffer, returning it to its pool once the last
+ * reference is gone. It may be called from any thread.
+ * 
+ * @param buffer buffer to release
+ */
+void common_pool_release(common_pool_buffer_s* const buffer);
+
+/**
+ * @brief Take a referenced slice of a buffer.
+ * 
+ * @param buffer buffer to slice
+ * @param offset offset of the slice in the buffer
+ * @param size   size of the slice
+ * 
+ * @return common_pool_slice_s
+ */
+common_pool_slice_s common_pool_slice(common_pool_buffer_s* const buffer, const uint64_t offset, const uint64_t size);
+
+/**
+ * @brief Release a slice and the reference it holds.
+ * 
+ * @param slice slice to release
+ */
+void common_pool_slice_release(common_pool_slice_s* const slice);
+
+/**
+ * @brief Describe the buffers of the pool for io_uring buffer registration.
+ * 
+ * @param pool    pool to describe
+ * @param iovecs  io vectors to fill, one per buffer
+ */
+void common_pool_iovecs(const common_pool_s* const pool, struct iovec* const iovecs);
+
+#endif
@@ -0,0 +1,298 @@
+
+/**
+ * @file protocol.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__protocol_h__
+#define __common__include__common__protocol_h__
+
+#include "common/types.h"
+
+/**
+ * @brief Wire layout of a frame header, all fields little-endian:
+ * 
+ *     offset  size  field
+ *     0       1     type
+ *     1       1     flags
+ *     2       2     reserved, must be zero
+ *     4       4     stream id
+ *     8       4     payload length
+ */
+#define common_protocol_header_size          ((uint64_t)12)
+#define common_protocol_control_limit        ((uint64_t)4096)
+#define common_protocol_request_size         ((uint64_t)12)
+#define common_protocol_error_size           ((uint64_t)4)
+#define common_protocol_range_size           ((uint64_t)24)
+#define common_protocol_subscribe_size       ((uint64_t)8)
+#define common_protocol_request_frame_size   (common_protocol_header_size + common_protocol_request_size)
+#define common_protocol_error_frame_size     (common_protocol_header_size + common_protocol_error_size)
+#define common_protocol_range_frame_size     (common_protocol_header_size + common_protocol_range_size)
+#define common_protocol_subscribe_frame_size (common_protocol_header_size + common_protocol_subscribe_size)
+#define common_protocol_ping_frame_size      (common_protocol_header_size)
+
+typedef enum
+{
+	common_protocol_frame_request = 1,
+	common_protocol_frame_segment,
+	common_protocol_frame_error,
+	common_protocol_frame_ping,
+	common_protocol_frame_pong,
+	common_protocol_frame_byte_range,
+	common_protocol_frame_time_range,
+	common_protocol_frame_subscribe,
+} common_protocol_frame_e;
+
+typedef enum
+{
+	common_protocol_flag_end = 1 << 0,
+} common_protocol_flag_e;
+
+typedef enum
+{
+	common_protocol_error_invalid = 1,
+	common_protocol_error_not_found,
+	common_protocol_error_unavailable,
+	common_protocol_error_out_of_range,
+} common_protocol_error_e;
+
+typedef enum
+{
+	common_protocol_status_complete,
+	common_protocol_status_incomplete,
+	common_protocol_status_invalid,
+} common_protocol_status_e;
+
+typedef struct
+{
+	uint8_t type;
+	uint8_t flags;
+	uint32_t stream_id;
+	uint32_t length;
+} common_protocol_header_s;
+
+/**
+ * @brief A complete frame decoded in place: the payload points into the buffer
+ * the frame was parsed from.
+ */
+typedef struct
+{
+	common_protocol_header_s header;
+	const uint8_t* payload;
+} common_protocol_frame_s;
+
+/**
+ * @brief A piece of a frame payload decoded in place by a reader. Control frames
+ * always come in a single chunk, segment frames as they arrive.
+ */
+typedef struct
+{
+	common_protocol_header_s header;
+	const uint8_t* data;
+	uint64_t size;
+	uint64_t offset;
+	bool_t last;
+} common_protocol_chunk_s;
+
+/**
+ * @brief Incremental frame reader, which keeps the state of a frame whose
+ * payload spans multiple reads.
+ */
+typedef struct
+{
+	common_protocol_header_s header;
+	uint64_t remaining;
+	bool_t active;
+} common_protocol_reader_s;
+
+typedef struct
+{
+	uint64_t media_id;
+	uint32_t chunk;
+} common_protocol_request_s;
+
+/**
+ * @brief A range of a media, requested with a byte range frame in bytes of
+ * its segments laid end to end, or with a time range frame in milliseconds
+ * of playback. A length of zero extends the range to the end of the media.
+ * 
+ * @note The range is answered with a segment frame per segment it covers, of
+ * which only the last one carries the end flag. Byte ranges are cut to the
+ * exact bytes, while time ranges cover whole segments, as segments are the
+ * only points playback can start from.
+ */
+typedef struct
+{
+	uint64_t media_id;
+	uint64_t start;
+	uint64_t length;
+} common_protocol_range_s;
+
+/**
+ * @brief Encode a frame header.
+ * 
+ * @param buffer buffer of at least @ref common_protocol_header_size bytes
+ * @param header header to encode
+ */
+void common_protocol_encode_header(uint8_t* const buffer, const common_protocol_header_s* const header);
+
+/**
+ * @brief Decode and validate a frame header.
+ * 
+ * @param data   received bytes
+ * @param size   number of received bytes
+ * @param header decoded header
+ * 
+ * @return common_protocol_status_e
+ */
+common_protocol_status_e common_protocol_decode_header(const uint8_t* const data, const uint64_t size, common_protocol_header_s* const header);
+
+/**
+ * @brief Parse a complete frame in place.
+ * 
+ * @note Only control frames are bounded by @ref common_protocol_control_limit,
+ * so callers that parse whole frames have to reject segment frames or be able
+ * to buffer them.
+ * 
+ * @param data     received bytes
+ * @param size     number of received bytes
+ * @param frame    parsed frame, pointing into data
+ * @param consumed number of bytes the frame takes up
+ * 
+ * @return common_protocol_status_e incomplete if the frame has not been fully
+ * received yet, in which case nothing is consumed
+ */
+common_protocol_status_e common_protocol_parse_frame(const uint8_t* const data, const uint64_t size, common_protocol_frame_s* const frame, uint64_t* const consumed);
+
+/**
+ * @brief Reset the reader to expect a frame header.
+ * 
+ * @param reader reader to reset
+ */
+void common_protocol_reader_reset(common_protocol_reader_s* const reader);
+
+/**
+ * @brief Feed received bytes to the reader.
+ * 
+ * @param reader   reader to feed
+ * @param data     received bytes
+ * @param size     number of received bytes
+ * @param chunk    decoded chunk, pointing into data
+ * @param consumed number of bytes consumed, which may be non-zero even when
+ * no chunk was decoded
+ * 
+ * @return common_protocol_status_e
+ */
+common_protocol_status_e common_protocol_reader_feed(common_protocol_reader_s* const reader, const uint8_t* const data, const uint64_t size, common_protocol_chunk_s* const chunk, uint64_t* const consumed);
+
+/**
+ * @brief Encode a request frame.
+ * 
+ * @param buffer    buffer of at least @ref common_protocol_request_frame_size bytes
+ * @param stream_id stream id of the request
+ * @param request   request to encode
+ */
+void common_protocol_encode_request(uint8_t* const buffer, const uint32_t stream_id, const common_protocol_request_s* const request);
+
+/**
+ * @brief Decode the payload of a request frame.
+ * 
+ * @param payload payload of the frame
+ * @param length  length of the payload
+ * @param request decoded request
+ * 
+ * @return bool_t false if the payload is malformed
+ */
+bool_t common_protocol_decode_request(const uint8_t* const payload, const uint64_t length, common_protocol_request_s* const request);
+
+/**
+ * @brief Encode a range frame.
+ * 
+ * @param buffer    buffer of at least @ref common_protocol_range_frame_size bytes
+ * @param stream_id stream id of the request
+ * @param type      either @ref common_protocol_frame_byte_range or
+ * @ref common_protocol_frame_time_range
+ * @param range     range to encode
+ */
+void common_protocol_encode_range(uint8_t* const buffer, const uint32_t stream_id, const common_protocol_frame_e type, const common_protocol_range_s* const range);
+
+/**
+ * @brief Decode the payload of a range frame.
+ * 
+ * @param payload payload of the frame
+ * @param length  length of the payload
+ * @param range   decoded range
+ * 
+ * @return bool_t false if the payload is malformed
+ */
+bool_t common_protocol_decode_range(const uint8_t* const payload, const uint64_t length, common_protocol_range_s* const range);
+
+/**
+ * @brief Encode a subscribe frame, which asks for the segments of a live media
+ * from its live edge on, each in a segment frame on the stream of the
+ * subscription as soon as it is published. The subscription never ends, and
+ * a subscriber that can not keep up skips to the newest segment instead.
+ * 
+ * @param buffer    buffer of at least @ref common_protocol_subscribe_frame_size bytes
+ * @param stream_id stream id of the subscription
+ * @param media_id  id of the live media
+ */
+void common_protocol_encode_subscribe(uint8_t* const buffer, const uint32_t stream_id, const uint64_t media_id);
+
+/**
+ * @brief Decode the payload of a subscribe frame.
+ * 
+ * @param payload  payload of the frame
+ * @param length   length of the payload
+ * @param media_id decoded id of the live media
+ * 
+ * @return bool_t false if the payload is malformed
+ */
+bool_t common_protocol_decode_subscribe(const uint8_t* const payload, const uint64_t length, uint64_t* const media_id);
+
+/**
+ * @brief Encode an error frame.
+ * 
+ * @param buffer    buffer of at least @ref common_protocol_error_frame_size bytes
+ * @param stream_id stream id the error refers to
+ * @param error     error to encode
+ */
+void common_protocol_encode_error(uint8_t* const buffer, const uint32_t stream_id, const common_protocol_error_e error);
+
+/**
+ * @brief Decode the payload of an error frame.
+ * 
+ * @param payload payload of the frame
+ * @param length  length of the payload
+ * @param error   decoded error
+ * 
+ * @return bool_t false if the payload is malformed
+ */
+bool_t common_protocol_decode_error(const uint8_t* const payload, const uint64_t length, common_protocol_error_e* const error);
+
+/**
+ * @brief Encode a ping frame, which the peer answers with a pong frame. Pings
+ * carry no payload and are sent on stream 0, outside of any request.
+ * 
+ * @param buffer buffer of at least @ref common_protocol_ping_frame_size bytes
+ * @param type   either @ref common_protocol_frame_ping or
+ * @ref common_protocol_frame_pong
+ */
+void common_protocol_encode_ping(uint8_t* const buffer, const common_protocol_frame_e type);
+
+/**
+ * @brief Convert an error to a human-readable string.
+ * 
+ * @param error error to convert
+ * 
+ * @return const char_t*
+ */
+const char_t* common_protocol_error_to_string(const common_protocol_error_e error);
+
+#endif
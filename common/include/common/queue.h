@@ -0,0 +1,194 @@
+
+/**
+ * @file queue.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__queue_h__
+#define __common__include__common__queue_h__
+
+#include "common/types.h"
+
+#define common_queue_cache_line ((uint64_t)64)
+
+/**
+ * @brief Bounded single-producer single-consumer ring of pointers.
+ * 
+ * @note The indices of each side live on their own cache line together with a
+ * cached copy of the other side's index, so that a side only touches the
+ * other's line when its cached copy says the ring is full or empty.
+ */
+typedef struct
+{
+	_Alignas(common_queue_cache_line) void** slots;
+	uint64_t mask;
+
+	_Alignas(common_queue_cache_line) uint64_t head;
+	uint64_t tail_cache;
+
+	_Alignas(common_queue_cache_line) uint64_t tail;
+	uint64_t head_cache;
+} common_queue_spsc_s;
+
+typedef struct
+{
+	uint64_t sequence;
+	void* item;
+} common_queue_cell_s;
+
+/**
+ * @brief Bounded multi-producer multi-consumer queue of pointers, after Dmitry
+ * Vyukov's design: every cell carries a sequence number telling which lap of
+ * the ring it is ready for, so producers and consumers only contend on their
+ * own index.
+ */
+typedef struct
+{
+	_Alignas(common_queue_cache_line) common_queue_cell_s* cells;
+	uint64_t mask;
+
+	_Alignas(common_queue_cache_line) uint64_t enqueue;
+
+	_Alignas(common_queue_cache_line) uint64_t dequeue;
+} common_queue_mpmc_s;
+
+/**
+ * @brief Create the ring.
+ * 
+ * @param queue    ring to create
+ * @param capacity capacity of the ring, rounded up to a power of two
+ * 
+ * @return bool_t
+ */
+bool_t common_queue_spsc_create(common_queue_spsc_s* const queue, const uint64_t capacity);
+
+/**
+ * @brief Destroy the ring.
+ * 
+ * @param queue ring to destroy
+ */
+void common_queue_spsc_destroy(common_queue_spsc_s* const queue);
+
+/**
+ * @brief Push an item. Only the producer thread may call it.
+ * 
+ * @param queue ring to push to
+ * @param item  item to push
+ * 
+ * @return bool_t false if the ring is full
+ */
+bool_t common_queue_spsc_push(common_queue_spsc_s* const queue, void* const item);
+
+/**
+ * @brief Push as many of the items as fit, publishing them at once. Only the
+ * producer thread may call it.
+ * 
+ * @param queue ring to push to
+ * @param items items to push
+ * @param count number of items
+ * 
+ * @return uint64_t number of items pushed
+ */
+uint64_t common_queue_spsc_push_many(common_queue_spsc_s* const queue, void* const* const items, const uint64_t count);
+
+/**
+ * @brief Pop an item. Only the consumer thread may call it.
+ * 
+ * @param queue ring to pop from
+ * @param item  popped item
+ * 
+ * @return bool_t false if the ring is empty
+ */
+bool_t common_queue_spsc_pop(common_queue_spsc_s* const queue, void** const item);
+
+/**
+ * @brief Pop up to capacity items at once. Only the consumer thread may call it.
+ * 
+ * @param queue    ring to pop from
+ * @param items    popped items
+ * @param capacity capacity of the items
+ * 
+ * @return uint64_t number of items popped
+ */
+uint64_t common_queue_spsc_pop_many(common_queue_spsc_s* const queue, void** const items, const uint64_t capacity);
+
+/**
+ * @brief Create the queue.
+ * 
+ * @param queue    queue to create
+ * @param capacity capacity of the queue, rounded up to a power of two
+ * 
+ * @return bool_t
+ */
+bool_t common_queue_mpmc_create(common_queue_mpmc_s* const queue, const uint64_t capacity);
+
+/**
+ * @brief Destroy the queue.
+ * 
+ * @param queue queue to destroy
+ */
+void common_queue_mpmc_destroy(common_queue_mpmc_s* const queue);
+
+/**
+ * @brief Push an item.
+ * 
+ * @param queue queue to push to
+ * @param item  item to push
+ * 
+ * @return bool_t false if the queue is full
+ */
+bool_t common_queue_mpmc_push(common_queue_mpmc_s* const queue, void* const item);
+
+/**
+ * @brief Push as many of the items as there are free cells in a row, claiming
+ * all of them with a single atomic operation.
+ * 
+ * @param queue queue to push to
+ * @param items items to push
+ * @param count number of items
+ * 
+ * @return uint64_t number of items pushed
+ */
+uint64_t common_queue_mpmc_push_many(common_queue_mpmc_s* const queue, void* const* const items, const uint64_t count);
+
+/**
+ * @brief Pop an item.
+ * 
+ * @param queue queue to pop from
+ * @param item  popped item
+ * 
+ * @return bool_t false if the queue is empty
+ */
+bool_t common_queue_mpmc_pop(common_queue_mpmc_s* const queue, void** const item);
+
+/**
+ * @brief Pop up to capacity items that are ready in a row, claiming all of them
+ * with a single atomic operation.
+ * 
+ * @param queue    queue to pop from
+ * @param items    popped items
+ * @param capacity capacity of the items
+ * 
+ * @return uint64_t number of items popped
+ */
+uint64_t common_queue_mpmc_pop_many(common_queue_mpmc_s* const queue, void** const items, const uint64_t capacity);
+
+/**
+ * @brief Get the number of items in the queue, from any thread.
+ * 
+ * @note The indices are read one after the other while the queue keeps being
+ * used, so the result is only a close estimate.
+ * 
+ * @param queue queue to query
+ * 
+ * @return uint64_t
+ */
+uint64_t common_queue_mpmc_size(const common_queue_mpmc_s* const queue);
+
+#endif
@@ -0,0 +1,137 @@
+
+/**
+ * @file scheduler.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__scheduler_h__
+#define __common__include__common__scheduler_h__
+
+#include "common/types.h"
+#include "common/queue.h"
+
+#include <pthread.h>
+
+#define common_scheduler_deque_capacity ((uint64_t)1024)
+#define common_scheduler_spin_rounds    ((uint32_t)64)
+
+typedef struct common_scheduler_s common_scheduler_s;
+
+/**
+ * @brief A unit of work. Tasks are owned by whoever submits them and have to
+ * stay alive until they have run, which usually means the function frees them.
+ */
+typedef struct
+{
+	void (*function)(void* const argument);
+	void* argument;
+} common_scheduler_task_s;
+
+/**
+ * @brief Chase-Lev work-stealing deque: the owner pushes and takes at the
+ * bottom, other workers steal from the top.
+ */
+typedef struct
+{
+	_Alignas(common_queue_cache_line) int64_t top;
+
+	_Alignas(common_queue_cache_line) int64_t bottom;
+
+	_Alignas(common_queue_cache_line) common_scheduler_task_s* tasks[common_scheduler_deque_capacity];
+} common_scheduler_deque_s;
+
+typedef struct
+{
+	common_scheduler_s* scheduler;
+	uint32_t index;
+	uint64_t seed;
+	pthread_t thread;
+	common_scheduler_deque_s deque;
+} common_scheduler_worker_s;
+
+/**
+ * @brief Work-stealing task scheduler. Tasks submitted from outside land in a
+ * shared injection queue, tasks submitted from a worker go to its own deque,
+ * and idle workers steal from the others before they park.
+ */
+struct common_scheduler_s
+{
+	common_scheduler_worker_s* workers;
+	uint32_t workers_count;
+	uint32_t workers_started;
+	common_queue_mpmc_s injected;
+
+	bool_t stopping;
+	uint64_t epoch;
+	uint32_t sleepers;
+	pthread_mutex_t lock;
+	pthread_cond_t wakeup;
+};
+
+/**
+ * @brief Create the scheduler and spawn its worker threads.
+ * 
+ * @note The scheduler is over-aligned, so it must not live in memory from
+ * plain malloc.
+ * 
+ * @param scheduler scheduler to create
+ * @param threads   number of worker threads
+ * @param capacity  capacity of the injection queue
+ * 
+ * @return bool_t
+ */
+bool_t common_scheduler_create(common_scheduler_s* const scheduler, const uint32_t threads, const uint64_t capacity);
+
+/**
+ * @brief Stop the scheduler and destroy it. Tasks already submitted still run
+ * before the workers exit, and long ones should check @ref
+ * common_scheduler_is_stopping to cut their work short.
+ * 
+ * @param scheduler scheduler to destroy
+ */
+void common_scheduler_destroy(common_scheduler_s* const scheduler);
+
+/**
+ * @brief Submit a task. From a worker of the scheduler the task goes to the
+ * worker's own deque, otherwise to the injection queue.
+ * 
+ * @param scheduler scheduler to submit the task to
+ * @param task      task to run
+ * 
+ * @note A worker whose deque and the injection queue are both full runs the
+ * task inline instead, so submitting from a worker always succeeds.
+ * 
+ * @return bool_t false if the injection queue is full or the scheduler is
+ * stopping, in which case the task is not run
+ */
+bool_t common_scheduler_submit(common_scheduler_s* const scheduler, common_scheduler_task_s* const task);
+
+/**
+ * @brief Check if the scheduler is stopping.
+ * 
+ * @param scheduler scheduler to check
+ * 
+ * @return bool_t
+ */
+bool_t common_scheduler_is_stopping(const common_scheduler_s* const scheduler);
+
+/**
+ * @brief Get the number of tasks waiting to run, in the injection queue and
+ * the deques of the workers, from any thread.
+ * 
+ * @note Tasks keep being submitted and run while they are counted, so the
+ * result is only a close estimate.
+ * 
+ * @param scheduler scheduler to query
+ * 
+ * @return uint64_t
+ */
+uint64_t common_scheduler_pending(const common_scheduler_s* const scheduler);
+
+#endif
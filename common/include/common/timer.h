@@ -0,0 +1,154 @@
+
+/**
+ * @file timer.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __common__include__common__timer_h__
+#define __common__include__common__timer_h__
+
+#include "common/types.h"
+
+#define common_timer_wheel_levels  ((uint64_t)4)
+#define common_timer_wheel_bits    ((uint64_t)6)
+#define common_timer_wheel_slots   ((uint64_t)1 << common_timer_wheel_bits)
+#define common_timer_wheel_mask    (common_timer_wheel_slots - 1)
+
+typedef struct common_timer_s common_timer_s;
+
+/**
+ * @brief A timer entry, embedded in the object it times. Entries are linked
+ * into the wheel intrusively, so scheduling and cancelling never allocate.
+ */
+struct common_timer_s
+{
+	common_timer_s* next;
+	common_timer_s* prev;
+	uint64_t deadline;
+	uint8_t level;
+	uint8_t slot;
+
+	void (*function)(common_timer_s* const timer, void* const argument);
+	void* argument;
+};
+
+/**
+ * @brief Hierarchical timer wheel. Every level has 64 slots, each slot of a
+ * level spanning a full turn of the level below, so that a timer is placed in
+ * constant time and cascades down at most once per level before it fires.
+ * 
+ * @note Time is kept in ticks of the wheel's resolution, and deadlines past
+ * the span of the top level are parked in it and re-placed as it turns. The
+ * wheel is not thread-safe and is meant to be driven by a single event loop.
+ */
+typedef struct
+{
+	common_timer_s slots[common_timer_wheel_levels][common_timer_wheel_slots];
+	uint64_t occupied[common_timer_wheel_levels];
+	uint64_t resolution_ms;
+	uint64_t now;
+	uint64_t count;
+} common_timer_wheel_s;
+
+/**
+ * @brief Create an empty wheel.
+ * 
+ * @param wheel         wheel to create
+ * @param now_ms        current time in milliseconds
+ * @param resolution_ms duration of a tick in milliseconds
+ */
+void common_timer_wheel_create(common_timer_wheel_s* const wheel, const uint64_t now_ms, const uint64_t resolution_ms);
+
+/**
+ * @brief Destroy the wheel, disarming every timer still scheduled on it.
+ * 
+ * @param wheel wheel to destroy
+ */
+void common_timer_wheel_destroy(common_timer_wheel_s* const wheel);
+
+/**
+ * @brief Initialize a disarmed timer.
+ * 
+ * @param timer    timer to initialize
+ * @param function function to call when the timer fires
+ * @param argument argument to pass to the function
+ */
+void common_timer_init(common_timer_s* const timer, void (*function)(common_timer_s* const timer, void* const argument), void* const argument);
+
+/**
+ * @brief Check whether the timer is scheduled.
+ * 
+ * @param timer timer to check
+ * 
+ * @return bool_t
+ */
+bool_t common_timer_is_armed(const common_timer_s* const timer);
+
+/**
+ * @brief Schedule the timer, rescheduling it if it is already armed.
+ * 
+ * @note The deadline is rounded up to the next tick, and a deadline that has
+ * already passed fires on the next tick.
+ * 
+ * @param wheel       wheel to schedule on
+ * @param timer       timer to schedule
+ * @param deadline_ms deadline in milliseconds
+ */
+void common_timer_wheel_schedule(common_timer_wheel_s* const wheel, common_timer_s* const timer, const uint64_t deadline_ms);
+
+/**
+ * @brief Cancel the timer. Cancelling a disarmed timer does nothing.
+ * 
+ * @param wheel wheel the timer is scheduled on
+ * @param timer timer to cancel
+ */
+void common_timer_wheel_cancel(common_timer_wheel_s* const wheel, common_timer_s* const timer);
+
+/**
+ * @brief Advance the wheel to the current time, firing every expired timer.
+ * 
+ * @note A fired timer is disarmed before its function is called, so that the
+ * function may schedule it again or cancel any other timer.
+ * 
+ * @param wheel  wheel to advance
+ * @param now_ms current time in milliseconds
+ * 
+ * @return uint64_t number of fired timers
+ */
+uint64_t common_timer_wheel_advance(common_timer_wheel_s* const wheel, const uint64_t now_ms);
+
+/**
+ * @brief Get how long an event loop may wait before the wheel has to be
+ * advanced again.
+ * 
+ * @note The result never exceeds the time to the earliest deadline, but may
+ * fall short of it when the earliest timer still has to cascade.
+ * 
+ * @param wheel  wheel to query
+ * @param now_ms current time in milliseconds
+ * 
+ * @return int32_t timeout in milliseconds, or -1 if no timer is scheduled
+ */
+int32_t common_timer_wheel_timeout(const common_timer_wheel_s* const wheel, const uint64_t now_ms);
+
+/**
+ * @brief Get the current time of the monotonic clock in milliseconds.
+ * 
+ * @return uint64_t
+ */
+uint64_t common_timer_now_ms(void);
+
+/**
+ * @brief Get the current time of the monotonic clock in nanoseconds.
+ * 
+ * @return uint64_t
+ */
+uint64_t common_timer_now_ns(void);
+
+#endif
@@ -0,0 +1,192 @@
+
+/**
+ * @file arena.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/arena.h"
+
+#include <stdlib.h>
+
+struct common_arena_chunk_s
+{
+	common_arena_chunk_s* next;
+	uint64_t capacity;
+	_Alignas(max_align_t) uint8_t data[];
+};
+
+#define _alignment      ((uint64_t)_Alignof(max_align_t))
+#define _chunk_capacity (common_arena_chunk_size - sizeof(common_arena_chunk_s))
+
+static _Thread_local common_arena_chunk_s* _g_cache = NULL;
+static _Thread_local uint64_t _g_cache_count = 0;
+
+static void* _alloc_slow(common_arena_s* const arena, const uint64_t size);
+
+static common_arena_chunk_s* _take_chunk(void);
+
+static void _give_chunks(common_arena_chunk_s* const first, common_arena_chunk_s* const last, const uint64_t count);
+
+void common_arena_create(common_arena_s* const arena)
+{
+	common_debug_assert(arena != NULL);
+	*arena = (const common_arena_s) {0};
+}
+
+void common_arena_destroy(common_arena_s* const arena)
+{
+	common_debug_assert(arena != NULL);
+
+	common_arena_reset(arena);
+
+	if (arena->first != NULL)
+	{
+		_give_chunks(arena->first, arena->first, 1);
+	}
+
+	*arena = (const common_arena_s) {0};
+}
+
+void* common_arena_alloc(common_arena_s* const arena, const uint64_t size)
+{
+	common_debug_assert(arena != NULL);
+
+	const uint64_t aligned = (size + _alignment - 1) & ~(_alignment - 1);
+
+	if ((arena->current != NULL) && (aligned <= (arena->current->capacity - arena->used)))
+	{
+		void* const memory = arena->current->data + arena->used;
+		arena->used += aligned;
+		return memory;
+	}
+
+	return _alloc_slow(arena, aligned);
+}
+
+void common_arena_reset(common_arena_s* const arena)
+{
+	common_debug_assert(arena != NULL);
+
+	while (arena->large != NULL)
+	{
+		common_arena_chunk_s* const chunk = arena->large;
+		arena->large = chunk->next;
+		free(chunk);
+	}
+
+	if ((arena->first != NULL) && (arena->first->next != NULL))
+	{
+		_give_chunks(arena->first->next, arena->current, arena->chunks - 1);
+		arena->first->next = NULL;
+	}
+
+	arena->current = arena->first;
+	arena->chunks  = (arena->first != NULL) ? 1 : 0;
+	arena->used    = 0;
+}
+
+void common_arena_release_cache(void)
+{
+	while (_g_cache != NULL)
+	{
+		common_arena_chunk_s* const chunk = _g_cache;
+		_g_cache = chunk->next;
+		free(chunk);
+	}
+
+	_g_cache_count = 0;
+}
+
+static void* _alloc_slow(common_arena_s* const arena, const uint64_t size)
+{
+	common_debug_assert(arena != NULL);
+
+	if (size > _chunk_capacity)
+	{
+		common_arena_chunk_s* const chunk = malloc(sizeof(common_arena_chunk_s) + size);
+
+		if (NULL == chunk)
+		{
+			return NULL;
+		}
+
+		chunk->capacity = size;
+		chunk->next     = arena->large;
+		arena->large    = chunk;
+		return chunk->data;
+	}
+
+	common_arena_chunk_s* const chunk = _take_chunk();
+
+	if (NULL == chunk)
+	{
+		return NULL;
+	}
+
+	if (NULL == arena->current)
+	{
+		arena->first = chunk;
+	}
+	else
+	{
+		arena->current->next = chunk;
+	}
+
+	arena->current = chunk;
+	arena->used    = size;
+	++arena->chunks;
+	return chunk->data;
+}
+
+static common_arena_chunk_s* _take_chunk(void)
+{
+	common_arena_chunk_s* chunk = _g_cache;
+
+	if (chunk != NULL)
+	{
+		_g_cache = chunk->next;
+		--_g_cache_count;
+	}
+	else
+	{
+		chunk = malloc(common_arena_chunk_size);
+
+		if (NULL == chunk)
+		{
+			return NULL;
+		}
+
+		chunk->capacity = _chunk_capacity;
+	}
+
+	chunk->next = NULL;
+	return chunk;
+}
+
+static void _give_chunks(common_arena_chunk_s* const first, common_arena_chunk_s* const last, const uint64_t count)
+{
+	common_debug_assert(first != NULL);
+	common_debug_assert(last != NULL);
+	common_debug_assert(NULL == last->next);
+
+	last->next      = _g_cache;
+	_g_cache        = first;
+	_g_cache_count += count;
+
+	// note: the cache is bounded, so that a burst of large requests does not
+	// pin its peak memory in every thread forever.
+	while (_g_cache_count > common_arena_cache_limit)
+	{
+		common_arena_chunk_s* const chunk = _g_cache;
+		_g_cache = chunk->next;
+		--_g_cache_count;
+		free(chunk);
+	}
+}
@@ -0,0 +1,597 @@
+
+/**
+ * @file binlog.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/binlog.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define _binlog_spec_limit ((uint64_t)32)
+
+typedef enum
+{
+	_binlog_modifier_none,
+	_binlog_modifier_hh,
+	_binlog_modifier_h,
+	_binlog_modifier_l,
+	_binlog_modifier_ll,
+	_binlog_modifier_j,
+	_binlog_modifier_z,
+	_binlog_modifier_t,
+	_binlog_modifier_L,
+} _binlog_modifier_e;
+
+typedef enum
+{
+	_binlog_kind_literal,
+	_binlog_kind_percent,
+	_binlog_kind_signed,
+	_binlog_kind_unsigned,
+	_binlog_kind_character,
+	_binlog_kind_double,
+	_binlog_kind_string,
+	_binlog_kind_pointer,
+	_binlog_kind_unsupported,
+} _binlog_kind_e;
+
+/**
+ * @brief A conversion of a format: the text from the percent sign up to the
+ * length modifier, the modifier and the conversion character.
+ */
+typedef struct
+{
+	uint64_t start;
+	uint64_t modifier_start;
+	uint64_t end;
+	_binlog_modifier_e modifier;
+	_binlog_kind_e kind;
+	uint8_t stars;
+} _binlog_spec_s;
+
+static bool_t _next_spec(const char_t* const format, uint64_t* const cursor, _binlog_spec_s* const spec);
+
+static _binlog_kind_e _classify(const char_t conversion, const _binlog_modifier_e modifier);
+
+static bool_t _put_u64(uint8_t* const buffer, const uint64_t capacity, uint64_t* const offset, const uint64_t value);
+
+static bool_t _take_u64(const uint8_t* const data, const uint64_t size, uint64_t* const offset, uint64_t* const value);
+
+static void _store_u32(uint8_t* const data, const uint32_t value);
+
+static void _store_u64(uint8_t* const data, const uint64_t value);
+
+static uint32_t _load_u32(const uint8_t* const data);
+
+static uint64_t _load_u64(const uint8_t* const data);
+
+void common_binlog_encode_definition(uint8_t* const buffer, const uint32_t id, const uint32_t length)
+{
+	common_debug_assert(buffer != NULL);
+
+	buffer[0] = common_binlog_record_definition;
+	_store_u32(buffer + 1, id);
+	_store_u32(buffer + 5, length);
+}
+
+uint64_t common_binlog_encode_message(uint8_t* const buffer, const uint64_t capacity, const uint8_t level, const uint32_t id, const uint64_t timestamp, const char_t* const format, va_list args)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert(format != NULL);
+
+	if (capacity < common_binlog_message_size)
+	{
+		return 0;
+	}
+
+	uint64_t offset = common_binlog_message_size;
+	uint64_t cursor = 0;
+	_binlog_spec_s spec = {0};
+
+	while (_next_spec(format, &cursor, &spec))
+	{
+		for (uint8_t star = 0; star < spec.stars; ++star)
+		{
+			if (!_put_u64(buffer, capacity, &offset, (uint64_t)(int64_t)va_arg(args, int32_t)))
+			{
+				return 0;
+			}
+		}
+
+		if ((_binlog_kind_literal == spec.kind) || (_binlog_kind_percent == spec.kind))
+		{
+			continue;
+		}
+
+		// note: the argument of a conversion that cannot be recorded can not be
+		// skipped either, as its size is unknown, so the message is dropped
+		// rather than having every later argument recorded from the wrong place.
+		if (_binlog_kind_unsupported == spec.kind)
+		{
+			return 0;
+		}
+
+		if (_binlog_kind_string == spec.kind)
+		{
+			const char_t* string = va_arg(args, const char_t*);
+			string = (string != NULL) ? string : "(null)";
+			const uint64_t length = strnlen(string, common_binlog_string_limit);
+
+			if ((capacity - offset) < (4 + length))
+			{
+				return 0;
+			}
+
+			_store_u32(buffer + offset, (uint32_t)length);
+			(void)memcpy(buffer + offset + 4, string, length);
+			offset += 4 + length;
+			continue;
+		}
+
+		uint64_t value = 0;
+
+		// note: the arguments are fetched with the types the format promises, and
+		// narrower integers are cut down here, so that they can be widened back
+		// when printed.
+		switch (spec.kind)
+		{
+			case _binlog_kind_signed:
+			{
+				switch (spec.modifier)
+				{
+					case _binlog_modifier_hh: { value = (uint64_t)(int64_t)(signed char)va_arg(args, int32_t); } break;
+					case _binlog_modifier_h:  { value = (uint64_t)(int64_t)(int16_t)va_arg(args, int32_t);     } break;
+					case _binlog_modifier_l:  { value = (uint64_t)(int64_t)va_arg(args, long);                 } break;
+					case _binlog_modifier_ll: { value = (uint64_t)(int64_t)va_arg(args, long long);            } break;
+					case _binlog_modifier_j:  { value = (uint64_t)(int64_t)va_arg(args, intmax_t);             } break;
+					case _binlog_modifier_z:  { value = (uint64_t)va_arg(args, size_t);                        } break;
+					case _binlog_modifier_t:  { value = (uint64_t)(int64_t)va_arg(args, ptrdiff_t);            } break;
+					default:                  { value = (uint64_t)(int64_t)va_arg(args, int32_t);              } break;
+				}
+			} break;
+
+			case _binlog_kind_unsigned:
+			{
+				switch (spec.modifier)
+				{
+					case _binlog_modifier_hh: { value = (uint8_t)va_arg(args, uint32_t);            } break;
+					case _binlog_modifier_h:  { value = (uint16_t)va_arg(args, uint32_t);           } break;
+					case _binlog_modifier_l:  { value = va_arg(args, unsigned long);                } break;
+					case _binlog_modifier_ll: { value = va_arg(args, unsigned long long);           } break;
+					case _binlog_modifier_j:  { value = va_arg(args, uintmax_t);                    } break;
+					case _binlog_modifier_z:  { value = va_arg(args, size_t);                       } break;
+					case _binlog_modifier_t:  { value = (uint64_t)va_arg(args, ptrdiff_t);          } break;
+					default:                  { value = va_arg(args, uint32_t);                     } break;
+				}
+			} break;
+
+			case _binlog_kind_character:
+			{
+				value = (uint64_t)(int64_t)va_arg(args, int32_t);
+			} break;
+
+			case _binlog_kind_double:
+			{
+				const double number = (_binlog_modifier_L == spec.modifier) ? (double)va_arg(args, long double) : va_arg(args, double);
+				(void)memcpy(&value, &number, sizeof(value));
+			} break;
+
+			case _binlog_kind_pointer:
+			{
+				value = (uint64_t)(uintptr_t)va_arg(args, void*);
+			} break;
+
+			default:
+			{
+				common_debug_assert(0);  // note: should not be reached.
+			} break;
+		}
+
+		if (!_put_u64(buffer, capacity, &offset, value))
+		{
+			return 0;
+		}
+	}
+
+	buffer[0] = common_binlog_record_message;
+	buffer[1] = level;
+	_store_u32(buffer + 2, id);
+	_store_u64(buffer + 6, timestamp);
+	_store_u32(buffer + 14, (uint32_t)(offset - common_binlog_message_size));
+	return offset;
+}
+
+bool_t common_binlog_decode_record(const uint8_t* const data, const uint64_t size, common_binlog_record_s* const record, uint64_t* const consumed)
+{
+	common_debug_assert((data != NULL) || (0 == size));
+	common_debug_assert(record != NULL);
+	common_debug_assert(consumed != NULL);
+
+	*consumed = 0;
+
+	if (0 == size)
+	{
+		return true;
+	}
+
+	*record = (const common_binlog_record_s) { .kind = data[0] };
+	uint64_t header = 0;
+
+	switch (record->kind)
+	{
+		case common_binlog_record_definition:
+		{
+			if (size < common_binlog_definition_size)
+			{
+				return true;
+			}
+
+			record->id   = _load_u32(data + 1);
+			record->size = _load_u32(data + 5);
+			header       = common_binlog_definition_size;
+		} break;
+
+		case common_binlog_record_message:
+		{
+			if (size < common_binlog_message_size)
+			{
+				return true;
+			}
+
+			record->level     = data[1];
+			record->id        = _load_u32(data + 2);
+			record->timestamp = _load_u64(data + 6);
+			record->size      = _load_u32(data + 14);
+			header            = common_binlog_message_size;
+		} break;
+
+		default:
+		{
+			return false;
+		}
+	}
+
+	if (record->size > common_binlog_record_limit)
+	{
+		return false;
+	}
+
+	if ((size - header) >= record->size)
+	{
+		record->data = data + header;
+		*consumed    = header + record->size;
+	}
+
+	return true;
+}
+
+bool_t common_binlog_print(FILE* const stream, const char_t* const format, const uint8_t* const arguments, const uint64_t size)
+{
+	common_debug_assert(stream != NULL);
+	common_debug_assert(format != NULL);
+	common_debug_assert((arguments != NULL) || (0 == size));
+
+	uint64_t offset = 0;
+	uint64_t cursor = 0;
+	uint64_t printed = 0;
+	_binlog_spec_s spec = {0};
+
+	while (_next_spec(format, &cursor, &spec))
+	{
+		(void)fwrite(format + printed, 1, spec.start - printed, stream);
+		printed = spec.end;
+
+		if (_binlog_kind_percent == spec.kind)
+		{
+			(void)fputc('%', stream);
+			continue;
+		}
+
+		if (_binlog_kind_literal == spec.kind)
+		{
+			(void)fwrite(format + spec.start, 1, spec.end - spec.start, stream);
+			continue;
+		}
+
+		if (_binlog_kind_unsupported == spec.kind)
+		{
+			return false;
+		}
+
+		// note: the conversion is rebuilt with the stars replaced by the recorded
+		// widths and precisions, and with the length modifier replaced by the one
+		// matching the way the argument was recorded.
+		char_t conversion[_binlog_spec_limit * 2] = {0};
+		uint64_t length = 0;
+
+		for (uint64_t index = spec.start; index < spec.modifier_start; ++index)
+		{
+			if (format[index] != '*')
+			{
+				conversion[length++] = format[index];
+				continue;
+			}
+
+			uint64_t star = 0;
+
+			if (!_take_u64(arguments, size, &offset, &star))
+			{
+				return false;
+			}
+
+			const bool_t precision = (index > spec.start) && ('.' == format[index - 1]);
+
+			if (precision && ((int64_t)star < 0))
+			{
+				--length;
+				continue;
+			}
+
+			length += (uint64_t)snprintf(conversion + length, sizeof(conversion) - length, "%ld", (int64_t)star);
+		}
+
+		if ((_binlog_kind_signed == spec.kind) || (_binlog_kind_unsigned == spec.kind))
+		{
+			conversion[length++] = 'l';
+			conversion[length++] = 'l';
+		}
+
+		conversion[length] = format[spec.end - 1];
+
+		if (_binlog_kind_string == spec.kind)
+		{
+			if (((size - offset) < 4) || ((size - offset - 4) < _load_u32(arguments + offset)) ||
+				(_load_u32(arguments + offset) > common_binlog_string_limit))
+			{
+				return false;
+			}
+
+			char_t string[common_binlog_string_limit + 1] = {0};
+			const uint32_t string_length = _load_u32(arguments + offset);
+			(void)memcpy(string, arguments + offset + 4, string_length);
+			offset += 4 + string_length;
+			(void)fprintf(stream, conversion, string);
+			continue;
+		}
+
+		uint64_t value = 0;
+
+		if (!_take_u64(arguments, size, &offset, &value))
+		{
+			return false;
+		}
+
+		switch (spec.kind)
+		{
+			case _binlog_kind_signed:    { (void)fprintf(stream, conversion, (long long)value);          } break;
+			case _binlog_kind_unsigned:  { (void)fprintf(stream, conversion, (unsigned long long)value); } break;
+			case _binlog_kind_character: { (void)fprintf(stream, conversion, (int32_t)(int64_t)value);   } break;
+			case _binlog_kind_pointer:   { (void)fprintf(stream, conversion, (void*)(uintptr_t)value);    } break;
+
+			case _binlog_kind_double:
+			{
+				double number = 0;
+				(void)memcpy(&number, &value, sizeof(number));
+				(void)fprintf(stream, conversion, number);
+			} break;
+
+			default:
+			{
+				common_debug_assert(0);  // note: should not be reached.
+			} break;
+		}
+	}
+
+	(void)fputs(format + printed, stream);
+	return offset == size;
+}
+
+static bool_t _next_spec(const char_t* const format, uint64_t* const cursor, _binlog_spec_s* const spec)
+{
+	common_debug_assert(format != NULL);
+	common_debug_assert(cursor != NULL);
+	common_debug_assert(spec != NULL);
+
+	const char_t* const percent = strchr(format + *cursor, '%');
+
+	if (NULL == percent)
+	{
+		return false;
+	}
+
+	*spec = (const _binlog_spec_s) { .start = (uint64_t)(percent - format) };
+	uint64_t index = spec->start + 1;
+
+	while ((format[index] != '\0') && (strchr("-+ #0'I", format[index]) != NULL))
+	{
+		++index;
+	}
+
+	for (bool_t precision = false; true; precision = true)
+	{
+		if ('*' == format[index])
+		{
+			++spec->stars;
+			++index;
+		}
+		else
+		{
+			while ((format[index] >= '0') && (format[index] <= '9'))
+			{
+				++index;
+			}
+		}
+
+		if (precision || (format[index] != '.'))
+		{
+			break;
+		}
+
+		++index;
+	}
+
+	spec->modifier_start = index;
+
+	switch (format[index])
+	{
+		case 'h': { ++index; spec->modifier = _binlog_modifier_h;  if ('h' == format[index]) { ++index; spec->modifier = _binlog_modifier_hh; } } break;
+		case 'l': { ++index; spec->modifier = _binlog_modifier_l;  if ('l' == format[index]) { ++index; spec->modifier = _binlog_modifier_ll; } } break;
+		case 'q': { ++index; spec->modifier = _binlog_modifier_ll; } break;
+		case 'j': { ++index; spec->modifier = _binlog_modifier_j;  } break;
+		case 'z': { ++index; spec->modifier = _binlog_modifier_z;  } break;
+		case 'Z': { ++index; spec->modifier = _binlog_modifier_z;  } break;
+		case 't': { ++index; spec->modifier = _binlog_modifier_t;  } break;
+		case 'L': { ++index; spec->modifier = _binlog_modifier_L;  } break;
+		default:  {                                                } break;
+	}
+
+	// note: a percent sign at the very end is kept as literal text, while a
+	// conversion that cannot be recorded, such as a wide string, or one too
+	// long to be rebuilt is unsupported, as it may still consume an argument.
+	spec->kind = (format[index] != '\0') ? _classify(format[index], spec->modifier) : _binlog_kind_literal;
+	spec->end  = (format[index] != '\0') ? (index + 1) : index;
+
+	if ((spec->kind != _binlog_kind_literal) && ((spec->end - spec->start) > _binlog_spec_limit))
+	{
+		spec->kind = _binlog_kind_unsupported;
+	}
+
+	if (_binlog_kind_literal == spec->kind)
+	{
+		spec->stars = 0;
+	}
+
+	*cursor = spec->end;
+	return true;
+}
+
+static _binlog_kind_e _classify(const char_t conversion, const _binlog_modifier_e modifier)
+{
+	switch (conversion)
+	{
+		case '%':
+		{
+			return _binlog_kind_percent;
+		}
+
+		case 'd':
+		case 'i':
+		{
+			return _binlog_kind_signed;
+		}
+
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+		{
+			return _binlog_kind_unsigned;
+		}
+
+		case 'c':
+		{
+			return (_binlog_modifier_none == modifier) ? _binlog_kind_character : _binlog_kind_unsupported;
+		}
+
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			return _binlog_kind_double;
+		}
+
+		case 's':
+		{
+			return (_binlog_modifier_none == modifier) ? _binlog_kind_string : _binlog_kind_unsupported;
+		}
+
+		case 'p':
+		{
+			return _binlog_kind_pointer;
+		}
+
+		// note: the error string conversion of glibc takes no argument, and is
+		// printed as it is.
+		case 'm':
+		{
+			return _binlog_kind_literal;
+		}
+
+		default:
+		{
+			return _binlog_kind_unsupported;
+		}
+	}
+}
+
+static bool_t _put_u64(uint8_t* const buffer, const uint64_t capacity, uint64_t* const offset, const uint64_t value)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert(offset != NULL);
+
+	if ((capacity - *offset) < 8)
+	{
+		return false;
+	}
+
+	_store_u64(buffer + *offset, value);
+	*offset += 8;
+	return true;
+}
+
+static bool_t _take_u64(const uint8_t* const data, const uint64_t size, uint64_t* const offset, uint64_t* const value)
+{
+	common_debug_assert(offset != NULL);
+	common_debug_assert(value != NULL);
+
+	if ((size - *offset) < 8)
+	{
+		return false;
+	}
+
+	*value   = _load_u64(data + *offset);
+	*offset += 8;
+	return true;
+}
+
+static void _store_u32(uint8_t* const data, const uint32_t value)
+{
+	common_debug_assert(data != NULL);
+	data[0] = (uint8_t)(value);
+	data[1] = (uint8_t)(value >> 8);
+	data[2] = (uint8_t)(value >> 16);
+	data[3] = (uint8_t)(value >> 24);
+}
+
+static void _store_u64(uint8_t* const data, const uint64_t value)
+{
+	common_debug_assert(data != NULL);
+	_store_u32(data, (uint32_t)value);
+	_store_u32(data + 4, (uint32_t)(value >> 32));
+}
+
+static uint32_t _load_u32(const uint8_t* const data)
+{
+	common_debug_assert(data != NULL);
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint64_t _load_u64(const uint8_t* const data)
+{
+	common_debug_assert(data != NULL);
+	return (uint64_t)_load_u32(data) | ((uint64_t)_load_u32(data + 4) << 32);
+}
@@ -0,0 +1,164 @@
+
+/**
+ * @file histogram.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/histogram.h"
+
+#include <string.h>
+
+static uint64_t _bucket_of(const uint64_t value);
+
+static uint64_t _highest_of(const uint64_t bucket);
+
+static void _bump(uint64_t* const counter, const uint64_t amount);
+
+void common_histogram_create(common_histogram_s* const histogram)
+{
+	common_debug_assert(histogram != NULL);
+
+	(void)memset(histogram, 0, sizeof(*histogram));
+	histogram->min = UINT64_MAX;
+}
+
+void common_histogram_record(common_histogram_s* const histogram, const uint64_t value)
+{
+	common_debug_assert(histogram != NULL);
+
+	// note: with a single writer a relaxed load and store make an increment
+	// that a concurrent snapshot never sees torn, without the locked
+	// instruction an atomic add would take.
+	_bump(&histogram->buckets[_bucket_of(value)], 1);
+	_bump(&histogram->count, 1);
+	_bump(&histogram->sum, value);
+
+	if (value < __atomic_load_n(&histogram->min, __ATOMIC_RELAXED))
+	{
+		__atomic_store_n(&histogram->min, value, __ATOMIC_RELAXED);
+	}
+
+	if (value > __atomic_load_n(&histogram->max, __ATOMIC_RELAXED))
+	{
+		__atomic_store_n(&histogram->max, value, __ATOMIC_RELAXED);
+	}
+}
+
+void common_histogram_snapshot(const common_histogram_s* const histogram, common_histogram_s* const snapshot)
+{
+	common_debug_assert(histogram != NULL);
+	common_debug_assert(snapshot != NULL);
+
+	snapshot->count = 0;
+	snapshot->sum   = __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED);
+	snapshot->min   = __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+	snapshot->max   = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+
+	for (uint64_t index = 0; index < common_histogram_buckets_count; ++index)
+	{
+		snapshot->buckets[index] = __atomic_load_n(&histogram->buckets[index], __ATOMIC_RELAXED);
+		snapshot->count += snapshot->buckets[index];
+	}
+}
+
+void common_histogram_merge(common_histogram_s* const target, const common_histogram_s* const source)
+{
+	common_debug_assert(target != NULL);
+	common_debug_assert(source != NULL);
+
+	target->count += source->count;
+	target->sum   += source->sum;
+	target->min    = (source->min < target->min) ? source->min : target->min;
+	target->max    = (source->max > target->max) ? source->max : target->max;
+
+	for (uint64_t index = 0; index < common_histogram_buckets_count; ++index)
+	{
+		target->buckets[index] += source->buckets[index];
+	}
+}
+
+uint64_t common_histogram_percentile(const common_histogram_s* const histogram, const double percentile)
+{
+	common_debug_assert(histogram != NULL);
+	common_debug_assert((percentile > 0) && (percentile <= 100));
+
+	if (0 == histogram->count)
+	{
+		return 0;
+	}
+
+	const double exact = (percentile / 100.0) * (double)histogram->count;
+	uint64_t rank = (uint64_t)exact;
+	rank += ((double)rank < exact) ? 1 : 0;
+	rank  = (rank > 0) ? rank : 1;
+
+	uint64_t seen = 0;
+
+	for (uint64_t index = 0; index < common_histogram_buckets_count; ++index)
+	{
+		seen += histogram->buckets[index];
+
+		if (seen >= rank)
+		{
+			const uint64_t highest = _highest_of(index);
+			return (highest < histogram->max) ? highest : histogram->max;
+		}
+	}
+
+	return histogram->max;
+}
+
+double common_histogram_mean(const common_histogram_s* const histogram)
+{
+	common_debug_assert(histogram != NULL);
+
+	if (0 == histogram->count)
+	{
+		return 0;
+	}
+
+	return (double)histogram->sum / (double)histogram->count;
+}
+
+static uint64_t _bucket_of(const uint64_t value)
+{
+	if (value < (common_histogram_half_count * 2))
+	{
+		return value;
+	}
+
+	// note: the value is cut down to its leading precision bits, whose upper
+	// half picks the bucket within the power of two the shift stands for.
+	const uint64_t shift = (uint64_t)(63 - __builtin_clzll(value)) - (common_histogram_precision_bits - 1);
+	return (shift * common_histogram_half_count) + (value >> shift);
+}
+
+static uint64_t _highest_of(const uint64_t bucket)
+{
+	common_debug_assert(bucket < common_histogram_buckets_count);
+
+	if (bucket < (common_histogram_half_count * 2))
+	{
+		return bucket;
+	}
+
+	const uint64_t shift = (bucket / common_histogram_half_count) - 1;
+	const uint64_t sub   = bucket - (shift * common_histogram_half_count);
+
+	// note: the top bucket ends at the top of the range, which the shift
+	// wraps around to.
+	return ((sub + 1) << shift) - 1;
+}
+
+static void _bump(uint64_t* const counter, const uint64_t amount)
+{
+	common_debug_assert(counter != NULL);
+	__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
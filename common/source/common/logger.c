@@ -12,72 +12,585 @@
 
 #include "common/debug.h"
 #include "common/logger.h"
+#include "common/binlog.h"
+
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
+
+#define _logger_message_size   ((uint64_t)512)
+#define _logger_ring_capacity  ((uint64_t)256)
+#define _logger_flush_batch    ((uint64_t)64)
+#define _logger_flush_interval ((int32_t)20)
+#define _logger_cache_line     ((uint64_t)64)
+#define _logger_format_capacity ((uint64_t)4096)
+
+/**
+ * @brief A message, either formatted or, in binary mode, recorded along with
+ * the format it has to be formatted with.
+ */
+typedef struct
+{
+	uint32_t size;
+	int32_t fd;
+	const char_t* format;
+	uint32_t id;
+	char_t text[_logger_message_size];
+} _logger_slot_s;
+
+/**
+ * @brief Single-producer single-consumer ring of formatted messages, owned by
+ * the thread that logs into it and drained by the flusher thread.
+ */
+typedef struct _logger_ring_s
+{
+	_Alignas(_logger_cache_line) struct _logger_ring_s* next;
+	bool_t owned;
+
+	_Alignas(_logger_cache_line) uint64_t head;
+
+	_Alignas(_logger_cache_line) uint64_t tail;
+	uint64_t head_cache;
+	uint64_t dropped;
+
+	_logger_slot_s slots[_logger_ring_capacity];
+} _logger_ring_s;
+
+uint32_t _common_logger_mask = common_logger_mask_levels | common_logger_mask_categories;
+
+static _logger_ring_s* _g_rings = NULL;
+static bool_t _g_running = false;
+static uint64_t _g_generation = 0;
+static int32_t _g_wakeup_fd = -1;
+static int32_t _g_binary_fd = -1;
+static pthread_t _g_flusher;
+static pthread_key_t _g_ring_key;
+static bool_t _g_ring_key_created = false;
+
+// note: in binary mode a format is identified by its slot in this table, which
+// is filled in as formats are first used. only the flusher keeps track of the
+// formats already defined in the binary log.
+static const char_t* _g_formats[_logger_format_capacity] = {0};
+static bool_t _g_formats_defined[_logger_format_capacity] = {0};
+
+static _Thread_local _logger_ring_s* _g_ring = NULL;
+static _Thread_local uint64_t _g_ring_generation = 0;
+
+static void _log_with_level(const common_logger_level_e level, const char_t* const format, va_list args);
+
+static uint32_t _register_format(const char_t* const format);
+
+static _logger_ring_s* _acquire_ring(void);
+
+static void _release_ring(void* const value);
+
+static void _wake_flusher(void);
+
+static void* _flusher_main(void* const argument);
+
+static void _flush_rings(void);
+
+static void _write_all(const int32_t fd, struct iovec* iovecs, uint64_t count);
 
-static void _log_with_tag(FILE* const stream, const char_t* const tag, const char_t* const format, va_list args);
+bool_t common_logger_start(void)
+{
+	if (__atomic_load_n(&_g_running, __ATOMIC_ACQUIRE))
+	{
+		return true;
+	}
+
+	if (!_g_ring_key_created)
+	{
+		if (pthread_key_create(&_g_ring_key, _release_ring) != 0)
+		{
+			common_logger_error("failed to create the logger ring key.");
+			return false;
+		}
+
+		_g_ring_key_created = true;
+	}
+
+	_g_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (_g_wakeup_fd < 0)
+	{
+		common_logger_error("failed to create the logger wakeup eventfd: %s.", strerror(errno));
+		return false;
+	}
+
+	// note: the flusher writes to the descriptors directly, so whatever is still
+	// buffered by stdio has to go out first to keep the messages in order.
+	(void)fflush(stdout);
+	(void)fflush(stderr);
+
+	(void)__atomic_fetch_add(&_g_generation, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&_g_running, true, __ATOMIC_RELEASE);
+
+	if (pthread_create(&_g_flusher, NULL, _flusher_main, NULL) != 0)
+	{
+		__atomic_store_n(&_g_running, false, __ATOMIC_RELEASE);
+		(void)close(_g_wakeup_fd);
+		_g_wakeup_fd = -1;
+		common_logger_error("failed to spawn the logger flusher thread.");
+		return false;
+	}
+
+	return true;
+}
+
+bool_t common_logger_start_binary(const char_t* const path)
+{
+	common_debug_assert(path != NULL);
+
+	if (__atomic_load_n(&_g_running, __ATOMIC_ACQUIRE))
+	{
+		return false;
+	}
+
+	_g_binary_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (_g_binary_fd < 0)
+	{
+		common_logger_error("failed to open the binary log %s: %s.", path, strerror(errno));
+		return false;
+	}
+
+	if (write(_g_binary_fd, common_binlog_magic, common_binlog_magic_size) != (int64_t)common_binlog_magic_size)
+	{
+		common_logger_error("failed to write to the binary log %s: %s.", path, strerror(errno));
+		goto common_logger_start_binary_failed;
+	}
+
+	(void)memset(_g_formats_defined, 0, sizeof(_g_formats_defined));
+
+	if (!common_logger_start())
+	{
+		goto common_logger_start_binary_failed;
+	}
+
+	return true;
+
+common_logger_start_binary_failed:
+	(void)close(_g_binary_fd);
+	_g_binary_fd = -1;
+	return false;
+}
+
+void common_logger_stop(void)
+{
+	if (!__atomic_load_n(&_g_running, __ATOMIC_ACQUIRE))
+	{
+		return;
+	}
+
+	__atomic_store_n(&_g_running, false, __ATOMIC_RELEASE);
+	_wake_flusher();
+	(void)pthread_join(_g_flusher, NULL);
+
+	_logger_ring_s* ring = __atomic_exchange_n(&_g_rings, NULL, __ATOMIC_ACQUIRE);
+
+	while (ring != NULL)
+	{
+		_logger_ring_s* const next = ring->next;
+		free(ring);
+		ring = next;
+	}
+
+	// note: threads that are still alive keep pointing to their freed rings, so
+	// the generation is bumped to make them pick up fresh ones next time.
+	(void)__atomic_fetch_add(&_g_generation, 1, __ATOMIC_RELAXED);
+	(void)close(_g_wakeup_fd);
+	_g_wakeup_fd = -1;
+
+	if (_g_binary_fd >= 0)
+	{
+		(void)close(_g_binary_fd);
+		_g_binary_fd = -1;
+	}
+}
+
+void common_logger_set_level(const common_logger_level_e level)
+{
+	// note: the mask bits of the levels below the given one.
+	const uint32_t below = common_logger_mask_level(level) - 1;
+	uint32_t mask = __atomic_load_n(&_common_logger_mask, __ATOMIC_RELAXED);
+
+	while (!__atomic_compare_exchange_n(&_common_logger_mask, &mask, (mask | common_logger_mask_levels) & ~below, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+	}
+}
+
+void common_logger_set_category(const common_logger_category_e category, const bool_t enabled)
+{
+	if (enabled)
+	{
+		(void)__atomic_fetch_or(&_common_logger_mask, common_logger_mask_category(category), __ATOMIC_RELAXED);
+	}
+	else
+	{
+		(void)__atomic_fetch_and(&_common_logger_mask, ~common_logger_mask_category(category), __ATOMIC_RELAXED);
+	}
+}
+
+const char_t* common_logger_level_to_tag(const common_logger_level_e level)
+{
+	switch (level)
+	{
+		case common_logger_level_debug: { return common_blue "debug" common_reset;  }
+		case common_logger_level_info:  { return common_green "info" common_reset;  }
+		case common_logger_level_note:  { return common_cyan "note" common_reset;   }
+		case common_logger_level_warn:  { return common_yellow "warn" common_reset; }
+		case common_logger_level_error: { return common_red "error" common_reset;   }
+		default:                        { return NULL;                              }
+	}
+}
 
 void common_logger_log(const char_t* const format, ...)
 {
 	common_debug_assert(format != NULL);
 	va_list args; va_start(args, format);
-	_log_with_tag(stdout, NULL, format, args);
+	_log_with_level(common_logger_level_log, format, args);
 	va_end(args);
 }
 
-#ifndef NDEBUG
-void _common_logger_debug_impl(const char_t* const format, ...)
+void _common_logger_impl(const common_logger_level_e level, const char_t* const format, ...)
 {
 	common_debug_assert(format != NULL);
 	va_list args; va_start(args, format);
-	_log_with_tag(stdout, common_blue "debug" common_reset, format, args);
+	_log_with_level(level, format, args);
 	va_end(args);
 }
-#endif
 
-void common_logger_info(const char_t* const format, ...)
+static void _log_with_level(const common_logger_level_e level, const char_t* const format, va_list args)
 {
 	common_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	_log_with_tag(stdout, common_green "info" common_reset, format, args);
-	va_end(args);
+
+	FILE* const stream = (level >= common_logger_level_warn) ? stderr : stdout;
+	const char_t* const tag = common_logger_level_to_tag(level);
+	_logger_ring_s* const ring = __atomic_load_n(&_g_running, __ATOMIC_ACQUIRE) ? _acquire_ring() : NULL;
+
+	if (NULL == ring)
+	{
+		if (tag != NULL)
+		{
+			(void)fprintf(stream, "%s: ", tag);
+		}
+
+		(void)vfprintf(stream, format, args);
+		(void)fprintf(stream, "\n");
+		return;
+	}
+
+	// note: only this thread ever moves the tail, so it is read without any
+	// ordering, while the head is re-read from the flusher only when the cached
+	// copy says the ring is full.
+	const uint64_t tail = ring->tail;
+
+	if ((tail - ring->head_cache) >= _logger_ring_capacity)
+	{
+		ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+		if ((tail - ring->head_cache) >= _logger_ring_capacity)
+		{
+			(void)__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	}
+
+	_logger_slot_s* const slot = &ring->slots[tail & (_logger_ring_capacity - 1)];
+
+	if (_g_binary_fd >= 0)
+	{
+		struct timespec now = {0};
+		(void)clock_gettime(CLOCK_REALTIME, &now);
+
+		const uint32_t id = _register_format(format);
+		const uint64_t timestamp = ((uint64_t)now.tv_sec * 1000000000) + (uint64_t)now.tv_nsec;
+		const uint64_t size = (id != common_binlog_none) ? common_binlog_encode_message((uint8_t*)slot->text, _logger_message_size, (uint8_t)level, id, timestamp, format, args) : 0;
+
+		if (0 == size)
+		{
+			(void)__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+
+		slot->size   = (uint32_t)size;
+		slot->fd     = _g_binary_fd;
+		slot->format = format;
+		slot->id     = id;
+		__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+		if ((level >= common_logger_level_warn) || ((tail + 1 - ring->head_cache) == (_logger_ring_capacity / 2)))
+		{
+			_wake_flusher();
+		}
+
+		return;
+	}
+
+	int32_t length = 0;
+
+	if (tag != NULL)
+	{
+		length = snprintf(slot->text, _logger_message_size, "%s: ", tag);
+	}
+
+	const int32_t written = vsnprintf(slot->text + length, _logger_message_size - (uint64_t)length, format, args);
+	length += (written > 0) ? written : 0;
+
+	// note: messages that do not fit into a slot are truncated, and the newline
+	// takes the place of the terminator, which the flusher does not need.
+	if ((uint64_t)length > (_logger_message_size - 1))
+	{
+		length = (int32_t)(_logger_message_size - 1);
+	}
+
+	slot->text[length] = '\n';
+	slot->size         = (uint32_t)length + 1;
+	slot->fd           = fileno(stream);
+	slot->format       = NULL;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+	// note: the flusher wakes up on its own every few milliseconds. it is only
+	// woken up early for warnings and errors, and when the ring is half full,
+	// so that a burst does not overrun it in between.
+	if ((stream == stderr) || ((tail + 1 - ring->head_cache) == (_logger_ring_capacity / 2)))
+	{
+		_wake_flusher();
+	}
 }
 
-void common_logger_note(const char_t* const format, ...)
+static uint32_t _register_format(const char_t* const format)
 {
 	common_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	_log_with_tag(stdout, common_cyan "note" common_reset, format, args);
-	va_end(args);
+
+	// note: formats are string literals, so they are told apart by address. the
+	// table is open-addressed and only ever grows, so a lookup of a known format
+	// is a few loads without any writes.
+	uint64_t index = ((uint64_t)(uintptr_t)format * UINT64_C(0x9e3779b97f4a7c15)) >> 52;
+
+	for (uint64_t probe = 0; probe < _logger_format_capacity; ++probe, index = (index + 1) & (_logger_format_capacity - 1))
+	{
+		const char_t* current = __atomic_load_n(&_g_formats[index], __ATOMIC_ACQUIRE);
+
+		if (NULL == current)
+		{
+			if (__atomic_compare_exchange_n(&_g_formats[index], &current, format, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			{
+				return (uint32_t)index;
+			}
+		}
+
+		if (current == format)
+		{
+			return (uint32_t)index;
+		}
+	}
+
+	return common_binlog_none;
 }
 
-void common_logger_warn(const char_t* const format, ...)
+static _logger_ring_s* _acquire_ring(void)
 {
-	common_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	_log_with_tag(stderr, common_yellow "warn" common_reset, format, args);
-	va_end(args);
+	const uint64_t generation = __atomic_load_n(&_g_generation, __ATOMIC_RELAXED);
+
+	if ((_g_ring != NULL) && (generation == _g_ring_generation))
+	{
+		return _g_ring;
+	}
+
+	_logger_ring_s* ring = __atomic_load_n(&_g_rings, __ATOMIC_ACQUIRE);
+
+	// note: the rings of exited threads are adopted by new ones, which carry on
+	// from where their previous owners stopped.
+	for (; ring != NULL; ring = ring->next)
+	{
+		bool_t owned = false;
+
+		if (__atomic_compare_exchange_n(&ring->owned, &owned, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+			break;
+		}
+	}
+
+	if (NULL == ring)
+	{
+		ring = aligned_alloc(_logger_cache_line, sizeof(*ring));
+
+		if (NULL == ring)
+		{
+			return NULL;
+		}
+
+		(void)memset(ring, 0, sizeof(*ring));
+		ring->owned = true;
+		ring->next  = __atomic_load_n(&_g_rings, __ATOMIC_RELAXED);
+
+		while (!__atomic_compare_exchange_n(&_g_rings, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		{
+		}
+	}
+
+	_g_ring            = ring;
+	_g_ring_generation = generation;
+	(void)pthread_setspecific(_g_ring_key, ring);
+	return ring;
 }
 
-void common_logger_error(const char_t* const format, ...)
+static void _release_ring(void* const value)
 {
-	common_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	_log_with_tag(stderr, common_red "error" common_reset, format, args);
-	va_end(args);
+	(void)value;
+
+	// note: the value may point to a ring freed by a stop in the meantime, so
+	// the thread's own copy is used once its generation has been checked.
+	if ((_g_ring != NULL) && (_g_ring_generation == __atomic_load_n(&_g_generation, __ATOMIC_RELAXED)))
+	{
+		__atomic_store_n(&_g_ring->owned, false, __ATOMIC_RELEASE);
+	}
+
+	_g_ring = NULL;
 }
 
-static void _log_with_tag(FILE* const stream, const char_t* const tag, const char_t* const format, va_list args)
+static void _wake_flusher(void)
 {
-	common_debug_assert(stream != NULL);
-	common_debug_assert(format != NULL);
+	const uint64_t value = 1;
+	(void)!write(_g_wakeup_fd, &value, sizeof(value));
+}
 
-	if (tag != NULL)
+static void* _flusher_main(void* const argument)
+{
+	(void)argument;
+
+	struct pollfd wakeup =
+	{
+		.fd     = _g_wakeup_fd,
+		.events = POLLIN,
+	};
+
+	while (true)
 	{
-		(void)fprintf(stream, "%s: ", tag);
+		(void)poll(&wakeup, 1, _logger_flush_interval);
+
+		uint64_t value = 0;
+		(void)!read(_g_wakeup_fd, &value, sizeof(value));
+
+		// note: the logging threads are done by the time the logger is stopped,
+		// so one more pass after noticing it drains everything they left behind.
+		const bool_t running = __atomic_load_n(&_g_running, __ATOMIC_ACQUIRE);
+		_flush_rings();
+
+		if (!running)
+		{
+			break;
+		}
 	}
 
-	(void)vfprintf(stream, format, args);
-	(void)fprintf(stream, "\n");
+	return NULL;
+}
+
+static void _flush_rings(void)
+{
+	struct iovec iovecs[_logger_flush_batch * 3];
+	uint8_t definitions[_logger_flush_batch][common_binlog_definition_size];
+	uint64_t dropped = 0;
+
+	for (_logger_ring_s* ring = __atomic_load_n(&_g_rings, __ATOMIC_ACQUIRE); ring != NULL; ring = ring->next)
+	{
+		uint64_t head = ring->head;
+		const uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+		while (head < tail)
+		{
+			// note: a batch ends where the stream changes, so that messages of the
+			// same ring keep their order on each of the streams.
+			const int32_t fd = ring->slots[head & (_logger_ring_capacity - 1)].fd;
+			uint64_t count = 0;
+			uint64_t iovecs_count = 0;
+
+			for (; ((head + count) < tail) && (count < _logger_flush_batch); ++count)
+			{
+				_logger_slot_s* const slot = &ring->slots[(head + count) & (_logger_ring_capacity - 1)];
+
+				if (slot->fd != fd)
+				{
+					break;
+				}
+
+				// note: the flusher is the only writer of the binary log, so defining
+				// a format right before its first message keeps the log decodable no
+				// matter which thread used the format first.
+				if ((slot->format != NULL) && !_g_formats_defined[slot->id])
+				{
+					const uint64_t length = strlen(slot->format);
+					common_binlog_encode_definition(definitions[count], slot->id, (uint32_t)length);
+					iovecs[iovecs_count++] = (const struct iovec) { .iov_base = definitions[count],   .iov_len = common_binlog_definition_size };
+					iovecs[iovecs_count++] = (const struct iovec) { .iov_base = (char_t*)slot->format, .iov_len = length                        };
+					_g_formats_defined[slot->id] = true;
+				}
+
+				iovecs[iovecs_count++] = (const struct iovec)
+				{
+					.iov_base = slot->text,
+					.iov_len  = slot->size,
+				};
+			}
+
+			_write_all(fd, iovecs, iovecs_count);
+			head += count;
+			__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+		}
+
+		dropped += __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+	}
+
+	if (dropped > 0)
+	{
+		char_t text[128] = {0};
+		const int32_t length = snprintf(text, sizeof(text), common_yellow "warn" common_reset ": logger dropped %lu messages.\n", dropped);
+		struct iovec iovec = { .iov_base = text, .iov_len = (uint64_t)length };
+		_write_all(STDERR_FILENO, &iovec, 1);
+	}
+}
+
+static void _write_all(const int32_t fd, struct iovec* iovecs, uint64_t count)
+{
+	common_debug_assert((iovecs != NULL) || (0 == count));
+
+	while (count > 0)
+	{
+		int64_t written = writev(fd, iovecs, (int32_t)count);
+
+		if (written < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			return;
+		}
+
+		while ((count > 0) && ((uint64_t)written >= iovecs->iov_len))
+		{
+			written -= (int64_t)iovecs->iov_len;
+			++iovecs;
+			--count;
+		}
+
+		if (count > 0)
+		{
+			iovecs->iov_base  = (uint8_t*)iovecs->iov_base + written;
+			iovecs->iov_len  -= (uint64_t)written;
+		}
+	}
 }
@@ -0,0 +1,240 @@
+
+/**
+ * @file pool.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_runtime
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/pool.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// note: the address of a thread-local variable identifies the calling thread
+// without a system call.
+static _Thread_local uint8_t _g_thread_token = 0;
+
+static void _push_local(common_pool_s* const pool, common_pool_buffer_s* const buffer);
+
+static void _push_remote(common_pool_s* const pool, common_pool_buffer_s* const buffer);
+
+static void _drain_remote(common_pool_s* const pool);
+
+bool_t common_pool_create(common_pool_s* const pool, const uint32_t count, const uint64_t buffer_size)
+{
+	common_debug_assert(pool != NULL);
+	common_debug_assert(count > 0);
+	common_debug_assert(count < common_pool_none);
+	common_debug_assert(buffer_size > 0);
+
+	(void)memset(pool, 0, sizeof(*pool));
+
+	const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+	pool->buffer_size = (buffer_size + page_size - 1) & ~(page_size - 1);
+	pool->region_size = pool->buffer_size * count;
+	pool->count       = count;
+	pool->region      = mmap(NULL, pool->region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	if (MAP_FAILED == pool->region)
+	{
+		common_logger_error("failed to map %u pooled buffers: %s.", count, strerror(errno));
+		pool->region = NULL;
+		return false;
+	}
+
+	pool->buffers = calloc(count, sizeof(*pool->buffers));
+
+	if (NULL == pool->buffers)
+	{
+		common_logger_error("failed to allocate %u pooled buffer descriptors.", count);
+		common_pool_destroy(pool);
+		return false;
+	}
+
+	pool->free_head   = common_pool_none;
+	pool->remote_head = common_pool_none;
+	pool->owner       = &_g_thread_token;
+
+	for (uint32_t index = count; index > 0; --index)
+	{
+		common_pool_buffer_s* const buffer = &pool->buffers[index - 1];
+		buffer->pool  = pool;
+		buffer->index = index - 1;
+		_push_local(pool, buffer);
+	}
+
+	return true;
+}
+
+void common_pool_destroy(common_pool_s* const pool)
+{
+	common_debug_assert(pool != NULL);
+
+	if (pool->region != NULL)
+	{
+		(void)munmap(pool->region, pool->region_size);
+	}
+
+	free(pool->buffers);
+	(void)memset(pool, 0, sizeof(*pool));
+}
+
+void common_pool_adopt(common_pool_s* const pool)
+{
+	common_debug_assert(pool != NULL);
+	pool->owner = &_g_thread_token;
+}
+
+common_pool_buffer_s* common_pool_acquire(common_pool_s* const pool)
+{
+	common_debug_assert(pool != NULL);
+	common_debug_assert(pool->owner == &_g_thread_token);
+
+	if (common_pool_none == pool->free_head)
+	{
+		_drain_remote(pool);
+
+		if (common_pool_none == pool->free_head)
+		{
+			return NULL;
+		}
+	}
+
+	common_pool_buffer_s* const buffer = &pool->buffers[pool->free_head];
+	pool->free_head = buffer->next;
+	--pool->free_count;
+
+	buffer->next = common_pool_none;
+	__atomic_store_n(&buffer->references, 1, __ATOMIC_RELAXED);
+	return buffer;
+}
+
+uint8_t* common_pool_data(const common_pool_buffer_s* const buffer)
+{
+	common_debug_assert(buffer != NULL);
+	return buffer->pool->region + (uint64_t)buffer->index * buffer->pool->buffer_size;
+}
+
+void common_pool_retain(common_pool_buffer_s* const buffer)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert(__atomic_load_n(&buffer->references, __ATOMIC_RELAXED) > 0);
+	(void)__atomic_add_fetch(&buffer->references, 1, __ATOMIC_RELAXED);
+}
+
+void common_pool_release(common_pool_buffer_s* const buffer)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert(__atomic_load_n(&buffer->references, __ATOMIC_RELAXED) > 0);
+
+	if (__atomic_sub_fetch(&buffer->references, 1, __ATOMIC_ACQ_REL) > 0)
+	{
+		return;
+	}
+
+	common_pool_s* const pool = buffer->pool;
+
+	if (pool->owner == &_g_thread_token)
+	{
+		_push_local(pool, buffer);
+	}
+	else
+	{
+		_push_remote(pool, buffer);
+	}
+}
+
+common_pool_slice_s common_pool_slice(common_pool_buffer_s* const buffer, const uint64_t offset, const uint64_t size)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert((offset + size) <= buffer->pool->buffer_size);
+
+	common_pool_retain(buffer);
+
+	return (const common_pool_slice_s)
+	{
+		.buffer = buffer,
+		.data   = common_pool_data(buffer) + offset,
+		.size   = size,
+	};
+}
+
+void common_pool_slice_release(common_pool_slice_s* const slice)
+{
+	common_debug_assert(slice != NULL);
+
+	if (slice->buffer != NULL)
+	{
+		common_pool_release(slice->buffer);
+	}
+
+	*slice = (const common_pool_slice_s) {0};
+}
+
+void common_pool_iovecs(const common_pool_s* const pool, struct iovec* const iovecs)
+{
+	common_debug_assert(pool != NULL);
+	common_debug_assert(iovecs != NULL);
+
+	for (uint32_t index = 0; index < pool->count; ++index)
+	{
+		iovecs[index] = (const struct iovec)
+		{
+			.iov_base = pool->region + (uint64_t)index * pool->buffer_size,
+			.iov_len  = pool->buffer_size,
+		};
+	}
+}
+
+static void _push_local(common_pool_s* const pool, common_pool_buffer_s* const buffer)
+{
+	common_debug_assert(pool != NULL);
+	common_debug_assert(buffer != NULL);
+
+	buffer->next    = pool->free_head;
+	pool->free_head = buffer->index;
+	++pool->free_count;
+}
+
+static void _push_remote(common_pool_s* const pool, common_pool_buffer_s* const buffer)
+{
+	common_debug_assert(pool != NULL);
+	common_debug_assert(buffer != NULL);
+
+	// note: only the owner takes buffers off the return list, and it takes the
+	// whole list at once, so a plain compare-and-swap push is free of ABA.
+	uint32_t head = __atomic_load_n(&pool->remote_head, __ATOMIC_RELAXED);
+
+	do
+	{
+		buffer->next = head;
+	}
+	while (!__atomic_compare_exchange_n(&pool->remote_head, &head, buffer->index, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static void _drain_remote(common_pool_s* const pool)
+{
+	common_debug_assert(pool != NULL);
+
+	uint32_t head = __atomic_exchange_n(&pool->remote_head, common_pool_none, __ATOMIC_ACQUIRE);
+
+	while (head != common_pool_none)
+	{
+		common_pool_buffer_s* const buffer = &pool->buffers[head];
+		head = buffer->next;
+		_push_local(pool, buffer);
+	}
+}
@@ -0,0 +1,359 @@
+
+/**
+ * @file protocol.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/protocol.h"
+
+static uint16_t _load_u16(const uint8_t* const data);
+
+static uint32_t _load_u32(const uint8_t* const data);
+
+static uint64_t _load_u64(const uint8_t* const data);
+
+static void _store_u16(uint8_t* const data, const uint16_t value);
+
+static void _store_u32(uint8_t* const data, const uint32_t value);
+
+static void _store_u64(uint8_t* const data, const uint64_t value);
+
+static bool_t _is_streamed(const uint8_t type);
+
+void common_protocol_encode_header(uint8_t* const buffer, const common_protocol_header_s* const header)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert(header != NULL);
+
+	buffer[0] = header->type;
+	buffer[1] = header->flags;
+	_store_u16(buffer + 2, 0);
+	_store_u32(buffer + 4, header->stream_id);
+	_store_u32(buffer + 8, header->length);
+}
+
+common_protocol_status_e common_protocol_decode_header(const uint8_t* const data, const uint64_t size, common_protocol_header_s* const header)
+{
+	common_debug_assert((data != NULL) || (0 == size));
+	common_debug_assert(header != NULL);
+
+	if (size < common_protocol_header_size)
+	{
+		return common_protocol_status_incomplete;
+	}
+
+	*header = (const common_protocol_header_s)
+	{
+		.type      = data[0],
+		.flags     = data[1],
+		.stream_id = _load_u32(data + 4),
+		.length    = _load_u32(data + 8),
+	};
+
+	if ((header->type < common_protocol_frame_request) || (header->type > common_protocol_frame_subscribe) ||
+		((header->flags & ~common_protocol_flag_end) != 0) || (_load_u16(data + 2) != 0))
+	{
+		return common_protocol_status_invalid;
+	}
+
+	if (!_is_streamed(header->type) && (header->length > common_protocol_control_limit))
+	{
+		return common_protocol_status_invalid;
+	}
+
+	return common_protocol_status_complete;
+}
+
+common_protocol_status_e common_protocol_parse_frame(const uint8_t* const data, const uint64_t size, common_protocol_frame_s* const frame, uint64_t* const consumed)
+{
+	common_debug_assert(frame != NULL);
+	common_debug_assert(consumed != NULL);
+
+	*consumed = 0;
+	const common_protocol_status_e status = common_protocol_decode_header(data, size, &frame->header);
+
+	if (status != common_protocol_status_complete)
+	{
+		return status;
+	}
+
+	if ((size - common_protocol_header_size) < frame->header.length)
+	{
+		return common_protocol_status_incomplete;
+	}
+
+	frame->payload = data + common_protocol_header_size;
+	*consumed      = common_protocol_header_size + frame->header.length;
+	return common_protocol_status_complete;
+}
+
+void common_protocol_reader_reset(common_protocol_reader_s* const reader)
+{
+	common_debug_assert(reader != NULL);
+	*reader = (const common_protocol_reader_s) {0};
+}
+
+common_protocol_status_e common_protocol_reader_feed(common_protocol_reader_s* const reader, const uint8_t* const data, const uint64_t size, common_protocol_chunk_s* const chunk, uint64_t* const consumed)
+{
+	common_debug_assert(reader != NULL);
+	common_debug_assert(chunk != NULL);
+	common_debug_assert(consumed != NULL);
+
+	*consumed = 0;
+
+	if (!reader->active)
+	{
+		const common_protocol_status_e status = common_protocol_decode_header(data, size, &reader->header);
+
+		if (status != common_protocol_status_complete)
+		{
+			return status;
+		}
+
+		// note: control frames are small and bounded, so they are handed out in
+		// one piece and left unconsumed until they have been fully received.
+		if (!_is_streamed(reader->header.type) && ((size - common_protocol_header_size) < reader->header.length))
+		{
+			return common_protocol_status_incomplete;
+		}
+
+		reader->remaining = reader->header.length;
+		reader->active    = true;
+		*consumed         = common_protocol_header_size;
+	}
+
+	const uint64_t available = size - *consumed;
+	const uint64_t taken     = (available < reader->remaining) ? available : reader->remaining;
+
+	if ((0 == taken) && (reader->remaining > 0))
+	{
+		return common_protocol_status_incomplete;
+	}
+
+	*chunk = (const common_protocol_chunk_s)
+	{
+		.header = reader->header,
+		.data   = data + *consumed,
+		.size   = taken,
+		.offset = reader->header.length - reader->remaining,
+		.last   = taken == reader->remaining,
+	};
+
+	reader->remaining -= taken;
+	reader->active     = reader->remaining > 0;
+	*consumed         += taken;
+	return common_protocol_status_complete;
+}
+
+void common_protocol_encode_request(uint8_t* const buffer, const uint32_t stream_id, const common_protocol_request_s* const request)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert(request != NULL);
+
+	const common_protocol_header_s header =
+	{
+		.type      = common_protocol_frame_request,
+		.flags     = common_protocol_flag_end,
+		.stream_id = stream_id,
+		.length    = (uint32_t)common_protocol_request_size,
+	};
+
+	common_protocol_encode_header(buffer, &header);
+	_store_u64(buffer + common_protocol_header_size + 0, request->media_id);
+	_store_u32(buffer + common_protocol_header_size + 8, request->chunk);
+}
+
+bool_t common_protocol_decode_request(const uint8_t* const payload, const uint64_t length, common_protocol_request_s* const request)
+{
+	common_debug_assert(payload != NULL);
+	common_debug_assert(request != NULL);
+
+	if (length != common_protocol_request_size)
+	{
+		return false;
+	}
+
+	request->media_id = _load_u64(payload + 0);
+	request->chunk    = _load_u32(payload + 8);
+	return true;
+}
+
+void common_protocol_encode_range(uint8_t* const buffer, const uint32_t stream_id, const common_protocol_frame_e type, const common_protocol_range_s* const range)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert((common_protocol_frame_byte_range == type) || (common_protocol_frame_time_range == type));
+	common_debug_assert(range != NULL);
+
+	const common_protocol_header_s header =
+	{
+		.type      = (uint8_t)type,
+		.flags     = common_protocol_flag_end,
+		.stream_id = stream_id,
+		.length    = (uint32_t)common_protocol_range_size,
+	};
+
+	common_protocol_encode_header(buffer, &header);
+	_store_u64(buffer + common_protocol_header_size + 0, range->media_id);
+	_store_u64(buffer + common_protocol_header_size + 8, range->start);
+	_store_u64(buffer + common_protocol_header_size + 16, range->length);
+}
+
+bool_t common_protocol_decode_range(const uint8_t* const payload, const uint64_t length, common_protocol_range_s* const range)
+{
+	common_debug_assert(payload != NULL);
+	common_debug_assert(range != NULL);
+
+	if (length != common_protocol_range_size)
+	{
+		return false;
+	}
+
+	range->media_id = _load_u64(payload + 0);
+	range->start    = _load_u64(payload + 8);
+	range->length   = _load_u64(payload + 16);
+	return true;
+}
+
+void common_protocol_encode_subscribe(uint8_t* const buffer, const uint32_t stream_id, const uint64_t media_id)
+{
+	common_debug_assert(buffer != NULL);
+
+	const common_protocol_header_s header =
+	{
+		.type      = common_protocol_frame_subscribe,
+		.flags     = common_protocol_flag_end,
+		.stream_id = stream_id,
+		.length    = (uint32_t)common_protocol_subscribe_size,
+	};
+
+	common_protocol_encode_header(buffer, &header);
+	_store_u64(buffer + common_protocol_header_size, media_id);
+}
+
+bool_t common_protocol_decode_subscribe(const uint8_t* const payload, const uint64_t length, uint64_t* const media_id)
+{
+	common_debug_assert(payload != NULL);
+	common_debug_assert(media_id != NULL);
+
+	if (length != common_protocol_subscribe_size)
+	{
+		return false;
+	}
+
+	*media_id = _load_u64(payload);
+	return true;
+}
+
+void common_protocol_encode_error(uint8_t* const buffer, const uint32_t stream_id, const common_protocol_error_e error)
+{
+	common_debug_assert(buffer != NULL);
+
+	const common_protocol_header_s header =
+	{
+		.type      = common_protocol_frame_error,
+		.flags     = common_protocol_flag_end,
+		.stream_id = stream_id,
+		.length    = (uint32_t)common_protocol_error_size,
+	};
+
+	common_protocol_encode_header(buffer, &header);
+	_store_u32(buffer + common_protocol_header_size, (uint32_t)error);
+}
+
+bool_t common_protocol_decode_error(const uint8_t* const payload, const uint64_t length, common_protocol_error_e* const error)
+{
+	common_debug_assert(payload != NULL);
+	common_debug_assert(error != NULL);
+
+	if (length != common_protocol_error_size)
+	{
+		return false;
+	}
+
+	*error = (common_protocol_error_e)_load_u32(payload);
+	return true;
+}
+
+void common_protocol_encode_ping(uint8_t* const buffer, const common_protocol_frame_e type)
+{
+	common_debug_assert(buffer != NULL);
+	common_debug_assert((common_protocol_frame_ping == type) || (common_protocol_frame_pong == type));
+
+	const common_protocol_header_s header =
+	{
+		.type      = (uint8_t)type,
+		.flags     = common_protocol_flag_end,
+		.stream_id = 0,
+		.length    = 0,
+	};
+
+	common_protocol_encode_header(buffer, &header);
+}
+
+const char_t* common_protocol_error_to_string(const common_protocol_error_e error)
+{
+	switch (error)
+	{
+		case common_protocol_error_invalid:      { return "invalid request";     }
+		case common_protocol_error_not_found:    { return "not found";           }
+		case common_protocol_error_unavailable:  { return "unavailable";         }
+		case common_protocol_error_out_of_range: { return "out of range";        }
+		default:                                 { return "unknown error";       }
+	}
+}
+
+// note: the fields are assembled byte by byte, which keeps the wire format
+// little-endian regardless of the host and avoids unaligned accesses, while
+// compilers still fold it into single loads and stores on little-endian hosts.
+static uint16_t _load_u16(const uint8_t* const data)
+{
+	common_debug_assert(data != NULL);
+	return (uint16_t)((uint16_t)data[0] | (uint16_t)((uint16_t)data[1] << 8));
+}
+
+static uint32_t _load_u32(const uint8_t* const data)
+{
+	common_debug_assert(data != NULL);
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint64_t _load_u64(const uint8_t* const data)
+{
+	common_debug_assert(data != NULL);
+	return (uint64_t)_load_u32(data) | ((uint64_t)_load_u32(data + 4) << 32);
+}
+
+static void _store_u16(uint8_t* const data, const uint16_t value)
+{
+	common_debug_assert(data != NULL);
+	data[0] = (uint8_t)(value);
+	data[1] = (uint8_t)(value >> 8);
+}
+
+static void _store_u32(uint8_t* const data, const uint32_t value)
+{
+	common_debug_assert(data != NULL);
+	data[0] = (uint8_t)(value);
+	data[1] = (uint8_t)(value >> 8);
+	data[2] = (uint8_t)(value >> 16);
+	data[3] = (uint8_t)(value >> 24);
+}
+
+static void _store_u64(uint8_t* const data, const uint64_t value)
+{
+	common_debug_assert(data != NULL);
+	_store_u32(data, (uint32_t)value);
+	_store_u32(data + 4, (uint32_t)(value >> 32));
+}
+
+static bool_t _is_streamed(const uint8_t type)
+{
+	return common_protocol_frame_segment == type;
+}
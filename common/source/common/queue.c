@@ -0,0 +1,275 @@
+
+/**
+ * @file queue.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_runtime
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t _round_capacity(const uint64_t capacity);
+
+static uint64_t _mpmc_claim(common_queue_mpmc_s* const queue, uint64_t* const index, const uint64_t limit, const uint64_t lap);
+
+bool_t common_queue_spsc_create(common_queue_spsc_s* const queue, const uint64_t capacity)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert(capacity > 0);
+
+	(void)memset(queue, 0, sizeof(*queue));
+
+	const uint64_t rounded = _round_capacity(capacity);
+	queue->slots = calloc(rounded, sizeof(*queue->slots));
+
+	if (NULL == queue->slots)
+	{
+		common_logger_error("failed to allocate a ring of %lu slots.", rounded);
+		return false;
+	}
+
+	queue->mask = rounded - 1;
+	return true;
+}
+
+void common_queue_spsc_destroy(common_queue_spsc_s* const queue)
+{
+	common_debug_assert(queue != NULL);
+
+	free(queue->slots);
+	(void)memset(queue, 0, sizeof(*queue));
+}
+
+bool_t common_queue_spsc_push(common_queue_spsc_s* const queue, void* const item)
+{
+	common_debug_assert(queue != NULL);
+	return common_queue_spsc_push_many(queue, &item, 1) == 1;
+}
+
+uint64_t common_queue_spsc_push_many(common_queue_spsc_s* const queue, void* const* const items, const uint64_t count)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert((items != NULL) || (0 == count));
+
+	const uint64_t tail = queue->tail;
+	uint64_t free_slots = queue->mask + 1 - (tail - queue->head_cache);
+
+	if (free_slots < count)
+	{
+		queue->head_cache = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+		free_slots = queue->mask + 1 - (tail - queue->head_cache);
+	}
+
+	const uint64_t pushed = (count < free_slots) ? count : free_slots;
+
+	for (uint64_t index = 0; index < pushed; ++index)
+	{
+		queue->slots[(tail + index) & queue->mask] = items[index];
+	}
+
+	__atomic_store_n(&queue->tail, tail + pushed, __ATOMIC_RELEASE);
+	return pushed;
+}
+
+bool_t common_queue_spsc_pop(common_queue_spsc_s* const queue, void** const item)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert(item != NULL);
+	return common_queue_spsc_pop_many(queue, item, 1) == 1;
+}
+
+uint64_t common_queue_spsc_pop_many(common_queue_spsc_s* const queue, void** const items, const uint64_t capacity)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert((items != NULL) || (0 == capacity));
+
+	const uint64_t head = queue->head;
+	uint64_t ready = queue->tail_cache - head;
+
+	if (ready < capacity)
+	{
+		queue->tail_cache = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+		ready = queue->tail_cache - head;
+	}
+
+	const uint64_t popped = (capacity < ready) ? capacity : ready;
+
+	for (uint64_t index = 0; index < popped; ++index)
+	{
+		items[index] = queue->slots[(head + index) & queue->mask];
+	}
+
+	__atomic_store_n(&queue->head, head + popped, __ATOMIC_RELEASE);
+	return popped;
+}
+
+bool_t common_queue_mpmc_create(common_queue_mpmc_s* const queue, const uint64_t capacity)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert(capacity > 0);
+
+	(void)memset(queue, 0, sizeof(*queue));
+
+	const uint64_t rounded = _round_capacity(capacity);
+	queue->cells = calloc(rounded, sizeof(*queue->cells));
+
+	if (NULL == queue->cells)
+	{
+		common_logger_error("failed to allocate a queue of %lu cells.", rounded);
+		return false;
+	}
+
+	queue->mask = rounded - 1;
+
+	for (uint64_t index = 0; index < rounded; ++index)
+	{
+		queue->cells[index].sequence = index;
+	}
+
+	return true;
+}
+
+void common_queue_mpmc_destroy(common_queue_mpmc_s* const queue)
+{
+	common_debug_assert(queue != NULL);
+
+	free(queue->cells);
+	(void)memset(queue, 0, sizeof(*queue));
+}
+
+bool_t common_queue_mpmc_push(common_queue_mpmc_s* const queue, void* const item)
+{
+	common_debug_assert(queue != NULL);
+	return common_queue_mpmc_push_many(queue, &item, 1) == 1;
+}
+
+uint64_t common_queue_mpmc_push_many(common_queue_mpmc_s* const queue, void* const* const items, const uint64_t count)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert((items != NULL) || (0 == count));
+
+	uint64_t index = 0;
+	const uint64_t pushed = _mpmc_claim(queue, &index, count, 0);
+
+	for (uint64_t offset = 0; offset < pushed; ++offset)
+	{
+		common_queue_cell_s* const cell = &queue->cells[(index + offset) & queue->mask];
+		cell->item = items[offset];
+		__atomic_store_n(&cell->sequence, index + offset + 1, __ATOMIC_RELEASE);
+	}
+
+	return pushed;
+}
+
+bool_t common_queue_mpmc_pop(common_queue_mpmc_s* const queue, void** const item)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert(item != NULL);
+	return common_queue_mpmc_pop_many(queue, item, 1) == 1;
+}
+
+uint64_t common_queue_mpmc_pop_many(common_queue_mpmc_s* const queue, void** const items, const uint64_t capacity)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert((items != NULL) || (0 == capacity));
+
+	uint64_t index = 0;
+	const uint64_t popped = _mpmc_claim(queue, &index, capacity, 1);
+
+	for (uint64_t offset = 0; offset < popped; ++offset)
+	{
+		common_queue_cell_s* const cell = &queue->cells[(index + offset) & queue->mask];
+		items[offset] = cell->item;
+		__atomic_store_n(&cell->sequence, index + offset + queue->mask + 1, __ATOMIC_RELEASE);
+	}
+
+	return popped;
+}
+
+uint64_t common_queue_mpmc_size(const common_queue_mpmc_s* const queue)
+{
+	common_debug_assert(queue != NULL);
+
+	// note: the dequeue index is read first, so that a pop in between can only
+	// make the queue look fuller than it is, never hold more than it can.
+	const uint64_t dequeue = __atomic_load_n(&queue->dequeue, __ATOMIC_RELAXED);
+	const uint64_t enqueue = __atomic_load_n(&queue->enqueue, __ATOMIC_RELAXED);
+	const uint64_t size    = (enqueue > dequeue) ? (enqueue - dequeue) : 0;
+	return (size < (queue->mask + 1)) ? size : (queue->mask + 1);
+}
+
+static uint64_t _round_capacity(const uint64_t capacity)
+{
+	uint64_t rounded = 1;
+
+	while (rounded < capacity)
+	{
+		rounded <<= 1;
+	}
+
+	return rounded;
+}
+
+// note: a cell at position p is free for producers once its sequence is p, and
+// ready for consumers once it is p + 1. a run of such cells is claimed at once
+// by moving the index of the side past it, after which no other thread of that
+// side can touch them until they are handed over by storing the next sequence.
+static uint64_t _mpmc_claim(common_queue_mpmc_s* const queue, uint64_t* const index, const uint64_t limit, const uint64_t lap)
+{
+	common_debug_assert(queue != NULL);
+	common_debug_assert(index != NULL);
+	common_debug_assert(lap <= 1);
+
+	uint64_t* const position = (0 == lap) ? &queue->enqueue : &queue->dequeue;
+	const uint64_t bound = (limit < (queue->mask + 1)) ? limit : (queue->mask + 1);
+	uint64_t current = __atomic_load_n(position, __ATOMIC_RELAXED);
+
+	while (bound > 0)
+	{
+		uint64_t claimed = 0;
+		int64_t difference = 0;
+
+		for (; claimed < bound; ++claimed)
+		{
+			const common_queue_cell_s* const cell = &queue->cells[(current + claimed) & queue->mask];
+			difference = (int64_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (current + claimed + lap));
+
+			if (difference != 0)
+			{
+				break;
+			}
+		}
+
+		if (claimed > 0)
+		{
+			if (__atomic_compare_exchange_n(position, &current, current + claimed, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				*index = current;
+				return claimed;
+			}
+		}
+		else if (difference < 0)
+		{
+			// note: the cell is still a lap behind, so the queue is full for
+			// producers or empty for consumers.
+			return 0;
+		}
+		else
+		{
+			current = __atomic_load_n(position, __ATOMIC_RELAXED);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,355 @@
+
+/**
+ * @file scheduler.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_runtime
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/scheduler.h"
+
+#include <sched.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static _Thread_local common_scheduler_worker_s* _g_current_worker = NULL;
+
+static bool_t _deque_push(common_scheduler_deque_s* const deque, common_scheduler_task_s* const task);
+
+static common_scheduler_task_s* _deque_take(common_scheduler_deque_s* const deque);
+
+static common_scheduler_task_s* _deque_steal(common_scheduler_deque_s* const deque);
+
+static common_scheduler_task_s* _find_task(common_scheduler_worker_s* const worker);
+
+static void _notify(common_scheduler_s* const scheduler);
+
+static void* _worker_main(void* const argument);
+
+bool_t common_scheduler_create(common_scheduler_s* const scheduler, const uint32_t threads, const uint64_t capacity)
+{
+	common_debug_assert(scheduler != NULL);
+	common_debug_assert(threads > 0);
+
+	(void)memset(scheduler, 0, sizeof(*scheduler));
+
+	if (!common_queue_mpmc_create(&scheduler->injected, capacity))
+	{
+		return false;
+	}
+
+	// note: the deques are aligned to cache lines, which plain malloc does not
+	// guarantee.
+	scheduler->workers = aligned_alloc(common_queue_cache_line, threads * sizeof(*scheduler->workers));
+
+	if (NULL == scheduler->workers)
+	{
+		common_logger_error("failed to allocate %u scheduler workers.", threads);
+		common_queue_mpmc_destroy(&scheduler->injected);
+		return false;
+	}
+
+	(void)memset(scheduler->workers, 0, threads * sizeof(*scheduler->workers));
+	(void)pthread_mutex_init(&scheduler->lock, NULL);
+	(void)pthread_cond_init(&scheduler->wakeup, NULL);
+	scheduler->workers_count = threads;
+
+	for (uint32_t index = 0; index < threads; ++index)
+	{
+		common_scheduler_worker_s* const worker = &scheduler->workers[index];
+		worker->scheduler = scheduler;
+		worker->index     = index;
+		worker->seed      = (uint64_t)index * 0x9E3779B97F4A7C15ull + 1;
+	}
+
+	for (; scheduler->workers_started < threads; ++scheduler->workers_started)
+	{
+		common_scheduler_worker_s* const worker = &scheduler->workers[scheduler->workers_started];
+
+		if (pthread_create(&worker->thread, NULL, _worker_main, worker) != 0)
+		{
+			common_logger_error("failed to spawn scheduler worker %u.", worker->index);
+			common_scheduler_destroy(scheduler);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void common_scheduler_destroy(common_scheduler_s* const scheduler)
+{
+	common_debug_assert(scheduler != NULL);
+
+	if (NULL == scheduler->workers)
+	{
+		return;
+	}
+
+	(void)pthread_mutex_lock(&scheduler->lock);
+	__atomic_store_n(&scheduler->stopping, true, __ATOMIC_SEQ_CST);
+	(void)pthread_cond_broadcast(&scheduler->wakeup);
+	(void)pthread_mutex_unlock(&scheduler->lock);
+
+	for (uint32_t index = 0; index < scheduler->workers_started; ++index)
+	{
+		(void)pthread_join(scheduler->workers[index].thread, NULL);
+	}
+
+	(void)pthread_cond_destroy(&scheduler->wakeup);
+	(void)pthread_mutex_destroy(&scheduler->lock);
+	common_queue_mpmc_destroy(&scheduler->injected);
+	free(scheduler->workers);
+	scheduler->workers = NULL;
+}
+
+bool_t common_scheduler_submit(common_scheduler_s* const scheduler, common_scheduler_task_s* const task)
+{
+	common_debug_assert(scheduler != NULL);
+	common_debug_assert(task != NULL);
+	common_debug_assert(task->function != NULL);
+
+	common_scheduler_worker_s* const worker = _g_current_worker;
+
+	if ((worker != NULL) && (worker->scheduler == scheduler))
+	{
+		if (!_deque_push(&worker->deque, task) && !common_queue_mpmc_push(&scheduler->injected, task))
+		{
+			task->function(task->argument);
+			return true;
+		}
+	}
+	else if (common_scheduler_is_stopping(scheduler) || !common_queue_mpmc_push(&scheduler->injected, task))
+	{
+		return false;
+	}
+
+	_notify(scheduler);
+	return true;
+}
+
+bool_t common_scheduler_is_stopping(const common_scheduler_s* const scheduler)
+{
+	common_debug_assert(scheduler != NULL);
+	return __atomic_load_n(&scheduler->stopping, __ATOMIC_RELAXED);
+}
+
+uint64_t common_scheduler_pending(const common_scheduler_s* const scheduler)
+{
+	common_debug_assert(scheduler != NULL);
+
+	uint64_t pending = common_queue_mpmc_size(&scheduler->injected);
+
+	for (uint32_t index = 0; index < scheduler->workers_started; ++index)
+	{
+		const common_scheduler_deque_s* const deque = &scheduler->workers[index].deque;
+		const int64_t top    = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+		const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+		pending += (bottom > top) ? (uint64_t)(bottom - top) : 0;
+	}
+
+	return pending;
+}
+
+// note: the deque follows the formulation of Chase and Lev for weak memory
+// models by Le, Pop, Cohen and Zappa Nardelli, over a fixed-size array. only
+// the owner moves the bottom, and the top is only ever moved forward with a
+// compare-and-swap, which settles the race between the owner taking the last
+// task and a thief stealing it.
+static bool_t _deque_push(common_scheduler_deque_s* const deque, common_scheduler_task_s* const task)
+{
+	common_debug_assert(deque != NULL);
+	common_debug_assert(task != NULL);
+
+	const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+	const int64_t top    = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+	if ((bottom - top) >= (int64_t)common_scheduler_deque_capacity)
+	{
+		return false;
+	}
+
+	__atomic_store_n(&deque->tasks[(uint64_t)bottom % common_scheduler_deque_capacity], task, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+static common_scheduler_task_s* _deque_take(common_scheduler_deque_s* const deque)
+{
+	common_debug_assert(deque != NULL);
+
+	const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+	__atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+	if (top > bottom)
+	{
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	common_scheduler_task_s* task = __atomic_load_n(&deque->tasks[(uint64_t)bottom % common_scheduler_deque_capacity], __ATOMIC_RELAXED);
+
+	if (top == bottom)
+	{
+		if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		{
+			task = NULL;
+		}
+
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+	}
+
+	return task;
+}
+
+static common_scheduler_task_s* _deque_steal(common_scheduler_deque_s* const deque)
+{
+	common_debug_assert(deque != NULL);
+
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+	if (top >= bottom)
+	{
+		return NULL;
+	}
+
+	common_scheduler_task_s* const task = __atomic_load_n(&deque->tasks[(uint64_t)top % common_scheduler_deque_capacity], __ATOMIC_RELAXED);
+
+	if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+	{
+		return NULL;
+	}
+
+	return task;
+}
+
+static common_scheduler_task_s* _find_task(common_scheduler_worker_s* const worker)
+{
+	common_debug_assert(worker != NULL);
+
+	common_scheduler_s* const scheduler = worker->scheduler;
+	common_scheduler_task_s* task = _deque_take(&worker->deque);
+
+	if (task != NULL)
+	{
+		return task;
+	}
+
+	void* injected = NULL;
+
+	if (common_queue_mpmc_pop(&scheduler->injected, &injected))
+	{
+		return injected;
+	}
+
+	// note: victims are visited from a random start, so that idle workers do
+	// not all pile onto the same deque.
+	worker->seed ^= worker->seed << 13;
+	worker->seed ^= worker->seed >> 7;
+	worker->seed ^= worker->seed << 17;
+
+	const uint32_t start = (uint32_t)(worker->seed % scheduler->workers_count);
+
+	for (uint32_t offset = 0; offset < scheduler->workers_count; ++offset)
+	{
+		const uint32_t victim = (start + offset) % scheduler->workers_count;
+
+		if (victim == worker->index)
+		{
+			continue;
+		}
+
+		task = _deque_steal(&scheduler->workers[victim].deque);
+
+		if (task != NULL)
+		{
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+static void _notify(common_scheduler_s* const scheduler)
+{
+	common_debug_assert(scheduler != NULL);
+
+	// note: the epoch is bumped before the sleepers are checked, while a worker
+	// counts itself as a sleeper before it checks the epoch, so either the
+	// worker sees the new epoch or the notifier sees the sleeper.
+	(void)__atomic_add_fetch(&scheduler->epoch, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&scheduler->sleepers, __ATOMIC_SEQ_CST) > 0)
+	{
+		(void)pthread_mutex_lock(&scheduler->lock);
+		(void)pthread_cond_signal(&scheduler->wakeup);
+		(void)pthread_mutex_unlock(&scheduler->lock);
+	}
+}
+
+static void* _worker_main(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+
+	common_scheduler_worker_s* const worker = argument;
+	common_scheduler_s* const scheduler = worker->scheduler;
+	_g_current_worker = worker;
+
+	uint32_t idle_rounds = 0;
+
+	while (true)
+	{
+		const uint64_t epoch = __atomic_load_n(&scheduler->epoch, __ATOMIC_SEQ_CST);
+		common_scheduler_task_s* const task = _find_task(worker);
+
+		if (task != NULL)
+		{
+			task->function(task->argument);
+			idle_rounds = 0;
+			continue;
+		}
+
+		if (idle_rounds < common_scheduler_spin_rounds)
+		{
+			++idle_rounds;
+			(void)sched_yield();
+			continue;
+		}
+
+		// note: the queues are only found empty after stopping once everything
+		// submitted has run, except what other workers still hold themselves.
+		if (common_scheduler_is_stopping(scheduler))
+		{
+			break;
+		}
+
+		(void)pthread_mutex_lock(&scheduler->lock);
+		(void)__atomic_add_fetch(&scheduler->sleepers, 1, __ATOMIC_SEQ_CST);
+
+		while ((__atomic_load_n(&scheduler->epoch, __ATOMIC_SEQ_CST) == epoch) && !common_scheduler_is_stopping(scheduler))
+		{
+			(void)pthread_cond_wait(&scheduler->wakeup, &scheduler->lock);
+		}
+
+		(void)__atomic_sub_fetch(&scheduler->sleepers, 1, __ATOMIC_SEQ_CST);
+		(void)pthread_mutex_unlock(&scheduler->lock);
+		idle_rounds = 0;
+	}
+
+	_g_current_worker = NULL;
+	return NULL;
+}
@@ -0,0 +1,373 @@
+
+/**
+ * @file timer.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/timer.h"
+
+#include <time.h>
+
+static void _list_reset(common_timer_s* const head);
+
+static void _list_unlink(common_timer_s* const timer);
+
+static void _list_take(common_timer_s* const head, common_timer_s* const list);
+
+static void _insert(common_timer_wheel_s* const wheel, common_timer_s* const timer);
+
+static void _cascade(common_timer_wheel_s* const wheel, const uint64_t level);
+
+static uint64_t _fire(common_timer_wheel_s* const wheel);
+
+static uint64_t _rotate(const uint64_t bits, const uint64_t shift);
+
+void common_timer_wheel_create(common_timer_wheel_s* const wheel, const uint64_t now_ms, const uint64_t resolution_ms)
+{
+	common_debug_assert(wheel != NULL);
+	common_debug_assert(resolution_ms > 0);
+
+	for (uint64_t level = 0; level < common_timer_wheel_levels; ++level)
+	{
+		for (uint64_t slot = 0; slot < common_timer_wheel_slots; ++slot)
+		{
+			_list_reset(&wheel->slots[level][slot]);
+		}
+
+		wheel->occupied[level] = 0;
+	}
+
+	wheel->resolution_ms = resolution_ms;
+	wheel->now           = now_ms / resolution_ms;
+	wheel->count         = 0;
+}
+
+void common_timer_wheel_destroy(common_timer_wheel_s* const wheel)
+{
+	common_debug_assert(wheel != NULL);
+
+	for (uint64_t level = 0; level < common_timer_wheel_levels; ++level)
+	{
+		for (uint64_t slot = 0; slot < common_timer_wheel_slots; ++slot)
+		{
+			common_timer_s* const head = &wheel->slots[level][slot];
+
+			while (head->next != head)
+			{
+				_list_unlink(head->next);
+			}
+		}
+
+		wheel->occupied[level] = 0;
+	}
+
+	wheel->count = 0;
+}
+
+void common_timer_init(common_timer_s* const timer, void (*function)(common_timer_s* const timer, void* const argument), void* const argument)
+{
+	common_debug_assert(timer != NULL);
+	common_debug_assert(function != NULL);
+
+	*timer = (const common_timer_s)
+	{
+		.function = function,
+		.argument = argument,
+	};
+}
+
+bool_t common_timer_is_armed(const common_timer_s* const timer)
+{
+	common_debug_assert(timer != NULL);
+	return timer->next != NULL;
+}
+
+void common_timer_wheel_schedule(common_timer_wheel_s* const wheel, common_timer_s* const timer, const uint64_t deadline_ms)
+{
+	common_debug_assert(wheel != NULL);
+	common_debug_assert(timer != NULL);
+
+	common_timer_wheel_cancel(wheel, timer);
+
+	// note: the tick the wheel is at has already fired, so the earliest a new
+	// timer can fire is the next one.
+	const uint64_t deadline = (deadline_ms + wheel->resolution_ms - 1) / wheel->resolution_ms;
+	timer->deadline = (deadline > wheel->now) ? deadline : (wheel->now + 1);
+
+	_insert(wheel, timer);
+	++wheel->count;
+}
+
+void common_timer_wheel_cancel(common_timer_wheel_s* const wheel, common_timer_s* const timer)
+{
+	common_debug_assert(wheel != NULL);
+	common_debug_assert(timer != NULL);
+
+	if (!common_timer_is_armed(timer))
+	{
+		return;
+	}
+
+	common_debug_assert(wheel->count > 0);
+
+	_list_unlink(timer);
+	--wheel->count;
+
+	// note: a timer that is being fired has already been taken out of its
+	// slot, in which case the slot may be empty or hold newer timers.
+	const common_timer_s* const head = &wheel->slots[timer->level][timer->slot];
+
+	if (head->next == head)
+	{
+		wheel->occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+	}
+}
+
+uint64_t common_timer_wheel_advance(common_timer_wheel_s* const wheel, const uint64_t now_ms)
+{
+	common_debug_assert(wheel != NULL);
+
+	const uint64_t target = now_ms / wheel->resolution_ms;
+	uint64_t fired = 0;
+
+	while (wheel->now < target)
+	{
+		if (0 == wheel->count)
+		{
+			wheel->now = target;
+			break;
+		}
+
+		// note: while the lowest level is empty nothing can fire before the next
+		// cascade, so the ticks up to it are skipped in one go.
+		if (0 == wheel->occupied[0])
+		{
+			const uint64_t boundary = ((wheel->now >> common_timer_wheel_bits) + 1) << common_timer_wheel_bits;
+			wheel->now = ((boundary - 1) < target) ? (boundary - 1) : target;
+
+			if (wheel->now == target)
+			{
+				break;
+			}
+		}
+
+		++wheel->now;
+
+		// note: at the turn of a level the next slot of every level above it is
+		// spread out over the levels below, top-down, so that the timers due on
+		// this very tick end up in the lowest level before it fires.
+		uint64_t levels = 0;
+
+		while (((levels + 1) < common_timer_wheel_levels) &&
+			(0 == (wheel->now & (((uint64_t)1 << (common_timer_wheel_bits * (levels + 1))) - 1))))
+		{
+			++levels;
+		}
+
+		for (uint64_t level = levels; level > 0; --level)
+		{
+			_cascade(wheel, level);
+		}
+
+		fired += _fire(wheel);
+	}
+
+	return fired;
+}
+
+int32_t common_timer_wheel_timeout(const common_timer_wheel_s* const wheel, const uint64_t now_ms)
+{
+	common_debug_assert(wheel != NULL);
+
+	if (0 == wheel->count)
+	{
+		return -1;
+	}
+
+	uint64_t earliest = UINT64_MAX;
+
+	for (uint64_t level = 0; level < common_timer_wheel_levels; ++level)
+	{
+		if (0 == wheel->occupied[level])
+		{
+			continue;
+		}
+
+		const uint64_t shift   = common_timer_wheel_bits * level;
+		const uint64_t turn    = wheel->now >> shift;
+		const uint64_t rotated = _rotate(wheel->occupied[level], turn & common_timer_wheel_mask);
+		uint64_t distance = 0;
+
+		// note: the current slot of the lowest level holds timers due right now,
+		// while the current slot of a higher level is a full turn away, as it
+		// has been spread out already when the level below turned last.
+		if (0 == level)
+		{
+			distance = (uint64_t)__builtin_ctzll(rotated);
+		}
+		else
+		{
+			const uint64_t ahead = rotated & ~(uint64_t)1;
+			distance = (ahead != 0) ? (uint64_t)__builtin_ctzll(ahead) : common_timer_wheel_slots;
+		}
+
+		const uint64_t tick = (turn + distance) << shift;
+		earliest = (tick < earliest) ? tick : earliest;
+	}
+
+	const uint64_t deadline_ms = earliest * wheel->resolution_ms;
+
+	if (deadline_ms <= now_ms)
+	{
+		return 0;
+	}
+
+	const uint64_t timeout = deadline_ms - now_ms;
+	return (timeout < (uint64_t)INT32_MAX) ? (int32_t)timeout : INT32_MAX;
+}
+
+uint64_t common_timer_now_ms(void)
+{
+	struct timespec now = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000) + ((uint64_t)now.tv_nsec / 1000000);
+}
+
+uint64_t common_timer_now_ns(void)
+{
+	struct timespec now = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000) + (uint64_t)now.tv_nsec;
+}
+
+static void _list_reset(common_timer_s* const head)
+{
+	common_debug_assert(head != NULL);
+
+	head->next = head;
+	head->prev = head;
+}
+
+static void _list_unlink(common_timer_s* const timer)
+{
+	common_debug_assert(timer != NULL);
+	common_debug_assert(timer->next != NULL);
+
+	timer->prev->next = timer->next;
+	timer->next->prev = timer->prev;
+	timer->next = NULL;
+	timer->prev = NULL;
+}
+
+static void _list_take(common_timer_s* const head, common_timer_s* const list)
+{
+	common_debug_assert(head != NULL);
+	common_debug_assert(list != NULL);
+
+	if (head->next == head)
+	{
+		_list_reset(list);
+		return;
+	}
+
+	list->next       = head->next;
+	list->prev       = head->prev;
+	list->next->prev = list;
+	list->prev->next = list;
+	_list_reset(head);
+}
+
+static void _insert(common_timer_wheel_s* const wheel, common_timer_s* const timer)
+{
+	common_debug_assert(wheel != NULL);
+	common_debug_assert(timer != NULL);
+
+	// note: a deadline past the span of the wheel is parked in the top level
+	// as far out as it reaches, and placed again once that slot comes up.
+	const uint64_t span  = (uint64_t)1 << (common_timer_wheel_bits * common_timer_wheel_levels);
+	const uint64_t delta = (timer->deadline > wheel->now) ? (timer->deadline - wheel->now) : 0;
+	const uint64_t place = wheel->now + ((delta < span) ? delta : (span - 1));
+
+	uint64_t level = 0;
+
+	while ((level + 1) < common_timer_wheel_levels)
+	{
+		if (0 == ((place - wheel->now) >> (common_timer_wheel_bits * (level + 1))))
+		{
+			break;
+		}
+
+		++level;
+	}
+
+	const uint64_t slot = (place >> (common_timer_wheel_bits * level)) & common_timer_wheel_mask;
+	common_timer_s* const head = &wheel->slots[level][slot];
+
+	timer->level = (uint8_t)level;
+	timer->slot  = (uint8_t)slot;
+	timer->next  = head;
+	timer->prev  = head->prev;
+	head->prev->next = timer;
+	head->prev       = timer;
+
+	wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+static void _cascade(common_timer_wheel_s* const wheel, const uint64_t level)
+{
+	common_debug_assert(wheel != NULL);
+	common_debug_assert(level > 0);
+
+	const uint64_t slot = (wheel->now >> (common_timer_wheel_bits * level)) & common_timer_wheel_mask;
+
+	common_timer_s list = {0};
+	_list_take(&wheel->slots[level][slot], &list);
+	wheel->occupied[level] &= ~((uint64_t)1 << slot);
+
+	while (list.next != &list)
+	{
+		common_timer_s* const timer = list.next;
+		_list_unlink(timer);
+		_insert(wheel, timer);
+	}
+}
+
+static uint64_t _fire(common_timer_wheel_s* const wheel)
+{
+	common_debug_assert(wheel != NULL);
+
+	const uint64_t slot = wheel->now & common_timer_wheel_mask;
+
+	common_timer_s list = {0};
+	_list_take(&wheel->slots[0][slot], &list);
+	wheel->occupied[0] &= ~((uint64_t)1 << slot);
+
+	uint64_t fired = 0;
+
+	// note: the expired timers are detached first, so that the functions may
+	// schedule into the slot being fired or cancel timers that are still due.
+	while (list.next != &list)
+	{
+		common_timer_s* const timer = list.next;
+		_list_unlink(timer);
+		--wheel->count;
+		++fired;
+
+		timer->function(timer, timer->argument);
+	}
+
+	return fired;
+}
+
+static uint64_t _rotate(const uint64_t bits, const uint64_t shift)
+{
+	common_debug_assert(shift < 64);
+	return (0 == shift) ? bits : ((bits >> shift) | (bits << (64 - shift)));
+}
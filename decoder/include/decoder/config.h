@@ -0,0 +1,31 @@
+
+/**
+ * @file config.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __decoder__include__decoder__config_h__
+#define __decoder__include__decoder__config_h__
+
+#include "common/types.h"
+
+typedef enum
+{
+	decoder_command_decode,
+} decoder_command_e;
+
+typedef struct
+{
+	decoder_command_e command;
+	const char_t* file;
+} decoder_config_s;
+
+decoder_config_s decoder_config_from_cli(int32_t* const argc, const char_t*** const argv);
+
+#endif
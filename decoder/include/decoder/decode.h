@@ -0,0 +1,28 @@
+
+/**
+ * @file decode.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __decoder__include__decoder__decode_h__
+#define __decoder__include__decoder__decode_h__
+
+#include "decoder/config.h"
+
+/**
+ * @brief Decode a binary log written by the logger and print its messages the
+ * way the logger would have printed them, prefixed with their timestamps.
+ * 
+ * @param config config of the decoder
+ * 
+ * @return bool_t false if the log could not be read or is malformed
+ */
+bool_t decoder_decode_run(const decoder_config_s* const config);
+
+#endif
@@ -0,0 +1,209 @@
+
+/**
+ * @file decode.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/binlog.h"
+
+#include "decoder/decode.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#define _decode_buffer_size (common_binlog_record_limit * 2)
+
+typedef struct
+{
+	char_t** formats;
+	uint64_t formats_capacity;
+	uint64_t messages;
+} _decode_state_s;
+
+static bool_t _handle_record(_decode_state_s* const state, const common_binlog_record_s* const record);
+
+static bool_t _define_format(_decode_state_s* const state, const common_binlog_record_s* const record);
+
+bool_t decoder_decode_run(const decoder_config_s* const config)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(config->file != NULL);
+
+	FILE* const file = fopen(config->file, "rb");
+
+	if (NULL == file)
+	{
+		common_logger_error("failed to open the binary log %s: %s.", config->file, strerror(errno));
+		return false;
+	}
+
+	char_t magic[common_binlog_magic_size] = {0};
+
+	if ((fread(magic, 1, sizeof(magic), file) != sizeof(magic)) || (memcmp(magic, common_binlog_magic, sizeof(magic)) != 0))
+	{
+		common_logger_error("%s is not a binary log.", config->file);
+		(void)fclose(file);
+		return false;
+	}
+
+	uint8_t* const buffer = malloc(_decode_buffer_size);
+
+	if (NULL == buffer)
+	{
+		common_logger_error("failed to allocate the decoding buffer.");
+		(void)fclose(file);
+		return false;
+	}
+
+	_decode_state_s state = {0};
+	uint64_t filled = 0;
+	bool_t status = true;
+
+	while (status)
+	{
+		const uint64_t received = fread(buffer + filled, 1, _decode_buffer_size - filled, file);
+		filled += received;
+
+		uint64_t offset = 0;
+
+		while (status && (offset < filled))
+		{
+			common_binlog_record_s record = {0};
+			uint64_t consumed = 0;
+
+			if (!common_binlog_decode_record(buffer + offset, filled - offset, &record, &consumed))
+			{
+				common_logger_error("malformed record found at offset %lu of the binary log.", offset);
+				status = false;
+				break;
+			}
+
+			if (0 == consumed)
+			{
+				break;
+			}
+
+			status  = _handle_record(&state, &record);
+			offset += consumed;
+		}
+
+		(void)memmove(buffer, buffer + offset, filled - offset);
+		filled -= offset;
+
+		if (0 == received)
+		{
+			if (ferror(file))
+			{
+				common_logger_error("failed to read the binary log %s.", config->file);
+				status = false;
+			}
+			else if (filled > 0)
+			{
+				// note: the server may have been stopped in the middle of writing
+				// out a batch, which leaves a truncated record at the very end.
+				common_logger_warn("the binary log ends with a truncated record of %lu bytes.", filled);
+			}
+
+			break;
+		}
+	}
+
+	common_logger_info("decoded %lu messages.", state.messages);
+
+	for (uint64_t index = 0; index < state.formats_capacity; ++index)
+	{
+		free(state.formats[index]);
+	}
+
+	free(state.formats);
+	free(buffer);
+	(void)fclose(file);
+	return status;
+}
+
+static bool_t _handle_record(_decode_state_s* const state, const common_binlog_record_s* const record)
+{
+	common_debug_assert(state != NULL);
+	common_debug_assert(record != NULL);
+
+	if (common_binlog_record_definition == record->kind)
+	{
+		return _define_format(state, record);
+	}
+
+	if ((record->id >= state->formats_capacity) || (NULL == state->formats[record->id]))
+	{
+		common_logger_error("message refers to the undefined format %u.", record->id);
+		return false;
+	}
+
+	const char_t* const tag = common_logger_level_to_tag((common_logger_level_e)record->level);
+	(void)printf("[%lu.%09lu] ", record->timestamp / 1000000000, record->timestamp % 1000000000);
+
+	if (tag != NULL)
+	{
+		(void)printf("%s: ", tag);
+	}
+
+	if (!common_binlog_print(stdout, state->formats[record->id], record->data, record->size))
+	{
+		(void)printf(" <malformed arguments>");
+	}
+
+	(void)printf("\n");
+	++state->messages;
+	return true;
+}
+
+static bool_t _define_format(_decode_state_s* const state, const common_binlog_record_s* const record)
+{
+	common_debug_assert(state != NULL);
+	common_debug_assert(record != NULL);
+
+	if (record->id >= state->formats_capacity)
+	{
+		uint64_t capacity = (state->formats_capacity > 0) ? state->formats_capacity : 256;
+
+		while (record->id >= capacity)
+		{
+			capacity *= 2;
+		}
+
+		char_t** const formats = realloc(state->formats, capacity * sizeof(*formats));
+
+		if (NULL == formats)
+		{
+			common_logger_error("failed to grow the format table to %lu formats.", capacity);
+			return false;
+		}
+
+		(void)memset(formats + state->formats_capacity, 0, (capacity - state->formats_capacity) * sizeof(*formats));
+		state->formats          = formats;
+		state->formats_capacity = capacity;
+	}
+
+	char_t* const format = malloc((uint64_t)record->size + 1);
+
+	if (NULL == format)
+	{
+		common_logger_error("failed to allocate format %u.", record->id);
+		return false;
+	}
+
+	(void)memcpy(format, record->data, record->size);
+	format[record->size] = '\0';
+
+	free(state->formats[record->id]);
+	state->formats[record->id] = format;
+	return true;
+}
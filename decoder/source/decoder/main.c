@@ -0,0 +1,32 @@
+
+/**
+ * @file main.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "decoder/config.h"
+#include "decoder/decode.h"
+#include "decoder/main.h"
+
+int32_t main(int32_t argc, const char_t** argv)
+{
+	const decoder_config_s config = decoder_config_from_cli(&argc, &argv);
+	bool_t status = false;
+
+	switch (config.command)
+	{
+		case decoder_command_decode: { status = decoder_decode_run(&config); } break;
+		default:                     { common_debug_assert(0);               } break;
+	}
+
+	return status ? 0 : 1;
+}
@@ -11,6 +11,10 @@ types: list[str] = [
 	f'rel_server',
 	f'dev_client',
 	f'rel_client',
+	f'dev_bench',
+	f'rel_bench',
+	f'dev_decoder',
+	f'rel_decoder',
 	f'dev_all',
 	f'rel_all',
 	f'all',
@@ -0,0 +1,112 @@
+
+/**
+ * @file backend.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__backend_h__
+#define __server__include__server__backend_h__
+
+#include "common/types.h"
+
+#include "server/backend_epoll.h"
+#include "server/backend_uring.h"
+#include "server/connection.h"
+#include "server/config.h"
+
+typedef struct server_reactor_s server_reactor_s;
+
+typedef struct
+{
+	server_io_backend_e kind;
+
+	union
+	{
+		server_backend_epoll_s epoll;
+		server_backend_uring_s uring;
+	};
+} server_backend_s;
+
+/**
+ * @brief Create the i/o backend of the requested kind for the reactor.
+ * 
+ * @note If io_uring is requested but the kernel does not support it, the
+ * backend falls back to epoll.
+ * 
+ * @param backend backend to create
+ * @param reactor reactor that owns the backend
+ * @param kind    requested kind of the backend
+ * 
+ * @return bool_t
+ */
+bool_t server_backend_create(server_backend_s* const backend, server_reactor_s* const reactor, const server_io_backend_e kind);
+
+/**
+ * @brief Destroy the backend.
+ * 
+ * @param backend backend to destroy
+ */
+void server_backend_destroy(server_backend_s* const backend);
+
+/**
+ * @brief Start the backend on the thread that is going to drive it.
+ * 
+ * @param backend backend to start
+ * 
+ * @return bool_t
+ */
+bool_t server_backend_start(server_backend_s* const backend);
+
+/**
+ * @brief Wait for i/o events and dispatch them to the reactor and connections.
+ * 
+ * @param backend    backend to wait on
+ * @param timeout_ms timeout in milliseconds, or -1 to wait indefinitely
+ * 
+ * @return bool_t false on an unrecoverable error
+ */
+bool_t server_backend_wait(server_backend_s* const backend, const int32_t timeout_ms);
+
+/**
+ * @brief Start transmitting output that was queued on the connection outside
+ * of the backend's own event dispatching.
+ * 
+ * @param backend    backend driving the connection
+ * @param connection connection to flush
+ */
+void server_backend_flush(server_backend_s* const backend, server_connection_s* const connection);
+
+/**
+ * @brief Pick a connection up again after it stopped serving requests to wait
+ * for a segment load: receive into it again and transmit what it queued.
+ * 
+ * @param backend    backend driving the connection
+ * @param connection connection to resume
+ */
+void server_backend_resume(server_backend_s* const backend, server_connection_s* const connection);
+
+/**
+ * @brief Release the connection. The backend closes it once no operations on
+ * it are in flight anymore.
+ * 
+ * @param backend    backend driving the connection
+ * @param connection connection to release
+ */
+void server_backend_release(server_backend_s* const backend, server_connection_s* const connection);
+
+/**
+ * @brief Get the name of the backend.
+ * 
+ * @param backend backend to get the name of
+ * 
+ * @return const char_t*
+ */
+const char_t* server_backend_name(const server_backend_s* const backend);
+
+#endif
@@ -0,0 +1,73 @@
+
+/**
+ * @file backend_epoll.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__backend_epoll_h__
+#define __server__include__server__backend_epoll_h__
+
+#include "common/types.h"
+
+#include "server/connection.h"
+
+#define server_backend_epoll_events_capacity ((uint64_t)256)
+
+typedef struct server_reactor_s server_reactor_s;
+
+typedef struct
+{
+	server_reactor_s* reactor;
+	int32_t fd;
+} server_backend_epoll_s;
+
+/**
+ * @brief Create the edge-triggered epoll backend.
+ * 
+ * @param epoll   backend to create
+ * @param reactor reactor that owns the backend
+ * 
+ * @return bool_t
+ */
+bool_t server_backend_epoll_create(server_backend_epoll_s* const epoll, server_reactor_s* const reactor);
+
+/**
+ * @brief Destroy the epoll backend.
+ * 
+ * @param epoll backend to destroy
+ */
+void server_backend_epoll_destroy(server_backend_epoll_s* const epoll);
+
+/**
+ * @brief Wait for readiness events and drive the ready connections.
+ * 
+ * @param epoll      backend to wait on
+ * @param timeout_ms timeout in milliseconds, or -1 to wait indefinitely
+ * 
+ * @return bool_t
+ */
+bool_t server_backend_epoll_wait(server_backend_epoll_s* const epoll, const int32_t timeout_ms);
+
+/**
+ * @brief Transmit output queued on the connection.
+ * 
+ * @param epoll      backend driving the connection
+ * @param connection connection to flush
+ */
+void server_backend_epoll_flush(server_backend_epoll_s* const epoll, server_connection_s* const connection);
+
+/**
+ * @brief Release and close the connection.
+ * 
+ * @param epoll      backend driving the connection
+ * @param connection connection to release
+ */
+void server_backend_epoll_release(server_backend_epoll_s* const epoll, server_connection_s* const connection);
+
+#endif
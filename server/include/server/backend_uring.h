@@ -0,0 +1,136 @@
+
+/**
+ * @file backend_uring.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__backend_uring_h__
+#define __server__include__server__backend_uring_h__
+
+#include "common/types.h"
+#include "common/pool.h"
+
+#include "server/connection.h"
+
+#include <linux/io_uring.h>
+
+#define server_backend_uring_entries       ((uint32_t)1024)
+#define server_backend_uring_buffers_count ((uint32_t)256)
+#define server_backend_uring_iowq_workers  ((uint32_t)4)
+
+typedef struct server_reactor_s server_reactor_s;
+
+typedef struct
+{
+	server_reactor_s* reactor;
+	int32_t fd;
+
+	void* rings;
+	uint64_t rings_size;
+	struct io_uring_sqe* sqes;
+	uint64_t sqes_size;
+
+	uint32_t* sq_head;
+	uint32_t* sq_tail;
+	uint32_t sq_mask;
+	uint32_t sq_entries;
+	uint32_t sq_unsubmitted;
+
+	uint32_t* cq_head;
+	uint32_t* cq_tail;
+	uint32_t cq_mask;
+	struct io_uring_cqe* cqes;
+
+	struct io_uring_buf_ring* buffers_ring;
+	uint64_t buffers_ring_size;
+	common_pool_buffer_s* buffers[server_backend_uring_buffers_count];
+	uint32_t buffers_length[server_backend_uring_buffers_count];
+	int32_t buffers_next[server_backend_uring_buffers_count];
+	uint16_t buffers_tail;
+	bool_t buffers_recycled;
+	bool_t buffers_fixed;
+
+	int32_t* starved;
+	uint64_t starved_count;
+	uint64_t starved_capacity;
+
+	uint64_t wakeup_value;
+} server_backend_uring_s;
+
+/**
+ * @brief Create the io_uring backend, with multishot accept, multishot recv
+ * over a provided buffer ring drawn from the reactor pool and batched sends.
+ * The reactor pool is also registered as fixed buffers when allowed, for the
+ * file reads of the copy data path.
+ * 
+ * @note The ring is created disabled and is enabled by @ref
+ * server_backend_uring_start on the thread that drives it.
+ * 
+ * @param uring   backend to create
+ * @param reactor reactor that owns the backend
+ * 
+ * @return bool_t false if the kernel does not support the required features
+ */
+bool_t server_backend_uring_create(server_backend_uring_s* const uring, server_reactor_s* const reactor);
+
+/**
+ * @brief Destroy the io_uring backend.
+ * 
+ * @param uring backend to destroy
+ */
+void server_backend_uring_destroy(server_backend_uring_s* const uring);
+
+/**
+ * @brief Enable the ring on the calling thread, which becomes its only issuer.
+ * 
+ * @param uring backend to start
+ * 
+ * @return bool_t
+ */
+bool_t server_backend_uring_start(server_backend_uring_s* const uring);
+
+/**
+ * @brief Submit queued operations, wait for completions and dispatch them.
+ * 
+ * @param uring      backend to wait on
+ * @param timeout_ms timeout in milliseconds, or -1 to wait indefinitely
+ * 
+ * @return bool_t
+ */
+bool_t server_backend_uring_wait(server_backend_uring_s* const uring, const int32_t timeout_ms);
+
+/**
+ * @brief Queue a single send for the output pending on the connection, or
+ * splice its head file segment into the socket, polling for room in the
+ * socket once it is full.
+ * 
+ * @param uring      backend driving the connection
+ * @param connection connection to flush
+ */
+void server_backend_uring_flush(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+/**
+ * @brief Feed the input held for the connection into it, arm its receive
+ * again if it has none in flight, and flush its output.
+ * 
+ * @param uring      backend driving the connection
+ * @param connection connection to resume
+ */
+void server_backend_uring_resume(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+/**
+ * @brief Release the connection, cancelling its in-flight operations. It gets
+ * closed once all of them have completed.
+ * 
+ * @param uring      backend driving the connection
+ * @param connection connection to release
+ */
+void server_backend_uring_release(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+#endif
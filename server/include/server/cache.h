@@ -0,0 +1,320 @@
+
+/**
+ * @file cache.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__cache_h__
+#define __server__include__server__cache_h__
+
+#include "common/scheduler.h"
+#include "common/queue.h"
+#include "common/types.h"
+
+#include <pthread.h>
+
+#define server_cache_shards_count      ((uint64_t)16)
+#define server_cache_buckets_minimum   ((uint64_t)64)
+#define server_cache_doorkeeper_words  ((uint64_t)64)
+
+typedef enum
+{
+	server_cache_state_loading,
+	server_cache_state_ready,
+	server_cache_state_failed,
+} server_cache_state_e;
+
+typedef struct server_cache_waiter_s server_cache_waiter_s;
+
+/**
+ * @brief A waiter for an entry that is being loaded, embedded in whatever
+ * waits for it. Waiters are linked into the entry intrusively, and their
+ * function is called once the load is done either way, on the thread that
+ * did it and with the shard of the entry locked.
+ */
+struct server_cache_waiter_s
+{
+	server_cache_waiter_s* next;
+	void (*function)(server_cache_waiter_s* const waiter, void* const argument);
+	void* argument;
+};
+
+typedef struct server_cache_entry_s server_cache_entry_s;
+
+/**
+ * @brief A segment held in memory. Entries are immutable once loaded, and
+ * every connection transmitting one holds a reference to it, so an entry that
+ * gets evicted stays alive until the last of them is done with it.
+ * 
+ * @note An entry is resident from the moment its load is issued, so that all
+ * requests for it coalesce into that single load, and every one of them gets
+ * the same buffer once it is done.
+ */
+struct server_cache_entry_s
+{
+	uint64_t media_id;
+	uint32_t chunk;
+	uint32_t references;
+	uint64_t hash;
+	uint64_t size;
+	server_cache_state_e state;
+
+	// note: an entry that was not admitted is only resident while it is being
+	// loaded, so that the requests missing it meanwhile coalesce into its
+	// load, and it leaves the shard as soon as the load is done.
+	bool_t admitted;
+
+	// note: lookups count their hits here without locking the shard, and the
+	// shard folds them into the frequency of the entry once it is about to be
+	// evicted, rather than reordering its heap on every hit.
+	uint64_t hits;
+
+	// note: owned by the shard the entry is resident in, under its lock, but
+	// for the chain link, which lookups follow without it.
+	server_cache_entry_s* next;
+	server_cache_entry_s* retired;
+	uint64_t heap_index;
+	uint64_t frequency;
+	uint64_t priority;
+	server_cache_waiter_s* waiters;
+
+	uint8_t data[];
+};
+
+typedef struct
+{
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t admitted;
+	uint64_t rejected;
+	uint64_t evicted;
+	uint64_t loads;
+	uint64_t coalesced;
+	uint64_t failed;
+	uint64_t entries;
+	uint64_t size;
+} server_cache_stats_s;
+
+typedef struct server_cache_table_s server_cache_table_s;
+
+/**
+ * @brief The buckets of the hash table of a shard. A table that is outgrown
+ * is kept, linked from the one replacing it, as lookups may still be walking
+ * it, and it is only freed along with the cache.
+ */
+struct server_cache_table_s
+{
+	server_cache_table_s* previous;
+	uint64_t count;
+	server_cache_entry_s* buckets[];
+};
+
+/**
+ * @brief A shard of the cache, with a hash table of its resident entries and
+ * a min-heap of the loaded ones ordered by their eviction priority.
+ * 
+ * @note Lookups do not take the lock of the shard. They announce themselves in
+ * the reader count of the current epoch instead, and an entry that leaves the
+ * table is only retired, keeping the reference of the shard, until the epoch
+ * has moved on and no reader of the one before it is left.
+ */
+typedef struct
+{
+	_Alignas(common_queue_cache_line) uint64_t readers[2];
+	uint64_t epoch;
+
+	_Alignas(common_queue_cache_line) pthread_mutex_t lock;
+
+	server_cache_table_s* table;
+	server_cache_entry_s* retired;
+	server_cache_entry_s* retiring;
+
+	server_cache_entry_s** heap;
+	uint64_t heap_count;
+	uint64_t heap_capacity;
+
+	uint64_t size;
+	uint64_t capacity;
+	uint64_t inflation;
+
+	// note: one bit per recently missed key, so that a segment is only loaded
+	// once it is asked for again, and a scan of cold segments can not flush
+	// the hot ones out of a full shard.
+	uint64_t doorkeeper[server_cache_doorkeeper_words];
+	uint64_t doorkeeper_count;
+
+	// note: hits, misses and coalesced requests are counted by lookups outside
+	// of the lock, so those three are only ever updated atomically.
+	server_cache_stats_s stats;
+} server_cache_shard_s;
+
+/**
+ * @brief Size-aware cache of media segments, keyed by media id and chunk and
+ * shared by all workers. Keys are spread over shards of their own locks, and
+ * each shard evicts by greedy-dual-size-frequency: an entry is ranked by how
+ * often it was hit over its size, on top of an inflation value that rises to
+ * the rank of every evicted entry, so that entries which were popular once
+ * age out once they stop being hit.
+ * 
+ * @note The cache is over-aligned, so it must not live in memory from plain
+ * malloc.
+ */
+typedef struct
+{
+	server_cache_shard_s shards[server_cache_shards_count];
+	common_scheduler_s* scheduler;
+	bool_t coalesce;
+} server_cache_s;
+
+/**
+ * @brief Create an empty cache.
+ * 
+ * @param cache     cache to create
+ * @param capacity  total size of the segments the cache may hold, spread
+ *                  evenly over its shards, which may be 0 to only coalesce
+ *                  loads
+ * @param scheduler scheduler to load segments on
+ * @param coalesce  whether segments that are not admitted are still loaded,
+ *                  once for all the requests that miss them while they are
+ *                  being loaded, rather than left to be served from their
+ *                  files
+ * 
+ * @return bool_t
+ */
+bool_t server_cache_create(server_cache_s* const cache, const uint64_t capacity, common_scheduler_s* const scheduler, const bool_t coalesce);
+
+/**
+ * @brief Destroy the cache. Entries still referenced are freed once their
+ * last reference is released.
+ * 
+ * @note No load may be in flight anymore, so the scheduler has to be
+ * destroyed first.
+ * 
+ * @param cache cache to destroy
+ */
+void server_cache_destroy(server_cache_s* const cache);
+
+/**
+ * @brief Look a segment up, counting a hit, a miss, or a request coalesced
+ * into the load of the segment if it is still being loaded. It never blocks
+ * on the lock of the shard.
+ * 
+ * @param cache    cache to look the segment up in
+ * @param media_id id of the media
+ * @param chunk    index of the segment within the media
+ * 
+ * @return server_cache_entry_s* referenced entry, which may still be loading,
+ * or NULL if the segment is not resident
+ */
+server_cache_entry_s* server_cache_acquire(server_cache_s* const cache, const uint64_t media_id, const uint32_t chunk);
+
+/**
+ * @brief Load a missed segment into the cache from its opened file.
+ * 
+ * @note The segment is only admitted if it fits a shard, and, once the shard
+ * is full, if it was missed recently before. A segment that is not admitted
+ * is still loaded if the cache coalesces loads, and only stays resident until
+ * its load is done. It is read in full on the scheduler, never on the calling
+ * thread, and if the scheduler does not take the load, the entry fails. If
+ * another thread issued the load of the segment in the meantime, the request
+ * is coalesced into that load instead.
+ * 
+ * @param cache    cache to load the segment into
+ * @param media_id id of the media
+ * @param chunk    index of the segment within the media
+ * @param fd       descriptor of the opened segment, which passes to the cache
+ *                 if an entry is returned
+ * @param size     size of the opened segment
+ * 
+ * @return server_cache_entry_s* referenced entry, which may still be loading,
+ * or NULL if the segment is not loaded, in which case it has to be served
+ * from its file
+ */
+server_cache_entry_s* server_cache_load(server_cache_s* const cache, const uint64_t media_id, const uint32_t chunk, const int32_t fd, const uint64_t size);
+
+/**
+ * @brief Read a segment into an entry of its own, which is not resident in any
+ * cache but is shared by reference all the same.
+ * 
+ * @param media_id id of the media
+ * @param chunk    index of the segment within the media
+ * @param fd       descriptor of the opened segment, which stays with the caller
+ * @param size     size of the opened segment
+ * 
+ * @return server_cache_entry_s* referenced and ready entry, or NULL if the
+ * segment could not be read
+ */
+server_cache_entry_s* server_cache_read(const uint64_t media_id, const uint32_t chunk, const int32_t fd, const uint64_t size);
+
+/**
+ * @brief Get the state of an entry. Only a loading entry may still change it.
+ * 
+ * @param entry entry to get the state of
+ * 
+ * @return server_cache_state_e
+ */
+server_cache_state_e server_cache_state(const server_cache_entry_s* const entry);
+
+/**
+ * @brief Initialize a waiter.
+ * 
+ * @param waiter   waiter to initialize
+ * @param function function to call once the load waited for is done
+ * @param argument argument to pass to the function
+ */
+void server_cache_waiter_init(server_cache_waiter_s* const waiter, void (*function)(server_cache_waiter_s* const waiter, void* const argument), void* const argument);
+
+/**
+ * @brief Wait for an entry to be loaded.
+ * 
+ * @param cache  cache the entry is resident in
+ * @param entry  entry to wait for
+ * @param waiter waiter to attach to the entry
+ * 
+ * @return bool_t false if the load is already done, in which case the waiter
+ * is not attached
+ */
+bool_t server_cache_wait(server_cache_s* const cache, server_cache_entry_s* const entry, server_cache_waiter_s* const waiter);
+
+/**
+ * @brief Detach a waiter from an entry it waits for.
+ * 
+ * @param cache  cache the entry is resident in
+ * @param entry  entry the waiter waits for
+ * @param waiter waiter to detach
+ * 
+ * @return bool_t false if the load is already done, in which case the function
+ * of the waiter has been called already
+ */
+bool_t server_cache_cancel(server_cache_s* const cache, server_cache_entry_s* const entry, server_cache_waiter_s* const waiter);
+
+/**
+ * @brief Add a reference to an entry.
+ * 
+ * @param entry entry to reference
+ */
+void server_cache_retain(server_cache_entry_s* const entry);
+
+/**
+ * @brief Drop a reference to an entry, freeing it once the last reference is
+ * gone. It may be called from any thread.
+ * 
+ * @param entry entry to release
+ */
+void server_cache_release(server_cache_entry_s* const entry);
+
+/**
+ * @brief Sum up the statistics of all shards.
+ * 
+ * @param cache cache to query
+ * @param stats statistics to fill
+ */
+void server_cache_stats(server_cache_s* const cache, server_cache_stats_s* const stats);
+
+#endif
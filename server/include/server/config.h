@@ -13,13 +13,47 @@
 #ifndef __server__include__server__config_h__
 #define __server__include__server__config_h__
 
+#include "common/logger.h"
 #include "common/types.h"
 
+typedef enum
+{
+	server_io_backend_uring,
+	server_io_backend_epoll,
+} server_io_backend_e;
+
+typedef enum
+{
+	server_data_path_zero_copy,
+	server_data_path_copy,
+} server_data_path_e;
+
 typedef struct
 {
 	const char_t* address;
 	uint16_t port;
 	uint16_t backlog;
+	uint16_t workers;
+	server_io_backend_e io_backend;
+	server_data_path_e data_path;
+	const char_t* media_dir;
+	uint32_t io_buffers;
+	uint16_t compute_threads;
+	const char_t* binary_log;
+	common_logger_level_e log_level;
+	uint32_t idle_timeout;
+	uint32_t write_timeout;
+	uint32_t keepalive;
+	uint64_t high_watermark;
+	uint64_t low_watermark;
+	uint32_t notsent_lowat;
+	uint64_t cache_size;
+	uint32_t segment_duration;
+	bool_t live;
+	uint64_t live_media;
+	uint16_t stats_port;
+	const char_t* stats_socket;
+	const char_t* checksums;
 } server_config_s;
 
 server_config_s server_config_from_cli(int32_t* const argc, const char_t*** const argv);
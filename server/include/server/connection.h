@@ -0,0 +1,541 @@
+
+/**
+ * @file connection.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__connection_h__
+#define __server__include__server__connection_h__
+
+#include "common/arena.h"
+#include "common/types.h"
+#include "common/timer.h"
+#include "common/pool.h"
+
+#include "server/config.h"
+#include "server/cache.h"
+#include "server/live.h"
+#include "server/stats.h"
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define server_connection_buffer_size        ((uint64_t)16384)
+#define server_connection_segments_capacity  ((uint64_t)16)
+#define server_connection_header_capacity    ((uint64_t)32)
+#define server_connection_pipe_size          ((uint64_t)262144)
+
+typedef enum
+{
+	server_connection_state_closed,
+	server_connection_state_open,
+	server_connection_state_draining,
+	server_connection_state_closing,
+} server_connection_state_e;
+
+typedef enum
+{
+	server_connection_segment_memory,
+	server_connection_segment_file,
+	server_connection_segment_cached,
+} server_connection_segment_e;
+
+/**
+ * @brief A contiguous piece of the pending output. Memory segments are slices
+ * of a pooled output buffer, file segments reference a range of a file to be
+ * transmitted straight from the page cache and cached segments a range of a
+ * cache entry, both optionally prefixed with a framing header.
+ */
+typedef struct
+{
+	server_connection_segment_e kind;
+
+	union
+	{
+		common_pool_slice_s memory;
+
+		struct
+		{
+			int32_t fd;
+			bool_t owned;
+			uint64_t offset;
+			uint64_t length;
+			uint8_t header[server_connection_header_capacity];
+			uint64_t header_length;
+			uint64_t sent;
+			uint64_t staged;
+			uint64_t bounced;
+		} file;
+
+		struct
+		{
+			server_cache_entry_s* entry;
+			uint64_t offset;
+			uint64_t length;
+			uint8_t header[server_connection_header_capacity];
+			uint64_t header_length;
+			uint64_t sent;
+		} cached;
+	};
+} server_connection_segment_s;
+
+typedef struct
+{
+	uint64_t bytes_received;
+	uint64_t bytes_written;
+	uint64_t bytes_sendfile;
+	uint64_t bytes_spliced;
+	uint64_t bytes_copied;
+	uint64_t bytes_cached;
+	uint64_t bytes_transmitted;
+	uint64_t sends;
+	uint64_t throttled;
+	uint64_t waited;
+	uint64_t skipped;
+} server_connection_stats_s;
+
+typedef struct server_connection_s server_connection_s;
+
+struct server_connection_s
+{
+	int32_t fd;
+	server_connection_state_e state;
+	const server_config_s* config;
+	bool_t failed;
+
+	// note: link of the list of closed or spare connections of the reactor.
+	server_connection_s* next;
+
+	// note: the received bytes that are not processed yet, in a pooled buffer
+	// that is only held while there are any.
+	common_pool_buffer_s* input;
+	uint64_t input_count;
+
+	// note: small frames are appended to a pooled buffer, which every memory
+	// segment in it holds a slice of. a full buffer is swapped for a fresh one
+	// while the backend may still transmit from it, and no buffer is held once
+	// nothing is pending, so that an idle connection holds no i/o memory.
+	common_pool_buffer_s* output;
+	uint64_t output_used;
+	uint64_t output_pending;
+
+	server_connection_segment_s segments[server_connection_segments_capacity];
+	uint64_t segments_head;
+	uint64_t segments_count;
+
+	// note: bytes queued for transmission across all segments. once they
+	// reach the high watermark no further requests are served, and with that
+	// no further files opened or read, until they drain to the low watermark.
+	uint64_t queued;
+	bool_t throttled;
+
+	int32_t pipe[2];
+	uint64_t pipe_capacity;
+
+	// note: the pool of the worker, which the input and output buffers are
+	// taken from. on the copy data path the head file segment is read into a
+	// pooled buffer too, which is held only while it is being transmitted.
+	common_pool_s* pool;
+	common_pool_buffer_s* bounce;
+
+	// note: the segment cache shared by all workers, or NULL if it is disabled.
+	// while a request waits for a segment being loaded into it, the frame of
+	// the request stays in the input and no further requests are served, so
+	// that the responses stay in order. the frame is served again with the
+	// loaded entry once the waiter is notified.
+	server_cache_s* cache;
+	server_cache_entry_s* loading;
+	server_cache_waiter_s waiter;
+	bool_t waiting;
+
+	// note: the progress of the range request at the front of the input. it
+	// is served a segment at a time while there is room for the responses,
+	// and its frame is only consumed once the last of them is queued. the
+	// remaining bytes are UINT64_MAX for a range open to the end of the media.
+	struct
+	{
+		bool_t active;
+		bool_t started;
+		uint64_t media_id;
+		uint32_t chunk;
+		uint32_t last;
+		uint64_t skip;
+		uint64_t remaining;
+	} range;
+
+	// note: the live channel, or NULL if no media is live, and the single
+	// subscription the connection may hold to it. live segments are queued
+	// straight from the buffer shared by all subscribers, and while the output
+	// is above the high watermark only the newest of them is held back, so
+	// that a subscriber that can not keep up skips ahead to the live edge.
+	server_live_s* live;
+
+	struct
+	{
+		bool_t active;
+		uint32_t stream_id;
+		uint64_t next_chunk;
+		server_cache_entry_s* pending;
+	} subscription;
+
+	// note: transient per-request objects are allocated from the arena, which
+	// is reset once the request has been handled. responses do not reference
+	// it, as they copy their framing into the output.
+	common_arena_s arena;
+
+	server_connection_stats_s stats;
+
+	// note: the statistics of the worker, which the connection adds its
+	// traffic to. the service time of a request runs from when its frame is
+	// first picked up to when the last of its responses is queued, and keeps
+	// running while it waits for a load or for room in the output.
+	server_stats_worker_s* worker_stats;
+	uint64_t serving_ns;
+
+	// note: the timers the reactor keeps for the connection. they fire at a
+	// fixed period and compare the progress made since the last time, so that
+	// traffic never has to touch the wheel.
+	struct
+	{
+		common_timer_s idle;
+		common_timer_s write;
+		common_timer_s keepalive;
+		uint64_t idle_mark;
+		uint64_t write_mark;
+		uint64_t keepalive_mark;
+	} timers;
+
+	// note: bookkeeping owned by the i/o backend driving the connection.
+	union
+	{
+		struct
+		{
+			bool_t readable;
+			bool_t writable;
+		} epoll;
+
+		struct
+		{
+			uint32_t pending;
+			uint32_t sending;
+			bool_t send_short;
+			bool_t receiving;
+			bool_t starved;
+			int32_t held_head;
+			int32_t held_tail;
+			uint32_t held_offset;
+			struct msghdr message;
+			struct iovec iovs[server_connection_segments_capacity];
+		} uring;
+	} io;
+};
+
+/**
+ * @brief Open the connection over an accepted socket.
+ * 
+ * @param connection   connection to open
+ * @param fd           accepted socket descriptor
+ * @param config       server configuration
+ * @param pool         pool of the worker the connection belongs to, which its
+ *                     buffers are taken from on demand
+ * @param cache        segment cache, or NULL if it is disabled
+ * @param live         live channel, or NULL if no media is live
+ * @param worker_stats statistics of the worker the connection belongs to
+ */
+void server_connection_open(server_connection_s* const connection, const int32_t fd, const server_config_s* const config, common_pool_s* const pool, server_cache_s* const cache, server_live_s* const live,
+	server_stats_worker_s* const worker_stats);
+
+/**
+ * @brief Close the connection, its socket and everything its output holds,
+ * returning its buffers to the pool.
+ * 
+ * @param connection connection to close
+ */
+void server_connection_close(server_connection_s* const connection);
+
+/**
+ * @brief Reserve the free tail of the input buffer, so that a backend can read
+ * into it directly. The buffer is taken from the pool if the connection holds
+ * none, and goes back to it once a commit leaves it empty, so a reservation
+ * that nothing was read into is committed with a size of 0.
+ * 
+ * @note The connection is marked as failed if no pooled buffer is left.
+ * 
+ * @param connection connection to reserve the input for
+ * @param data       pointer to the reserved space
+ * @param size       size of the reserved space
+ * 
+ * @return bool_t false if there is no space left in the input buffer
+ */
+bool_t server_connection_reserve_input(server_connection_s* const connection, uint8_t** const data, uint64_t* const size);
+
+/**
+ * @brief Commit bytes read into the reserved input space and process them.
+ * 
+ * @param connection connection to commit the input for
+ * @param size       number of bytes read
+ */
+void server_connection_commit_input(server_connection_s* const connection, const uint64_t size);
+
+/**
+ * @brief Process received bytes. While no partial frame is pending, frames are
+ * parsed straight from the received bytes, and only what can not be processed
+ * yet is copied into the input buffer.
+ * 
+ * @param connection connection to feed
+ * @param data       received bytes
+ * @param size       number of received bytes
+ * 
+ * @return uint64_t number of bytes absorbed, less than size if the connection
+ * can not take more input until its output gets flushed
+ */
+uint64_t server_connection_receive(server_connection_s* const connection, const uint8_t* const data, const uint64_t size);
+
+/**
+ * @brief Queue a file range for transmission after the pending output.
+ * 
+ * @note Depending on the data path, the range is either transmitted straight
+ * from the page cache (sendfile, or splice through a pipe when a header has to
+ * be interleaved) or read into the output buffer first.
+ * 
+ * @param connection    connection to queue the file range on
+ * @param fd            descriptor of the file
+ * @param owned         whether the descriptor is closed once the range is done
+ * @param offset        offset of the range in the file
+ * @param length        length of the range
+ * @param header        header transmitted right before the range, or NULL
+ * @param header_length length of the header
+ * 
+ * @return bool_t false if the output queue is full
+ */
+bool_t server_connection_queue_file(server_connection_s* const connection, const int32_t fd, const bool_t owned, const uint64_t offset, const uint64_t length, const uint8_t* const header, const uint64_t header_length);
+
+/**
+ * @brief Queue a range of a cache entry for transmission after the pending
+ * output. The range is transmitted straight from the entry, which takes no
+ * pooled buffer and no file read on either data path.
+ * 
+ * @param connection    connection to queue the range on
+ * @param entry         cache entry to transmit from, whose reference passes
+ *                      to the connection if the range is queued
+ * @param offset        offset of the range in the entry
+ * @param length        length of the range
+ * @param header        header transmitted right before the range, or NULL
+ * @param header_length length of the header
+ * 
+ * @return bool_t false if the output queue is full
+ */
+bool_t server_connection_queue_cached(server_connection_s* const connection, server_cache_entry_s* const entry, const uint64_t offset, const uint64_t length, const uint8_t* const header, const uint64_t header_length);
+
+/**
+ * @brief Queue a keepalive ping for transmission after the pending output.
+ * 
+ * @param connection connection to queue the ping on
+ * 
+ * @return bool_t false if the output queue is full
+ */
+bool_t server_connection_queue_ping(server_connection_s* const connection);
+
+/**
+ * @brief Queue a published live segment for a subscribed connection, unless
+ * the connection has seen it already. While the output is above the high
+ * watermark or full, the segment is held back in place of the one held back
+ * before, which is skipped.
+ * 
+ * @param connection connection to queue the segment on
+ * @param entry      entry of the segment, which is referenced anew if queued
+ */
+void server_connection_queue_live(server_connection_s* const connection, server_cache_entry_s* const entry);
+
+/**
+ * @brief Gather the leading memory and cached segments of the pending output
+ * into io vectors, in transmission order. It stops at the first file segment.
+ * 
+ * @param connection connection to gather the output from
+ * @param iovs       io vectors to fill
+ * @param capacity   capacity of the io vectors
+ * 
+ * @return uint64_t number of io vectors filled
+ */
+uint64_t server_connection_gather_output(server_connection_s* const connection, struct iovec* const iovs, const uint64_t capacity);
+
+/**
+ * @brief Get the file segment at the head of the pending output.
+ * 
+ * @param connection connection to get the file segment of
+ * 
+ * @return server_connection_segment_s* NULL if the head is not a file segment
+ */
+server_connection_segment_s* server_connection_head_file(server_connection_s* const connection);
+
+/**
+ * @brief Stage the file segment at the head of the pending output for its next
+ * read into the bounce buffer on the copy data path, so that a backend can
+ * read it asynchronously and complete it with @ref server_connection_commit_bounce.
+ * 
+ * @note The connection is marked as failed if no pooled buffer is left.
+ * 
+ * @param connection connection to stage the read for
+ * @param target     bounce buffer space to read into
+ * @param offset     offset in the file to read from
+ * 
+ * @return server_connection_segment_s* segment to read from, or NULL if no read
+ * is due
+ */
+server_connection_segment_s* server_connection_prepare_bounce(server_connection_s* const connection, struct iovec* const target, uint64_t* const offset);
+
+/**
+ * @brief Commit bytes read into the bounce buffer by a staged read.
+ * 
+ * @param connection connection to commit the read for
+ * @param size       number of bytes read
+ */
+void server_connection_commit_bounce(server_connection_s* const connection, const uint64_t size);
+
+/**
+ * @brief Transmit the head file segment on the zero-copy data path, without
+ * its bytes ever reaching userspace: a bare file range with sendfile, and one
+ * with a header through the pipe of the connection, which the header is
+ * written into and the range spliced in after. The socket must be in
+ * non-blocking mode, and it is never waited on.
+ * 
+ * @param connection connection to transmit the segment of
+ * @param segment    head file segment
+ * @param progress   set if any bytes were moved
+ * @param blocked    set if the socket could not take any more bytes
+ * 
+ * @return bool_t false if moving the segment failed
+ */
+bool_t server_connection_transmit_file(server_connection_s* const connection, server_connection_segment_s* const segment, bool_t* const progress, bool_t* const blocked);
+
+/**
+ * @brief Stage the head file segment into the pipe of the connection for a
+ * splice of its file range issued by the caller, so that a backend can read
+ * the file asynchronously and complete it with @ref server_connection_commit_file.
+ * The header, if any, is written into the pipe first.
+ * 
+ * @param connection connection to stage the segment of
+ * @param segment    head file segment
+ * @param offset     offset in the file to splice from
+ * @param length     number of bytes to splice, zero if no splice is due
+ * 
+ * @return bool_t false if staging the segment failed
+ */
+bool_t server_connection_stage_file(server_connection_s* const connection, server_connection_segment_s* const segment, uint64_t* const offset, uint64_t* const length);
+
+/**
+ * @brief Commit bytes spliced into the pipe by a staged splice.
+ * 
+ * @param connection connection to commit the splice for
+ * @param size       number of bytes spliced
+ */
+void server_connection_commit_file(server_connection_s* const connection, const uint64_t size);
+
+/**
+ * @brief Splice the bytes staged in the pipe of the connection into its
+ * socket. The socket must be in non-blocking mode, and it is never waited on.
+ * 
+ * @param connection connection to drain the pipe of
+ * @param segment    head file segment
+ * @param progress   set if any bytes were moved
+ * @param blocked    set if the socket could not take any more bytes
+ * 
+ * @return bool_t false if moving the bytes failed
+ */
+bool_t server_connection_drain_file(server_connection_s* const connection, server_connection_segment_s* const segment, bool_t* const progress, bool_t* const blocked);
+
+/**
+ * @brief Consume transmitted bytes from the head of the pending output.
+ * 
+ * @param connection connection to consume the output of
+ * @param size       number of transmitted bytes
+ */
+void server_connection_consume_output(server_connection_s* const connection, const uint64_t size);
+
+/**
+ * @brief Check if the connection stopped serving requests until the client
+ * takes more of its output.
+ * 
+ * @param connection connection to check
+ * 
+ * @return bool_t
+ */
+bool_t server_connection_is_throttled(const server_connection_s* const connection);
+
+/**
+ * @brief Check if the connection waits for a segment to be loaded into the
+ * cache before it serves further requests.
+ * 
+ * @param connection connection to check
+ * 
+ * @return bool_t
+ */
+bool_t server_connection_is_waiting(const server_connection_s* const connection);
+
+/**
+ * @brief Resume serving requests once the load the connection waited for is
+ * done.
+ * 
+ * @param connection connection to resume
+ */
+void server_connection_resume(server_connection_s* const connection);
+
+/**
+ * @brief Check if the connection is subscribed to the live channel.
+ * 
+ * @param connection connection to check
+ * 
+ * @return bool_t
+ */
+bool_t server_connection_is_subscribed(const server_connection_s* const connection);
+
+/**
+ * @brief Check if the connection has output pending.
+ * 
+ * @param connection connection to check
+ * 
+ * @return bool_t
+ */
+bool_t server_connection_has_output(const server_connection_s* const connection);
+
+/**
+ * @brief Check if the connection failed to produce its output, in which case
+ * it has to be released.
+ * 
+ * @param connection connection to check
+ * 
+ * @return bool_t
+ */
+bool_t server_connection_has_failed(const server_connection_s* const connection);
+
+/**
+ * @brief Mark that the connection failed to produce its output.
+ * 
+ * @param connection connection to mark
+ */
+void server_connection_fail(server_connection_s* const connection);
+
+/**
+ * @brief Mark that the peer has closed its side of the connection.
+ * 
+ * @param connection connection to mark
+ */
+void server_connection_shutdown_input(server_connection_s* const connection);
+
+/**
+ * @brief Check if the peer has closed its side and everything owed to it was
+ * transmitted.
+ * 
+ * @param connection connection to check
+ * 
+ * @return bool_t
+ */
+bool_t server_connection_is_finished(const server_connection_s* const connection);
+
+#endif
@@ -0,0 +1,39 @@
+
+/**
+ * @file library.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__library_h__
+#define __server__include__server__library_h__
+
+#include "common/scheduler.h"
+#include "common/types.h"
+
+#define server_library_read_size ((uint64_t)65536)
+
+/**
+ * @brief Scan the media library on the compute scheduler: every media directory
+ * is indexed and its segments are checksummed by a task of its own, and a
+ * summary is logged once all of them are done.
+ * 
+ * @note The scan reads every segment once, which also flags segments that can
+ * not be served before any client asks for them. It records a line of the form
+ * "<MEDIA>/<CHUNK>.seg <SIZE> <CHECKSUM>" for every segment to the checksums
+ * file, in no particular order, so that copies of the library can be compared.
+ * 
+ * @param scheduler scheduler to run the scan on
+ * @param root      directory the media is served from
+ * @param checksums path of the file to record the checksums to
+ * 
+ * @return bool_t false if the scan could not be submitted
+ */
+bool_t server_library_scan(common_scheduler_s* const scheduler, const char_t* const root, const char_t* const checksums);
+
+#endif
@@ -0,0 +1,158 @@
+
+/**
+ * @file live.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__live_h__
+#define __server__include__server__live_h__
+
+#include "common/types.h"
+
+#include "server/cache.h"
+
+#include <pthread.h>
+
+#define server_live_history_capacity ((uint64_t)4)
+#define server_live_events_size      ((uint64_t)4096)
+
+typedef struct
+{
+	void (*function)(void* const argument);
+	void* argument;
+} server_live_listener_s;
+
+typedef struct
+{
+	uint64_t published;
+	uint64_t failed;
+	uint64_t bytes;
+} server_live_stats_s;
+
+/**
+ * @brief A live channel: a media whose segments are written into its directory
+ * by an ingest while it is being served. Every segment that appears is read
+ * into memory once, and the very same buffer is queued to every subscriber.
+ * 
+ * @note Segments have to appear in order and complete, i.e. be closed after
+ * writing or renamed into the directory, as only newer segments than the last
+ * published one are picked up.
+ */
+typedef struct
+{
+	const char_t* root;
+	uint64_t media_id;
+
+	pthread_t thread;
+	int32_t inotify_fd;
+	int32_t wakeup_fd;
+	bool_t started;
+
+	// note: the listeners are registered before the channel is started and
+	// are called on its thread, so they only ever hand the news over.
+	server_live_listener_s* listeners;
+	uint64_t listeners_count;
+	uint64_t listeners_capacity;
+
+	// note: the most recently published segments, oldest first, so that a
+	// worker that falls behind by a few of them can still catch up.
+	pthread_mutex_t lock;
+	server_cache_entry_s* history[server_live_history_capacity];
+	uint64_t history_count;
+	server_live_stats_s stats;
+} server_live_s;
+
+/**
+ * @brief Create the live channel and start watching its directory.
+ * 
+ * @param live               live channel to create
+ * @param root               directory the media is served from
+ * @param media_id           id of the media that is live
+ * @param listeners_capacity number of listeners that may be registered
+ * 
+ * @return bool_t
+ */
+bool_t server_live_create(server_live_s* const live, const char_t* const root, const uint64_t media_id, const uint64_t listeners_capacity);
+
+/**
+ * @brief Destroy the live channel. It must not be running.
+ * 
+ * @param live live channel to destroy
+ */
+void server_live_destroy(server_live_s* const live);
+
+/**
+ * @brief Register a function that is called every time a segment gets
+ * published. It must only be called before the channel is started.
+ * 
+ * @param live     live channel to listen to
+ * @param function function to call, on the thread of the channel
+ * @param argument argument to pass to the function
+ * 
+ * @return bool_t false if there is no room for another listener
+ */
+bool_t server_live_listen(server_live_s* const live, void (*function)(void* const argument), void* const argument);
+
+/**
+ * @brief Publish the newest segment already in the directory as the live
+ * edge, and spawn the thread that publishes the ones that appear after it.
+ * 
+ * @param live live channel to start
+ * 
+ * @return bool_t
+ */
+bool_t server_live_start(server_live_s* const live);
+
+/**
+ * @brief Stop the thread of the live channel and wait for it to finish.
+ * 
+ * @param live live channel to stop
+ */
+void server_live_stop(server_live_s* const live);
+
+/**
+ * @brief Collect the published segments a reader has not seen yet.
+ * 
+ * @param live     live channel to collect from
+ * @param next     lowest chunk the reader has not seen yet
+ * @param entries  referenced entries, oldest first
+ * @param capacity capacity of the entries
+ * 
+ * @return uint64_t number of entries collected
+ */
+uint64_t server_live_collect(server_live_s* const live, const uint64_t next, server_cache_entry_s** const entries, const uint64_t capacity);
+
+/**
+ * @brief Get the newest published segment, which a new subscriber starts from.
+ * 
+ * @param live live channel to query
+ * 
+ * @return server_cache_entry_s* referenced entry, or NULL if nothing has been
+ * published yet
+ */
+server_cache_entry_s* server_live_edge(server_live_s* const live);
+
+/**
+ * @brief Get the id of the media that is live.
+ * 
+ * @param live live channel to query
+ * 
+ * @return uint64_t
+ */
+uint64_t server_live_media_id(const server_live_s* const live);
+
+/**
+ * @brief Get the statistics of the live channel.
+ * 
+ * @param live  live channel to query
+ * @param stats statistics to fill
+ */
+void server_live_stats(server_live_s* const live, server_live_stats_s* const stats);
+
+#endif
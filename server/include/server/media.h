@@ -0,0 +1,66 @@
+
+/**
+ * @file media.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__media_h__
+#define __server__include__server__media_h__
+
+#include "common/arena.h"
+#include "common/types.h"
+
+/**
+ * @brief Open a segment of a media for transmission.
+ * 
+ * @note Segments are stored as <root>/<media id>/<chunk>.seg.
+ * 
+ * @param arena    arena for transient allocations of the request
+ * @param root     directory the media is served from
+ * @param media_id id of the media
+ * @param chunk    index of the segment within the media
+ * @param fd       descriptor of the opened segment
+ * @param size     size of the opened segment
+ * 
+ * @return bool_t false if the segment does not exist or can not be served
+ */
+bool_t server_media_open_segment(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint32_t chunk, int32_t* const fd, uint64_t* const size);
+
+/**
+ * @brief Get the size of a segment of a media without opening it.
+ * 
+ * @param arena    arena for transient allocations of the request
+ * @param root     directory the media is served from
+ * @param media_id id of the media
+ * @param chunk    index of the segment within the media
+ * @param size     size of the segment
+ * 
+ * @return bool_t false if the segment does not exist or can not be served
+ */
+bool_t server_media_stat_segment(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint32_t chunk, uint64_t* const size);
+
+/**
+ * @brief Find the segment a byte offset falls into, with the segments of the
+ * media laid end to end.
+ * 
+ * @note Only the sizes of the segments before the offset are looked up, none
+ * of them is read.
+ * 
+ * @param arena    arena for transient allocations of the request
+ * @param root     directory the media is served from
+ * @param media_id id of the media
+ * @param offset   byte offset within the media
+ * @param chunk    index of the segment the offset falls into
+ * @param skip     offset within that segment
+ * 
+ * @return bool_t false if the offset is past the end of the media
+ */
+bool_t server_media_locate(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint64_t offset, uint32_t* const chunk, uint64_t* const skip);
+
+#endif
@@ -0,0 +1,162 @@
+
+/**
+ * @file reactor.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__reactor_h__
+#define __server__include__server__reactor_h__
+
+#include "common/types.h"
+#include "common/timer.h"
+#include "common/pool.h"
+
+#include "server/connection.h"
+#include "server/cache.h"
+#include "server/live.h"
+#include "server/stats.h"
+#include "server/backend.h"
+#include "server/config.h"
+
+#include <pthread.h>
+
+#define server_reactor_timer_resolution ((uint64_t)10)
+#define server_reactor_spare_connections ((uint64_t)256)
+
+struct server_reactor_s
+{
+	int32_t listen_fd;
+	int32_t wakeup_fd;
+	bool_t running;
+	bool_t stopping;
+	const server_config_s* config;
+
+	// note: the i/o buffers of the worker, from which the backend receives and
+	// the connections read files on the copy data path.
+	common_pool_s pool;
+
+	server_backend_s backend;
+
+	// note: the segment cache shared by all workers, or NULL if it is disabled.
+	// the waiters of the connections whose segment got loaded are handed over
+	// from the loading thread through the list, and the reactor is woken up to
+	// resume them.
+	server_cache_s* cache;
+	pthread_mutex_t loaded_lock;
+	server_cache_waiter_s* loaded;
+
+	// note: the live channel, or NULL if no media is live. the reactor is
+	// woken up whenever a segment gets published, and hands every segment
+	// from its cursor on to all of its subscribed connections.
+	server_live_s* live;
+	uint64_t live_next;
+
+	// note: the connection timeouts and keepalives, advanced every time the
+	// backend returns from waiting, which it does no later than the earliest
+	// of them is due.
+	common_timer_wheel_s timers;
+	uint64_t now_ms;
+
+	// note: the statistics of the worker, recorded only by its own thread and
+	// read by the stats endpoint without ever holding it up. every iteration
+	// of the event loop is busy from when the backend is done waiting up to
+	// the timers being advanced.
+	server_stats_worker_s* worker_stats;
+	uint64_t dispatched_ns;
+
+	// note: the connections by descriptor. a connection is allocated on
+	// accept and freed once closed, except for a few kept spare for the next
+	// accepts. a closed one is only set aside until the iteration of the event
+	// loop is over, as whatever closed it may still look at it.
+	server_connection_s** connections;
+	uint64_t connections_capacity;
+	uint64_t connections_count;
+	server_connection_s* closed;
+	server_connection_s* spare;
+	uint64_t spare_count;
+};
+
+/**
+ * @brief Create the reactor: bind and listen on the configured address, and
+ * set up the configured i/o backend around the listening socket.
+ * 
+ * @param reactor      reactor to create
+ * @param config       server configuration
+ * @param cache        segment cache, or NULL if it is disabled
+ * @param live         live channel, or NULL if no media is live
+ * @param worker_stats statistics of the worker the reactor belongs to
+ * 
+ * @return bool_t
+ */
+bool_t server_reactor_create(server_reactor_s* const reactor, const server_config_s* const config, server_cache_s* const cache, server_live_s* const live, server_stats_worker_s* const worker_stats);
+
+/**
+ * @brief Destroy the reactor, closing all of its connections and descriptors.
+ * 
+ * @param reactor reactor to destroy
+ */
+void server_reactor_destroy(server_reactor_s* const reactor);
+
+/**
+ * @brief Run the event loop until @ref server_reactor_stop is called.
+ * 
+ * @param reactor reactor to run
+ * 
+ * @return bool_t false if the loop stopped because of an unrecoverable error
+ */
+bool_t server_reactor_run(server_reactor_s* const reactor);
+
+/**
+ * @brief Request the event loop to stop.
+ * 
+ * @note It is async-signal-safe and may be called from any thread.
+ * 
+ * @param reactor reactor to stop
+ */
+void server_reactor_stop(server_reactor_s* const reactor);
+
+/**
+ * @brief Handle a wakeup of the event loop: resume the connections whose
+ * segment got loaded, hand newly published live segments to the subscribed
+ * connections, and stop the loop if it was requested to.
+ * 
+ * @note It is called by the backend once the wakeup eventfd is read.
+ * 
+ * @param reactor reactor that was woken up
+ */
+void server_reactor_wakeup(server_reactor_s* const reactor);
+
+/**
+ * @brief Mark that the backend is done waiting and starts dispatching events,
+ * which starts the busy part of the current iteration of the event loop.
+ * 
+ * @param reactor reactor whose backend is done waiting
+ */
+void server_reactor_dispatch(server_reactor_s* const reactor);
+
+/**
+ * @brief Open a connection over a socket accepted by the backend.
+ * 
+ * @param reactor reactor to open the connection in
+ * @param fd      accepted socket descriptor
+ * 
+ * @return server_connection_s* NULL if the connection could not be allocated,
+ * in which case the socket is closed
+ */
+server_connection_s* server_reactor_open_connection(server_reactor_s* const reactor, const int32_t fd);
+
+/**
+ * @brief Close a connection once the backend is done with it.
+ * 
+ * @param reactor    reactor the connection belongs to
+ * @param connection connection to close
+ */
+void server_reactor_close_connection(server_reactor_s* const reactor, server_connection_s* const connection);
+
+#endif
@@ -0,0 +1,201 @@
+
+/**
+ * @file stats.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__stats_h__
+#define __server__include__server__stats_h__
+
+#include "common/types.h"
+#include "common/queue.h"
+#include "common/histogram.h"
+#include "common/scheduler.h"
+
+#include "server/config.h"
+#include "server/cache.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+#define server_stats_request_size ((uint64_t)1024)
+#define server_stats_io_timeout   ((uint64_t)1000)
+
+typedef enum
+{
+	server_stats_connections_accepted,
+	server_stats_connections_closed,
+	server_stats_connections_failed,
+	server_stats_connections_expired,
+	server_stats_connections_open,
+	server_stats_bytes_received,
+	server_stats_bytes_sent,
+	server_stats_bytes_sendfile,
+	server_stats_bytes_spliced,
+	server_stats_bytes_copied,
+	server_stats_sends,
+	server_stats_frames_received,
+	server_stats_frames_sent,
+	server_stats_errors,
+	server_stats_cache_hits,
+	server_stats_cache_misses,
+	server_stats_throttled,
+	server_stats_queued_bytes,
+	server_stats_count,
+} server_stats_e;
+
+typedef enum
+{
+	server_stats_format_text,
+	server_stats_format_prometheus,
+} server_stats_format_e;
+
+/**
+ * @brief The statistics of a single worker, written by its thread alone. Each
+ * worker's lie on cache lines of their own, so that the workers never contend
+ * over them, and are only summed up when they are read.
+ * 
+ * @note Counters and gauges are updated with relaxed loads and stores rather
+ * than atomic read-modify-writes, as they only ever have a single writer.
+ */
+typedef struct
+{
+	_Alignas(common_queue_cache_line) uint64_t values[server_stats_count];
+
+	// note: the service time of every request served by the connections of
+	// the worker, and the time every iteration of its event loop spent busy,
+	// from when the backend is done waiting up to the timers being advanced.
+	common_histogram_s service;
+	common_histogram_s loop;
+} server_stats_worker_s;
+
+/**
+ * @brief The statistics of the server, along with the endpoint they are served
+ * on, a tcp port on the server address or a unix socket. Every connection to
+ * it is answered with the statistics and closed: an http request for /metrics
+ * is answered in the prometheus text format and any other for / or /stats as
+ * plain text, and so is a bare "metrics" or "stats" line.
+ * 
+ * @note The endpoint is served from a thread of its own, one connection at a
+ * time, so that reading the statistics never holds up a worker.
+ */
+typedef struct
+{
+	const server_config_s* config;
+
+	server_stats_worker_s* workers;
+	uint64_t workers_count;
+
+	// note: the segment cache and the compute scheduler, or NULL if they are
+	// disabled, whose shared state is reported along with the workers'.
+	server_cache_s* cache;
+	common_scheduler_s* compute;
+
+	pthread_t thread;
+	int32_t listen_fd;
+	int32_t wakeup_fd;
+	bool_t started;
+	uint64_t start_ms;
+} server_stats_s;
+
+/**
+ * @brief Create the statistics of the server, all of them zero.
+ * 
+ * @param stats         statistics to create
+ * @param config        server configuration
+ * @param workers_count number of workers
+ * @param cache         segment cache, or NULL if it is disabled
+ * @param compute       compute scheduler, or NULL if it is disabled
+ * 
+ * @return bool_t
+ */
+bool_t server_stats_create(server_stats_s* const stats, const server_config_s* const config, const uint64_t workers_count, server_cache_s* const cache, common_scheduler_s* const compute);
+
+/**
+ * @brief Destroy the statistics. The endpoint must not be running.
+ * 
+ * @param stats statistics to destroy
+ */
+void server_stats_destroy(server_stats_s* const stats);
+
+/**
+ * @brief Get the statistics of a worker, for its thread to record in.
+ * 
+ * @param stats statistics of the server
+ * @param index index of the worker
+ * 
+ * @return server_stats_worker_s*
+ */
+server_stats_worker_s* server_stats_worker(server_stats_s* const stats, const uint64_t index);
+
+/**
+ * @brief Open the configured endpoint and spawn the thread that serves it.
+ * It does nothing if no endpoint is configured.
+ * 
+ * @param stats statistics to serve
+ * 
+ * @return bool_t
+ */
+bool_t server_stats_start(server_stats_s* const stats);
+
+/**
+ * @brief Stop the thread serving the endpoint, wait for it to finish and close
+ * the endpoint.
+ * 
+ * @param stats statistics whose endpoint to stop
+ */
+void server_stats_stop(server_stats_s* const stats);
+
+/**
+ * @brief Sum up the statistics of all workers, from any thread.
+ * 
+ * @param stats statistics of the server
+ * @param total statistics to hold the sums
+ */
+void server_stats_collect(server_stats_s* const stats, server_stats_worker_s* const total);
+
+/**
+ * @brief Write the statistics of the server in the given format.
+ * 
+ * @param stats  statistics of the server
+ * @param format format to write them in
+ * @param file   stream to write them to
+ */
+void server_stats_write(server_stats_s* const stats, const server_stats_format_e format, FILE* const file);
+
+/**
+ * @brief Add to a counter or gauge of a worker. Only the thread of the worker
+ * may call it.
+ * 
+ * @param worker statistics of the worker
+ * @param which  counter or gauge to add to
+ * @param amount amount to add
+ */
+void server_stats_add(server_stats_worker_s* const worker, const server_stats_e which, const uint64_t amount);
+
+/**
+ * @brief Subtract from a gauge of a worker. Only the thread of the worker may
+ * call it.
+ * 
+ * @param worker statistics of the worker
+ * @param which  gauge to subtract from
+ * @param amount amount to subtract
+ */
+void server_stats_sub(server_stats_worker_s* const worker, const server_stats_e which, const uint64_t amount);
+
+/**
+ * @brief Set a gauge of a worker. Only the thread of the worker may call it.
+ * 
+ * @param worker statistics of the worker
+ * @param which  gauge to set
+ * @param value  value to set it to
+ */
+void server_stats_set(server_stats_worker_s* const worker, const server_stats_e which, const uint64_t value);
+
+#endif
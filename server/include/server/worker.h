@@ -0,0 +1,81 @@
+
+/**
+ * @file worker.h
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#ifndef __server__include__server__worker_h__
+#define __server__include__server__worker_h__
+
+#include "common/types.h"
+
+#include "server/reactor.h"
+#include "server/config.h"
+
+#include <pthread.h>
+
+typedef struct
+{
+	uint64_t index;
+	pthread_t thread;
+	server_reactor_s reactor;
+	bool_t status;
+} server_worker_s;
+
+/**
+ * @brief Create the worker and its reactor, with a listening socket of its own.
+ * 
+ * @note The reactor is set up on the calling thread, so that bind and listen
+ * errors are reported before any thread gets spawned.
+ * 
+ * @param worker worker to create
+ * @param config server configuration
+ * @param cache  segment cache, or NULL if it is disabled
+ * @param live   live channel, or NULL if no media is live
+ * @param index  index of the worker
+ * @param stats  statistics of the worker
+ * 
+ * @return bool_t
+ */
+bool_t server_worker_create(server_worker_s* const worker, const server_config_s* const config, server_cache_s* const cache, server_live_s* const live, const uint64_t index,
+	server_stats_worker_s* const stats);
+
+/**
+ * @brief Destroy the worker and its reactor. The worker must not be running.
+ * 
+ * @param worker worker to destroy
+ */
+void server_worker_destroy(server_worker_s* const worker);
+
+/**
+ * @brief Spawn the worker thread, which runs the reactor event loop.
+ * 
+ * @param worker worker to start
+ * 
+ * @return bool_t
+ */
+bool_t server_worker_start(server_worker_s* const worker);
+
+/**
+ * @brief Request the worker to stop. It is async-signal-safe.
+ * 
+ * @param worker worker to stop
+ */
+void server_worker_stop(server_worker_s* const worker);
+
+/**
+ * @brief Wait for the worker thread to finish.
+ * 
+ * @param worker worker to join
+ * 
+ * @return bool_t false if the worker event loop failed
+ */
+bool_t server_worker_join(server_worker_s* const worker);
+
+#endif
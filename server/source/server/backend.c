@@ -0,0 +1,138 @@
+
+/**
+ * @file backend.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/backend.h"
+
+bool_t server_backend_create(server_backend_s* const backend, server_reactor_s* const reactor, const server_io_backend_e kind)
+{
+	common_debug_assert(backend != NULL);
+	common_debug_assert(reactor != NULL);
+
+	switch (kind)
+	{
+		case server_io_backend_uring:
+		{
+			if (server_backend_uring_create(&backend->uring, reactor))
+			{
+				backend->kind = server_io_backend_uring;
+				return true;
+			}
+
+			common_logger_warn("io_uring backend is not available, falling back to epoll.");
+		} // fall through
+
+		case server_io_backend_epoll:
+		{
+			backend->kind = server_io_backend_epoll;
+			return server_backend_epoll_create(&backend->epoll, reactor);
+		} break;
+
+		default:
+		{
+			common_debug_assert(0);  // note: should not be reached.
+			return false;
+		} break;
+	}
+}
+
+void server_backend_destroy(server_backend_s* const backend)
+{
+	common_debug_assert(backend != NULL);
+
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { server_backend_uring_destroy(&backend->uring); } break;
+		case server_io_backend_epoll: { server_backend_epoll_destroy(&backend->epoll); } break;
+		default:                      { common_debug_assert(0);                        } break;
+	}
+}
+
+bool_t server_backend_start(server_backend_s* const backend)
+{
+	common_debug_assert(backend != NULL);
+
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { return server_backend_uring_start(&backend->uring); } break;
+		case server_io_backend_epoll: { return true;                                        } break;
+		default:                      { common_debug_assert(0); return false;               } break;
+	}
+}
+
+bool_t server_backend_wait(server_backend_s* const backend, const int32_t timeout_ms)
+{
+	common_debug_assert(backend != NULL);
+
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { return server_backend_uring_wait(&backend->uring, timeout_ms); } break;
+		case server_io_backend_epoll: { return server_backend_epoll_wait(&backend->epoll, timeout_ms); } break;
+		default:                      { common_debug_assert(0); return false;                          } break;
+	}
+}
+
+void server_backend_flush(server_backend_s* const backend, server_connection_s* const connection)
+{
+	common_debug_assert(backend != NULL);
+	common_debug_assert(connection != NULL);
+
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { server_backend_uring_flush(&backend->uring, connection); } break;
+		case server_io_backend_epoll: { server_backend_epoll_flush(&backend->epoll, connection); } break;
+		default:                      { common_debug_assert(0);                                  } break;
+	}
+}
+
+void server_backend_resume(server_backend_s* const backend, server_connection_s* const connection)
+{
+	common_debug_assert(backend != NULL);
+	common_debug_assert(connection != NULL);
+
+	// note: an epoll connection is driven in both directions on every flush.
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { server_backend_uring_resume(&backend->uring, connection); } break;
+		case server_io_backend_epoll: { server_backend_epoll_flush(&backend->epoll, connection);  } break;
+		default:                      { common_debug_assert(0);                                   } break;
+	}
+}
+
+void server_backend_release(server_backend_s* const backend, server_connection_s* const connection)
+{
+	common_debug_assert(backend != NULL);
+	common_debug_assert(connection != NULL);
+
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { server_backend_uring_release(&backend->uring, connection); } break;
+		case server_io_backend_epoll: { server_backend_epoll_release(&backend->epoll, connection); } break;
+		default:                      { common_debug_assert(0);                                    } break;
+	}
+}
+
+const char_t* server_backend_name(const server_backend_s* const backend)
+{
+	common_debug_assert(backend != NULL);
+
+	switch (backend->kind)
+	{
+		case server_io_backend_uring: { return "io_uring"; } break;
+		case server_io_backend_epoll: { return "epoll";    } break;
+		default:                      { return "unknown";  } break;
+	}
+}
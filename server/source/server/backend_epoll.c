@@ -0,0 +1,364 @@
+
+/**
+ * @file backend_epoll.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/backend_epoll.h"
+#include "server/reactor.h"
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <string.h>
+#include <errno.h>
+
+static void _accept_connections(server_backend_epoll_s* const epoll);
+
+static void _drive_connection(server_backend_epoll_s* const epoll, server_connection_s* const connection);
+
+static bool_t _write_output(server_connection_s* const connection, bool_t* const progress);
+
+static bool_t _read_input(server_connection_s* const connection, bool_t* const progress);
+
+bool_t server_backend_epoll_create(server_backend_epoll_s* const epoll, server_reactor_s* const reactor)
+{
+	common_debug_assert(epoll != NULL);
+	common_debug_assert(reactor != NULL);
+
+	epoll->reactor = reactor;
+	epoll->fd      = epoll_create1(EPOLL_CLOEXEC);
+
+	if (epoll->fd < 0)
+	{
+		common_logger_error("failed to create the epoll instance: %s.", strerror(errno));
+		return false;
+	}
+
+	struct epoll_event listen_event = { .events = EPOLLIN | EPOLLET, .data.fd = reactor->listen_fd };
+	struct epoll_event wakeup_event = { .events = EPOLLIN,           .data.fd = reactor->wakeup_fd };
+
+	if ((epoll_ctl(epoll->fd, EPOLL_CTL_ADD, reactor->listen_fd, &listen_event) < 0) ||
+		(epoll_ctl(epoll->fd, EPOLL_CTL_ADD, reactor->wakeup_fd, &wakeup_event) < 0))
+	{
+		common_logger_error("failed to register the reactor descriptors: %s.", strerror(errno));
+		server_backend_epoll_destroy(epoll);
+		return false;
+	}
+
+	return true;
+}
+
+void server_backend_epoll_destroy(server_backend_epoll_s* const epoll)
+{
+	common_debug_assert(epoll != NULL);
+
+	if (epoll->fd >= 0)
+	{
+		(void)close(epoll->fd);
+		epoll->fd = -1;
+	}
+}
+
+bool_t server_backend_epoll_wait(server_backend_epoll_s* const epoll, const int32_t timeout_ms)
+{
+	common_debug_assert(epoll != NULL);
+
+	server_reactor_s* const reactor = epoll->reactor;
+	struct epoll_event events[server_backend_epoll_events_capacity];
+
+	const int32_t count = epoll_wait(epoll->fd, events, (int32_t)server_backend_epoll_events_capacity, timeout_ms);
+
+	if (count < 0)
+	{
+		if (EINTR == errno)
+		{
+			return true;
+		}
+
+		common_logger_error("failed to wait for reactor events: %s.", strerror(errno));
+		return false;
+	}
+
+	server_reactor_dispatch(reactor);
+
+	for (int32_t index = 0; index < count; ++index)
+	{
+		const int32_t fd = events[index].data.fd;
+		const uint32_t flags = events[index].events;
+
+		if (fd == reactor->listen_fd)
+		{
+			_accept_connections(epoll);
+		}
+		else if (fd == reactor->wakeup_fd)
+		{
+			uint64_t value = 0;
+			(void)!read(reactor->wakeup_fd, &value, sizeof(value));
+			server_reactor_wakeup(reactor);
+		}
+		else if ((uint64_t)fd < reactor->connections_capacity)
+		{
+			server_connection_s* const connection = reactor->connections[fd];
+
+			if ((NULL == connection) || (server_connection_state_closed == connection->state))
+			{
+				continue;
+			}
+
+			// note: errors and hang-ups are surfaced by the next read or write.
+			if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+			{
+				connection->io.epoll.readable = true;
+			}
+
+			if (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+			{
+				connection->io.epoll.writable = true;
+			}
+
+			_drive_connection(epoll, connection);
+		}
+	}
+
+	return true;
+}
+
+void server_backend_epoll_flush(server_backend_epoll_s* const epoll, server_connection_s* const connection)
+{
+	common_debug_assert(epoll != NULL);
+	common_debug_assert(connection != NULL);
+	_drive_connection(epoll, connection);
+}
+
+void server_backend_epoll_release(server_backend_epoll_s* const epoll, server_connection_s* const connection)
+{
+	common_debug_assert(epoll != NULL);
+	common_debug_assert(connection != NULL);
+
+	// note: closing the descriptor removes it from the epoll interest list.
+	if (connection->state != server_connection_state_closed)
+	{
+		server_reactor_close_connection(epoll->reactor, connection);
+	}
+}
+
+static void _accept_connections(server_backend_epoll_s* const epoll)
+{
+	common_debug_assert(epoll != NULL);
+
+	server_reactor_s* const reactor = epoll->reactor;
+
+	while (true)
+	{
+		const int32_t fd = accept4(reactor->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+		if (fd < 0)
+		{
+			if ((EINTR == errno) || (ECONNABORTED == errno))
+			{
+				continue;
+			}
+
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+			{
+				common_logger_warn("failed to accept a connection: %s.", strerror(errno));
+			}
+
+			break;
+		}
+
+		server_connection_s* const connection = server_reactor_open_connection(reactor, fd);
+
+		if (NULL == connection)
+		{
+			continue;
+		}
+
+		struct epoll_event event = { .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, .data.fd = fd };
+
+		if (epoll_ctl(epoll->fd, EPOLL_CTL_ADD, fd, &event) < 0)
+		{
+			common_logger_warn("failed to register connection %d: %s.", fd, strerror(errno));
+			server_reactor_close_connection(reactor, connection);
+		}
+	}
+}
+
+static void _drive_connection(server_backend_epoll_s* const epoll, server_connection_s* const connection)
+{
+	common_debug_assert(epoll != NULL);
+	common_debug_assert(connection != NULL);
+
+	if (connection->state == server_connection_state_closed)
+	{
+		return;
+	}
+
+	// note: edge-triggered readiness is reported only once, so the connection
+	// keeps cycling between writing and reading until neither direction makes
+	// progress, i.e. the socket would block or the buffers are exhausted.
+	bool_t progress = true;
+
+	while (progress)
+	{
+		progress = false;
+
+		if (!_write_output(connection, &progress) || !_read_input(connection, &progress) ||
+			server_connection_has_failed(connection))
+		{
+			server_backend_epoll_release(epoll, connection);
+			return;
+		}
+	}
+
+	if (server_connection_is_finished(connection))
+	{
+		server_backend_epoll_release(epoll, connection);
+	}
+}
+
+static bool_t _write_output(server_connection_s* const connection, bool_t* const progress)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(progress != NULL);
+
+	if (!connection->io.epoll.writable || !server_connection_has_output(connection))
+	{
+		return true;
+	}
+
+	server_connection_segment_s* const segment = server_connection_head_file(connection);
+
+	if (segment != NULL)
+	{
+		bool_t blocked = false;
+
+		if (!server_connection_transmit_file(connection, segment, progress, &blocked))
+		{
+			return false;
+		}
+
+		connection->io.epoll.writable = !blocked;
+		return true;
+	}
+
+	struct iovec iovs[IOV_MAX < 64 ? IOV_MAX : 64];
+	const uint64_t count = server_connection_gather_output(connection, iovs, sizeof(iovs) / sizeof(*iovs));
+
+	if (server_connection_has_failed(connection))
+	{
+		return false;
+	}
+
+	if (0 == count)
+	{
+		return true;
+	}
+
+	uint64_t length = 0;
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		length += iovs[index].iov_len;
+	}
+
+	// note: everything gathered goes out in one call, corked with MSG_MORE
+	// while more output is queued behind it, e.g. a file segment transmitted
+	// by the next call, so that small frames do not go out as segments of
+	// their own.
+	const struct msghdr message =
+	{
+		.msg_iov    = iovs,
+		.msg_iovlen = count,
+	};
+
+	const int32_t more = (length < connection->queued) ? MSG_MORE : 0;
+	const ssize_t result = sendmsg(connection->fd, &message, MSG_NOSIGNAL | more);
+	++connection->stats.sends;
+	server_stats_add(connection->worker_stats, server_stats_sends, 1);
+
+	if (result >= 0)
+	{
+		server_connection_consume_output(connection, (uint64_t)result);
+		*progress = true;
+	}
+	else if (EINTR == errno)
+	{
+		*progress = true;
+	}
+	else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+	{
+		connection->io.epoll.writable = false;
+	}
+	else
+	{
+		common_logger_debug("write on connection %d failed: %s.", connection->fd, strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+static bool_t _read_input(server_connection_s* const connection, bool_t* const progress)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(progress != NULL);
+
+	uint8_t* space = NULL;
+	uint64_t space_size = 0;
+
+	if (!connection->io.epoll.readable || (connection->state != server_connection_state_open) ||
+		server_connection_is_throttled(connection) || server_connection_is_waiting(connection) ||
+		!server_connection_reserve_input(connection, &space, &space_size))
+	{
+		return true;
+	}
+
+	const ssize_t result = read(connection->fd, space, space_size);
+	const int32_t error  = errno;
+
+	// note: a read that took nothing is committed all the same, so that the
+	// input buffer goes back to the pool if it holds nothing.
+	server_connection_commit_input(connection, (result > 0) ? (uint64_t)result : 0);
+
+	if (result > 0)
+	{
+		*progress = true;
+	}
+	else if (0 == result)
+	{
+		server_connection_shutdown_input(connection);
+		connection->io.epoll.readable = false;
+		*progress = true;
+	}
+	else if (EINTR == error)
+	{
+		*progress = true;
+	}
+	else if ((EAGAIN == error) || (EWOULDBLOCK == error))
+	{
+		connection->io.epoll.readable = false;
+	}
+	else
+	{
+		common_logger_debug("read on connection %d failed: %s.", connection->fd, strerror(error));
+		return false;
+	}
+
+	return true;
+}
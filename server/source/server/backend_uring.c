@@ -0,0 +1,1188 @@
+
+/**
+ * @file backend_uring.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/backend_uring.h"
+#include "server/reactor.h"
+
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+
+typedef enum
+{
+	_operation_accept = 1,
+	_operation_wakeup,
+	_operation_recv,
+	_operation_send,
+	_operation_poll,
+	_operation_read,
+	_operation_splice,
+	_operation_cancel,
+} _operation_e;
+
+#define _send_length_limit ((uint64_t)0xFFFFFF)
+
+static uint64_t _encode_user_data(const _operation_e operation, const int32_t fd, const uint64_t length);
+
+static _operation_e _decode_operation(const uint64_t user_data);
+
+static int32_t _decode_fd(const uint64_t user_data);
+
+static uint64_t _decode_length(const uint64_t user_data);
+
+static int32_t _enter(const int32_t fd, const uint32_t to_submit, const uint32_t min_complete, const uint32_t flags, const void* const argument, const uint64_t argument_size);
+
+static bool_t _map_rings(server_backend_uring_s* const uring, const struct io_uring_params* const params);
+
+static bool_t _register_buffers(server_backend_uring_s* const uring);
+
+static void _register_pool(server_backend_uring_s* const uring);
+
+static bool_t _reserve_sqes(server_backend_uring_s* const uring, const uint32_t count);
+
+static struct io_uring_sqe* _get_sqe(server_backend_uring_s* const uring);
+
+static bool_t _submit(server_backend_uring_s* const uring);
+
+static void _recycle_buffer(server_backend_uring_s* const uring, const uint16_t buffer);
+
+static void _arm_accept(server_backend_uring_s* const uring);
+
+static void _arm_wakeup(server_backend_uring_s* const uring);
+
+static void _arm_recv(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+static void _cancel(server_backend_uring_s* const uring, server_connection_s* const connection, const bool_t everything);
+
+static void _arm_poll(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+static void _read_file(server_backend_uring_s* const uring, server_connection_s* const connection, const server_connection_segment_s* const segment, const struct iovec* const target, const uint64_t offset);
+
+static void _splice_file(server_backend_uring_s* const uring, server_connection_s* const connection, const server_connection_segment_s* const segment, const uint64_t offset, const uint64_t length);
+
+static void _complete_send(server_connection_s* const connection, const _operation_e operation, const uint64_t size);
+
+static void _feed_held(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+static void _drop_held(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+static void _settle(server_backend_uring_s* const uring, server_connection_s* const connection);
+
+static server_connection_s* _lookup(server_backend_uring_s* const uring, const int32_t fd);
+
+static void _handle_accept(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe);
+
+static void _handle_recv(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe);
+
+static void _handle_send(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe);
+
+static void _handle_poll(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe);
+
+static void _handle_cancel(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe);
+
+static void _handle_wakeup(server_backend_uring_s* const uring);
+
+static void _rearm_starved(server_backend_uring_s* const uring);
+
+bool_t server_backend_uring_create(server_backend_uring_s* const uring, server_reactor_s* const reactor)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(reactor != NULL);
+
+	(void)memset(uring, 0, sizeof(*uring));
+	uring->reactor = reactor;
+
+	// note: the single issuer and deferred task running flags require a 6.1+
+	// kernel, which also covers multishot accept, multishot recv and provided
+	// buffer rings. the ring is created disabled so that the worker thread can
+	// become its issuer when it enables it.
+	struct io_uring_params params =
+	{
+		.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SINGLE_ISSUER |
+			IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED | IORING_SETUP_CQSIZE,
+		.cq_entries = server_backend_uring_entries * 4,
+	};
+
+	uring->fd = (int32_t)syscall(__NR_io_uring_setup, server_backend_uring_entries, &params);
+
+	if (uring->fd < 0)
+	{
+		common_logger_debug("failed to set up the io_uring instance: %s.", strerror(errno));
+		return false;
+	}
+
+	const uint32_t required_features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_FAST_POLL;
+
+	if ((params.features & required_features) != required_features)
+	{
+		common_logger_debug("the io_uring instance lacks required features: %#x.", params.features);
+		goto server_backend_uring_create_failed;
+	}
+
+	if (!_map_rings(uring, &params) || !_register_buffers(uring))
+	{
+		goto server_backend_uring_create_failed;
+	}
+
+	_register_pool(uring);
+
+	// note: the ring waits for readiness by itself, so the listening socket is
+	// switched to blocking mode, otherwise older kernels complete the accepts
+	// with -EAGAIN instead of arming a poll for them.
+	const int32_t listen_flags = fcntl(reactor->listen_fd, F_GETFL);
+
+	if ((listen_flags < 0) || (fcntl(reactor->listen_fd, F_SETFL, listen_flags & ~O_NONBLOCK) < 0))
+	{
+		common_logger_debug("failed to switch the listening socket to blocking mode: %s.", strerror(errno));
+		goto server_backend_uring_create_failed;
+	}
+
+	_arm_accept(uring);
+	_arm_wakeup(uring);
+	return true;
+
+server_backend_uring_create_failed:
+	server_backend_uring_destroy(uring);
+	return false;
+}
+
+void server_backend_uring_destroy(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	// note: closing the ring cancels every operation in flight, so the memory
+	// shared with the kernel is unmapped only afterwards.
+	if (uring->fd >= 0)
+	{
+		(void)close(uring->fd);
+		uring->fd = -1;
+	}
+
+	for (uint32_t index = 0; index < server_backend_uring_buffers_count; ++index)
+	{
+		if (uring->buffers[index] != NULL)
+		{
+			common_pool_release(uring->buffers[index]);
+			uring->buffers[index] = NULL;
+		}
+	}
+
+	if (uring->buffers_ring != NULL) { (void)munmap(uring->buffers_ring, uring->buffers_ring_size); }
+	if (uring->sqes         != NULL) { (void)munmap(uring->sqes, uring->sqes_size);                  }
+	if (uring->rings        != NULL) { (void)munmap(uring->rings, uring->rings_size);                }
+
+	uring->buffers_ring = NULL;
+	uring->sqes         = NULL;
+	uring->rings        = NULL;
+
+	free(uring->starved);
+	uring->starved          = NULL;
+	uring->starved_count    = 0;
+	uring->starved_capacity = 0;
+}
+
+bool_t server_backend_uring_start(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	if (syscall(__NR_io_uring_register, uring->fd, IORING_REGISTER_ENABLE_RINGS, NULL, 0) < 0)
+	{
+		common_logger_error("failed to enable the io_uring instance: %s.", strerror(errno));
+		return false;
+	}
+
+	// note: the io-wq threads belong to the issuing thread, so they are capped
+	// from it. the ring only hands them file reads that would block, which are
+	// then never spread over more threads than the limit.
+	uint32_t workers[2] = { server_backend_uring_iowq_workers, server_backend_uring_iowq_workers };
+
+	if (syscall(__NR_io_uring_register, uring->fd, IORING_REGISTER_IOWQ_MAX_WORKERS, workers, 2) < 0)
+	{
+		common_logger_debug("failed to cap the io-wq workers: %s.", strerror(errno));
+	}
+
+	return _submit(uring);
+}
+
+bool_t server_backend_uring_wait(server_backend_uring_s* const uring, const int32_t timeout_ms)
+{
+	common_debug_assert(uring != NULL);
+
+	uint32_t head = *uring->cq_head;
+	const bool_t ready = head != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+	// note: queued operations are submitted with the same system call that
+	// waits for completions. with deferred task running the kernel also posts
+	// the completions from within that call.
+	if (!ready || (uring->sq_unsubmitted > 0))
+	{
+		const uint32_t wait_for = ready ? 0 : 1;
+		int32_t result = 0;
+
+		if ((timeout_ms < 0) || ready)
+		{
+			result = _enter(uring->fd, uring->sq_unsubmitted, wait_for, IORING_ENTER_GETEVENTS, NULL, 0);
+		}
+		else
+		{
+			struct __kernel_timespec timeout =
+			{
+				.tv_sec  = timeout_ms / 1000,
+				.tv_nsec = (timeout_ms % 1000) * 1000000,
+			};
+
+			struct io_uring_getevents_arg argument = { .ts = (uint64_t)(uintptr_t)&timeout };
+			result = _enter(uring->fd, uring->sq_unsubmitted, wait_for, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &argument, sizeof(argument));
+		}
+
+		if (result >= 0)
+		{
+			uring->sq_unsubmitted -= (uint32_t)result;
+		}
+		else if ((result != -EINTR) && (result != -ETIME) && (result != -EBUSY) && (result != -EAGAIN))
+		{
+			common_logger_error("failed to wait for io_uring completions: %s.", strerror(-result));
+			return false;
+		}
+	}
+
+	server_reactor_dispatch(uring->reactor);
+	uring->buffers_recycled = false;
+	const uint32_t tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; ++head)
+	{
+		const struct io_uring_cqe* const cqe = &uring->cqes[head & uring->cq_mask];
+
+		switch (_decode_operation(cqe->user_data))
+		{
+			case _operation_accept: { _handle_accept(uring, cqe); } break;
+			case _operation_wakeup: { _handle_wakeup(uring);      } break;
+			case _operation_recv:   { _handle_recv(uring, cqe);   } break;
+			case _operation_send:   { _handle_send(uring, cqe);   } break;
+			case _operation_poll:   { _handle_poll(uring, cqe);   } break;
+			case _operation_read:   { _handle_send(uring, cqe);   } break;
+			case _operation_splice: { _handle_send(uring, cqe);   } break;
+			case _operation_cancel: { _handle_cancel(uring, cqe); } break;
+			default:                { common_debug_assert(0);     } break;
+		}
+	}
+
+	__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+	if (uring->buffers_recycled)
+	{
+		_rearm_starved(uring);
+	}
+
+	return true;
+}
+
+void server_backend_uring_flush(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	if ((connection->io.uring.sending > 0) || (connection->state == server_connection_state_closing) ||
+		(connection->state == server_connection_state_closed))
+	{
+		return;
+	}
+
+	// note: the file range of a file segment is spliced into the pipe of the
+	// connection by the ring, whose worker threads absorb a cold page cache,
+	// and the pipe is drained into the socket right here. the ring is not left
+	// to splice into the socket, as it would hand that to a worker thread that
+	// then blocks on the socket of a slow reader. once the socket is full, a
+	// poll waits for room in it instead.
+	server_connection_segment_s* segment = server_connection_head_file(connection);
+
+	while (segment != NULL)
+	{
+		uint64_t offset = 0;
+		uint64_t length = 0;
+		bool_t progress = false;
+		bool_t blocked  = false;
+
+		if (!server_connection_stage_file(connection, segment, &offset, &length) ||
+			!server_connection_drain_file(connection, segment, &progress, &blocked))
+		{
+			server_connection_fail(connection);
+			return;
+		}
+
+		if (blocked)
+		{
+			_arm_poll(uring, connection);
+			return;
+		}
+
+		// note: the pipe is drained before it is filled again, so the room it
+		// was staged with only grows while the splice is in flight.
+		if (progress)
+		{
+			segment = server_connection_head_file(connection);
+			continue;
+		}
+
+		if (length > 0)
+		{
+			_splice_file(uring, connection, segment, offset, length);
+		}
+		else
+		{
+			_arm_poll(uring, connection);
+		}
+
+		return;
+	}
+
+	struct iovec target = {0};
+	uint64_t offset = 0;
+	const server_connection_segment_s* const bounced = server_connection_prepare_bounce(connection, &target, &offset);
+
+	if (bounced != NULL)
+	{
+		_read_file(uring, connection, bounced, &target, offset);
+		return;
+	}
+
+	if (server_connection_has_failed(connection))
+	{
+		return;
+	}
+
+	struct iovec* const iovs = connection->io.uring.iovs;
+	uint64_t count = server_connection_gather_output(connection, iovs, server_connection_segments_capacity);
+
+	if ((0 == count) || !_reserve_sqes(uring, 1))
+	{
+		return;
+	}
+
+	uint64_t length = 0;
+
+	// note: cached segments can be gathered whole, so the message is cut down
+	// to what the user data can carry, and the rest goes out with the next.
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		if ((length + iovs[index].iov_len) >= _send_length_limit)
+		{
+			iovs[index].iov_len = _send_length_limit - length;
+			count = index + 1;
+		}
+
+		length += iovs[index].iov_len;
+	}
+
+	// note: all of the gathered output goes out as a single message, and
+	// MSG_WAITALL makes the kernel retry a partial send instead of completing
+	// it short. MSG_MORE corks the message while more output is queued behind
+	// it, so that small frames share segments with whatever follows them.
+	const int32_t more = (length < connection->queued) ? MSG_MORE : 0;
+
+	connection->io.uring.message = (const struct msghdr)
+	{
+		.msg_iov    = iovs,
+		.msg_iovlen = count,
+	};
+
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode    = IORING_OP_SENDMSG;
+	sqe->fd        = connection->fd;
+	sqe->addr      = (uint64_t)(uintptr_t)&connection->io.uring.message;
+	sqe->len       = 1;
+	sqe->msg_flags = (uint32_t)(MSG_NOSIGNAL | MSG_WAITALL | more);
+	sqe->user_data = _encode_user_data(_operation_send, connection->fd, length);
+
+	++connection->io.uring.sending;
+	++connection->io.uring.pending;
+}
+
+void server_backend_uring_resume(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+	_settle(uring, connection);
+}
+
+void server_backend_uring_release(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	if ((connection->state == server_connection_state_closing) || (connection->state == server_connection_state_closed))
+	{
+		return;
+	}
+
+	_drop_held(uring, connection);
+
+	if (0 == connection->io.uring.pending)
+	{
+		server_reactor_close_connection(uring->reactor, connection);
+		return;
+	}
+
+	// note: the descriptor stays open until every in-flight operation on it has
+	// completed, so its number (and the connection slot) can not be reused
+	// while the kernel may still touch the connection buffers.
+	connection->state = server_connection_state_closing;
+	(void)shutdown(connection->fd, SHUT_RDWR);
+	_cancel(uring, connection, true);
+}
+
+static uint64_t _encode_user_data(const _operation_e operation, const int32_t fd, const uint64_t length)
+{
+	return ((uint64_t)operation) | (((uint64_t)(uint32_t)fd) << 8) | ((length & _send_length_limit) << 40);
+}
+
+static _operation_e _decode_operation(const uint64_t user_data)
+{
+	return (_operation_e)(user_data & 0xFF);
+}
+
+static int32_t _decode_fd(const uint64_t user_data)
+{
+	return (int32_t)(uint32_t)((user_data >> 8) & 0xFFFFFFFF);
+}
+
+static uint64_t _decode_length(const uint64_t user_data)
+{
+	return (user_data >> 40) & _send_length_limit;
+}
+
+static int32_t _enter(const int32_t fd, const uint32_t to_submit, const uint32_t min_complete, const uint32_t flags, const void* const argument, const uint64_t argument_size)
+{
+	const long result = syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, argument, argument_size);
+	return (result < 0) ? -errno : (int32_t)result;
+}
+
+static bool_t _map_rings(server_backend_uring_s* const uring, const struct io_uring_params* const params)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(params != NULL);
+
+	const uint64_t sq_size = params->sq_off.array + params->sq_entries * sizeof(uint32_t);
+	const uint64_t cq_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+
+	uring->rings_size = (sq_size > cq_size) ? sq_size : cq_size;
+	uring->rings = mmap(NULL, uring->rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+
+	if (MAP_FAILED == uring->rings)
+	{
+		uring->rings = NULL;
+		common_logger_debug("failed to map the io_uring rings: %s.", strerror(errno));
+		return false;
+	}
+
+	uring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+	uring->sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+
+	if (MAP_FAILED == uring->sqes)
+	{
+		uring->sqes = NULL;
+		common_logger_debug("failed to map the io_uring submission entries: %s.", strerror(errno));
+		return false;
+	}
+
+	uint8_t* const rings = (uint8_t*)uring->rings;
+
+	uring->sq_head    = (uint32_t*)(rings + params->sq_off.head);
+	uring->sq_tail    = (uint32_t*)(rings + params->sq_off.tail);
+	uring->sq_mask    = *(uint32_t*)(rings + params->sq_off.ring_mask);
+	uring->sq_entries = params->sq_entries;
+
+	uring->cq_head = (uint32_t*)(rings + params->cq_off.head);
+	uring->cq_tail = (uint32_t*)(rings + params->cq_off.tail);
+	uring->cq_mask = *(uint32_t*)(rings + params->cq_off.ring_mask);
+	uring->cqes    = (struct io_uring_cqe*)(rings + params->cq_off.cqes);
+
+	// note: the submission array maps ring slots one to one onto entries.
+	uint32_t* const array = (uint32_t*)(rings + params->sq_off.array);
+
+	for (uint32_t index = 0; index < uring->sq_entries; ++index)
+	{
+		array[index] = index;
+	}
+
+	return true;
+}
+
+static bool_t _register_buffers(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+	const uint64_t ring_size = server_backend_uring_buffers_count * sizeof(struct io_uring_buf);
+
+	uring->buffers_ring_size = (ring_size + page_size - 1) & ~(page_size - 1);
+	uring->buffers_ring = mmap(NULL, uring->buffers_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (MAP_FAILED == uring->buffers_ring)
+	{
+		uring->buffers_ring = NULL;
+		common_logger_debug("failed to map the provided buffer ring: %s.", strerror(errno));
+		return false;
+	}
+
+	for (uint32_t index = 0; index < server_backend_uring_buffers_count; ++index)
+	{
+		uring->buffers[index] = common_pool_acquire(&uring->reactor->pool);
+
+		if (NULL == uring->buffers[index])
+		{
+			common_logger_debug("the buffer pool is too small for the provided buffer ring.");
+			return false;
+		}
+	}
+
+	struct io_uring_buf_reg registration =
+	{
+		.ring_addr    = (uint64_t)(uintptr_t)uring->buffers_ring,
+		.ring_entries = server_backend_uring_buffers_count,
+		.bgid         = 0,
+	};
+
+	if (syscall(__NR_io_uring_register, uring->fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0)
+	{
+		common_logger_debug("failed to register the provided buffer ring: %s.", strerror(errno));
+		return false;
+	}
+
+	uring->buffers_tail = 0;
+
+	for (uint32_t index = 0; index < server_backend_uring_buffers_count; ++index)
+	{
+		_recycle_buffer(uring, (uint16_t)index);
+	}
+
+	return true;
+}
+
+static void _register_pool(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	const common_pool_s* const pool = &uring->reactor->pool;
+	struct iovec* const iovecs = malloc(pool->count * sizeof(*iovecs));
+
+	if (NULL == iovecs)
+	{
+		return;
+	}
+
+	// note: fixed buffers spare the kernel from pinning the pages of every read
+	// into them. the registration counts against the locked memory limit, so it
+	// is optional and reads fall back to regular buffers without it.
+	common_pool_iovecs(pool, iovecs);
+	uring->buffers_fixed = syscall(__NR_io_uring_register, uring->fd, IORING_REGISTER_BUFFERS, iovecs, pool->count) >= 0;
+
+	if (!uring->buffers_fixed)
+	{
+		common_logger_debug("failed to register the buffer pool as fixed buffers: %s.", strerror(errno));
+	}
+
+	free(iovecs);
+}
+
+static bool_t _reserve_sqes(server_backend_uring_s* const uring, const uint32_t count)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(count <= uring->sq_entries);
+
+	const uint32_t used = *uring->sq_tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+
+	if ((uring->sq_entries - used) >= count)
+	{
+		return true;
+	}
+
+	return _submit(uring);
+}
+
+static struct io_uring_sqe* _get_sqe(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	if (!_reserve_sqes(uring, 1))
+	{
+		// note: the kernel could not take the queue even once, which leaves no
+		// way to make progress.
+		common_logger_error("the io_uring submission queue is stuck.");
+		abort();
+	}
+
+	const uint32_t tail = *uring->sq_tail;
+	struct io_uring_sqe* const sqe = &uring->sqes[tail & uring->sq_mask];
+	(void)memset(sqe, 0, sizeof(*sqe));
+
+	__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	++uring->sq_unsubmitted;
+	return sqe;
+}
+
+static bool_t _submit(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	while (uring->sq_unsubmitted > 0)
+	{
+		const int32_t result = _enter(uring->fd, uring->sq_unsubmitted, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+
+		if (result < 0)
+		{
+			if ((-EINTR == result) || (-EAGAIN == result) || (-EBUSY == result))
+			{
+				continue;
+			}
+
+			common_logger_error("failed to submit io_uring operations: %s.", strerror(-result));
+			return false;
+		}
+
+		uring->sq_unsubmitted -= (uint32_t)result;
+	}
+
+	return true;
+}
+
+static void _recycle_buffer(server_backend_uring_s* const uring, const uint16_t buffer)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(buffer < server_backend_uring_buffers_count);
+
+	struct io_uring_buf* const entry = &uring->buffers_ring->bufs[uring->buffers_tail & (server_backend_uring_buffers_count - 1)];
+	entry->addr = (uint64_t)(uintptr_t)common_pool_data(uring->buffers[buffer]);
+	entry->len  = (uint32_t)uring->reactor->pool.buffer_size;
+	entry->bid  = buffer;
+
+	++uring->buffers_tail;
+	__atomic_store_n(&uring->buffers_ring->tail, uring->buffers_tail, __ATOMIC_RELEASE);
+	uring->buffers_recycled = true;
+}
+
+static void _arm_accept(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode       = IORING_OP_ACCEPT;
+	sqe->fd           = uring->reactor->listen_fd;
+	sqe->ioprio       = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+	sqe->user_data    = _encode_user_data(_operation_accept, uring->reactor->listen_fd, 0);
+}
+
+static void _arm_wakeup(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode    = IORING_OP_READ;
+	sqe->fd        = uring->reactor->wakeup_fd;
+	sqe->addr      = (uint64_t)(uintptr_t)&uring->wakeup_value;
+	sqe->len       = sizeof(uring->wakeup_value);
+	sqe->user_data = _encode_user_data(_operation_wakeup, uring->reactor->wakeup_fd, 0);
+}
+
+static void _arm_recv(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+	common_debug_assert(!connection->io.uring.receiving);
+
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode    = IORING_OP_RECV;
+	sqe->fd        = connection->fd;
+	sqe->ioprio    = IORING_RECV_MULTISHOT;
+	sqe->flags     = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = 0;
+	sqe->user_data = _encode_user_data(_operation_recv, connection->fd, 0);
+
+	connection->io.uring.receiving = true;
+	++connection->io.uring.pending;
+}
+
+static void _cancel(server_backend_uring_s* const uring, server_connection_s* const connection, const bool_t everything)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+	sqe->user_data = _encode_user_data(_operation_cancel, connection->fd, 0);
+
+	if (everything)
+	{
+		sqe->fd           = connection->fd;
+		sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+	}
+	else
+	{
+		sqe->addr = _encode_user_data(_operation_recv, connection->fd, 0);
+	}
+
+	++connection->io.uring.pending;
+}
+
+static void _arm_poll(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode        = IORING_OP_POLL_ADD;
+	sqe->fd            = connection->fd;
+	sqe->poll32_events = POLLOUT;
+	sqe->user_data     = _encode_user_data(_operation_poll, connection->fd, 0);
+
+	++connection->io.uring.sending;
+	++connection->io.uring.pending;
+}
+
+static void _read_file(server_backend_uring_s* const uring, server_connection_s* const connection, const server_connection_segment_s* const segment, const struct iovec* const target, const uint64_t offset)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(target != NULL);
+	common_debug_assert(connection->bounce != NULL);
+
+	// note: on the copy data path the file is read into the bounce buffer by the
+	// ring as well, so a cold page cache never stalls the event loop. the send
+	// of the chunk is queued once the read completes.
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode    = uring->buffers_fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	sqe->fd        = segment->file.fd;
+	sqe->addr      = (uint64_t)(uintptr_t)target->iov_base;
+	sqe->len       = (uint32_t)target->iov_len;
+	sqe->off       = offset;
+	sqe->buf_index = uring->buffers_fixed ? (uint16_t)connection->bounce->index : 0;
+	sqe->user_data = _encode_user_data(_operation_read, connection->fd, target->iov_len);
+
+	++connection->io.uring.sending;
+	++connection->io.uring.pending;
+}
+
+static void _splice_file(server_backend_uring_s* const uring, server_connection_s* const connection, const server_connection_segment_s* const segment, const uint64_t offset, const uint64_t length)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(connection->pipe[1] >= 0);
+
+	// note: the splice never waits on the pipe, as it is no longer than the
+	// room left in it, so only the read of the file can stall the worker.
+	struct io_uring_sqe* const sqe = _get_sqe(uring);
+	sqe->opcode        = IORING_OP_SPLICE;
+	sqe->fd            = connection->pipe[1];
+	sqe->off           = (uint64_t)-1;
+	sqe->len           = (uint32_t)length;
+	sqe->splice_fd_in  = segment->file.fd;
+	sqe->splice_off_in = offset;
+	sqe->splice_flags  = SPLICE_F_MOVE;
+	sqe->user_data     = _encode_user_data(_operation_splice, connection->fd, length);
+
+	++connection->io.uring.sending;
+	++connection->io.uring.pending;
+}
+
+static void _complete_send(server_connection_s* const connection, const _operation_e operation, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+
+	switch (operation)
+	{
+		case _operation_send:
+		{
+			++connection->stats.sends;
+			server_stats_add(connection->worker_stats, server_stats_sends, 1);
+			server_connection_consume_output(connection, size);
+		} break;
+
+		case _operation_read:
+		{
+			if (0 == size)
+			{
+				common_logger_warn("file segment for connection %d ended unexpectedly.", connection->fd);
+				server_connection_fail(connection);
+			}
+
+			server_connection_commit_bounce(connection, size);
+		} break;
+
+		case _operation_splice:
+		{
+			if (0 == size)
+			{
+				common_logger_warn("file segment for connection %d ended unexpectedly.", connection->fd);
+				server_connection_fail(connection);
+			}
+
+			server_connection_commit_file(connection, size);
+		} break;
+
+		default:
+		{
+			common_debug_assert(0);
+		} break;
+	}
+}
+
+static void _feed_held(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	while (connection->io.uring.held_head >= 0)
+	{
+		const uint16_t buffer = (uint16_t)connection->io.uring.held_head;
+		const uint32_t offset = connection->io.uring.held_offset;
+		const uint8_t* const data = common_pool_data(uring->buffers[buffer]);
+
+		const uint64_t absorbed = server_connection_receive(connection, data + offset, uring->buffers_length[buffer] - offset);
+		connection->io.uring.held_offset += (uint32_t)absorbed;
+
+		if (connection->io.uring.held_offset < uring->buffers_length[buffer])
+		{
+			break;
+		}
+
+		connection->io.uring.held_head   = uring->buffers_next[buffer];
+		connection->io.uring.held_offset = 0;
+
+		if (connection->io.uring.held_head < 0)
+		{
+			connection->io.uring.held_tail = -1;
+		}
+
+		_recycle_buffer(uring, buffer);
+	}
+}
+
+static void _drop_held(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	while (connection->io.uring.held_head >= 0)
+	{
+		const uint16_t buffer = (uint16_t)connection->io.uring.held_head;
+		connection->io.uring.held_head = uring->buffers_next[buffer];
+		_recycle_buffer(uring, buffer);
+	}
+
+	connection->io.uring.held_tail   = -1;
+	connection->io.uring.held_offset = 0;
+}
+
+static void _settle(server_backend_uring_s* const uring, server_connection_s* const connection)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(connection != NULL);
+
+	if (server_connection_state_closed == connection->state)
+	{
+		return;
+	}
+
+	if (server_connection_state_closing == connection->state)
+	{
+		if (0 == connection->io.uring.pending)
+		{
+			server_reactor_close_connection(uring->reactor, connection);
+		}
+
+		return;
+	}
+
+	if (server_connection_has_failed(connection))
+	{
+		server_backend_uring_release(uring, connection);
+		return;
+	}
+
+	_feed_held(uring, connection);
+
+	const bool_t holding = connection->io.uring.held_head >= 0;
+
+	// note: a throttled or waiting connection is not received from, so that
+	// requests it can not serve yet stay in the socket instead of holding
+	// pooled buffers.
+	if (!holding && !connection->io.uring.receiving && !connection->io.uring.starved &&
+		(server_connection_state_open == connection->state) && !server_connection_is_throttled(connection) &&
+		!server_connection_is_waiting(connection))
+	{
+		_arm_recv(uring, connection);
+	}
+
+	server_backend_uring_flush(uring, connection);
+
+	if (server_connection_has_failed(connection))
+	{
+		server_backend_uring_release(uring, connection);
+	}
+	else if (!holding && server_connection_is_finished(connection))
+	{
+		server_backend_uring_release(uring, connection);
+	}
+}
+
+static server_connection_s* _lookup(server_backend_uring_s* const uring, const int32_t fd)
+{
+	common_debug_assert(uring != NULL);
+
+	server_reactor_s* const reactor = uring->reactor;
+
+	if ((fd < 0) || ((uint64_t)fd >= reactor->connections_capacity))
+	{
+		return NULL;
+	}
+
+	server_connection_s* const connection = reactor->connections[fd];
+	return ((connection != NULL) && (connection->state != server_connection_state_closed)) ? connection : NULL;
+}
+
+static void _handle_accept(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(cqe != NULL);
+
+	if (cqe->res >= 0)
+	{
+		server_connection_s* const connection = server_reactor_open_connection(uring->reactor, cqe->res);
+
+		if (connection != NULL)
+		{
+			connection->io.uring.held_head = -1;
+			connection->io.uring.held_tail = -1;
+			_arm_recv(uring, connection);
+		}
+	}
+	else if ((cqe->res != -ECANCELED) && (cqe->res != -ECONNABORTED) && (cqe->res != -EINTR))
+	{
+		common_logger_warn("failed to accept a connection: %s.", strerror(-cqe->res));
+	}
+
+	if (!(cqe->flags & IORING_CQE_F_MORE) && uring->reactor->running)
+	{
+		_arm_accept(uring);
+	}
+}
+
+static void _handle_recv(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(cqe != NULL);
+
+	server_connection_s* const connection = _lookup(uring, _decode_fd(cqe->user_data));
+	common_debug_assert(connection != NULL);
+
+	const bool_t has_buffer = (cqe->flags & IORING_CQE_F_BUFFER) != 0;
+	const uint16_t buffer = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+	if (!(cqe->flags & IORING_CQE_F_MORE))
+	{
+		connection->io.uring.receiving = false;
+		--connection->io.uring.pending;
+	}
+
+	if (server_connection_state_closing == connection->state)
+	{
+		if (has_buffer)
+		{
+			_recycle_buffer(uring, buffer);
+		}
+	}
+	else if (cqe->res > 0)
+	{
+		common_debug_assert(has_buffer);
+
+		// note: received buffers are queued on the connection and handed back
+		// to the ring as soon as the connection absorbs them. a connection that
+		// can not keep up stops receiving until it catches up, rather than
+		// draining the shared ring.
+		const bool_t was_holding = connection->io.uring.held_head >= 0;
+
+		uring->buffers_length[buffer] = (uint32_t)cqe->res;
+		uring->buffers_next[buffer]   = -1;
+
+		if (was_holding)
+		{
+			uring->buffers_next[connection->io.uring.held_tail] = buffer;
+		}
+		else
+		{
+			connection->io.uring.held_head = buffer;
+		}
+
+		connection->io.uring.held_tail = buffer;
+		_feed_held(uring, connection);
+
+		if ((connection->io.uring.held_head >= 0) && !was_holding && connection->io.uring.receiving)
+		{
+			_cancel(uring, connection, false);
+		}
+	}
+	else if (0 == cqe->res)
+	{
+		server_connection_shutdown_input(connection);
+	}
+	else if (-ENOBUFS == cqe->res)
+	{
+		if (!connection->io.uring.starved && !connection->io.uring.receiving)
+		{
+			if (uring->starved_count >= uring->starved_capacity)
+			{
+				const uint64_t capacity = (uring->starved_capacity > 0) ? (uring->starved_capacity * 2) : 64;
+				int32_t* const starved = realloc(uring->starved, capacity * sizeof(*starved));
+
+				if (NULL == starved)
+				{
+					server_backend_uring_release(uring, connection);
+					return;
+				}
+
+				uring->starved          = starved;
+				uring->starved_capacity = capacity;
+			}
+
+			uring->starved[uring->starved_count++] = connection->fd;
+			connection->io.uring.starved = true;
+		}
+	}
+	else if (cqe->res != -ECANCELED)
+	{
+		common_logger_debug("recv on connection %d failed: %s.", connection->fd, strerror(-cqe->res));
+		server_backend_uring_release(uring, connection);
+	}
+
+	_settle(uring, connection);
+}
+
+static void _handle_send(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(cqe != NULL);
+
+	server_connection_s* const connection = _lookup(uring, _decode_fd(cqe->user_data));
+	common_debug_assert(connection != NULL);
+
+	--connection->io.uring.sending;
+	--connection->io.uring.pending;
+
+	if (connection->state != server_connection_state_closing)
+	{
+		if (cqe->res >= 0)
+		{
+			if (!connection->io.uring.send_short)
+			{
+				_complete_send(connection, _decode_operation(cqe->user_data), (uint64_t)cqe->res);
+				connection->io.uring.send_short = (uint64_t)cqe->res < _decode_length(cqe->user_data);
+			}
+		}
+		else if ((cqe->res != -ECANCELED) || !connection->io.uring.send_short)
+		{
+			common_logger_debug("send on connection %d failed: %s.", connection->fd, strerror(-cqe->res));
+			server_backend_uring_release(uring, connection);
+		}
+
+		if (0 == connection->io.uring.sending)
+		{
+			connection->io.uring.send_short = false;
+		}
+	}
+
+	_settle(uring, connection);
+}
+
+static void _handle_poll(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(cqe != NULL);
+
+	server_connection_s* const connection = _lookup(uring, _decode_fd(cqe->user_data));
+	common_debug_assert(connection != NULL);
+
+	--connection->io.uring.sending;
+	--connection->io.uring.pending;
+
+	// note: an error reported by the poll itself surfaces again on the next
+	// splice, which fails the connection.
+	if ((connection->state != server_connection_state_closing) && (cqe->res < 0) && (cqe->res != -ECANCELED))
+	{
+		common_logger_debug("waiting for room on connection %d failed: %s.", connection->fd, strerror(-cqe->res));
+		server_backend_uring_release(uring, connection);
+	}
+
+	_settle(uring, connection);
+}
+
+static void _handle_cancel(server_backend_uring_s* const uring, const struct io_uring_cqe* const cqe)
+{
+	common_debug_assert(uring != NULL);
+	common_debug_assert(cqe != NULL);
+
+	server_connection_s* const connection = _lookup(uring, _decode_fd(cqe->user_data));
+	common_debug_assert(connection != NULL);
+
+	--connection->io.uring.pending;
+	_settle(uring, connection);
+}
+
+static void _handle_wakeup(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	server_reactor_s* const reactor = uring->reactor;
+	server_reactor_wakeup(reactor);
+
+	// note: the eventfd is read by the ring, so the read is armed again for
+	// the next wakeup unless the loop is stopping.
+	if (reactor->running)
+	{
+		_arm_wakeup(uring);
+	}
+}
+
+static void _rearm_starved(server_backend_uring_s* const uring)
+{
+	common_debug_assert(uring != NULL);
+
+	const uint64_t count = uring->starved_count;
+	uring->starved_count = 0;
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		server_connection_s* const connection = _lookup(uring, uring->starved[index]);
+
+		if ((connection != NULL) && connection->io.uring.starved)
+		{
+			connection->io.uring.starved = false;
+			_settle(uring, connection);
+		}
+	}
+}
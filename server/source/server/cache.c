@@ -0,0 +1,879 @@
+
+/**
+ * @file cache.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_storage
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/cache.h"
+
+#include <unistd.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define _doorkeeper_bits (server_cache_doorkeeper_words * 64)
+
+typedef struct
+{
+	common_scheduler_task_s task;
+	server_cache_s* cache;
+	server_cache_entry_s* entry;
+	int32_t fd;
+} _load_s;
+
+static uint64_t _hash(const uint64_t media_id, const uint32_t chunk);
+
+static server_cache_shard_s* _shard_of(server_cache_s* const cache, const uint64_t hash);
+
+static server_cache_entry_s* _find(server_cache_shard_s* const shard, const uint64_t hash, const uint64_t media_id, const uint32_t chunk);
+
+static bool_t _admit(server_cache_shard_s* const shard, const uint64_t hash, const uint64_t size);
+
+static bool_t _reserve_heap(server_cache_shard_s* const shard);
+
+static server_cache_table_s* _create_table(const uint64_t count);
+
+static void _grow_table(server_cache_shard_s* const shard);
+
+static void _link(server_cache_shard_s* const shard, server_cache_entry_s* const entry);
+
+static void _unlink(server_cache_shard_s* const shard, server_cache_entry_s* const entry);
+
+static void _retire(server_cache_shard_s* const shard, server_cache_entry_s* const entry);
+
+static void _reclaim(server_cache_shard_s* const shard);
+
+static void _release_list(server_cache_entry_s* entry);
+
+static void _fold_hits(server_cache_entry_s* const entry);
+
+static void _evict(server_cache_shard_s* const shard);
+
+static uint64_t _rank(const server_cache_entry_s* const entry);
+
+static void _heap_place(server_cache_shard_s* const shard, server_cache_entry_s* const entry, const uint64_t index);
+
+static void _heap_sift_up(server_cache_shard_s* const shard, uint64_t index);
+
+static void _heap_sift_down(server_cache_shard_s* const shard, uint64_t index);
+
+static void _load(void* const argument);
+
+static void _complete(server_cache_s* const cache, server_cache_entry_s* const entry, const bool_t loaded);
+
+static bool_t _read_segment(server_cache_entry_s* const entry, const int32_t fd);
+
+bool_t server_cache_create(server_cache_s* const cache, const uint64_t capacity, common_scheduler_s* const scheduler, const bool_t coalesce)
+{
+	common_debug_assert(cache != NULL);
+	common_debug_assert(scheduler != NULL);
+
+	cache->scheduler = scheduler;
+	cache->coalesce  = coalesce;
+	uint64_t created = 0;
+
+	for (; created < server_cache_shards_count; ++created)
+	{
+		server_cache_shard_s* const shard = &cache->shards[created];
+		(void)memset(shard, 0, sizeof(*shard));
+
+		shard->table = _create_table(server_cache_buckets_minimum);
+
+		if (NULL == shard->table)
+		{
+			common_logger_error("failed to allocate the buckets of cache shard %lu.", created);
+			goto server_cache_create_failed;
+		}
+
+		if (pthread_mutex_init(&shard->lock, NULL) != 0)
+		{
+			common_logger_error("failed to create the lock of cache shard %lu.", created);
+			free(shard->table);
+			goto server_cache_create_failed;
+		}
+
+		shard->capacity = capacity / server_cache_shards_count;
+	}
+
+	return true;
+
+server_cache_create_failed:
+	for (uint64_t index = 0; index < created; ++index)
+	{
+		(void)pthread_mutex_destroy(&cache->shards[index].lock);
+		free(cache->shards[index].table);
+	}
+
+	return false;
+}
+
+void server_cache_destroy(server_cache_s* const cache)
+{
+	common_debug_assert(cache != NULL);
+
+	for (uint64_t index = 0; index < server_cache_shards_count; ++index)
+	{
+		server_cache_shard_s* const shard = &cache->shards[index];
+
+		for (uint64_t slot = 0; slot < shard->heap_count; ++slot)
+		{
+			server_cache_release(shard->heap[slot]);
+		}
+
+		_release_list(shard->retiring);
+		_release_list(shard->retired);
+
+		while (shard->table != NULL)
+		{
+			server_cache_table_s* const previous = shard->table->previous;
+			free(shard->table);
+			shard->table = previous;
+		}
+
+		free(shard->heap);
+		(void)pthread_mutex_destroy(&shard->lock);
+	}
+}
+
+server_cache_entry_s* server_cache_acquire(server_cache_s* const cache, const uint64_t media_id, const uint32_t chunk)
+{
+	common_debug_assert(cache != NULL);
+
+	const uint64_t hash = _hash(media_id, chunk);
+	server_cache_shard_s* const shard = _shard_of(cache, hash);
+
+	// note: the fence orders the announcement of the reader before its walk
+	// of the table, against the fence of a writer between unlinking entries
+	// and checking for readers, so that either the reader does not see the
+	// unlinked entries or the writer sees the reader.
+	const uint64_t epoch = __atomic_load_n(&shard->epoch, __ATOMIC_ACQUIRE) & 1;
+	(void)__atomic_add_fetch(&shard->readers[epoch], 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	server_cache_entry_s* const entry = _find(shard, hash, media_id, chunk);
+
+	if (entry != NULL)
+	{
+		// note: an entry found in the table holds the reference of the shard
+		// until no reader is left that could have found it.
+		server_cache_retain(entry);
+		(void)__atomic_add_fetch(&entry->hits, 1, __ATOMIC_RELAXED);
+	}
+
+	(void)__atomic_sub_fetch(&shard->readers[epoch], 1, __ATOMIC_RELEASE);
+
+	if (NULL == entry)
+	{
+		(void)__atomic_add_fetch(&shard->stats.misses, 1, __ATOMIC_RELAXED);
+	}
+	else if (server_cache_state_loading == server_cache_state(entry))
+	{
+		(void)__atomic_add_fetch(&shard->stats.coalesced, 1, __ATOMIC_RELAXED);
+	}
+	else
+	{
+		(void)__atomic_add_fetch(&shard->stats.hits, 1, __ATOMIC_RELAXED);
+	}
+
+	return entry;
+}
+
+server_cache_entry_s* server_cache_load(server_cache_s* const cache, const uint64_t media_id, const uint32_t chunk, const int32_t fd, const uint64_t size)
+{
+	common_debug_assert(cache != NULL);
+	common_debug_assert(fd >= 0);
+
+	const uint64_t hash = _hash(media_id, chunk);
+	server_cache_shard_s* const shard = _shard_of(cache, hash);
+
+	(void)pthread_mutex_lock(&shard->lock);
+	bool_t admitted = _admit(shard, hash, size);
+	(void)pthread_mutex_unlock(&shard->lock);
+
+	if (!admitted && !cache->coalesce)
+	{
+		return NULL;
+	}
+
+	server_cache_entry_s* entry = malloc(sizeof(*entry) + size);
+
+	if (NULL == entry)
+	{
+		common_logger_warn("failed to allocate %lu bytes to load media %lu chunk %u.", size, media_id, chunk);
+		return NULL;
+	}
+
+	// note: the entry is referenced by the shard, the caller and the load.
+	*entry = (const server_cache_entry_s)
+	{
+		.media_id   = media_id,
+		.chunk      = chunk,
+		.references = 3,
+		.hash       = hash,
+		.size       = size,
+		.state      = server_cache_state_loading,
+		.frequency  = 1,
+	};
+
+	(void)pthread_mutex_lock(&shard->lock);
+	server_cache_entry_s* const resident = _find(shard, hash, media_id, chunk);
+
+	// note: the shard was unlocked for the allocation, so another thread may
+	// have issued the load of the same segment in the meantime.
+	if (resident != NULL)
+	{
+		(void)__atomic_add_fetch(&resident->hits, 1, __ATOMIC_RELAXED);
+		(void)__atomic_add_fetch(&shard->stats.coalesced, 1, __ATOMIC_RELAXED);
+		server_cache_retain(resident);
+		(void)pthread_mutex_unlock(&shard->lock);
+
+		free(entry);
+		(void)close(fd);
+		return resident;
+	}
+
+	while (admitted && ((shard->size + size) > shard->capacity) && (shard->heap_count > 0))
+	{
+		_evict(shard);
+	}
+
+	// note: the segments still being loaded can not be evicted, so the shard
+	// may not have room for the segment even with all others gone.
+	if (admitted && ((shard->size + size) > shard->capacity))
+	{
+		admitted = false;
+		++shard->stats.rejected;
+	}
+
+	if (!admitted && !cache->coalesce)
+	{
+		(void)pthread_mutex_unlock(&shard->lock);
+		free(entry);
+		return NULL;
+	}
+
+	entry->admitted = admitted;
+	shard->size += admitted ? size : 0;
+	_link(shard, entry);
+	++shard->stats.loads;
+
+	if (shard->heap_count > shard->table->count)
+	{
+		_grow_table(shard);
+	}
+
+	_reclaim(shard);
+	(void)pthread_mutex_unlock(&shard->lock);
+
+	_load_s* const load = malloc(sizeof(*load));
+
+	if (load != NULL)
+	{
+		*load = (const _load_s)
+		{
+			.task  = { .function = _load, .argument = load },
+			.cache = cache,
+			.entry = entry,
+			.fd    = fd,
+		};
+
+		if (common_scheduler_submit(cache->scheduler, &load->task))
+		{
+			return entry;
+		}
+
+		free(load);
+	}
+
+	// note: the segment is never read on the calling thread, which is the
+	// event loop of a worker, so a load the scheduler does not take fails
+	// along with the requests coalesced into it, and they all fall back to
+	// the file of the segment.
+	common_logger_warn("failed to submit the load of media %lu chunk %u.", media_id, chunk);
+	_complete(cache, entry, false);
+	(void)close(fd);
+	return entry;
+}
+
+server_cache_entry_s* server_cache_read(const uint64_t media_id, const uint32_t chunk, const int32_t fd, const uint64_t size)
+{
+	common_debug_assert(fd >= 0);
+
+	server_cache_entry_s* const entry = malloc(sizeof(*entry) + size);
+
+	if (NULL == entry)
+	{
+		common_logger_warn("failed to allocate %lu bytes to read media %lu chunk %u.", size, media_id, chunk);
+		return NULL;
+	}
+
+	*entry = (const server_cache_entry_s)
+	{
+		.media_id   = media_id,
+		.chunk      = chunk,
+		.references = 1,
+		.hash       = _hash(media_id, chunk),
+		.size       = size,
+		.state      = server_cache_state_ready,
+	};
+
+	if (!_read_segment(entry, fd))
+	{
+		free(entry);
+		return NULL;
+	}
+
+	return entry;
+}
+
+server_cache_state_e server_cache_state(const server_cache_entry_s* const entry)
+{
+	common_debug_assert(entry != NULL);
+	return __atomic_load_n(&entry->state, __ATOMIC_ACQUIRE);
+}
+
+void server_cache_waiter_init(server_cache_waiter_s* const waiter, void (*function)(server_cache_waiter_s* const waiter, void* const argument), void* const argument)
+{
+	common_debug_assert(waiter != NULL);
+	common_debug_assert(function != NULL);
+
+	*waiter = (const server_cache_waiter_s)
+	{
+		.function = function,
+		.argument = argument,
+	};
+}
+
+bool_t server_cache_wait(server_cache_s* const cache, server_cache_entry_s* const entry, server_cache_waiter_s* const waiter)
+{
+	common_debug_assert(cache != NULL);
+	common_debug_assert(entry != NULL);
+	common_debug_assert(waiter != NULL);
+
+	server_cache_shard_s* const shard = _shard_of(cache, entry->hash);
+
+	(void)pthread_mutex_lock(&shard->lock);
+	const bool_t loading = server_cache_state_loading == entry->state;
+
+	if (loading)
+	{
+		waiter->next   = entry->waiters;
+		entry->waiters = waiter;
+	}
+
+	(void)pthread_mutex_unlock(&shard->lock);
+	return loading;
+}
+
+bool_t server_cache_cancel(server_cache_s* const cache, server_cache_entry_s* const entry, server_cache_waiter_s* const waiter)
+{
+	common_debug_assert(cache != NULL);
+	common_debug_assert(entry != NULL);
+	common_debug_assert(waiter != NULL);
+
+	server_cache_shard_s* const shard = _shard_of(cache, entry->hash);
+
+	(void)pthread_mutex_lock(&shard->lock);
+	server_cache_waiter_s** link = &entry->waiters;
+
+	while ((*link != NULL) && (*link != waiter))
+	{
+		link = &(*link)->next;
+	}
+
+	const bool_t found = *link != NULL;
+
+	if (found)
+	{
+		*link = waiter->next;
+		waiter->next = NULL;
+	}
+
+	(void)pthread_mutex_unlock(&shard->lock);
+	return found;
+}
+
+void server_cache_retain(server_cache_entry_s* const entry)
+{
+	common_debug_assert(entry != NULL);
+	common_debug_assert(__atomic_load_n(&entry->references, __ATOMIC_RELAXED) > 0);
+	(void)__atomic_add_fetch(&entry->references, 1, __ATOMIC_RELAXED);
+}
+
+void server_cache_release(server_cache_entry_s* const entry)
+{
+	common_debug_assert(entry != NULL);
+	common_debug_assert(__atomic_load_n(&entry->references, __ATOMIC_RELAXED) > 0);
+
+	if (__atomic_sub_fetch(&entry->references, 1, __ATOMIC_ACQ_REL) > 0)
+	{
+		return;
+	}
+
+	free(entry);
+}
+
+void server_cache_stats(server_cache_s* const cache, server_cache_stats_s* const stats)
+{
+	common_debug_assert(cache != NULL);
+	common_debug_assert(stats != NULL);
+
+	*stats = (const server_cache_stats_s) {0};
+
+	for (uint64_t index = 0; index < server_cache_shards_count; ++index)
+	{
+		server_cache_shard_s* const shard = &cache->shards[index];
+
+		(void)pthread_mutex_lock(&shard->lock);
+		stats->hits      += __atomic_load_n(&shard->stats.hits, __ATOMIC_RELAXED);
+		stats->misses    += __atomic_load_n(&shard->stats.misses, __ATOMIC_RELAXED);
+		stats->admitted  += shard->stats.admitted;
+		stats->rejected  += shard->stats.rejected;
+		stats->evicted   += shard->stats.evicted;
+		stats->loads     += shard->stats.loads;
+		stats->coalesced += __atomic_load_n(&shard->stats.coalesced, __ATOMIC_RELAXED);
+		stats->failed    += shard->stats.failed;
+		stats->entries   += shard->heap_count;
+		stats->size      += shard->size;
+		(void)pthread_mutex_unlock(&shard->lock);
+	}
+}
+
+static uint64_t _hash(const uint64_t media_id, const uint32_t chunk)
+{
+	uint64_t hash = (media_id * 0x9E3779B97F4A7C15ull) ^ chunk;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+	return hash ^ (hash >> 31);
+}
+
+static server_cache_shard_s* _shard_of(server_cache_s* const cache, const uint64_t hash)
+{
+	common_debug_assert(cache != NULL);
+	return &cache->shards[hash % server_cache_shards_count];
+}
+
+static server_cache_entry_s* _find(server_cache_shard_s* const shard, const uint64_t hash, const uint64_t media_id, const uint32_t chunk)
+{
+	common_debug_assert(shard != NULL);
+
+	// note: the low bits of the hash pick the shard, so the buckets are picked
+	// by the bits above them. a lookup that races the table growing may miss
+	// an entry, which the load of the segment finds again under the lock.
+	const server_cache_table_s* const table = __atomic_load_n(&shard->table, __ATOMIC_ACQUIRE);
+	server_cache_entry_s* entry = __atomic_load_n(&table->buckets[(hash / server_cache_shards_count) & (table->count - 1)], __ATOMIC_ACQUIRE);
+
+	while ((entry != NULL) && ((entry->media_id != media_id) || (entry->chunk != chunk)))
+	{
+		entry = __atomic_load_n(&entry->next, __ATOMIC_ACQUIRE);
+	}
+
+	return entry;
+}
+
+static bool_t _admit(server_cache_shard_s* const shard, const uint64_t hash, const uint64_t size)
+{
+	common_debug_assert(shard != NULL);
+
+	if ((0 == size) || (size > shard->capacity))
+	{
+		++shard->stats.rejected;
+		return false;
+	}
+
+	if ((shard->size + size) <= shard->capacity)
+	{
+		return true;
+	}
+
+	const uint64_t bit  = (hash >> 32) % _doorkeeper_bits;
+	const uint64_t mask = (uint64_t)1 << (bit % 64);
+
+	if ((shard->doorkeeper[bit / 64] & mask) != 0)
+	{
+		return true;
+	}
+
+	// note: the doorkeeper is cleared once half of it is set, which keeps its
+	// false positives down and forgets keys that were missed long ago.
+	if (shard->doorkeeper_count >= (_doorkeeper_bits / 2))
+	{
+		(void)memset(shard->doorkeeper, 0, sizeof(shard->doorkeeper));
+		shard->doorkeeper_count = 0;
+	}
+
+	shard->doorkeeper[bit / 64] |= mask;
+	++shard->doorkeeper_count;
+	++shard->stats.rejected;
+	return false;
+}
+
+static bool_t _reserve_heap(server_cache_shard_s* const shard)
+{
+	common_debug_assert(shard != NULL);
+
+	if (shard->heap_count < shard->heap_capacity)
+	{
+		return true;
+	}
+
+	const uint64_t capacity = (shard->heap_capacity > 0) ? (shard->heap_capacity * 2) : server_cache_buckets_minimum;
+	server_cache_entry_s** const heap = realloc(shard->heap, capacity * sizeof(*heap));
+
+	if (NULL == heap)
+	{
+		common_logger_warn("failed to grow the heap of a cache shard to %lu entries.", capacity);
+		return false;
+	}
+
+	shard->heap          = heap;
+	shard->heap_capacity = capacity;
+	return true;
+}
+
+static server_cache_table_s* _create_table(const uint64_t count)
+{
+	server_cache_table_s* const table = calloc(1, sizeof(*table) + (count * sizeof(*table->buckets)));
+
+	if (table != NULL)
+	{
+		table->count = count;
+	}
+
+	return table;
+}
+
+static void _grow_table(server_cache_shard_s* const shard)
+{
+	common_debug_assert(shard != NULL);
+
+	server_cache_table_s* const previous = shard->table;
+	server_cache_table_s* const table = _create_table(previous->count * 2);
+
+	// note: the table keeps working when it can not grow, with longer chains.
+	if (NULL == table)
+	{
+		return;
+	}
+
+	for (uint64_t index = 0; index < previous->count; ++index)
+	{
+		server_cache_entry_s* entry = previous->buckets[index];
+
+		while (entry != NULL)
+		{
+			server_cache_entry_s* const next = entry->next;
+			server_cache_entry_s** const bucket = &table->buckets[(entry->hash / server_cache_shards_count) & (table->count - 1)];
+			__atomic_store_n(&entry->next, *bucket, __ATOMIC_RELEASE);
+			*bucket = entry;
+			entry = next;
+		}
+	}
+
+	table->previous = previous;
+	__atomic_store_n(&shard->table, table, __ATOMIC_RELEASE);
+}
+
+static void _link(server_cache_shard_s* const shard, server_cache_entry_s* const entry)
+{
+	common_debug_assert(shard != NULL);
+	common_debug_assert(entry != NULL);
+
+	server_cache_table_s* const table = shard->table;
+	server_cache_entry_s** const bucket = &table->buckets[(entry->hash / server_cache_shards_count) & (table->count - 1)];
+	entry->next = *bucket;
+	__atomic_store_n(bucket, entry, __ATOMIC_RELEASE);
+}
+
+static void _unlink(server_cache_shard_s* const shard, server_cache_entry_s* const entry)
+{
+	common_debug_assert(shard != NULL);
+	common_debug_assert(entry != NULL);
+
+	server_cache_table_s* const table = shard->table;
+	server_cache_entry_s** link = &table->buckets[(entry->hash / server_cache_shards_count) & (table->count - 1)];
+
+	while (*link != entry)
+	{
+		common_debug_assert(*link != NULL);
+		link = &(*link)->next;
+	}
+
+	// note: the link of the entry is left as it is, so that a lookup standing
+	// on it still gets to the rest of the chain.
+	__atomic_store_n(link, entry->next, __ATOMIC_RELEASE);
+}
+
+static void _retire(server_cache_shard_s* const shard, server_cache_entry_s* const entry)
+{
+	common_debug_assert(shard != NULL);
+	common_debug_assert(entry != NULL);
+
+	entry->retired = shard->retired;
+	shard->retired = entry;
+}
+
+static void _reclaim(server_cache_shard_s* const shard)
+{
+	common_debug_assert(shard != NULL);
+
+	// note: the entries retiring were all unlinked before the epoch last moved
+	// on, so once no reader of the epoch before is left, nothing can be
+	// looking at them anymore. the epoch only moves on again then, so that a
+	// reader still counted in the other epoch is always waited for.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	const uint64_t previous = (shard->epoch & 1) ^ 1;
+
+	if (__atomic_load_n(&shard->readers[previous], __ATOMIC_ACQUIRE) != 0)
+	{
+		return;
+	}
+
+	_release_list(shard->retiring);
+	shard->retiring = shard->retired;
+	shard->retired  = NULL;
+
+	if (shard->retiring != NULL)
+	{
+		__atomic_store_n(&shard->epoch, shard->epoch + 1, __ATOMIC_RELEASE);
+	}
+}
+
+static void _release_list(server_cache_entry_s* entry)
+{
+	while (entry != NULL)
+	{
+		server_cache_entry_s* const retired = entry->retired;
+		server_cache_release(entry);
+		entry = retired;
+	}
+}
+
+static void _fold_hits(server_cache_entry_s* const entry)
+{
+	common_debug_assert(entry != NULL);
+
+	// note: the frequency stays capped to 32 bits, which _rank relies on.
+	const uint64_t hits = __atomic_exchange_n(&entry->hits, 0, __ATOMIC_RELAXED);
+	entry->frequency = ((entry->frequency + hits) < UINT32_MAX) ? (entry->frequency + hits) : UINT32_MAX;
+}
+
+static void _evict(server_cache_shard_s* const shard)
+{
+	common_debug_assert(shard != NULL);
+	common_debug_assert(shard->heap_count > 0);
+
+	// note: the hits of an entry only count once it is about to be evicted,
+	// which ranks it again and gives its place up to the next lowest, until
+	// one is found that was not hit since it was last ranked. every entry is
+	// ranked again at most once, so hits that keep coming in can not hold the
+	// eviction up for long.
+	for (uint64_t ranked = 0; ranked < shard->heap_count; ++ranked)
+	{
+		server_cache_entry_s* const lowest = shard->heap[0];
+
+		if (0 == __atomic_load_n(&lowest->hits, __ATOMIC_RELAXED))
+		{
+			break;
+		}
+
+		_fold_hits(lowest);
+		lowest->priority = shard->inflation + _rank(lowest);
+		_heap_sift_down(shard, 0);
+	}
+
+	server_cache_entry_s* const entry = shard->heap[0];
+	shard->inflation = entry->priority;
+
+	_heap_place(shard, shard->heap[--shard->heap_count], 0);
+	_heap_sift_down(shard, 0);
+	_unlink(shard, entry);
+
+	shard->size -= entry->size;
+	++shard->stats.evicted;
+
+	// note: connections still transmitting the entry keep it alive, and so does
+	// the shard until no lookup can be looking at it anymore.
+	_retire(shard, entry);
+}
+
+static uint64_t _rank(const server_cache_entry_s* const entry)
+{
+	common_debug_assert(entry != NULL);
+	common_debug_assert(entry->size > 0);
+
+	// note: the frequency is capped to 32 bits, so the fixed-point ratio of it
+	// over the size never overflows.
+	return (entry->frequency << 32) / entry->size;
+}
+
+static void _heap_place(server_cache_shard_s* const shard, server_cache_entry_s* const entry, const uint64_t index)
+{
+	common_debug_assert(shard != NULL);
+	common_debug_assert(entry != NULL);
+
+	shard->heap[index] = entry;
+	entry->heap_index  = index;
+}
+
+static void _heap_sift_up(server_cache_shard_s* const shard, uint64_t index)
+{
+	common_debug_assert(shard != NULL);
+	common_debug_assert(index < shard->heap_count);
+
+	server_cache_entry_s* const entry = shard->heap[index];
+
+	while (index > 0)
+	{
+		const uint64_t parent = (index - 1) / 2;
+
+		if (shard->heap[parent]->priority <= entry->priority)
+		{
+			break;
+		}
+
+		_heap_place(shard, shard->heap[parent], index);
+		index = parent;
+	}
+
+	_heap_place(shard, entry, index);
+}
+
+static void _heap_sift_down(server_cache_shard_s* const shard, uint64_t index)
+{
+	common_debug_assert(shard != NULL);
+
+	if (index >= shard->heap_count)
+	{
+		return;
+	}
+
+	server_cache_entry_s* const entry = shard->heap[index];
+
+	while (true)
+	{
+		const uint64_t left  = (index * 2) + 1;
+		const uint64_t right = left + 1;
+		uint64_t smallest = index;
+		uint64_t priority = entry->priority;
+
+		if ((left < shard->heap_count) && (shard->heap[left]->priority < priority))
+		{
+			smallest = left;
+			priority = shard->heap[left]->priority;
+		}
+
+		if ((right < shard->heap_count) && (shard->heap[right]->priority < priority))
+		{
+			smallest = right;
+		}
+
+		if (smallest == index)
+		{
+			break;
+		}
+
+		_heap_place(shard, shard->heap[smallest], index);
+		index = smallest;
+	}
+
+	_heap_place(shard, entry, index);
+}
+
+static void _load(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+
+	_load_s* const load = argument;
+	_complete(load->cache, load->entry, _read_segment(load->entry, load->fd));
+	(void)close(load->fd);
+	free(load);
+}
+
+static void _complete(server_cache_s* const cache, server_cache_entry_s* const entry, const bool_t loaded)
+{
+	common_debug_assert(cache != NULL);
+	common_debug_assert(entry != NULL);
+
+	server_cache_shard_s* const shard = _shard_of(cache, entry->hash);
+
+	(void)pthread_mutex_lock(&shard->lock);
+	common_debug_assert(server_cache_state_loading == entry->state);
+
+	const bool_t ready = loaded && (!entry->admitted || _reserve_heap(shard));
+
+	if (ready && entry->admitted)
+	{
+		_fold_hits(entry);
+		entry->priority = shard->inflation + _rank(entry);
+		_heap_place(shard, entry, shard->heap_count++);
+		_heap_sift_up(shard, entry->heap_index);
+		++shard->stats.admitted;
+	}
+	else
+	{
+		// note: a failed entry leaves the shard right away, so that the next
+		// request for the segment issues a load of its own, and so does one
+		// that was not admitted, once the requests coalesced into it have it.
+		_unlink(shard, entry);
+		_retire(shard, entry);
+		shard->size -= entry->admitted ? entry->size : 0;
+		shard->stats.failed += ready ? 0 : 1;
+	}
+
+	__atomic_store_n(&entry->state, ready ? server_cache_state_ready : server_cache_state_failed, __ATOMIC_RELEASE);
+
+	while (entry->waiters != NULL)
+	{
+		server_cache_waiter_s* const waiter = entry->waiters;
+		entry->waiters = waiter->next;
+		waiter->next   = NULL;
+		waiter->function(waiter, waiter->argument);
+	}
+
+	_reclaim(shard);
+	(void)pthread_mutex_unlock(&shard->lock);
+	server_cache_release(entry);
+}
+
+static bool_t _read_segment(server_cache_entry_s* const entry, const int32_t fd)
+{
+	common_debug_assert(entry != NULL);
+	common_debug_assert(fd >= 0);
+
+	uint64_t loaded = 0;
+
+	while (loaded < entry->size)
+	{
+		const ssize_t result = pread(fd, entry->data + loaded, entry->size - loaded, (off_t)loaded);
+
+		if (result > 0)
+		{
+			loaded += (uint64_t)result;
+		}
+		else if ((result < 0) && (EINTR == errno))
+		{
+			continue;
+		}
+		else
+		{
+			common_logger_warn("failed to load media %lu chunk %u into the cache: %s.", entry->media_id, entry->chunk,
+				(0 == result) ? "unexpected end of file" : strerror(errno));
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -15,13 +15,40 @@
 
 #include "server/config.h"
 
+#include <sys/un.h>
+#include <unistd.h>
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 
 #define address_default_value "127.0.0.1"
 #define port_default_value    "25505"
 #define backlog_default_value "10"
+#define workers_default_value "auto"
+#define io_backend_default_value "io_uring"
+
+// note: release builds default to transmitting files straight from the page
+// cache, develop builds keep the copying data path as their default.
+#if defined(server_zero_copy)
+#	define data_path_default_value "zero-copy"
+#else
+#	define data_path_default_value "copy"
+#endif
+
+#define media_dir_default_value "./media"
+#define io_buffers_default_value "1024"
+#define compute_threads_default_value "auto"
+#define log_level_default_value "debug"
+#define idle_timeout_default_value "60000"
+#define write_timeout_default_value "30000"
+#define keepalive_default_value "20000"
+#define high_watermark_default_value "4194304"
+#define low_watermark_default_value "1048576"
+#define notsent_lowat_default_value "131072"
+#define cache_size_default_value "268435456"
+#define segment_duration_default_value "2000"
 
 static const char_t* _g_program = NULL;
 
@@ -36,6 +63,59 @@ const char_t _g_usage_banner[] =
 	"            -a, --address <ADDRESS>     set the host address for the server. if not provided, defaults to %s.\n"                        \
 	"            -p, --port    <PORT>        set the port for the server. if not provided, defaults to %s.\n"                                \
 	"            -b, --backlog <BACKLOG>     set the backlog (max number of connections) for the server. if not provided, defaults to %s.\n" \
+	"            -w, --workers <N|auto>      set the number of worker threads, each with its own listener and event loop. auto uses one\n"   \
+	"                                        worker per online cpu. if not provided, defaults to %s.\n"                                      \
+	"            -i, --io-backend <BACKEND>  set the i/o backend, one of io_uring or epoll. io_uring falls back to epoll at startup\n"       \
+	"                                        if the kernel does not support it. if not provided, defaults to %s.\n"                          \
+	"            -d, --data-path <PATH>      set how files are transmitted, one of zero-copy (sendfile, or splice through a pipe when\n"     \
+	"                                        framing is interleaved) or copy (read into userspace). if not provided, defaults to %s.\n"      \
+	"            -m, --media-dir <PATH>      set the directory media is served from, laid out as <PATH>/<MEDIA>/<CHUNK>.seg.\n"              \
+	"                                        if not provided, defaults to %s.\n"                                                             \
+	"            -B, --io-buffers <COUNT>    set the number of 16 KiB i/o buffers each worker pools for receiving and reading files.\n"      \
+	"                                        connections are shed while all of them are in use. if not provided, defaults to %s.\n"          \
+	"            -c, --compute-threads <N|auto>\n"                                                                                           \
+	"                                        set the number of threads running cpu-heavy tasks, such as the media library scan\n"            \
+	"                                        and segment loads, off the event loops. auto uses a quarter of the online cpus, and 0\n"        \
+	"                                        disables them, along with the cache.\n"                                                         \
+	"                                        if not provided, defaults to %s.\n"                                                             \
+	"            -L, --binary-log <PATH>     set the file messages are recorded to in binary form, leaving their formatting to the\n"        \
+	"                                        decoder. if not provided, messages are written out as text.\n"                                  \
+	"            -l, --log-level <LEVEL>     set the lowest level logged, one of debug, info, note, warn or error. levels compiled out\n"    \
+	"                                        of the build stay off. if not provided, defaults to %s.";
+
+// note: the banner is split in two, as iso c only guarantees support for string
+// literals of up to 4095 characters.
+const char_t _g_usage_banner_continued[] =
+	"            -t, --idle-timeout <MS>     set how long a connection may stay silent, with nothing owed to it, before it is closed.\n"     \
+	"                                        connections are checked once per timeout, so an idle one is closed within twice that.\n"        \
+	"                                        0 disables it. if not provided, defaults to %s.\n"                                              \
+	"            -W, --write-timeout <MS>    set how long a connection may go without taking any of the output owed to it before it is\n"    \
+	"                                        closed as too slow. 0 disables it. if not provided, defaults to %s.\n"                          \
+	"            -k, --keepalive <MS>        set how long a connection may stay silent before it is sent a ping, which a live client\n"      \
+	"                                        answers. 0 disables it. if not provided, defaults to %s.\n"                                     \
+	"            -H, --high-watermark <BYTES>\n"                                                                                             \
+	"                                        set how many bytes may be queued for a connection before the server stops serving its\n"        \
+	"                                        requests, and with them reading files, until the client catches up. if not provided,\n"         \
+	"                                        defaults to %s.\n"                                                                              \
+	"            -O, --low-watermark <BYTES> set how many bytes queued for a stopped connection it has to drain to before its requests\n"    \
+	"                                        are served again. it may not exceed the high watermark. if not provided, defaults to %s.\n"     \
+	"            -N, --notsent-lowat <BYTES> set how many bytes not yet sent a connection socket may hold before it stops reporting\n"       \
+	"                                        writability, which keeps bulk data in the page cache instead of socket buffers. 0 keeps\n"      \
+	"                                        the system default. if not provided, defaults to %s.\n"                                         \
+	"            -C, --cache-size <BYTES>    set how many bytes of segments are held in memory, shared by all workers, to serve the\n"       \
+	"                                        most requested ones without reading their files. cached segments are copied out to\n"           \
+	"                                        clients, so they give up zero-copy transmission. 0 disables it. if not provided,\n"             \
+	"                                        defaults to %s on the copy data path and to 0 on the zero-copy one.\n"                          \
+	"            -D, --segment-duration <MS> set the playback duration of every segment, by which requests for a time range of a\n"          \
+	"                                        media are mapped onto its segments. if not provided, defaults to %s.\n"                         \
+	"            -V, --live <MEDIA>          set the media served as a live channel, whose segments are published to its subscribers\n"      \
+	"                                        as they are written into its directory. if not provided, no media is live.\n"                   \
+	"            -S, --stats <PORT|PATH>     set where the statistics are served, a tcp port on the server address or the path of a\n"       \
+	"                                        unix socket. http requests for /stats get them as text and for /metrics in the\n"               \
+	"                                        prometheus format, as do bare stats and metrics lines. if not provided, they are not\n"         \
+	"                                        served.\n"                                                                                      \
+	"            -X, --checksums <PATH>      set the file the media library scan records the size and checksum of every segment to,\n"       \
+	"                                        which needs compute threads. if not provided, the library is not scanned.\n"                    \
 	"\n"                                                                                                                                     \
 	"    help                                print this help message banner.\n"                                                              \
 	"\n"                                                                                                                                     \
@@ -52,6 +132,34 @@ static bool_t _match_cli_option(const char_t* const option, const char_t* const
 
 static const char_t* _get_option_argument(const char_t* const option, int32_t* const argc, const char_t*** const argv);
 
+static uint16_t _parse_workers(const char_t* const workers_as_string);
+
+static server_io_backend_e _parse_io_backend(const char_t* const io_backend_as_string);
+
+static server_data_path_e _parse_data_path(const char_t* const data_path_as_string);
+
+static uint32_t _parse_io_buffers(const char_t* const io_buffers_as_string);
+
+static uint16_t _parse_compute_threads(const char_t* const compute_threads_as_string);
+
+static common_logger_level_e _parse_log_level(const char_t* const log_level_as_string);
+
+static uint32_t _parse_timeout(const char_t* const timeout_as_string, const char_t* const option_names);
+
+static uint64_t _parse_watermark(const char_t* const watermark_as_string, const char_t* const option_names);
+
+static uint32_t _parse_notsent_lowat(const char_t* const notsent_lowat_as_string);
+
+static uint64_t _parse_cache_size(const char_t* const cache_size_as_string);
+
+static uint32_t _parse_segment_duration(const char_t* const segment_duration_as_string);
+
+static uint64_t _parse_live_media(const char_t* const live_media_as_string);
+
+static uint16_t _parse_stats_port(const char_t* const stats_as_string);
+
+static const char_t* _parse_stats_socket(const char_t* const stats_as_string);
+
 static server_config_s _parse_run_command(int32_t* const argc, const char_t*** const argv);
 
 server_config_s server_config_from_cli(int32_t* const argc, const char_t*** const argv)
@@ -114,7 +222,8 @@ static void _print_usage_banner(void)
 {
 	common_debug_assert(_g_usage_banner != NULL);
 	common_debug_assert(_g_program != NULL);
-	common_logger_log(_g_usage_banner, _g_program, address_default_value, port_default_value, backlog_default_value);
+	common_logger_log(_g_usage_banner, _g_program, address_default_value, port_default_value, backlog_default_value, workers_default_value, io_backend_default_value, data_path_default_value, media_dir_default_value, io_buffers_default_value, compute_threads_default_value, log_level_default_value);
+	common_logger_log(_g_usage_banner_continued, idle_timeout_default_value, write_timeout_default_value, keepalive_default_value, high_watermark_default_value, low_watermark_default_value, notsent_lowat_default_value, cache_size_default_value, segment_duration_default_value);
 }
 
 static const char_t* _shift_cli_args(int32_t* const argc, const char_t*** const argv)
@@ -168,6 +277,284 @@ static const char_t* _get_option_argument(const char_t* const option, int32_t* c
 	return argument;
 }
 
+static uint16_t _parse_workers(const char_t* const workers_as_string)
+{
+	common_debug_assert(workers_as_string != NULL);
+
+	if (strcmp(workers_as_string, "auto") == 0)
+	{
+		const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		return (cpus > 0) ? (uint16_t)((cpus < UINT16_MAX) ? cpus : UINT16_MAX) : 1;
+	}
+
+	const int32_t workers = atoi(workers_as_string);
+
+	if ((workers <= 0) || (workers > UINT16_MAX))
+	{
+		common_logger_error("invalid --workers, -w value provided in 'run' command: %s.", workers_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint16_t)workers;
+}
+
+static server_io_backend_e _parse_io_backend(const char_t* const io_backend_as_string)
+{
+	common_debug_assert(io_backend_as_string != NULL);
+
+	if (strcmp(io_backend_as_string, "io_uring") == 0)
+	{
+		return server_io_backend_uring;
+	}
+	else if (strcmp(io_backend_as_string, "epoll") == 0)
+	{
+		return server_io_backend_epoll;
+	}
+
+	common_logger_error("invalid --io-backend, -i value provided in 'run' command: %s.", io_backend_as_string);
+	_print_usage_banner();
+	exit(1);
+}
+
+static server_data_path_e _parse_data_path(const char_t* const data_path_as_string)
+{
+	common_debug_assert(data_path_as_string != NULL);
+
+	if (strcmp(data_path_as_string, "zero-copy") == 0)
+	{
+		return server_data_path_zero_copy;
+	}
+	else if (strcmp(data_path_as_string, "copy") == 0)
+	{
+		return server_data_path_copy;
+	}
+
+	common_logger_error("invalid --data-path, -d value provided in 'run' command: %s.", data_path_as_string);
+	_print_usage_banner();
+	exit(1);
+}
+
+static uint32_t _parse_io_buffers(const char_t* const io_buffers_as_string)
+{
+	common_debug_assert(io_buffers_as_string != NULL);
+
+	const int32_t io_buffers = atoi(io_buffers_as_string);
+
+	// note: the upper bound is the number of buffers io_uring can register.
+	if ((io_buffers <= 0) || (io_buffers > 16384))
+	{
+		common_logger_error("invalid --io-buffers, -B value provided in 'run' command: %s.", io_buffers_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)io_buffers;
+}
+
+static uint16_t _parse_compute_threads(const char_t* const compute_threads_as_string)
+{
+	common_debug_assert(compute_threads_as_string != NULL);
+
+	if (strcmp(compute_threads_as_string, "auto") == 0)
+	{
+		const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		return (cpus > 4) ? (uint16_t)(((cpus / 4) < UINT16_MAX) ? (cpus / 4) : UINT16_MAX) : 1;
+	}
+
+	char_t* end = NULL;
+	const long compute_threads = strtol(compute_threads_as_string, &end, 10);
+
+	if ((end == compute_threads_as_string) || (*end != '\0') || (compute_threads < 0) || (compute_threads > UINT16_MAX))
+	{
+		common_logger_error("invalid --compute-threads, -c value provided in 'run' command: %s.", compute_threads_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint16_t)compute_threads;
+}
+
+static common_logger_level_e _parse_log_level(const char_t* const log_level_as_string)
+{
+	common_debug_assert(log_level_as_string != NULL);
+
+	if (strcmp(log_level_as_string, "debug") == 0)
+	{
+		return common_logger_level_debug;
+	}
+	else if (strcmp(log_level_as_string, "info") == 0)
+	{
+		return common_logger_level_info;
+	}
+	else if (strcmp(log_level_as_string, "note") == 0)
+	{
+		return common_logger_level_note;
+	}
+	else if (strcmp(log_level_as_string, "warn") == 0)
+	{
+		return common_logger_level_warn;
+	}
+	else if (strcmp(log_level_as_string, "error") == 0)
+	{
+		return common_logger_level_error;
+	}
+
+	common_logger_error("invalid --log-level, -l value provided in 'run' command: %s.", log_level_as_string);
+	_print_usage_banner();
+	exit(1);
+}
+
+static uint32_t _parse_timeout(const char_t* const timeout_as_string, const char_t* const option_names)
+{
+	common_debug_assert(timeout_as_string != NULL);
+	common_debug_assert(option_names != NULL);
+
+	char_t* end = NULL;
+	const long timeout = strtol(timeout_as_string, &end, 10);
+
+	if ((end == timeout_as_string) || (*end != '\0') || (timeout < 0) || (timeout > INT32_MAX))
+	{
+		common_logger_error("invalid %s value provided in 'run' command: %s.", option_names, timeout_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)timeout;
+}
+
+static uint64_t _parse_watermark(const char_t* const watermark_as_string, const char_t* const option_names)
+{
+	common_debug_assert(watermark_as_string != NULL);
+	common_debug_assert(option_names != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long watermark = strtoull(watermark_as_string, &end, 10);
+
+	if ((end == watermark_as_string) || (*end != '\0') || (errno != 0) || (watermark_as_string[0] == '-') || (0 == watermark))
+	{
+		common_logger_error("invalid %s value provided in 'run' command: %s.", option_names, watermark_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint64_t)watermark;
+}
+
+static uint32_t _parse_notsent_lowat(const char_t* const notsent_lowat_as_string)
+{
+	common_debug_assert(notsent_lowat_as_string != NULL);
+
+	char_t* end = NULL;
+	const long notsent_lowat = strtol(notsent_lowat_as_string, &end, 10);
+
+	if ((end == notsent_lowat_as_string) || (*end != '\0') || (notsent_lowat < 0) || (notsent_lowat > INT32_MAX))
+	{
+		common_logger_error("invalid --notsent-lowat, -N value provided in 'run' command: %s.", notsent_lowat_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)notsent_lowat;
+}
+
+static uint64_t _parse_cache_size(const char_t* const cache_size_as_string)
+{
+	common_debug_assert(cache_size_as_string != NULL);
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long cache_size = strtoull(cache_size_as_string, &end, 10);
+
+	if ((end == cache_size_as_string) || (*end != '\0') || (errno != 0) || (cache_size_as_string[0] == '-'))
+	{
+		common_logger_error("invalid --cache-size, -C value provided in 'run' command: %s.", cache_size_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint64_t)cache_size;
+}
+
+static uint32_t _parse_segment_duration(const char_t* const segment_duration_as_string)
+{
+	common_debug_assert(segment_duration_as_string != NULL);
+
+	char_t* end = NULL;
+	const long segment_duration = strtol(segment_duration_as_string, &end, 10);
+
+	if ((end == segment_duration_as_string) || (*end != '\0') || (segment_duration <= 0) || (segment_duration > INT32_MAX))
+	{
+		common_logger_error("invalid --segment-duration, -D value provided in 'run' command: %s.", segment_duration_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint32_t)segment_duration;
+}
+
+static uint64_t _parse_live_media(const char_t* const live_media_as_string)
+{
+	if (NULL == live_media_as_string)
+	{
+		return 0;
+	}
+
+	char_t* end = NULL;
+	errno = 0;
+	const unsigned long long live_media = strtoull(live_media_as_string, &end, 10);
+
+	if ((end == live_media_as_string) || (*end != '\0') || (errno != 0) || (live_media_as_string[0] == '-'))
+	{
+		common_logger_error("invalid --live, -V value provided in 'run' command: %s.", live_media_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint64_t)live_media;
+}
+
+static uint16_t _parse_stats_port(const char_t* const stats_as_string)
+{
+	// note: an argument of digits alone is a port, anything else the path of
+	// a unix socket.
+	if ((NULL == stats_as_string) || (strspn(stats_as_string, "0123456789") != strlen(stats_as_string)))
+	{
+		return 0;
+	}
+
+	const long stats_port = strtol(stats_as_string, NULL, 10);
+
+	if ((stats_port <= 0) || (stats_port > UINT16_MAX))
+	{
+		common_logger_error("invalid --stats, -S value provided in 'run' command: %s.", stats_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return (uint16_t)stats_port;
+}
+
+static const char_t* _parse_stats_socket(const char_t* const stats_as_string)
+{
+	if ((NULL == stats_as_string) || (strspn(stats_as_string, "0123456789") == strlen(stats_as_string)))
+	{
+		return NULL;
+	}
+
+	const struct sockaddr_un address = {0};
+
+	if (strlen(stats_as_string) >= sizeof(address.sun_path))
+	{
+		common_logger_error("invalid --stats, -S value provided in 'run' command: %s is too long for a unix socket path.", stats_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return stats_as_string;
+}
+
 static server_config_s _parse_run_command(int32_t* const argc, const char_t*** const argv)
 {
 	common_debug_assert(argc != NULL);
@@ -176,6 +563,25 @@ static server_config_s _parse_run_command(int32_t* const argc, const char_t*** c
 	const char_t* address_as_string = NULL;
 	const char_t* port_as_string    = NULL;
 	const char_t* backlog_as_string = NULL;
+	const char_t* workers_as_string = NULL;
+	const char_t* io_backend_as_string = NULL;
+	const char_t* data_path_as_string  = NULL;
+	const char_t* media_dir_as_string = NULL;
+	const char_t* io_buffers_as_string = NULL;
+	const char_t* compute_threads_as_string = NULL;
+	const char_t* log_level_as_string = NULL;
+	const char_t* idle_timeout_as_string = NULL;
+	const char_t* write_timeout_as_string = NULL;
+	const char_t* keepalive_as_string = NULL;
+	const char_t* high_watermark_as_string = NULL;
+	const char_t* low_watermark_as_string = NULL;
+	const char_t* notsent_lowat_as_string = NULL;
+	const char_t* cache_size_as_string = NULL;
+	const char_t* segment_duration_as_string = NULL;
+	const char_t* live_media_as_string = NULL;
+	const char_t* stats_as_string = NULL;
+	const char_t* checksums_path = NULL;
+	const char_t* binary_log_path = NULL;
 
 	for (uint64_t index = 0; true; ++index)
 	{
@@ -222,6 +628,234 @@ static server_config_s _parse_run_command(int32_t* const argc, const char_t*** c
 			backlog_as_string = _get_option_argument(option, argc, argv);
 			common_debug_assert(backlog_as_string != NULL);
 		}
+		else if (_match_cli_option(option, "--workers", "-w"))
+		{
+			if (workers_as_string != NULL)
+			{
+				common_logger_error("multiple --workers, -w arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			workers_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(workers_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--io-backend", "-i"))
+		{
+			if (io_backend_as_string != NULL)
+			{
+				common_logger_error("multiple --io-backend, -i arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			io_backend_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(io_backend_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--data-path", "-d"))
+		{
+			if (data_path_as_string != NULL)
+			{
+				common_logger_error("multiple --data-path, -d arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			data_path_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(data_path_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--media-dir", "-m"))
+		{
+			if (media_dir_as_string != NULL)
+			{
+				common_logger_error("multiple --media-dir, -m arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			media_dir_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(media_dir_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--io-buffers", "-B"))
+		{
+			if (io_buffers_as_string != NULL)
+			{
+				common_logger_error("multiple --io-buffers, -B arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			io_buffers_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(io_buffers_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--compute-threads", "-c"))
+		{
+			if (compute_threads_as_string != NULL)
+			{
+				common_logger_error("multiple --compute-threads, -c arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			compute_threads_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(compute_threads_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--binary-log", "-L"))
+		{
+			if (binary_log_path != NULL)
+			{
+				common_logger_error("multiple --binary-log, -L arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			binary_log_path = _get_option_argument(option, argc, argv);
+			common_debug_assert(binary_log_path != NULL);
+		}
+		else if (_match_cli_option(option, "--log-level", "-l"))
+		{
+			if (log_level_as_string != NULL)
+			{
+				common_logger_error("multiple --log-level, -l arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			log_level_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(log_level_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--idle-timeout", "-t"))
+		{
+			if (idle_timeout_as_string != NULL)
+			{
+				common_logger_error("multiple --idle-timeout, -t arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			idle_timeout_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(idle_timeout_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--write-timeout", "-W"))
+		{
+			if (write_timeout_as_string != NULL)
+			{
+				common_logger_error("multiple --write-timeout, -W arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			write_timeout_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(write_timeout_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--keepalive", "-k"))
+		{
+			if (keepalive_as_string != NULL)
+			{
+				common_logger_error("multiple --keepalive, -k arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			keepalive_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(keepalive_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--high-watermark", "-H"))
+		{
+			if (high_watermark_as_string != NULL)
+			{
+				common_logger_error("multiple --high-watermark, -H arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			high_watermark_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(high_watermark_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--low-watermark", "-O"))
+		{
+			if (low_watermark_as_string != NULL)
+			{
+				common_logger_error("multiple --low-watermark, -O arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			low_watermark_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(low_watermark_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--notsent-lowat", "-N"))
+		{
+			if (notsent_lowat_as_string != NULL)
+			{
+				common_logger_error("multiple --notsent-lowat, -N arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			notsent_lowat_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(notsent_lowat_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--cache-size", "-C"))
+		{
+			if (cache_size_as_string != NULL)
+			{
+				common_logger_error("multiple --cache-size, -C arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			cache_size_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(cache_size_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--segment-duration", "-D"))
+		{
+			if (segment_duration_as_string != NULL)
+			{
+				common_logger_error("multiple --segment-duration, -D arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			segment_duration_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(segment_duration_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--live", "-V"))
+		{
+			if (live_media_as_string != NULL)
+			{
+				common_logger_error("multiple --live, -V arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			live_media_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(live_media_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--stats", "-S"))
+		{
+			if (stats_as_string != NULL)
+			{
+				common_logger_error("multiple --stats, -S arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			stats_as_string = _get_option_argument(option, argc, argv);
+			common_debug_assert(stats_as_string != NULL);
+		}
+		else if (_match_cli_option(option, "--checksums", "-X"))
+		{
+			if (checksums_path != NULL)
+			{
+				common_logger_error("multiple --checksums, -X arguments found in the command line arguments in 'run' command.");
+				_print_usage_banner();
+				exit(1);
+			}
+
+			checksums_path = _get_option_argument(option, argc, argv);
+			common_debug_assert(checksums_path != NULL);
+		}
 		else
 		{
 			common_logger_error("invalid/unrecognized command line argument found in 'run' command: %s.", option);
@@ -245,10 +879,125 @@ static server_config_s _parse_run_command(int32_t* const argc, const char_t*** c
 		backlog_as_string = backlog_default_value;
 	}
 
-	return (const server_config_s)
+	if (NULL == workers_as_string)
+	{
+		workers_as_string = workers_default_value;
+	}
+
+	if (NULL == io_backend_as_string)
+	{
+		io_backend_as_string = io_backend_default_value;
+	}
+
+	if (NULL == data_path_as_string)
+	{
+		data_path_as_string = data_path_default_value;
+	}
+
+	if (NULL == media_dir_as_string)
+	{
+		media_dir_as_string = media_dir_default_value;
+	}
+
+	if (NULL == io_buffers_as_string)
+	{
+		io_buffers_as_string = io_buffers_default_value;
+	}
+
+	if (NULL == compute_threads_as_string)
+	{
+		compute_threads_as_string = compute_threads_default_value;
+	}
+
+	if (NULL == log_level_as_string)
+	{
+		log_level_as_string = log_level_default_value;
+	}
+
+	if (NULL == idle_timeout_as_string)
 	{
-		.address = address_as_string                      ,
-		.port    = (const uint16_t)atoi(port_as_string)   ,
-		.backlog = (const uint16_t)atoi(backlog_as_string),
+		idle_timeout_as_string = idle_timeout_default_value;
+	}
+
+	if (NULL == write_timeout_as_string)
+	{
+		write_timeout_as_string = write_timeout_default_value;
+	}
+
+	if (NULL == keepalive_as_string)
+	{
+		keepalive_as_string = keepalive_default_value;
+	}
+
+	if (NULL == high_watermark_as_string)
+	{
+		high_watermark_as_string = high_watermark_default_value;
+	}
+
+	if (NULL == low_watermark_as_string)
+	{
+		low_watermark_as_string = low_watermark_default_value;
+	}
+
+	if (NULL == notsent_lowat_as_string)
+	{
+		notsent_lowat_as_string = notsent_lowat_default_value;
+	}
+
+	// note: the cache serves segments out of memory with copying sends, which
+	// on the zero-copy data path would trade sendfile from the page cache for
+	// a copy of every hot segment, so there it is only enabled when asked for.
+	if (NULL == cache_size_as_string)
+	{
+		cache_size_as_string = (server_data_path_zero_copy == _parse_data_path(data_path_as_string)) ? "0" : cache_size_default_value;
+	}
+
+	if (NULL == segment_duration_as_string)
+	{
+		segment_duration_as_string = segment_duration_default_value;
+	}
+
+	const server_config_s config =
+	{
+		.address          = address_as_string                                                 ,
+		.port             = (const uint16_t)atoi(port_as_string)                              ,
+		.backlog          = (const uint16_t)atoi(backlog_as_string)                           ,
+		.workers          = _parse_workers(workers_as_string)                                 ,
+		.io_backend       = _parse_io_backend(io_backend_as_string)                           ,
+		.data_path        = _parse_data_path(data_path_as_string)                             ,
+		.media_dir        = media_dir_as_string                                               ,
+		.io_buffers       = _parse_io_buffers(io_buffers_as_string)                           ,
+		.compute_threads  = _parse_compute_threads(compute_threads_as_string)                 ,
+		.binary_log       = binary_log_path                                                   ,
+		.log_level        = _parse_log_level(log_level_as_string)                             ,
+		.idle_timeout     = _parse_timeout(idle_timeout_as_string, "--idle-timeout, -t")      ,
+		.write_timeout    = _parse_timeout(write_timeout_as_string, "--write-timeout, -W")    ,
+		.keepalive        = _parse_timeout(keepalive_as_string, "--keepalive, -k")            ,
+		.high_watermark   = _parse_watermark(high_watermark_as_string, "--high-watermark, -H"),
+		.low_watermark    = _parse_watermark(low_watermark_as_string, "--low-watermark, -O")  ,
+		.notsent_lowat    = _parse_notsent_lowat(notsent_lowat_as_string)                     ,
+		.cache_size       = _parse_cache_size(cache_size_as_string)                           ,
+		.segment_duration = _parse_segment_duration(segment_duration_as_string)               ,
+		.live             = (live_media_as_string != NULL)                                    ,
+		.live_media       = _parse_live_media(live_media_as_string)                           ,
+		.stats_port       = _parse_stats_port(stats_as_string)                                ,
+		.stats_socket     = _parse_stats_socket(stats_as_string)                              ,
+		.checksums        = checksums_path                                                    ,
 	};
+
+	if (config.low_watermark > config.high_watermark)
+	{
+		common_logger_error("invalid --low-watermark, -O value provided in 'run' command: %s exceeds the high watermark.", low_watermark_as_string);
+		_print_usage_banner();
+		exit(1);
+	}
+
+	if ((config.checksums != NULL) && (0 == config.compute_threads))
+	{
+		common_logger_error("invalid --checksums, -X value provided in 'run' command: the media library scan needs compute threads.");
+		_print_usage_banner();
+		exit(1);
+	}
+
+	return config;
 }
@@ -0,0 +1,1583 @@
+
+/**
+ * @file connection.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/protocol.h"
+#include "common/timer.h"
+
+#include "server/connection.h"
+#include "server/media.h"
+
+#include <sys/sendfile.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+typedef enum
+{
+	_source_ready,
+	_source_waiting,
+	_source_missing,
+} _source_e;
+
+// note: where the payload of a response comes from, either a cache entry or
+// the opened file of the segment.
+typedef struct
+{
+	server_cache_entry_s* entry;
+	int32_t fd;
+	uint64_t size;
+} _source_s;
+
+static server_connection_segment_s* _segment_at(server_connection_s* const connection, const uint64_t index);
+
+static uint64_t _segment_remaining(const server_connection_segment_s* const segment);
+
+static void _pop_segment(server_connection_s* const connection);
+
+static uint64_t _append_output(server_connection_s* const connection, const uint8_t* const data, const uint64_t size);
+
+static bool_t _stage_bounce(server_connection_s* const connection, server_connection_segment_s* const segment, struct iovec* const target, uint64_t* const offset);
+
+static bool_t _bounce_file(server_connection_s* const connection, server_connection_segment_s* const segment);
+
+static void _process_input(server_connection_s* const connection);
+
+static uint64_t _process_frames(server_connection_s* const connection, const uint8_t* const data, const uint64_t size);
+
+static void _begin_service(server_connection_s* const connection);
+
+static void _end_service(server_connection_s* const connection);
+
+static bool_t _handle_request(server_connection_s* const connection, const common_protocol_frame_s* const frame);
+
+static bool_t _handle_range(server_connection_s* const connection, const common_protocol_frame_s* const frame);
+
+static bool_t _handle_subscribe(server_connection_s* const connection, const common_protocol_frame_s* const frame);
+
+static bool_t _start_range(server_connection_s* const connection, const common_protocol_frame_s* const frame, common_protocol_error_e* const error);
+
+static _source_e _open_source(server_connection_s* const connection, const uint64_t media_id, const uint32_t chunk, _source_s* const source);
+
+static bool_t _queue_source(server_connection_s* const connection, const _source_s* const source, const uint32_t stream_id, const uint64_t offset, const uint64_t length, const uint8_t flags);
+
+static bool_t _queue_live(server_connection_s* const connection, server_cache_entry_s* const entry);
+
+static bool_t _append_error(server_connection_s* const connection, const uint32_t stream_id, const common_protocol_error_e error);
+
+static bool_t _append_ping(server_connection_s* const connection, const common_protocol_frame_e type);
+
+static bool_t _has_room(const server_connection_s* const connection, const uint64_t size);
+
+static bool_t _send_file(server_connection_s* const connection, server_connection_segment_s* const segment, bool_t* const progress, bool_t* const blocked);
+
+static bool_t _ensure_pipe(server_connection_s* const connection);
+
+void server_connection_open(server_connection_s* const connection, const int32_t fd, const server_config_s* const config, common_pool_s* const pool, server_cache_s* const cache, server_live_s* const live,
+	server_stats_worker_s* const worker_stats)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(fd >= 0);
+	common_debug_assert(config != NULL);
+	common_debug_assert(pool != NULL);
+	common_debug_assert(worker_stats != NULL);
+
+	connection->fd             = fd;
+	connection->state          = server_connection_state_open;
+	connection->config         = config;
+	connection->failed         = false;
+	connection->input          = NULL;
+	connection->input_count    = 0;
+	connection->output         = NULL;
+	connection->output_used    = 0;
+	connection->output_pending = 0;
+	connection->segments_head  = 0;
+	connection->segments_count = 0;
+	connection->queued         = 0;
+	connection->throttled      = false;
+	connection->pipe[0]        = -1;
+	connection->pipe[1]        = -1;
+	connection->pipe_capacity  = 0;
+	connection->pool           = pool;
+	connection->bounce         = NULL;
+	connection->cache          = cache;
+	connection->loading        = NULL;
+	connection->waiting        = false;
+	connection->range.active   = false;
+	connection->live           = live;
+	common_arena_create(&connection->arena);
+	(void)memset(&connection->stats, 0, sizeof(connection->stats));
+	connection->worker_stats          = worker_stats;
+	connection->serving_ns            = 0;
+	connection->timers.idle_mark      = 0;
+	connection->timers.write_mark     = 0;
+	connection->timers.keepalive_mark = 0;
+	connection->subscription.active   = false;
+	connection->subscription.pending  = NULL;
+	(void)memset(&connection->io, 0, sizeof(connection->io));
+}
+
+void server_connection_close(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (connection->state == server_connection_state_closed)
+	{
+		return;
+	}
+
+	while (connection->segments_count > 0)
+	{
+		_pop_segment(connection);
+	}
+
+	if (connection->input != NULL)
+	{
+		common_pool_release(connection->input);
+		connection->input       = NULL;
+		connection->input_count = 0;
+	}
+
+	if (connection->loading != NULL)
+	{
+		server_cache_release(connection->loading);
+		connection->loading = NULL;
+		connection->waiting = false;
+	}
+
+	if (connection->subscription.pending != NULL)
+	{
+		server_cache_release(connection->subscription.pending);
+		connection->subscription.pending = NULL;
+	}
+
+	connection->subscription.active = false;
+
+	if (connection->pipe[0] >= 0) { (void)close(connection->pipe[0]); connection->pipe[0] = -1; }
+	if (connection->pipe[1] >= 0) { (void)close(connection->pipe[1]); connection->pipe[1] = -1; }
+
+	common_arena_destroy(&connection->arena);
+
+	(void)close(connection->fd);
+	connection->fd    = -1;
+	connection->state = server_connection_state_closed;
+}
+
+bool_t server_connection_reserve_input(server_connection_s* const connection, uint8_t** const data, uint64_t* const size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(data != NULL);
+	common_debug_assert(size != NULL);
+
+	if (NULL == connection->input)
+	{
+		connection->input = common_pool_acquire(connection->pool);
+
+		if (NULL == connection->input)
+		{
+			common_logger_warn("no pooled buffer left to receive into for connection %d.", connection->fd);
+			server_connection_fail(connection);
+			return false;
+		}
+	}
+
+	*data = common_pool_data(connection->input) + connection->input_count;
+	*size = connection->pool->buffer_size - connection->input_count;
+	return *size > 0;
+}
+
+void server_connection_commit_input(server_connection_s* const connection, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert((connection->input != NULL) || (0 == size));
+	common_debug_assert((connection->input_count + size) <= connection->pool->buffer_size);
+
+	connection->input_count          += size;
+	connection->stats.bytes_received += size;
+	server_stats_add(connection->worker_stats, server_stats_bytes_received, size);
+	_process_input(connection);
+}
+
+uint64_t server_connection_receive(server_connection_s* const connection, const uint8_t* const data, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(data != NULL);
+
+	uint64_t absorbed = 0;
+
+	if (0 == connection->input_count)
+	{
+		absorbed = _process_frames(connection, data, size);
+		connection->stats.bytes_received += absorbed;
+		server_stats_add(connection->worker_stats, server_stats_bytes_received, absorbed);
+	}
+
+	while (absorbed < size)
+	{
+		uint8_t* space = NULL;
+		uint64_t space_size = 0;
+
+		if (!server_connection_reserve_input(connection, &space, &space_size))
+		{
+			break;
+		}
+
+		const uint64_t chunk = ((size - absorbed) < space_size) ? (size - absorbed) : space_size;
+		(void)memcpy(space, data + absorbed, chunk);
+		server_connection_commit_input(connection, chunk);
+		absorbed += chunk;
+	}
+
+	return absorbed;
+}
+
+bool_t server_connection_queue_file(server_connection_s* const connection, const int32_t fd, const bool_t owned, const uint64_t offset, const uint64_t length, const uint8_t* const header, const uint64_t header_length)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(fd >= 0);
+	common_debug_assert(header_length <= server_connection_header_capacity);
+	common_debug_assert((NULL == header) == (0 == header_length));
+
+	if (connection->segments_count >= server_connection_segments_capacity)
+	{
+		return false;
+	}
+
+	if ((0 == length) && (0 == header_length))
+	{
+		if (owned)
+		{
+			(void)close(fd);
+		}
+
+		return true;
+	}
+
+	server_connection_segment_s* const segment = _segment_at(connection, connection->segments_count++);
+	segment->kind               = server_connection_segment_file;
+	segment->file.fd            = fd;
+	segment->file.owned         = owned;
+	segment->file.offset        = offset;
+	segment->file.length        = length;
+	segment->file.header_length = header_length;
+	segment->file.sent          = 0;
+	segment->file.staged        = 0;
+	segment->file.bounced       = 0;
+
+	if (header_length > 0)
+	{
+		(void)memcpy(segment->file.header, header, header_length);
+	}
+
+	connection->queued += header_length + length;
+	server_stats_add(connection->worker_stats, server_stats_queued_bytes, header_length + length);
+	server_stats_add(connection->worker_stats, server_stats_frames_sent, (header_length > 0) ? 1 : 0);
+
+	return true;
+}
+
+bool_t server_connection_queue_cached(server_connection_s* const connection, server_cache_entry_s* const entry, const uint64_t offset, const uint64_t length, const uint8_t* const header, const uint64_t header_length)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(entry != NULL);
+	common_debug_assert((offset + length) <= entry->size);
+	common_debug_assert(header_length <= server_connection_header_capacity);
+	common_debug_assert((NULL == header) == (0 == header_length));
+
+	if (connection->segments_count >= server_connection_segments_capacity)
+	{
+		return false;
+	}
+
+	if ((0 == length) && (0 == header_length))
+	{
+		server_cache_release(entry);
+		return true;
+	}
+
+	server_connection_segment_s* const segment = _segment_at(connection, connection->segments_count++);
+	segment->kind                 = server_connection_segment_cached;
+	segment->cached.entry         = entry;
+	segment->cached.offset        = offset;
+	segment->cached.length        = length;
+	segment->cached.header_length = header_length;
+	segment->cached.sent          = 0;
+
+	if (header_length > 0)
+	{
+		(void)memcpy(segment->cached.header, header, header_length);
+	}
+
+	connection->queued += header_length + length;
+	server_stats_add(connection->worker_stats, server_stats_queued_bytes, header_length + length);
+	server_stats_add(connection->worker_stats, server_stats_frames_sent, (header_length > 0) ? 1 : 0);
+
+	return true;
+}
+
+bool_t server_connection_queue_ping(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	return _append_ping(connection, common_protocol_frame_ping);
+}
+
+void server_connection_queue_live(server_connection_s* const connection, server_cache_entry_s* const entry)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(entry != NULL);
+
+	if (!connection->subscription.active || (entry->chunk < connection->subscription.next_chunk))
+	{
+		return;
+	}
+
+	connection->subscription.next_chunk = (uint64_t)entry->chunk + 1;
+	server_cache_retain(entry);
+
+	// note: a segment held back already is queued first once the output
+	// drains, so a newer one may only ever replace it.
+	if ((connection->subscription.pending != NULL) || (connection->queued >= connection->config->high_watermark) ||
+		!_queue_live(connection, entry))
+	{
+		if (connection->subscription.pending != NULL)
+		{
+			server_cache_release(connection->subscription.pending);
+			++connection->stats.skipped;
+		}
+
+		connection->subscription.pending = entry;
+	}
+}
+
+uint64_t server_connection_gather_output(server_connection_s* const connection, struct iovec* const iovs, const uint64_t capacity)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(iovs != NULL);
+
+	uint64_t count = 0;
+
+	for (uint64_t index = 0; (index < connection->segments_count) && (count < capacity); ++index)
+	{
+		server_connection_segment_s* const segment = _segment_at(connection, index);
+
+		if (server_connection_segment_memory == segment->kind)
+		{
+			iovs[count++] = (const struct iovec)
+			{
+				.iov_base = segment->memory.data,
+				.iov_len  = segment->memory.size,
+			};
+
+			continue;
+		}
+
+		if (server_connection_segment_cached == segment->kind)
+		{
+			const uint64_t header_length = segment->cached.header_length;
+			const uint64_t sent          = segment->cached.sent;
+
+			if (sent < header_length)
+			{
+				iovs[count++] = (const struct iovec)
+				{
+					.iov_base = segment->cached.header + sent,
+					.iov_len  = header_length - sent,
+				};
+
+				if (count >= capacity)
+				{
+					break;
+				}
+			}
+
+			const uint64_t payload_sent = (sent > header_length) ? (sent - header_length) : 0;
+
+			if (payload_sent < segment->cached.length)
+			{
+				iovs[count++] = (const struct iovec)
+				{
+					.iov_base = segment->cached.entry->data + segment->cached.offset + payload_sent,
+					.iov_len  = segment->cached.length - payload_sent,
+				};
+			}
+
+			continue;
+		}
+
+		// note: on the zero-copy data path file segments are transmitted by the
+		// backend itself. on the copy path the head file segment is read into
+		// the bounce buffer chunk by chunk and transmitted like memory.
+		if ((connection->config->data_path != server_data_path_copy) || (index > 0))
+		{
+			break;
+		}
+
+		if (!_bounce_file(connection, segment))
+		{
+			server_connection_fail(connection);
+			break;
+		}
+
+		const uint64_t bounce_offset = segment->file.sent - segment->file.bounced;
+
+		iovs[count++] = (const struct iovec)
+		{
+			.iov_base = common_pool_data(connection->bounce) + bounce_offset,
+			.iov_len  = segment->file.staged - segment->file.sent,
+		};
+
+		if (segment->file.staged < (segment->file.header_length + segment->file.length))
+		{
+			break;
+		}
+	}
+
+	return count;
+}
+
+server_connection_segment_s* server_connection_head_file(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if ((0 == connection->segments_count) || (connection->config->data_path == server_data_path_copy))
+	{
+		return NULL;
+	}
+
+	server_connection_segment_s* const segment = _segment_at(connection, 0);
+	return (server_connection_segment_file == segment->kind) ? segment : NULL;
+}
+
+server_connection_segment_s* server_connection_prepare_bounce(server_connection_s* const connection, struct iovec* const target, uint64_t* const offset)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(target != NULL);
+	common_debug_assert(offset != NULL);
+
+	if ((0 == connection->segments_count) || (connection->config->data_path != server_data_path_copy))
+	{
+		return NULL;
+	}
+
+	server_connection_segment_s* const segment = _segment_at(connection, 0);
+
+	if ((segment->kind != server_connection_segment_file) || (segment->file.staged > segment->file.sent))
+	{
+		return NULL;
+	}
+
+	if (!_stage_bounce(connection, segment, target, offset))
+	{
+		server_connection_fail(connection);
+		return NULL;
+	}
+
+	return (target->iov_len > 0) ? segment : NULL;
+}
+
+void server_connection_commit_bounce(server_connection_s* const connection, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(connection->segments_count > 0);
+
+	server_connection_segment_s* const segment = _segment_at(connection, 0);
+	common_debug_assert(server_connection_segment_file == segment->kind);
+
+	segment->file.staged           += size;
+	connection->stats.bytes_copied += size;
+	server_stats_add(connection->worker_stats, server_stats_bytes_copied, size);
+}
+
+bool_t server_connection_transmit_file(server_connection_s* const connection, server_connection_segment_s* const segment, bool_t* const progress, bool_t* const blocked)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(server_connection_segment_file == segment->kind);
+	common_debug_assert(progress != NULL);
+	common_debug_assert(blocked != NULL);
+
+	if (0 == segment->file.header_length)
+	{
+		return _send_file(connection, segment, progress, blocked);
+	}
+
+	const uint64_t staged = segment->file.staged;
+	uint64_t offset = 0;
+	uint64_t length = 0;
+
+	if (!server_connection_stage_file(connection, segment, &offset, &length))
+	{
+		return false;
+	}
+
+	*progress = segment->file.staged > staged;
+
+	if (length > 0)
+	{
+		loff_t from = (loff_t)offset;
+		const ssize_t result = splice(segment->file.fd, &from, connection->pipe[1], NULL, length, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+		if (result > 0)
+		{
+			server_connection_commit_file(connection, (uint64_t)result);
+			*progress = true;
+		}
+		else if (0 == result)
+		{
+			common_logger_warn("file segment for connection %d ended unexpectedly.", connection->fd);
+			return false;
+		}
+		else if ((errno != EAGAIN) && (errno != EINTR))
+		{
+			common_logger_debug("splicing a file for connection %d failed: %s.", connection->fd, strerror(errno));
+			return false;
+		}
+	}
+
+	return server_connection_drain_file(connection, segment, progress, blocked);
+}
+
+bool_t server_connection_stage_file(server_connection_s* const connection, server_connection_segment_s* const segment, uint64_t* const offset, uint64_t* const length)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(server_connection_segment_file == segment->kind);
+	common_debug_assert(offset != NULL);
+	common_debug_assert(length != NULL);
+
+	*offset = 0;
+	*length = 0;
+
+	if (!_ensure_pipe(connection))
+	{
+		return false;
+	}
+
+	// note: the header and the file range are staged into the pipe back to
+	// back, and the pipe is then spliced into the socket, so that the framing
+	// goes out interleaved with the payload without the payload ever reaching
+	// userspace. the pipe only ever holds bytes of the head segment.
+	const uint64_t total = segment->file.header_length + segment->file.length;
+
+	if (segment->file.staged < segment->file.header_length)
+	{
+		const ssize_t result = write(connection->pipe[1], segment->file.header + segment->file.staged,
+			segment->file.header_length - segment->file.staged);
+
+		if (result > 0)
+		{
+			segment->file.staged += (uint64_t)result;
+		}
+		else if ((result < 0) && (errno != EAGAIN) && (errno != EINTR))
+		{
+			common_logger_debug("staging a header for connection %d failed: %s.", connection->fd, strerror(errno));
+			return false;
+		}
+	}
+
+	const uint64_t room = connection->pipe_capacity - (segment->file.staged - segment->file.sent);
+
+	if ((segment->file.staged >= segment->file.header_length) && (segment->file.staged < total) && (room > 0))
+	{
+		*offset = segment->file.offset + segment->file.staged - segment->file.header_length;
+		*length = ((total - segment->file.staged) < room) ? (total - segment->file.staged) : room;
+	}
+
+	return true;
+}
+
+void server_connection_commit_file(server_connection_s* const connection, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(connection->segments_count > 0);
+
+	server_connection_segment_s* const segment = _segment_at(connection, 0);
+	common_debug_assert(server_connection_segment_file == segment->kind);
+
+	segment->file.staged += size;
+}
+
+bool_t server_connection_drain_file(server_connection_s* const connection, server_connection_segment_s* const segment, bool_t* const progress, bool_t* const blocked)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(server_connection_segment_file == segment->kind);
+	common_debug_assert(progress != NULL);
+	common_debug_assert(blocked != NULL);
+
+	if (segment->file.staged <= segment->file.sent)
+	{
+		return true;
+	}
+
+	const uint64_t total = segment->file.header_length + segment->file.length;
+	const uint32_t more  = ((segment->file.staged < total) || (connection->segments_count > 1)) ? SPLICE_F_MORE : 0;
+	const ssize_t result = splice(connection->pipe[0], NULL, connection->fd, NULL, segment->file.staged - segment->file.sent,
+		SPLICE_F_MOVE | SPLICE_F_NONBLOCK | more);
+	++connection->stats.sends;
+	server_stats_add(connection->worker_stats, server_stats_sends, 1);
+
+	if (result > 0)
+	{
+		connection->stats.bytes_spliced += (uint64_t)result;
+		server_stats_add(connection->worker_stats, server_stats_bytes_spliced, (uint64_t)result);
+		server_connection_consume_output(connection, (uint64_t)result);
+		*progress = true;
+	}
+	else if ((result < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno)))
+	{
+		*blocked = true;
+	}
+	else if ((result < 0) && (errno != EINTR))
+	{
+		common_logger_debug("splicing to connection %d failed: %s.", connection->fd, strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+void server_connection_consume_output(server_connection_s* const connection, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+
+	uint64_t remaining = size;
+
+	while (remaining > 0)
+	{
+		common_debug_assert(connection->segments_count > 0);
+
+		server_connection_segment_s* const segment = _segment_at(connection, 0);
+		const uint64_t available = _segment_remaining(segment);
+		const uint64_t consumed  = (remaining < available) ? remaining : available;
+
+		if (server_connection_segment_memory == segment->kind)
+		{
+			segment->memory.data       += consumed;
+			segment->memory.size       -= consumed;
+			connection->output_pending -= consumed;
+			connection->stats.bytes_written += consumed;
+		}
+		else if (server_connection_segment_cached == segment->kind)
+		{
+			segment->cached.sent += consumed;
+			connection->stats.bytes_cached += consumed;
+		}
+		else
+		{
+			segment->file.sent += consumed;
+		}
+
+		remaining -= consumed;
+		connection->queued -= consumed;
+		connection->stats.bytes_transmitted += consumed;
+		server_stats_add(connection->worker_stats, server_stats_bytes_sent, consumed);
+		server_stats_sub(connection->worker_stats, server_stats_queued_bytes, consumed);
+
+		if (consumed == available)
+		{
+			_pop_segment(connection);
+		}
+	}
+
+	if (connection->throttled && (connection->queued <= connection->config->low_watermark))
+	{
+		connection->throttled = false;
+	}
+
+	if ((connection->subscription.pending != NULL) && (connection->queued <= connection->config->low_watermark) &&
+		_queue_live(connection, connection->subscription.pending))
+	{
+		connection->subscription.pending = NULL;
+	}
+
+	// note: freed output space may unblock input that could not be processed.
+	_process_input(connection);
+}
+
+bool_t server_connection_is_throttled(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	return connection->throttled;
+}
+
+bool_t server_connection_is_waiting(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	return connection->waiting;
+}
+
+void server_connection_resume(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(connection->waiting);
+
+	connection->waiting = false;
+
+	if ((server_connection_state_open == connection->state) || (server_connection_state_draining == connection->state))
+	{
+		_process_input(connection);
+	}
+}
+
+bool_t server_connection_is_subscribed(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	return connection->subscription.active;
+}
+
+bool_t server_connection_has_output(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	return connection->segments_count > 0;
+}
+
+bool_t server_connection_has_failed(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	return connection->failed;
+}
+
+void server_connection_fail(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	connection->failed = true;
+}
+
+void server_connection_shutdown_input(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (server_connection_state_open == connection->state)
+	{
+		connection->state = server_connection_state_draining;
+	}
+}
+
+bool_t server_connection_is_finished(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	// note: input is processed whenever output drains, so whatever input is
+	// left once nothing is pending is a partial frame that can never complete.
+	return (connection->state != server_connection_state_open) && (0 == connection->segments_count) && !connection->waiting;
+}
+
+static server_connection_segment_s* _segment_at(server_connection_s* const connection, const uint64_t index)
+{
+	common_debug_assert(connection != NULL);
+	return &connection->segments[(connection->segments_head + index) % server_connection_segments_capacity];
+}
+
+static uint64_t _segment_remaining(const server_connection_segment_s* const segment)
+{
+	common_debug_assert(segment != NULL);
+
+	if (server_connection_segment_memory == segment->kind)
+	{
+		return segment->memory.size;
+	}
+
+	if (server_connection_segment_cached == segment->kind)
+	{
+		return segment->cached.header_length + segment->cached.length - segment->cached.sent;
+	}
+
+	return segment->file.header_length + segment->file.length - segment->file.sent;
+}
+
+static void _pop_segment(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(connection->segments_count > 0);
+
+	server_connection_segment_s* const segment = _segment_at(connection, 0);
+	const uint64_t remaining = _segment_remaining(segment);
+	connection->queued -= remaining;
+	server_stats_sub(connection->worker_stats, server_stats_queued_bytes, remaining);
+
+	if (server_connection_segment_memory == segment->kind)
+	{
+		connection->output_pending -= segment->memory.size;
+		common_pool_slice_release(&segment->memory);
+	}
+	else if (server_connection_segment_cached == segment->kind)
+	{
+		server_cache_release(segment->cached.entry);
+	}
+	else
+	{
+		if (segment->file.owned)
+		{
+			(void)close(segment->file.fd);
+		}
+
+		// note: only the head file segment is ever bounced, so the buffer goes
+		// back to the pool as soon as it is done.
+		if (connection->bounce != NULL)
+		{
+			common_pool_release(connection->bounce);
+			connection->bounce = NULL;
+		}
+	}
+
+	connection->segments_head = (connection->segments_head + 1) % server_connection_segments_capacity;
+	--connection->segments_count;
+
+	// note: the output buffer is only ever appended to, as a backend may be
+	// transmitting from it, and it goes back to the pool once nothing in it
+	// is pending.
+	if ((0 == connection->output_pending) && (connection->output != NULL))
+	{
+		common_pool_release(connection->output);
+		connection->output      = NULL;
+		connection->output_used = 0;
+	}
+}
+
+static uint64_t _append_output(server_connection_s* const connection, const uint8_t* const data, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(data != NULL);
+	common_debug_assert(size <= connection->pool->buffer_size);
+
+	if ((connection->output != NULL) && ((connection->pool->buffer_size - connection->output_used) < size))
+	{
+		common_pool_release(connection->output);
+		connection->output      = NULL;
+		connection->output_used = 0;
+	}
+
+	if (NULL == connection->output)
+	{
+		connection->output = common_pool_acquire(connection->pool);
+
+		if (NULL == connection->output)
+		{
+			common_logger_warn("no pooled buffer left to queue output for connection %d.", connection->fd);
+			server_connection_fail(connection);
+			return 0;
+		}
+	}
+
+	uint8_t* const target = common_pool_data(connection->output) + connection->output_used;
+	server_connection_segment_s* segment = NULL;
+
+	if (connection->segments_count > 0)
+	{
+		segment = _segment_at(connection, connection->segments_count - 1);
+
+		// note: the buffers of the pool lie back to back, so a segment only
+		// grows while it is a slice of the very buffer appended to.
+		if ((segment->kind != server_connection_segment_memory) || (segment->memory.buffer != connection->output) ||
+			((segment->memory.data + segment->memory.size) != target))
+		{
+			segment = NULL;
+		}
+	}
+
+	if (NULL == segment)
+	{
+		if (connection->segments_count >= server_connection_segments_capacity)
+		{
+			return 0;
+		}
+
+		segment = _segment_at(connection, connection->segments_count++);
+		segment->kind   = server_connection_segment_memory;
+		segment->memory = common_pool_slice(connection->output, connection->output_used, 0);
+	}
+
+	(void)memcpy(target, data, size);
+	segment->memory.size       += size;
+	connection->output_used    += size;
+	connection->output_pending += size;
+	connection->queued         += size;
+	server_stats_add(connection->worker_stats, server_stats_queued_bytes, size);
+	return size;
+}
+
+static bool_t _stage_bounce(server_connection_s* const connection, server_connection_segment_s* const segment, struct iovec* const target, uint64_t* const offset)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(target != NULL);
+	common_debug_assert(offset != NULL);
+
+	if (NULL == connection->bounce)
+	{
+		connection->bounce = common_pool_acquire(connection->pool);
+
+		if (NULL == connection->bounce)
+		{
+			common_logger_warn("no pooled buffer left to read a file segment for connection %d.", connection->fd);
+			return false;
+		}
+	}
+
+	uint8_t* const bounce = common_pool_data(connection->bounce);
+	uint64_t filled = 0;
+
+	if (segment->file.sent < segment->file.header_length)
+	{
+		filled = segment->file.header_length - segment->file.sent;
+		(void)memcpy(bounce, segment->file.header + segment->file.sent, filled);
+	}
+
+	const uint64_t payload_sent = segment->file.sent + filled - segment->file.header_length;
+	const uint64_t payload_left = segment->file.length - payload_sent;
+	const uint64_t room         = connection->pool->buffer_size - filled;
+	const uint64_t wanted       = (payload_left < room) ? payload_left : room;
+
+	segment->file.bounced = segment->file.sent;
+	segment->file.staged  = segment->file.sent + filled;
+
+	*target = (const struct iovec)
+	{
+		.iov_base = bounce + filled,
+		.iov_len  = wanted,
+	};
+
+	*offset = segment->file.offset + payload_sent;
+	return true;
+}
+
+static bool_t _bounce_file(server_connection_s* const connection, server_connection_segment_s* const segment)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+
+	if (segment->file.staged > segment->file.sent)
+	{
+		return true;
+	}
+
+	struct iovec target = {0};
+	uint64_t offset = 0;
+
+	if (!_stage_bounce(connection, segment, &target, &offset))
+	{
+		return false;
+	}
+
+	if (target.iov_len > 0)
+	{
+		const ssize_t result = pread(segment->file.fd, target.iov_base, target.iov_len, (off_t)offset);
+
+		if (result <= 0)
+		{
+			common_logger_warn("failed to read a file segment for connection %d: %s.", connection->fd, (0 == result) ? "unexpected end of file" : strerror(errno));
+			return false;
+		}
+
+		segment->file.staged           += (uint64_t)result;
+		connection->stats.bytes_copied += (uint64_t)result;
+		server_stats_add(connection->worker_stats, server_stats_bytes_copied, (uint64_t)result);
+	}
+
+	return segment->file.staged > segment->file.sent;
+}
+
+static void _process_input(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (NULL == connection->input)
+	{
+		return;
+	}
+
+	uint8_t* const input = common_pool_data(connection->input);
+	const uint64_t offset = _process_frames(connection, input, connection->input_count);
+
+	// note: a partial frame stays at the front of the buffer until the rest
+	// of it arrives, and the buffer goes back to the pool once it is empty.
+	if (offset > 0)
+	{
+		(void)memmove(input, input + offset, connection->input_count - offset);
+		connection->input_count -= offset;
+	}
+
+	if (0 == connection->input_count)
+	{
+		common_pool_release(connection->input);
+		connection->input = NULL;
+	}
+}
+
+static uint64_t _process_frames(server_connection_s* const connection, const uint8_t* const data, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert((data != NULL) || (0 == size));
+
+	uint64_t offset = 0;
+
+	// note: frames are parsed in place, and frames whose response can not be
+	// queued yet are picked up again once the output drains.
+	while (!connection->failed && !connection->throttled && !connection->waiting)
+	{
+		common_protocol_frame_s frame = {0};
+		uint64_t frame_size = 0;
+
+		const common_protocol_status_e status = common_protocol_parse_frame(data + offset, size - offset, &frame, &frame_size);
+
+		if (common_protocol_status_incomplete == status)
+		{
+			break;
+		}
+
+		if ((common_protocol_status_invalid == status) || (common_protocol_frame_segment == frame.header.type) ||
+			(common_protocol_frame_error == frame.header.type))
+		{
+			common_logger_debug("connection %d sent an invalid frame.", connection->fd);
+			server_connection_fail(connection);
+			break;
+		}
+
+		bool_t handled = true;
+
+		// note: a pong only has to arrive to count as traffic, while a ping from
+		// the peer is answered in line with the responses.
+		if (common_protocol_frame_request == frame.header.type)
+		{
+			_begin_service(connection);
+			handled = _handle_request(connection, &frame);
+			common_arena_reset(&connection->arena);
+		}
+		else if ((common_protocol_frame_byte_range == frame.header.type) || (common_protocol_frame_time_range == frame.header.type))
+		{
+			_begin_service(connection);
+			handled = _handle_range(connection, &frame);
+			common_arena_reset(&connection->arena);
+		}
+		else if (common_protocol_frame_subscribe == frame.header.type)
+		{
+			handled = _handle_subscribe(connection, &frame);
+		}
+		else if (common_protocol_frame_ping == frame.header.type)
+		{
+			handled = _append_ping(connection, common_protocol_frame_pong);
+		}
+
+		if (!handled)
+		{
+			break;
+		}
+
+		_end_service(connection);
+		offset += frame_size;
+		server_stats_add(connection->worker_stats, server_stats_frames_received, 1);
+
+		if (connection->queued >= connection->config->high_watermark)
+		{
+			connection->throttled = true;
+			++connection->stats.throttled;
+			server_stats_add(connection->worker_stats, server_stats_throttled, 1);
+		}
+	}
+
+	return offset;
+}
+
+static void _begin_service(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (0 == connection->serving_ns)
+	{
+		connection->serving_ns = common_timer_now_ns();
+	}
+}
+
+static void _end_service(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (connection->serving_ns > 0)
+	{
+		common_histogram_record(&connection->worker_stats->service, common_timer_now_ns() - connection->serving_ns);
+		connection->serving_ns = 0;
+	}
+}
+
+static bool_t _handle_request(server_connection_s* const connection, const common_protocol_frame_s* const frame)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(frame != NULL);
+
+	// note: a response takes up an output segment, and an error response also
+	// takes up room in the output buffer.
+	if (!_has_room(connection, common_protocol_error_frame_size))
+	{
+		return false;
+	}
+
+	common_protocol_request_s request = {0};
+	common_protocol_error_e error = common_protocol_error_invalid;
+
+	if (common_protocol_decode_request(frame->payload, frame->header.length, &request))
+	{
+		_source_s source = {0};
+		const _source_e status = _open_source(connection, request.media_id, request.chunk, &source);
+
+		if (_source_waiting == status)
+		{
+			return false;
+		}
+
+		if (_source_ready == status)
+		{
+			return _queue_source(connection, &source, frame->header.stream_id, 0, source.size, common_protocol_flag_end);
+		}
+
+		error = common_protocol_error_not_found;
+	}
+
+	return _append_error(connection, frame->header.stream_id, error);
+}
+
+static bool_t _handle_range(server_connection_s* const connection, const common_protocol_frame_s* const frame)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(frame != NULL);
+
+	common_protocol_error_e error = common_protocol_error_invalid;
+
+	if (!connection->range.active)
+	{
+		if (!_has_room(connection, common_protocol_error_frame_size))
+		{
+			return false;
+		}
+
+		if (!_start_range(connection, frame, &error))
+		{
+			return _append_error(connection, frame->header.stream_id, error);
+		}
+	}
+
+	// note: the range is served a segment at a time for as long as there is
+	// room for another response, and picked up again from where it stopped
+	// once the output drains.
+	while (true)
+	{
+		if (!_has_room(connection, common_protocol_error_frame_size))
+		{
+			return false;
+		}
+
+		if (connection->queued >= connection->config->high_watermark)
+		{
+			connection->throttled = true;
+			++connection->stats.throttled;
+			server_stats_add(connection->worker_stats, server_stats_throttled, 1);
+			return false;
+		}
+
+		_source_s source = {0};
+		const _source_e status = _open_source(connection, connection->range.media_id, connection->range.chunk, &source);
+
+		if (_source_waiting == status)
+		{
+			return false;
+		}
+
+		// note: once responses went out, a missing segment can only have gone
+		// away while the range was being served.
+		if (_source_missing == status)
+		{
+			error = connection->range.started ? common_protocol_error_unavailable : common_protocol_error_out_of_range;
+			connection->range.active = false;
+			return _append_error(connection, frame->header.stream_id, error);
+		}
+
+		const uint64_t skip      = (connection->range.skip < source.size) ? connection->range.skip : source.size;
+		const uint64_t available = source.size - skip;
+		const uint64_t length    = (available < connection->range.remaining) ? available : connection->range.remaining;
+		uint64_t next_size = 0;
+
+		// note: the end flag goes on the response of the last segment, which is
+		// the one where the range runs out, or the last one of the media.
+		const bool_t last = (length == connection->range.remaining) || (connection->range.chunk >= connection->range.last) ||
+			!server_media_stat_segment(&connection->arena, connection->config->media_dir, connection->range.media_id,
+				connection->range.chunk + 1, &next_size);
+
+		if (!_queue_source(connection, &source, frame->header.stream_id, skip, length, last ? common_protocol_flag_end : 0))
+		{
+			return false;
+		}
+
+		connection->range.started = true;
+
+		if (last)
+		{
+			connection->range.active = false;
+			return true;
+		}
+
+		++connection->range.chunk;
+		connection->range.skip       = 0;
+		connection->range.remaining -= length;
+	}
+}
+
+static bool_t _handle_subscribe(server_connection_s* const connection, const common_protocol_frame_s* const frame)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(frame != NULL);
+
+	if (!_has_room(connection, common_protocol_error_frame_size))
+	{
+		return false;
+	}
+
+	uint64_t media_id = 0;
+
+	if (!common_protocol_decode_subscribe(frame->payload, frame->header.length, &media_id) || connection->subscription.active)
+	{
+		return _append_error(connection, frame->header.stream_id, common_protocol_error_invalid);
+	}
+
+	if ((NULL == connection->live) || (server_live_media_id(connection->live) != media_id))
+	{
+		return _append_error(connection, frame->header.stream_id, common_protocol_error_not_found);
+	}
+
+	connection->subscription.active     = true;
+	connection->subscription.stream_id  = frame->header.stream_id;
+	connection->subscription.next_chunk = 0;
+
+	// note: the subscriber starts from the live edge, and is handed every
+	// segment published after it by the reactor.
+	server_cache_entry_s* const edge = server_live_edge(connection->live);
+
+	if (edge != NULL)
+	{
+		server_connection_queue_live(connection, edge);
+		server_cache_release(edge);
+	}
+
+	return true;
+}
+
+static bool_t _start_range(server_connection_s* const connection, const common_protocol_frame_s* const frame, common_protocol_error_e* const error)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(frame != NULL);
+	common_debug_assert(error != NULL);
+
+	common_protocol_range_s range = {0};
+
+	if (!common_protocol_decode_range(frame->payload, frame->header.length, &range))
+	{
+		*error = common_protocol_error_invalid;
+		return false;
+	}
+
+	connection->range.media_id  = range.media_id;
+	connection->range.chunk     = 0;
+	connection->range.last      = UINT32_MAX;
+	connection->range.skip      = 0;
+	connection->range.remaining = UINT64_MAX;
+	connection->range.started   = false;
+
+	// note: a range that runs past what a 64 bit position can hold is open.
+	const bool_t open = (0 == range.length) || (range.length > (UINT64_MAX - range.start));
+
+	if (common_protocol_frame_time_range == frame->header.type)
+	{
+		// note: segments all last the configured duration, so a time range maps
+		// onto the segments it overlaps without looking any of them up.
+		const uint64_t duration = connection->config->segment_duration;
+		const uint64_t first = range.start / duration;
+		const uint64_t last  = open ? UINT32_MAX : ((range.start + range.length - 1) / duration);
+
+		if (first >= UINT32_MAX)
+		{
+			*error = common_protocol_error_out_of_range;
+			return false;
+		}
+
+		connection->range.chunk = (uint32_t)first;
+		connection->range.last  = (last < UINT32_MAX) ? (uint32_t)last : UINT32_MAX;
+	}
+	else
+	{
+		if (!server_media_locate(&connection->arena, connection->config->media_dir, range.media_id, range.start,
+			&connection->range.chunk, &connection->range.skip))
+		{
+			*error = common_protocol_error_out_of_range;
+			return false;
+		}
+
+		connection->range.remaining = open ? UINT64_MAX : range.length;
+	}
+
+	connection->range.active = true;
+	return true;
+}
+
+static _source_e _open_source(server_connection_s* const connection, const uint64_t media_id, const uint32_t chunk, _source_s* const source)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(source != NULL);
+
+	common_arena_s* const arena = &connection->arena;
+	const char_t* const root = connection->config->media_dir;
+	server_cache_s* const cache = connection->cache;
+
+	// note: a request that waited for its segment to be loaded is served
+	// again with the entry it waited for.
+	*source = (const _source_s)
+	{
+		.entry = connection->loading,
+		.fd    = -1,
+	};
+
+	connection->loading = NULL;
+
+	if ((NULL == source->entry) && (cache != NULL))
+	{
+		source->entry = server_cache_acquire(cache, media_id, chunk);
+		server_stats_add(connection->worker_stats, (source->entry != NULL) ? server_stats_cache_hits : server_stats_cache_misses, 1);
+	}
+
+	// note: the descriptor of a missed segment passes to the cache if the
+	// segment gets loaded into it, and the segment is served from its file
+	// otherwise.
+	if (NULL == source->entry)
+	{
+		if (!server_media_open_segment(arena, root, media_id, chunk, &source->fd, &source->size))
+		{
+			return _source_missing;
+		}
+
+		if (cache != NULL)
+		{
+			source->entry = server_cache_load(cache, media_id, chunk, source->fd, source->size);
+			source->fd = (source->entry != NULL) ? -1 : source->fd;
+		}
+	}
+
+	if ((source->entry != NULL) && (server_cache_state_loading == server_cache_state(source->entry)) &&
+		server_cache_wait(cache, source->entry, &connection->waiter))
+	{
+		connection->loading = source->entry;
+		connection->waiting = true;
+		++connection->stats.waited;
+		return _source_waiting;
+	}
+
+	// note: a segment that failed to load is served from its file, like one
+	// that was never admitted.
+	if ((source->entry != NULL) && (server_cache_state_failed == server_cache_state(source->entry)))
+	{
+		server_cache_release(source->entry);
+		source->entry = NULL;
+
+		if (!server_media_open_segment(arena, root, media_id, chunk, &source->fd, &source->size))
+		{
+			return _source_missing;
+		}
+	}
+
+	source->size = (source->entry != NULL) ? source->entry->size : source->size;
+	return _source_ready;
+}
+
+static bool_t _queue_source(server_connection_s* const connection, const _source_s* const source, const uint32_t stream_id, const uint64_t offset, const uint64_t length, const uint8_t flags)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(source != NULL);
+	common_debug_assert((offset + length) <= source->size);
+
+	const common_protocol_header_s header =
+	{
+		.type      = common_protocol_frame_segment,
+		.flags     = flags,
+		.stream_id = stream_id,
+		.length    = (uint32_t)length,
+	};
+
+	uint8_t encoded[common_protocol_header_size];
+	common_protocol_encode_header(encoded, &header);
+
+	if (source->entry != NULL)
+	{
+		if (!server_connection_queue_cached(connection, source->entry, offset, length, encoded, sizeof(encoded)))
+		{
+			server_cache_release(source->entry);
+			return false;
+		}
+
+		return true;
+	}
+
+	// note: on the zero-copy data path the header goes out as memory, corked
+	// ahead of the bare file range, so that the range can be handed to
+	// sendfile instead of being staged through the pipe behind the header. it
+	// stays attached to the range only if there is no room to split the two.
+	const bool_t split = (server_data_path_zero_copy == connection->config->data_path) && _has_room(connection, sizeof(encoded)) &&
+		((connection->segments_count + 2) <= server_connection_segments_capacity);
+
+	if (split)
+	{
+		(void)_append_output(connection, encoded, sizeof(encoded));
+		server_stats_add(connection->worker_stats, server_stats_frames_sent, 1);
+	}
+
+	if (!server_connection_queue_file(connection, source->fd, true, offset, length, split ? NULL : encoded, split ? 0 : sizeof(encoded)))
+	{
+		(void)close(source->fd);
+		return false;
+	}
+
+	return true;
+}
+
+static bool_t _queue_live(server_connection_s* const connection, server_cache_entry_s* const entry)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(entry != NULL);
+
+	// note: live segments never carry the end flag, as the subscription goes
+	// on for as long as the connection does.
+	const common_protocol_header_s header =
+	{
+		.type      = common_protocol_frame_segment,
+		.flags     = 0,
+		.stream_id = connection->subscription.stream_id,
+		.length    = (uint32_t)entry->size,
+	};
+
+	uint8_t encoded[common_protocol_header_size];
+	common_protocol_encode_header(encoded, &header);
+	return server_connection_queue_cached(connection, entry, 0, entry->size, encoded, sizeof(encoded));
+}
+
+static bool_t _append_error(server_connection_s* const connection, const uint32_t stream_id, const common_protocol_error_e error)
+{
+	common_debug_assert(connection != NULL);
+
+	uint8_t encoded[common_protocol_error_frame_size];
+	common_protocol_encode_error(encoded, stream_id, error);
+
+	if (_append_output(connection, encoded, sizeof(encoded)) != sizeof(encoded))
+	{
+		return false;
+	}
+
+	server_stats_add(connection->worker_stats, server_stats_frames_sent, 1);
+	server_stats_add(connection->worker_stats, server_stats_errors, 1);
+	return true;
+}
+
+static bool_t _append_ping(server_connection_s* const connection, const common_protocol_frame_e type)
+{
+	common_debug_assert(connection != NULL);
+
+	if (!_has_room(connection, common_protocol_ping_frame_size))
+	{
+		return false;
+	}
+
+	uint8_t encoded[common_protocol_ping_frame_size];
+	common_protocol_encode_ping(encoded, type);
+
+	if (_append_output(connection, encoded, sizeof(encoded)) != sizeof(encoded))
+	{
+		return false;
+	}
+
+	server_stats_add(connection->worker_stats, server_stats_frames_sent, 1);
+	return true;
+}
+
+static bool_t _has_room(const server_connection_s* const connection, const uint64_t size)
+{
+	common_debug_assert(connection != NULL);
+	// note: a frame that does not fit the output buffer any more goes into a
+	// fresh one.
+	return (connection->segments_count < server_connection_segments_capacity) && (size <= connection->pool->buffer_size);
+}
+
+static bool_t _ensure_pipe(server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	if (connection->pipe[0] >= 0)
+	{
+		return true;
+	}
+
+	if (pipe2(connection->pipe, O_NONBLOCK | O_CLOEXEC) < 0)
+	{
+		common_logger_warn("failed to create a splice pipe for connection %d: %s.", connection->fd, strerror(errno));
+		connection->pipe[0] = -1;
+		connection->pipe[1] = -1;
+		return false;
+	}
+
+	// note: a larger pipe moves more of the file per splice. the limit may be
+	// lowered by the system, so the actual capacity is queried back.
+	(void)fcntl(connection->pipe[1], F_SETPIPE_SZ, (int32_t)server_connection_pipe_size);
+	const int32_t capacity = fcntl(connection->pipe[1], F_GETPIPE_SZ);
+	connection->pipe_capacity = (capacity > 0) ? (uint64_t)capacity : 65536;
+	return true;
+}
+
+static bool_t _send_file(server_connection_s* const connection, server_connection_segment_s* const segment, bool_t* const progress, bool_t* const blocked)
+{
+	common_debug_assert(connection != NULL);
+	common_debug_assert(segment != NULL);
+	common_debug_assert(progress != NULL);
+	common_debug_assert(blocked != NULL);
+
+	off_t offset = (off_t)(segment->file.offset + segment->file.sent);
+	const ssize_t result = sendfile(connection->fd, segment->file.fd, &offset, segment->file.length - segment->file.sent);
+	++connection->stats.sends;
+	server_stats_add(connection->worker_stats, server_stats_sends, 1);
+
+	if (result > 0)
+	{
+		connection->stats.bytes_sendfile += (uint64_t)result;
+		server_stats_add(connection->worker_stats, server_stats_bytes_sendfile, (uint64_t)result);
+		server_connection_consume_output(connection, (uint64_t)result);
+		*progress = true;
+	}
+	else if (0 == result)
+	{
+		common_logger_warn("file segment for connection %d ended unexpectedly.", connection->fd);
+		return false;
+	}
+	else if (EINTR == errno)
+	{
+		*progress = true;
+	}
+	else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+	{
+		*blocked = true;
+	}
+	else
+	{
+		common_logger_debug("sendfile on connection %d failed: %s.", connection->fd, strerror(errno));
+		return false;
+	}
+
+	return true;
+}
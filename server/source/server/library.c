@@ -0,0 +1,313 @@
+
+/**
+ * @file library.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_storage
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/library.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+
+typedef struct
+{
+	common_scheduler_task_s task;
+	common_scheduler_s* scheduler;
+	const char_t* root;
+	FILE* checksums;
+	struct timespec start;
+
+	uint64_t pending;
+	uint64_t media;
+	uint64_t segments;
+	uint64_t bytes;
+	uint64_t unservable;
+} _scan_s;
+
+typedef struct
+{
+	common_scheduler_task_s task;
+	_scan_s* scan;
+	uint64_t media_id;
+} _scan_media_s;
+
+static void _scan_library(void* const argument);
+
+static void _scan_media(void* const argument);
+
+static bool_t _checksum_segment(_scan_s* const scan, const int32_t directory, const char_t* const name, const uint64_t media_id, uint8_t* const buffer);
+
+static bool_t _parse_id(const char_t* const name, const char_t* const suffix, uint64_t* const id);
+
+static void _finish(_scan_s* const scan);
+
+bool_t server_library_scan(common_scheduler_s* const scheduler, const char_t* const root, const char_t* const checksums)
+{
+	common_debug_assert(scheduler != NULL);
+	common_debug_assert(root != NULL);
+	common_debug_assert(checksums != NULL);
+
+	_scan_s* const scan = calloc(1, sizeof(*scan));
+
+	if (NULL == scan)
+	{
+		common_logger_warn("failed to allocate the media library scan.");
+		return false;
+	}
+
+	scan->checksums = fopen(checksums, "we");
+
+	if (NULL == scan->checksums)
+	{
+		common_logger_warn("failed to open the checksums file %s: %s.", checksums, strerror(errno));
+		free(scan);
+		return false;
+	}
+
+	scan->task      = (const common_scheduler_task_s) { .function = _scan_library, .argument = scan };
+	scan->scheduler = scheduler;
+	scan->root      = root;
+	scan->pending   = 1;
+	(void)clock_gettime(CLOCK_MONOTONIC, &scan->start);
+
+	if (!common_scheduler_submit(scheduler, &scan->task))
+	{
+		common_logger_warn("failed to submit the media library scan.");
+		(void)fclose(scan->checksums);
+		free(scan);
+		return false;
+	}
+
+	return true;
+}
+
+static void _scan_library(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+
+	_scan_s* const scan = argument;
+	DIR* const directory = opendir(scan->root);
+
+	if (NULL == directory)
+	{
+		common_logger_warn("failed to open the media directory %s: %s.", scan->root, strerror(errno));
+		_finish(scan);
+		return;
+	}
+
+	// note: every media gets a task of its own, which lands on the deque of
+	// this worker and gets stolen by the idle ones.
+	for (const struct dirent* entry = readdir(directory); entry != NULL; entry = readdir(directory))
+	{
+		uint64_t media_id = 0;
+
+		if (common_scheduler_is_stopping(scan->scheduler) || !_parse_id(entry->d_name, "", &media_id))
+		{
+			continue;
+		}
+
+		_scan_media_s* const media = malloc(sizeof(*media));
+
+		if (NULL == media)
+		{
+			common_logger_warn("failed to allocate the scan of media %lu.", media_id);
+			continue;
+		}
+
+		*media = (const _scan_media_s)
+		{
+			.task     = { .function = _scan_media, .argument = media },
+			.scan     = scan,
+			.media_id = media_id,
+		};
+
+		(void)__atomic_add_fetch(&scan->pending, 1, __ATOMIC_RELAXED);
+		(void)common_scheduler_submit(scan->scheduler, &media->task);
+	}
+
+	(void)closedir(directory);
+	_finish(scan);
+}
+
+static void _scan_media(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+
+	_scan_media_s* const media = argument;
+	_scan_s* const scan = media->scan;
+
+	char_t path[PATH_MAX];
+	(void)snprintf(path, sizeof(path), "%s/%lu", scan->root, media->media_id);
+
+	const int32_t fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	DIR* const directory = (fd >= 0) ? fdopendir(fd) : NULL;
+	uint8_t* const buffer = malloc(server_library_read_size);
+
+	if ((NULL == directory) || (NULL == buffer))
+	{
+		if (directory != NULL)
+		{
+			(void)closedir(directory);
+		}
+		else if (fd >= 0)
+		{
+			(void)close(fd);
+		}
+
+		common_logger_warn("failed to scan media %lu.", media->media_id);
+		goto scan_media_end;
+	}
+
+	uint64_t segments = 0;
+
+	for (const struct dirent* entry = readdir(directory); entry != NULL; entry = readdir(directory))
+	{
+		uint64_t chunk = 0;
+
+		if (common_scheduler_is_stopping(scan->scheduler))
+		{
+			break;
+		}
+
+		if (!_parse_id(entry->d_name, ".seg", &chunk))
+		{
+			continue;
+		}
+
+		if (_checksum_segment(scan, fd, entry->d_name, media->media_id, buffer))
+		{
+			++segments;
+		}
+		else
+		{
+			(void)__atomic_add_fetch(&scan->unservable, 1, __ATOMIC_RELAXED);
+		}
+	}
+
+	(void)closedir(directory);
+	(void)__atomic_add_fetch(&scan->media, 1, __ATOMIC_RELAXED);
+	(void)__atomic_add_fetch(&scan->segments, segments, __ATOMIC_RELAXED);
+
+scan_media_end:
+	free(buffer);
+	free(media);
+	_finish(scan);
+}
+
+static bool_t _checksum_segment(_scan_s* const scan, const int32_t directory, const char_t* const name, const uint64_t media_id, uint8_t* const buffer)
+{
+	common_debug_assert(scan != NULL);
+	common_debug_assert(name != NULL);
+	common_debug_assert(buffer != NULL);
+
+	const int32_t fd = openat(directory, name, O_RDONLY | O_CLOEXEC);
+	struct stat status = {0};
+
+	// note: the same checks as when the segment gets served.
+	if ((fd < 0) || (fstat(fd, &status) < 0) || !S_ISREG(status.st_mode) || ((uint64_t)status.st_size > UINT32_MAX))
+	{
+		common_logger_warn("segment %lu/%s is not a servable regular file.", media_id, name);
+
+		if (fd >= 0)
+		{
+			(void)close(fd);
+		}
+
+		return false;
+	}
+
+	// note: 64 bit fnv-1a, which needs no tables and is plenty to tell whether
+	// copies of a segment differ.
+	uint64_t checksum = 0xCBF29CE484222325ull;
+	uint64_t total = 0;
+	ssize_t result = 0;
+
+	while ((result = read(fd, buffer, server_library_read_size)) > 0)
+	{
+		for (ssize_t index = 0; index < result; ++index)
+		{
+			checksum = (checksum ^ buffer[index]) * 0x100000001B3ull;
+		}
+
+		total += (uint64_t)result;
+
+		if (common_scheduler_is_stopping(scan->scheduler))
+		{
+			break;
+		}
+	}
+
+	(void)close(fd);
+
+	if (result < 0)
+	{
+		common_logger_warn("failed to read segment %lu/%s: %s.", media_id, name, strerror(errno));
+		return false;
+	}
+
+	// note: stdio locks the stream around every call, so the lines written by
+	// the tasks of different media never interleave.
+	(void)__atomic_add_fetch(&scan->bytes, total, __ATOMIC_RELAXED);
+	(void)fprintf(scan->checksums, "%lu/%s %lu %016lx\n", media_id, name, total, checksum);
+	return true;
+}
+
+static bool_t _parse_id(const char_t* const name, const char_t* const suffix, uint64_t* const id)
+{
+	common_debug_assert(name != NULL);
+	common_debug_assert(suffix != NULL);
+	common_debug_assert(id != NULL);
+
+	if ((name[0] < '0') || (name[0] > '9'))
+	{
+		return false;
+	}
+
+	char_t* end = NULL;
+	errno = 0;
+	*id = (uint64_t)strtoull(name, &end, 10);
+	return (0 == errno) && (strcmp(end, suffix) == 0);
+}
+
+static void _finish(_scan_s* const scan)
+{
+	common_debug_assert(scan != NULL);
+
+	if (__atomic_sub_fetch(&scan->pending, 1, __ATOMIC_ACQ_REL) > 0)
+	{
+		return;
+	}
+
+	struct timespec end = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &end);
+	const double elapsed_ms = ((double)(end.tv_sec - scan->start.tv_sec) * 1e3) + ((double)(end.tv_nsec - scan->start.tv_nsec) / 1e6);
+
+	common_logger_note("media library scan%s: media=%lu, segments=%lu, bytes=%lu, unservable=%lu, elapsed=%.2fms.",
+		common_scheduler_is_stopping(scan->scheduler) ? " cut short" : "", scan->media, scan->segments, scan->bytes, scan->unservable, elapsed_ms);
+
+	if (fclose(scan->checksums) != 0)
+	{
+		common_logger_warn("failed to write the checksums file: %s.", strerror(errno));
+	}
+
+	free(scan);
+}
@@ -0,0 +1,425 @@
+
+/**
+ * @file live.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_storage
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/arena.h"
+
+#include "server/media.h"
+#include "server/live.h"
+
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <poll.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+static void* _live_main(void* const argument);
+
+static bool_t _drain_events(server_live_s* const live, common_arena_s* const arena);
+
+static void _publish(server_live_s* const live, common_arena_s* const arena, const uint32_t chunk);
+
+static bool_t _is_newer(const server_live_s* const live, const uint64_t chunk);
+
+static bool_t _parse_id(const char_t* const name, const char_t* const suffix, uint64_t* const id);
+
+bool_t server_live_create(server_live_s* const live, const char_t* const root, const uint64_t media_id, const uint64_t listeners_capacity)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(root != NULL);
+
+	*live = (const server_live_s)
+	{
+		.root               = root,
+		.media_id           = media_id,
+		.inotify_fd         = -1,
+		.wakeup_fd          = -1,
+		.listeners_capacity = listeners_capacity,
+	};
+
+	char_t path[PATH_MAX];
+	(void)snprintf(path, sizeof(path), "%s/%lu", root, media_id);
+
+	live->listeners = calloc((listeners_capacity > 0) ? listeners_capacity : 1, sizeof(*live->listeners));
+
+	if (NULL == live->listeners)
+	{
+		common_logger_error("failed to allocate the listeners of live media %lu.", media_id);
+		goto server_live_create_failed;
+	}
+
+	live->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (live->inotify_fd < 0)
+	{
+		common_logger_error("failed to create the inotify instance of live media %lu: %s.", media_id, strerror(errno));
+		goto server_live_create_failed;
+	}
+
+	if (inotify_add_watch(live->inotify_fd, path, IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR) < 0)
+	{
+		common_logger_error("failed to watch live media directory %s: %s.", path, strerror(errno));
+		goto server_live_create_failed;
+	}
+
+	live->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (live->wakeup_fd < 0)
+	{
+		common_logger_error("failed to create the wakeup eventfd of live media %lu: %s.", media_id, strerror(errno));
+		goto server_live_create_failed;
+	}
+
+	(void)pthread_mutex_init(&live->lock, NULL);
+	return true;
+
+server_live_create_failed:
+	if (live->wakeup_fd >= 0)
+	{
+		(void)close(live->wakeup_fd);
+	}
+
+	if (live->inotify_fd >= 0)
+	{
+		(void)close(live->inotify_fd);
+	}
+
+	free(live->listeners);
+	return false;
+}
+
+void server_live_destroy(server_live_s* const live)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(!live->started);
+
+	for (uint64_t index = 0; index < live->history_count; ++index)
+	{
+		server_cache_release(live->history[index]);
+	}
+
+	(void)pthread_mutex_destroy(&live->lock);
+	(void)close(live->wakeup_fd);
+	(void)close(live->inotify_fd);
+	free(live->listeners);
+}
+
+bool_t server_live_listen(server_live_s* const live, void (*function)(void* const argument), void* const argument)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(function != NULL);
+	common_debug_assert(!live->started);
+
+	if (live->listeners_count >= live->listeners_capacity)
+	{
+		common_logger_error("no room for another listener of live media %lu.", live->media_id);
+		return false;
+	}
+
+	live->listeners[live->listeners_count++] = (const server_live_listener_s) { .function = function, .argument = argument };
+	return true;
+}
+
+bool_t server_live_start(server_live_s* const live)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(!live->started);
+
+	char_t path[PATH_MAX];
+	(void)snprintf(path, sizeof(path), "%s/%lu", live->root, live->media_id);
+
+	// note: the directory is watched already, so a segment that is written
+	// while it is being listed is published either way.
+	DIR* const directory = opendir(path);
+	bool_t found = false;
+	uint64_t newest = 0;
+
+	if (directory != NULL)
+	{
+		for (const struct dirent* entry = readdir(directory); entry != NULL; entry = readdir(directory))
+		{
+			uint64_t chunk = 0;
+
+			if (_parse_id(entry->d_name, ".seg", &chunk) && (chunk <= UINT32_MAX) && (!found || (chunk > newest)))
+			{
+				found  = true;
+				newest = chunk;
+			}
+		}
+
+		(void)closedir(directory);
+	}
+
+	if (found)
+	{
+		common_arena_s arena = {0};
+		common_arena_create(&arena);
+		_publish(live, &arena, (uint32_t)newest);
+		common_arena_destroy(&arena);
+	}
+
+	const int32_t status = pthread_create(&live->thread, NULL, _live_main, live);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to spawn the thread of live media %lu: %s.", live->media_id, strerror(status));
+		return false;
+	}
+
+	(void)pthread_setname_np(live->thread, "mediantazy/live");
+	live->started = true;
+	common_logger_note("live media %lu started at chunk %lu.", live->media_id, found ? newest : 0);
+	return true;
+}
+
+void server_live_stop(server_live_s* const live)
+{
+	common_debug_assert(live != NULL);
+
+	if (!live->started)
+	{
+		return;
+	}
+
+	const uint64_t value = 1;
+	(void)!write(live->wakeup_fd, &value, sizeof(value));
+	(void)pthread_join(live->thread, NULL);
+	live->started = false;
+}
+
+uint64_t server_live_collect(server_live_s* const live, const uint64_t next, server_cache_entry_s** const entries, const uint64_t capacity)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(entries != NULL);
+
+	uint64_t count = 0;
+	(void)pthread_mutex_lock(&live->lock);
+
+	for (uint64_t index = 0; (index < live->history_count) && (count < capacity); ++index)
+	{
+		server_cache_entry_s* const entry = live->history[index];
+
+		if (entry->chunk >= next)
+		{
+			server_cache_retain(entry);
+			entries[count++] = entry;
+		}
+	}
+
+	(void)pthread_mutex_unlock(&live->lock);
+	return count;
+}
+
+server_cache_entry_s* server_live_edge(server_live_s* const live)
+{
+	common_debug_assert(live != NULL);
+
+	(void)pthread_mutex_lock(&live->lock);
+	server_cache_entry_s* const entry = (live->history_count > 0) ? live->history[live->history_count - 1] : NULL;
+
+	if (entry != NULL)
+	{
+		server_cache_retain(entry);
+	}
+
+	(void)pthread_mutex_unlock(&live->lock);
+	return entry;
+}
+
+uint64_t server_live_media_id(const server_live_s* const live)
+{
+	common_debug_assert(live != NULL);
+	return live->media_id;
+}
+
+void server_live_stats(server_live_s* const live, server_live_stats_s* const stats)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(stats != NULL);
+
+	(void)pthread_mutex_lock(&live->lock);
+	*stats = live->stats;
+	(void)pthread_mutex_unlock(&live->lock);
+}
+
+static void* _live_main(void* const argument)
+{
+	server_live_s* const live = (server_live_s*)argument;
+	common_debug_assert(live != NULL);
+
+	common_arena_s arena = {0};
+	common_arena_create(&arena);
+
+	struct pollfd fds[2] =
+	{
+		{ .fd = live->inotify_fd, .events = POLLIN },
+		{ .fd = live->wakeup_fd,  .events = POLLIN },
+	};
+
+	while (true)
+	{
+		if (poll(fds, 2, -1) < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			common_logger_error("failed to poll live media %lu: %s.", live->media_id, strerror(errno));
+			break;
+		}
+
+		if (fds[1].revents != 0)
+		{
+			break;
+		}
+
+		if ((fds[0].revents != 0) && !_drain_events(live, &arena))
+		{
+			break;
+		}
+	}
+
+	common_arena_destroy(&arena);
+	common_arena_release_cache();
+	return NULL;
+}
+
+static bool_t _drain_events(server_live_s* const live, common_arena_s* const arena)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(arena != NULL);
+
+	_Alignas(struct inotify_event) char_t events[server_live_events_size];
+
+	while (true)
+	{
+		const ssize_t result = read(live->inotify_fd, events, sizeof(events));
+
+		if (result < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+			{
+				return true;
+			}
+
+			common_logger_error("failed to read the events of live media %lu: %s.", live->media_id, strerror(errno));
+			return false;
+		}
+
+		for (uint64_t offset = 0; offset < (uint64_t)result;)
+		{
+			const struct inotify_event* const event = (const struct inotify_event*)(void*)(events + offset);
+			offset += sizeof(*event) + event->len;
+			uint64_t chunk = 0;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				common_logger_warn("events of live media %lu overflowed, segments may have been missed.", live->media_id);
+				continue;
+			}
+
+			// note: only segments newer than the live edge are published, so
+			// rewrites of old ones and late arrivals are left to plain requests.
+			if ((event->len > 0) && _parse_id(event->name, ".seg", &chunk) && (chunk <= UINT32_MAX) && _is_newer(live, chunk))
+			{
+				_publish(live, arena, (uint32_t)chunk);
+				common_arena_reset(arena);
+			}
+		}
+	}
+}
+
+static void _publish(server_live_s* const live, common_arena_s* const arena, const uint32_t chunk)
+{
+	common_debug_assert(live != NULL);
+	common_debug_assert(arena != NULL);
+
+	int32_t fd = -1;
+	uint64_t size = 0;
+	server_cache_entry_s* entry = NULL;
+
+	if (server_media_open_segment(arena, live->root, live->media_id, chunk, &fd, &size))
+	{
+		entry = server_cache_read(live->media_id, chunk, fd, size);
+		(void)close(fd);
+	}
+
+	(void)pthread_mutex_lock(&live->lock);
+
+	if (NULL == entry)
+	{
+		++live->stats.failed;
+		(void)pthread_mutex_unlock(&live->lock);
+		common_logger_warn("failed to publish live media %lu chunk %u.", live->media_id, chunk);
+		return;
+	}
+
+	if (server_live_history_capacity == live->history_count)
+	{
+		server_cache_release(live->history[0]);
+		(void)memmove(live->history, live->history + 1, (server_live_history_capacity - 1) * sizeof(*live->history));
+		--live->history_count;
+	}
+
+	live->history[live->history_count++] = entry;
+	++live->stats.published;
+	live->stats.bytes += size;
+	(void)pthread_mutex_unlock(&live->lock);
+
+	common_logger_debug("published live media %lu chunk %u, size=%lu.", live->media_id, chunk, size);
+
+	for (uint64_t index = 0; index < live->listeners_count; ++index)
+	{
+		live->listeners[index].function(live->listeners[index].argument);
+	}
+}
+
+static bool_t _is_newer(const server_live_s* const live, const uint64_t chunk)
+{
+	common_debug_assert(live != NULL);
+
+	// note: the history is only ever changed on the thread of the channel,
+	// which is the one asking here, so it is read without the lock.
+	return (0 == live->history_count) || (chunk > live->history[live->history_count - 1]->chunk);
+}
+
+static bool_t _parse_id(const char_t* const name, const char_t* const suffix, uint64_t* const id)
+{
+	common_debug_assert(name != NULL);
+	common_debug_assert(suffix != NULL);
+	common_debug_assert(id != NULL);
+
+	if ((name[0] < '0') || (name[0] > '9'))
+	{
+		return false;
+	}
+
+	char_t* end = NULL;
+	errno = 0;
+	*id = (uint64_t)strtoull(name, &end, 10);
+	return (0 == errno) && (strcmp(end, suffix) == 0);
+}
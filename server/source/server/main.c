@@ -10,18 +10,291 @@
  * @date 2024-07-25
  */
 
+#include "common/debug.h"
 #include "common/logger.h"
+#include "common/scheduler.h"
+#include "common/histogram.h"
+#include "common/arena.h"
 
 #include "server/main.h"
 #include "server/config.h"
+#include "server/library.h"
+#include "server/worker.h"
+#include "server/cache.h"
+#include "server/live.h"
+#include "server/stats.h"
 
-#include <stdio.h>
+#include <signal.h>
+#include <stdlib.h>
+
+#define _compute_queue_capacity ((uint64_t)4096)
+
+static bool_t _block_signals(sigset_t* const stop_signals);
+
+static void _log_latency(const char_t* const name, const char_t* const unit, const common_histogram_s* const histogram);
 
 int32_t main(int32_t argc, const char_t** argv)
 {
 	server_config_s config = server_config_from_cli(&argc, &argv);
-	common_logger_info("config=[address=%s, port=%u, backlog=%u]", config.address, config.port, config.backlog);
+	common_logger_set_level(config.log_level);
+	common_logger_note("config=[address=%s, port=%u, backlog=%u, workers=%u, media_dir=%s, io_buffers=%u, compute_threads=%u, idle_timeout=%u, write_timeout=%u, keepalive=%u, high_watermark=%lu, low_watermark=%lu, notsent_lowat=%u, cache_size=%lu, segment_duration=%u]", config.address, config.port, config.backlog, config.workers, config.media_dir, config.io_buffers, config.compute_threads, config.idle_timeout, config.write_timeout, config.keepalive, config.high_watermark, config.low_watermark, config.notsent_lowat, config.cache_size, config.segment_duration);
+
+	// note: the stop signals are blocked before any worker is spawned, so the
+	// workers inherit the mask and only the main thread ever receives them.
+	sigset_t stop_signals;
+
+	if (!_block_signals(&stop_signals))
+	{
+		return 1;
+	}
+
+	// note: from here on the event loops never block on writing out the logs,
+	// which are handed to a background thread instead. with a binary log, they
+	// do not even format them.
+	if (config.binary_log != NULL)
+	{
+		common_logger_note("recording messages to the binary log %s.", config.binary_log);
+
+		if (!common_logger_start_binary(config.binary_log))
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		(void)common_logger_start();
+	}
+
+	server_worker_s* const workers = calloc(config.workers, sizeof(*workers));
+
+	if (NULL == workers)
+	{
+		common_logger_error("failed to allocate %u workers.", config.workers);
+		common_logger_stop();
+		return 1;
+	}
+
+	// note: cpu-heavy tasks run on a scheduler of their own, so that they never
+	// hold up the event loops of the workers.
+	common_scheduler_s compute = {0};
+	uint64_t created = 0;
+	uint64_t started = 0;
+	bool_t status = true;
+
+	if ((config.compute_threads > 0) && !common_scheduler_create(&compute, config.compute_threads, _compute_queue_capacity))
+	{
+		free(workers);
+		common_logger_stop();
+		return 1;
+	}
+
+	// note: the segment cache is shared by all workers, so that a popular
+	// segment is held in memory once however many workers serve it, and it is
+	// loaded on the compute scheduler, so that reading a cold segment in never
+	// holds up a worker either. on the copy data path it also coalesces the
+	// loads of segments it does not hold, which the zero-copy one leaves to
+	// the page cache, so there it is only needed when it holds segments.
+	const bool_t coalesce = server_data_path_copy == config.data_path;
+	server_cache_s cache = {0};
+	server_cache_s* const shared_cache = ((config.compute_threads > 0) && ((config.cache_size > 0) || coalesce)) ? &cache : NULL;
+
+	if ((config.cache_size > 0) && (0 == config.compute_threads))
+	{
+		common_logger_warn("the segment cache is loaded on the compute threads, so it is disabled without them.");
+	}
+
+	if ((shared_cache != NULL) && !server_cache_create(shared_cache, config.cache_size, &compute, coalesce))
+	{
+		common_scheduler_destroy(&compute);
+		free(workers);
+		common_logger_stop();
+		return 1;
+	}
+
+	if ((shared_cache != NULL) && (config.cache_size > 0) && (server_data_path_zero_copy == config.data_path))
+	{
+		common_logger_note("cached segments are copied out of memory, only the rest are transmitted from the page cache.");
+	}
+
+	// note: a live segment is read in once by the thread of the channel, and
+	// every worker queues that same buffer to each of its subscribers.
+	server_live_s live = {0};
+	server_live_s* const shared_live = config.live ? &live : NULL;
+
+	if (shared_live != NULL)
+	{
+		common_logger_note("serving media %lu live.", config.live_media);
+
+		if (!server_live_create(shared_live, config.media_dir, config.live_media, config.workers))
+		{
+			if (shared_cache != NULL)
+			{
+				server_cache_destroy(shared_cache);
+			}
+
+			common_scheduler_destroy(&compute);
+			free(workers);
+			common_logger_stop();
+			return 1;
+		}
+	}
+
+	// note: every worker records its statistics in a slot of its own, which
+	// the stats endpoint reads without ever holding the worker up.
+	server_stats_s statistics = {0};
+
+	if (!server_stats_create(&statistics, &config, config.workers, shared_cache, (config.compute_threads > 0) ? &compute : NULL))
+	{
+		if (shared_live != NULL)
+		{
+			server_live_destroy(shared_live);
+		}
+
+		if (shared_cache != NULL)
+		{
+			server_cache_destroy(shared_cache);
+		}
+
+		common_scheduler_destroy(&compute);
+		free(workers);
+		common_logger_stop();
+		return 1;
+	}
+
+	for (; created < config.workers; ++created)
+	{
+		if (!server_worker_create(&workers[created], &config, shared_cache, shared_live, created, server_stats_worker(&statistics, created)))
+		{
+			status = false;
+			goto main_cleanup;
+		}
+	}
+
+	for (; started < created; ++started)
+	{
+		if (!server_worker_start(&workers[started]))
+		{
+			status = false;
+			goto main_cleanup;
+		}
+	}
+
+	common_logger_note("listening on %s:%u with %u workers over %s.", config.address, config.port, config.workers,
+		server_backend_name(&workers[0].reactor.backend));
+
+	if ((shared_live != NULL) && !server_live_start(shared_live))
+	{
+		status = false;
+		goto main_cleanup;
+	}
+
+	if (!server_stats_start(&statistics))
+	{
+		status = false;
+		goto main_cleanup;
+	}
+
+	if (config.checksums != NULL)
+	{
+		(void)server_library_scan(&compute, config.media_dir, config.checksums);
+	}
+
+	int32_t signal = 0;
+	(void)sigwait(&stop_signals, &signal);
+	common_logger_note("shutting down.");
+
+main_cleanup:
+	server_stats_stop(&statistics);
+
+	if (shared_live != NULL)
+	{
+		server_live_stop(shared_live);
+	}
+
+	for (uint64_t index = 0; index < started; ++index)
+	{
+		server_worker_stop(&workers[index]);
+	}
+
+	for (uint64_t index = 0; index < started; ++index)
+	{
+		status = server_worker_join(&workers[index]) && status;
+	}
+
+	// note: loads still in flight notify the workers that wait for them, so
+	// the scheduler is drained before the workers are destroyed.
+	common_scheduler_destroy(&compute);
+
+	for (uint64_t index = 0; index < created; ++index)
+	{
+		server_worker_destroy(&workers[index]);
+	}
+
+	free(workers);
+
+	// note: the percentiles tell what the averages hide, the requests and the
+	// iterations that ran the longest.
+	server_stats_worker_s total;
+	server_stats_collect(&statistics, &total);
+	server_stats_destroy(&statistics);
+
+	_log_latency("service", "requests", &total.service);
+	_log_latency("loop", "iterations", &total.loop);
+
+	if (shared_live != NULL)
+	{
+		server_live_stats_s stats = {0};
+		server_live_stats(shared_live, &stats);
+		common_logger_note("live: published=%lu, failed=%lu, bytes=%lu.", stats.published, stats.failed, stats.bytes);
+		server_live_destroy(shared_live);
+	}
+
+	if (shared_cache != NULL)
+	{
+		server_cache_stats_s stats = {0};
+		server_cache_stats(shared_cache, &stats);
+		common_logger_note("cache: hits=%lu, misses=%lu, admitted=%lu, rejected=%lu, evicted=%lu, loads=%lu, coalesced=%lu, failed=%lu, entries=%lu, size=%lu.",
+			stats.hits, stats.misses, stats.admitted, stats.rejected, stats.evicted, stats.loads, stats.coalesced, stats.failed, stats.entries, stats.size);
+		server_cache_destroy(shared_cache);
+	}
+
+	common_arena_release_cache();
+	common_logger_stop();
+	return status ? 0 : 1;
+}
+
+static bool_t _block_signals(sigset_t* const stop_signals)
+{
+	struct sigaction action = {0};
+	(void)sigemptyset(&action.sa_mask);
+	action.sa_handler = SIG_IGN;
+
+	if (sigaction(SIGPIPE, &action, NULL) < 0)
+	{
+		common_logger_error("failed to ignore the SIGPIPE signal.");
+		return false;
+	}
+
+	(void)sigemptyset(stop_signals);
+	(void)sigaddset(stop_signals, SIGINT);
+	(void)sigaddset(stop_signals, SIGTERM);
+
+	if (pthread_sigmask(SIG_BLOCK, stop_signals, NULL) != 0)
+	{
+		common_logger_error("failed to block the stop signals.");
+		return false;
+	}
+
+	return true;
+}
+
+static void _log_latency(const char_t* const name, const char_t* const unit, const common_histogram_s* const histogram)
+{
+	common_debug_assert(name != NULL);
+	common_debug_assert(unit != NULL);
+	common_debug_assert(histogram != NULL);
 
-	(void)printf("hello, from server!\n");
-	return 0;
+	common_logger_note("%s: %s=%lu, mean=%.1fus, p50=%.1fus, p90=%.1fus, p99=%.1fus, p99.9=%.1fus, max=%.1fus.", name, unit, histogram->count,
+		common_histogram_mean(histogram) / 1e3, (double)common_histogram_percentile(histogram, 50) / 1e3, (double)common_histogram_percentile(histogram, 90) / 1e3,
+		(double)common_histogram_percentile(histogram, 99) / 1e3, (double)common_histogram_percentile(histogram, 99.9) / 1e3, (double)histogram->max / 1e3);
 }
@@ -0,0 +1,146 @@
+
+/**
+ * @file media.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_storage
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/media.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+static char_t* _segment_path(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint32_t chunk);
+
+static bool_t _is_servable(const struct stat* const status);
+
+bool_t server_media_open_segment(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint32_t chunk, int32_t* const fd, uint64_t* const size)
+{
+	common_debug_assert(arena != NULL);
+	common_debug_assert(root != NULL);
+	common_debug_assert(fd != NULL);
+	common_debug_assert(size != NULL);
+
+	const char_t* const path = _segment_path(arena, root, media_id, chunk);
+
+	if (NULL == path)
+	{
+		return false;
+	}
+
+	*fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (*fd < 0)
+	{
+		if (errno != ENOENT)
+		{
+			common_logger_warn("failed to open segment %s: %s.", path, strerror(errno));
+		}
+
+		return false;
+	}
+
+	struct stat status = {0};
+
+	if ((fstat(*fd, &status) < 0) || !_is_servable(&status))
+	{
+		common_logger_warn("segment %s is not a servable regular file.", path);
+		(void)close(*fd);
+		*fd = -1;
+		return false;
+	}
+
+	*size = (uint64_t)status.st_size;
+	return true;
+}
+
+bool_t server_media_stat_segment(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint32_t chunk, uint64_t* const size)
+{
+	common_debug_assert(arena != NULL);
+	common_debug_assert(root != NULL);
+	common_debug_assert(size != NULL);
+
+	const char_t* const path = _segment_path(arena, root, media_id, chunk);
+	struct stat status = {0};
+
+	if ((NULL == path) || (stat(path, &status) < 0) || !_is_servable(&status))
+	{
+		return false;
+	}
+
+	*size = (uint64_t)status.st_size;
+	return true;
+}
+
+bool_t server_media_locate(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint64_t offset, uint32_t* const chunk, uint64_t* const skip)
+{
+	common_debug_assert(arena != NULL);
+	common_debug_assert(root != NULL);
+	common_debug_assert(chunk != NULL);
+	common_debug_assert(skip != NULL);
+
+	uint64_t remaining = offset;
+
+	for (uint32_t index = 0; index < UINT32_MAX; ++index)
+	{
+		uint64_t size = 0;
+
+		if (!server_media_stat_segment(arena, root, media_id, index, &size))
+		{
+			return false;
+		}
+
+		if (remaining < size)
+		{
+			*chunk = index;
+			*skip  = remaining;
+			return true;
+		}
+
+		remaining -= size;
+	}
+
+	return false;
+}
+
+static char_t* _segment_path(common_arena_s* const arena, const char_t* const root, const uint64_t media_id, const uint32_t chunk)
+{
+	common_debug_assert(arena != NULL);
+	common_debug_assert(root != NULL);
+
+	const int32_t length = snprintf(NULL, 0, "%s/%lu/%u.seg", root, media_id, chunk);
+	char_t* const path = (length > 0) ? common_arena_alloc(arena, (uint64_t)length + 1) : NULL;
+
+	if (NULL == path)
+	{
+		common_logger_warn("failed to build the segment path for media %lu chunk %u.", media_id, chunk);
+		return NULL;
+	}
+
+	(void)snprintf(path, (uint64_t)length + 1, "%s/%lu/%u.seg", root, media_id, chunk);
+	return path;
+}
+
+static bool_t _is_servable(const struct stat* const status)
+{
+	common_debug_assert(status != NULL);
+
+	// note: a frame carries at most a 32 bit payload length, so larger files
+	// can not be served as a single segment.
+	return S_ISREG(status->st_mode) && ((uint64_t)status->st_size <= UINT32_MAX);
+}
@@ -0,0 +1,674 @@
+
+/**
+ * @file reactor.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+
+#include "server/reactor.h"
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <netdb.h>
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+static int32_t _open_listener(const server_config_s* const config);
+
+static server_connection_s* _timer_connection(common_timer_s* const timer, const uint64_t offset);
+
+static bool_t _is_live(const server_connection_s* const connection);
+
+static void _expire_idle(common_timer_s* const timer, void* const argument);
+
+static void _expire_write(common_timer_s* const timer, void* const argument);
+
+static void _expire_keepalive(common_timer_s* const timer, void* const argument);
+
+static void _loaded(server_cache_waiter_s* const waiter, void* const argument);
+
+static void _published(void* const argument);
+
+static void _deliver_live(server_reactor_s* const reactor);
+
+static void _notify(server_reactor_s* const reactor);
+
+static void _reclaim(server_reactor_s* const reactor);
+
+static void _free_list(server_connection_s* connection);
+
+bool_t server_reactor_create(server_reactor_s* const reactor, const server_config_s* const config, server_cache_s* const cache, server_live_s* const live, server_stats_worker_s* const worker_stats)
+{
+	common_debug_assert(reactor != NULL);
+	common_debug_assert(config != NULL);
+	common_debug_assert(worker_stats != NULL);
+
+	*reactor = (const server_reactor_s)
+	{
+		.listen_fd    = -1,
+		.wakeup_fd    = -1,
+		.config       = config,
+		.cache        = cache,
+		.live         = live,
+		.worker_stats = worker_stats,
+	};
+
+	(void)pthread_mutex_init(&reactor->loaded_lock, NULL);
+
+	reactor->now_ms = common_timer_now_ms();
+	common_timer_wheel_create(&reactor->timers, reactor->now_ms, server_reactor_timer_resolution);
+
+	reactor->listen_fd = _open_listener(config);
+
+	if (reactor->listen_fd < 0)
+	{
+		goto server_reactor_create_failed;
+	}
+
+	reactor->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (reactor->wakeup_fd < 0)
+	{
+		common_logger_error("failed to create the wakeup eventfd: %s.", strerror(errno));
+		goto server_reactor_create_failed;
+	}
+
+	if (!common_pool_create(&reactor->pool, config->io_buffers, server_connection_buffer_size))
+	{
+		goto server_reactor_create_failed;
+	}
+
+	if (!server_backend_create(&reactor->backend, reactor, config->io_backend))
+	{
+		common_pool_destroy(&reactor->pool);
+		goto server_reactor_create_failed;
+	}
+
+	if ((live != NULL) && !server_live_listen(live, _published, reactor))
+	{
+		server_backend_destroy(&reactor->backend);
+		common_pool_destroy(&reactor->pool);
+		goto server_reactor_create_failed;
+	}
+
+	return true;
+
+server_reactor_create_failed:
+	if (reactor->wakeup_fd >= 0) { (void)close(reactor->wakeup_fd); reactor->wakeup_fd = -1; }
+	if (reactor->listen_fd >= 0) { (void)close(reactor->listen_fd); reactor->listen_fd = -1; }
+	(void)pthread_mutex_destroy(&reactor->loaded_lock);
+	return false;
+}
+
+void server_reactor_destroy(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+
+	// note: the backend goes first, so that no operation is in flight on the
+	// connections when their sockets get closed.
+	server_backend_destroy(&reactor->backend);
+
+	// note: the timers are linked through the connections, so they are dropped
+	// before any connection is freed.
+	common_timer_wheel_destroy(&reactor->timers);
+
+	for (uint64_t index = 0; index < reactor->connections_capacity; ++index)
+	{
+		server_connection_s* const connection = reactor->connections[index];
+
+		if (connection != NULL)
+		{
+			server_connection_close(connection);
+			free(connection);
+		}
+	}
+
+	_free_list(reactor->closed);
+	_free_list(reactor->spare);
+
+	free(reactor->connections);
+	reactor->connections          = NULL;
+	reactor->connections_capacity = 0;
+	reactor->connections_count    = 0;
+	reactor->closed               = NULL;
+	reactor->spare                = NULL;
+	reactor->spare_count          = 0;
+
+	common_pool_destroy(&reactor->pool);
+
+	if (reactor->wakeup_fd >= 0) { (void)close(reactor->wakeup_fd); reactor->wakeup_fd = -1; }
+	if (reactor->listen_fd >= 0) { (void)close(reactor->listen_fd); reactor->listen_fd = -1; }
+
+	reactor->loaded = NULL;
+	(void)pthread_mutex_destroy(&reactor->loaded_lock);
+}
+
+bool_t server_reactor_run(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+
+	common_pool_adopt(&reactor->pool);
+
+	if (!server_backend_start(&reactor->backend))
+	{
+		return false;
+	}
+
+	reactor->running = true;
+
+	while (reactor->running)
+	{
+		reactor->dispatched_ns = 0;
+
+		if (!server_backend_wait(&reactor->backend, common_timer_wheel_timeout(&reactor->timers, reactor->now_ms)))
+		{
+			return false;
+		}
+
+		reactor->now_ms = common_timer_now_ms();
+		(void)common_timer_wheel_advance(&reactor->timers, reactor->now_ms);
+		_reclaim(reactor);
+
+		if (reactor->dispatched_ns > 0)
+		{
+			common_histogram_record(&reactor->worker_stats->loop, common_timer_now_ns() - reactor->dispatched_ns);
+		}
+	}
+
+	return true;
+}
+
+void server_reactor_stop(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+
+	__atomic_store_n(&reactor->stopping, true, __ATOMIC_RELEASE);
+	_notify(reactor);
+}
+
+void server_reactor_wakeup(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+
+	if (__atomic_load_n(&reactor->stopping, __ATOMIC_ACQUIRE))
+	{
+		reactor->running = false;
+	}
+
+	// note: the waiters are taken one at a time, since resuming a connection
+	// may close another one that is still linked into the list.
+	while (true)
+	{
+		(void)pthread_mutex_lock(&reactor->loaded_lock);
+		server_cache_waiter_s* const waiter = reactor->loaded;
+
+		if (waiter != NULL)
+		{
+			reactor->loaded = waiter->next;
+			waiter->next = NULL;
+		}
+
+		(void)pthread_mutex_unlock(&reactor->loaded_lock);
+
+		if (NULL == waiter)
+		{
+			break;
+		}
+
+		server_connection_s* const connection = (server_connection_s*)(void*)((uint8_t*)waiter - offsetof(server_connection_s, waiter));
+		server_connection_resume(connection);
+		server_backend_resume(&reactor->backend, connection);
+	}
+
+	if (reactor->live != NULL)
+	{
+		_deliver_live(reactor);
+	}
+}
+
+void server_reactor_dispatch(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+	reactor->dispatched_ns = common_timer_now_ns();
+}
+
+server_connection_s* server_reactor_open_connection(server_reactor_s* const reactor, const int32_t fd)
+{
+	common_debug_assert(reactor != NULL);
+	common_debug_assert(fd >= 0);
+
+	// note: the connection table is indexed by the descriptor. the kernel hands
+	// out the lowest free descriptor, so the table stays as small as the peak
+	// number of connections.
+	if ((uint64_t)fd >= reactor->connections_capacity)
+	{
+		uint64_t capacity = (reactor->connections_capacity > 0) ? reactor->connections_capacity : 64;
+
+		while ((uint64_t)fd >= capacity)
+		{
+			capacity *= 2;
+		}
+
+		server_connection_s** const connections = realloc(reactor->connections, capacity * sizeof(*connections));
+
+		if (NULL == connections)
+		{
+			common_logger_warn("failed to grow the connection table for descriptor %d.", fd);
+			(void)close(fd);
+			return NULL;
+		}
+
+		(void)memset(connections + reactor->connections_capacity, 0,
+			(capacity - reactor->connections_capacity) * sizeof(*connections));
+
+		reactor->connections          = connections;
+		reactor->connections_capacity = capacity;
+	}
+
+	common_debug_assert(NULL == reactor->connections[fd]);
+	server_connection_s* connection = reactor->spare;
+
+	if (connection != NULL)
+	{
+		reactor->spare = connection->next;
+		--reactor->spare_count;
+	}
+	else if (NULL == (connection = malloc(sizeof(*connection))))
+	{
+		common_logger_warn("failed to allocate a connection for descriptor %d.", fd);
+		(void)close(fd);
+		return NULL;
+	}
+
+	connection->state = server_connection_state_closed;
+	connection->next  = NULL;
+	reactor->connections[fd] = connection;
+
+	const int32_t enable = 1;
+	(void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+	// note: with a low not-sent mark the socket only reports writability once
+	// most of what it holds is on the wire, so that queued file data is moved
+	// into it in large batches rather than in many small sends.
+	if (reactor->config->notsent_lowat > 0)
+	{
+		const int32_t notsent_lowat = (int32_t)reactor->config->notsent_lowat;
+		(void)setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &notsent_lowat, sizeof(notsent_lowat));
+	}
+
+	server_connection_open(connection, fd, reactor->config, &reactor->pool, reactor->cache, reactor->live, reactor->worker_stats);
+	server_cache_waiter_init(&connection->waiter, _loaded, reactor);
+	++reactor->connections_count;
+
+	server_stats_add(reactor->worker_stats, server_stats_connections_accepted, 1);
+	server_stats_set(reactor->worker_stats, server_stats_connections_open, reactor->connections_count);
+
+	common_timer_init(&connection->timers.idle, _expire_idle, reactor);
+	common_timer_init(&connection->timers.write, _expire_write, reactor);
+	common_timer_init(&connection->timers.keepalive, _expire_keepalive, reactor);
+
+	// note: the clock of the reactor is only read after every wait, and may
+	// be far behind after a long one, so it is brought up to date here.
+	const server_config_s* const config = reactor->config;
+	reactor->now_ms = common_timer_now_ms();
+
+	if (config->idle_timeout > 0)
+	{
+		common_timer_wheel_schedule(&reactor->timers, &connection->timers.idle, reactor->now_ms + config->idle_timeout);
+	}
+
+	if (config->write_timeout > 0)
+	{
+		common_timer_wheel_schedule(&reactor->timers, &connection->timers.write, reactor->now_ms + config->write_timeout);
+	}
+
+	if (config->keepalive > 0)
+	{
+		common_timer_wheel_schedule(&reactor->timers, &connection->timers.keepalive, reactor->now_ms + config->keepalive);
+	}
+
+	return connection;
+}
+
+void server_reactor_close_connection(server_reactor_s* const reactor, server_connection_s* const connection)
+{
+	common_debug_assert(reactor != NULL);
+	common_debug_assert(connection != NULL);
+	common_debug_assert(reactor->connections_count > 0);
+
+	const server_connection_stats_s* const stats = &connection->stats;
+	common_logger_debug("connection %d closed: received=%lu, written=%lu, sendfile=%lu, spliced=%lu, copied=%lu, cached=%lu, sends=%lu, bytes_per_send=%lu, throttled=%lu, waited=%lu, skipped=%lu.",
+		connection->fd, stats->bytes_received, stats->bytes_written, stats->bytes_sendfile, stats->bytes_spliced, stats->bytes_copied, stats->bytes_cached, stats->sends,
+		(stats->sends > 0) ? (stats->bytes_transmitted / stats->sends) : 0, stats->throttled, stats->waited, stats->skipped);
+
+	common_timer_wheel_cancel(&reactor->timers, &connection->timers.idle);
+	common_timer_wheel_cancel(&reactor->timers, &connection->timers.write);
+	common_timer_wheel_cancel(&reactor->timers, &connection->timers.keepalive);
+
+	// note: the waiter of a connection that waits for a segment is either
+	// still attached to the entry, or already handed over to the reactor.
+	if (server_connection_is_waiting(connection) &&
+		!server_cache_cancel(reactor->cache, connection->loading, &connection->waiter))
+	{
+		(void)pthread_mutex_lock(&reactor->loaded_lock);
+		server_cache_waiter_s** link = &reactor->loaded;
+
+		while ((*link != NULL) && (*link != &connection->waiter))
+		{
+			link = &(*link)->next;
+		}
+
+		if (*link != NULL)
+		{
+			*link = connection->waiter.next;
+		}
+
+		(void)pthread_mutex_unlock(&reactor->loaded_lock);
+	}
+
+	server_stats_add(reactor->worker_stats, server_stats_connections_closed, 1);
+
+	if (server_connection_has_failed(connection))
+	{
+		server_stats_add(reactor->worker_stats, server_stats_connections_failed, 1);
+	}
+
+	const int32_t fd = connection->fd;
+	server_connection_close(connection);
+	--reactor->connections_count;
+	server_stats_set(reactor->worker_stats, server_stats_connections_open, reactor->connections_count);
+
+	reactor->connections[fd] = NULL;
+	connection->next = reactor->closed;
+	reactor->closed  = connection;
+}
+
+static int32_t _open_listener(const server_config_s* const config)
+{
+	common_debug_assert(config != NULL);
+	common_debug_assert(config->address != NULL);
+
+	char_t port[8] = {0};
+	(void)snprintf(port, sizeof(port), "%u", config->port);
+
+	const struct addrinfo hints =
+	{
+		.ai_family   = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+		.ai_flags    = AI_PASSIVE | AI_NUMERICHOST | AI_NUMERICSERV,
+	};
+
+	struct addrinfo* address = NULL;
+	const int32_t status = getaddrinfo(config->address, port, &hints, &address);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to resolve address %s:%s: %s.", config->address, port, gai_strerror(status));
+		return -1;
+	}
+
+	const int32_t fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+
+	if (fd < 0)
+	{
+		common_logger_error("failed to create the listening socket: %s.", strerror(errno));
+		freeaddrinfo(address);
+		return -1;
+	}
+
+	// note: every worker binds its own listening socket to the same address.
+	// with SO_REUSEPORT the kernel load-balances incoming connections between
+	// them, so there is no shared accept queue or lock between the workers.
+	const int32_t enable = 1;
+	(void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0)
+	{
+		common_logger_error("failed to enable SO_REUSEPORT on the listening socket: %s.", strerror(errno));
+		freeaddrinfo(address);
+		(void)close(fd);
+		return -1;
+	}
+
+	if (bind(fd, address->ai_addr, address->ai_addrlen) < 0)
+	{
+		common_logger_error("failed to bind to %s:%s: %s.", config->address, port, strerror(errno));
+		freeaddrinfo(address);
+		(void)close(fd);
+		return -1;
+	}
+
+	freeaddrinfo(address);
+
+	if (listen(fd, config->backlog) < 0)
+	{
+		common_logger_error("failed to listen on %s:%s: %s.", config->address, port, strerror(errno));
+		(void)close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static server_connection_s* _timer_connection(common_timer_s* const timer, const uint64_t offset)
+{
+	common_debug_assert(timer != NULL);
+	return (server_connection_s*)(void*)((uint8_t*)timer - offset);
+}
+
+static bool_t _is_live(const server_connection_s* const connection)
+{
+	common_debug_assert(connection != NULL);
+
+	// note: a connection that is being released may still wait for in-flight
+	// operations, and its timers have nothing left to do.
+	return (server_connection_state_open == connection->state) || (server_connection_state_draining == connection->state);
+}
+
+static void _expire_idle(common_timer_s* const timer, void* const argument)
+{
+	common_debug_assert(timer != NULL);
+	common_debug_assert(argument != NULL);
+
+	server_reactor_s* const reactor = argument;
+	server_connection_s* const connection = _timer_connection(timer, offsetof(server_connection_s, timers.idle));
+
+	if (!_is_live(connection))
+	{
+		return;
+	}
+
+	const uint64_t mark = connection->stats.bytes_received;
+
+	// note: a subscriber has nothing to send, and is owed the next segment.
+	if ((mark == connection->timers.idle_mark) && !server_connection_has_output(connection) && !server_connection_is_subscribed(connection))
+	{
+		common_logger_debug("connection %d was idle for %u ms, closing it.", connection->fd, reactor->config->idle_timeout);
+		server_stats_add(reactor->worker_stats, server_stats_connections_expired, 1);
+		server_backend_release(&reactor->backend, connection);
+		return;
+	}
+
+	connection->timers.idle_mark = mark;
+	common_timer_wheel_schedule(&reactor->timers, timer, reactor->now_ms + reactor->config->idle_timeout);
+}
+
+static void _expire_write(common_timer_s* const timer, void* const argument)
+{
+	common_debug_assert(timer != NULL);
+	common_debug_assert(argument != NULL);
+
+	server_reactor_s* const reactor = argument;
+	server_connection_s* const connection = _timer_connection(timer, offsetof(server_connection_s, timers.write));
+
+	if (!_is_live(connection))
+	{
+		return;
+	}
+
+	const uint64_t mark = connection->stats.bytes_transmitted;
+
+	if ((mark == connection->timers.write_mark) && server_connection_has_output(connection))
+	{
+		common_logger_debug("connection %d took no output for %u ms, closing it as too slow.", connection->fd, reactor->config->write_timeout);
+		server_stats_add(reactor->worker_stats, server_stats_connections_expired, 1);
+		server_backend_release(&reactor->backend, connection);
+		return;
+	}
+
+	connection->timers.write_mark = mark;
+	common_timer_wheel_schedule(&reactor->timers, timer, reactor->now_ms + reactor->config->write_timeout);
+}
+
+static void _expire_keepalive(common_timer_s* const timer, void* const argument)
+{
+	common_debug_assert(timer != NULL);
+	common_debug_assert(argument != NULL);
+
+	server_reactor_s* const reactor = argument;
+	server_connection_s* const connection = _timer_connection(timer, offsetof(server_connection_s, timers.keepalive));
+
+	if (!_is_live(connection))
+	{
+		return;
+	}
+
+	const uint64_t mark  = connection->stats.bytes_received;
+	const bool_t   quiet = (mark == connection->timers.keepalive_mark) && !server_connection_has_output(connection);
+
+	connection->timers.keepalive_mark = mark;
+	common_timer_wheel_schedule(&reactor->timers, timer, reactor->now_ms + reactor->config->keepalive);
+
+	// note: the ping goes out last, as flushing it may release the connection,
+	// which cancels the timer again.
+	if (quiet && (server_connection_state_open == connection->state) && server_connection_queue_ping(connection))
+	{
+		server_backend_flush(&reactor->backend, connection);
+
+		if (server_connection_has_failed(connection))
+		{
+			server_backend_release(&reactor->backend, connection);
+		}
+	}
+}
+
+static void _loaded(server_cache_waiter_s* const waiter, void* const argument)
+{
+	common_debug_assert(waiter != NULL);
+	common_debug_assert(argument != NULL);
+
+	server_reactor_s* const reactor = argument;
+
+	(void)pthread_mutex_lock(&reactor->loaded_lock);
+	waiter->next = reactor->loaded;
+	reactor->loaded = waiter;
+	(void)pthread_mutex_unlock(&reactor->loaded_lock);
+
+	_notify(reactor);
+}
+
+static void _published(void* const argument)
+{
+	common_debug_assert(argument != NULL);
+	_notify((server_reactor_s*)argument);
+}
+
+static void _deliver_live(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+	common_debug_assert(reactor->live != NULL);
+
+	server_cache_entry_s* entries[server_live_history_capacity];
+	const uint64_t count = server_live_collect(reactor->live, reactor->live_next, entries, server_live_history_capacity);
+
+	if (0 == count)
+	{
+		return;
+	}
+
+	reactor->live_next = (uint64_t)entries[count - 1]->chunk + 1;
+
+	for (uint64_t index = 0; index < reactor->connections_capacity; ++index)
+	{
+		server_connection_s* const connection = reactor->connections[index];
+
+		if ((NULL == connection) || !_is_live(connection) || !server_connection_is_subscribed(connection))
+		{
+			continue;
+		}
+
+		for (uint64_t entry = 0; entry < count; ++entry)
+		{
+			server_connection_queue_live(connection, entries[entry]);
+		}
+
+		server_backend_flush(&reactor->backend, connection);
+
+		if (server_connection_has_failed(connection))
+		{
+			server_backend_release(&reactor->backend, connection);
+		}
+	}
+
+	for (uint64_t entry = 0; entry < count; ++entry)
+	{
+		server_cache_release(entries[entry]);
+	}
+}
+
+static void _notify(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+
+	const uint64_t value = 1;
+	(void)!write(reactor->wakeup_fd, &value, sizeof(value));
+}
+
+static void _reclaim(server_reactor_s* const reactor)
+{
+	common_debug_assert(reactor != NULL);
+
+	while (reactor->closed != NULL)
+	{
+		server_connection_s* const connection = reactor->closed;
+		reactor->closed = connection->next;
+
+		if (reactor->spare_count < server_reactor_spare_connections)
+		{
+			connection->next = reactor->spare;
+			reactor->spare   = connection;
+			++reactor->spare_count;
+		}
+		else
+		{
+			free(connection);
+		}
+	}
+}
+
+static void _free_list(server_connection_s* connection)
+{
+	while (connection != NULL)
+	{
+		server_connection_s* const next = connection->next;
+		free(connection);
+		connection = next;
+	}
+}
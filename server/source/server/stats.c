@@ -0,0 +1,681 @@
+
+/**
+ * @file stats.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/timer.h"
+
+#include "server/stats.h"
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <poll.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+typedef struct
+{
+	const char_t* name;
+	const char_t* help;
+	bool_t gauge;
+} _metric_s;
+
+static const _metric_s _g_metrics[server_stats_count] =
+{
+	[server_stats_connections_accepted] = { "connections_accepted", "Connections accepted.",                                        false },
+	[server_stats_connections_closed]   = { "connections_closed",   "Connections closed.",                                          false },
+	[server_stats_connections_failed]   = { "connections_failed",   "Connections closed on failing to produce their output.",       false },
+	[server_stats_connections_expired]  = { "connections_expired",  "Connections closed as idle or too slow to take their output.", false },
+	[server_stats_connections_open]     = { "connections_open",     "Connections currently open.",                                  true  },
+	[server_stats_bytes_received]       = { "bytes_received",       "Bytes received from clients.",                                 false },
+	[server_stats_bytes_sent]           = { "bytes_sent",           "Bytes transmitted to clients.",                                false },
+	[server_stats_bytes_sendfile]       = { "bytes_sendfile",       "Bytes of file segments transmitted with sendfile.",            false },
+	[server_stats_bytes_spliced]        = { "bytes_spliced",        "Bytes of file segments transmitted through a pipe.",           false },
+	[server_stats_bytes_copied]         = { "bytes_copied",         "Bytes of file segments read into buffers to be transmitted.",  false },
+	[server_stats_sends]                = { "sends",                "System calls and submissions transmitting output.",            false },
+	[server_stats_frames_received]      = { "frames_received",      "Frames received and handled.",                                 false },
+	[server_stats_frames_sent]          = { "frames_sent",          "Frames queued for transmission.",                              false },
+	[server_stats_errors]               = { "errors",               "Error responses queued for transmission.",                     false },
+	[server_stats_cache_hits]           = { "cache_hits",           "Segments found in the cache.",                                 false },
+	[server_stats_cache_misses]         = { "cache_misses",         "Segments not found in the cache.",                             false },
+	[server_stats_throttled]            = { "throttled",            "Connections throttled at their high watermark.",               false },
+	[server_stats_queued_bytes]         = { "queued_bytes",         "Bytes queued for transmission.",                               true  },
+};
+
+static void* _stats_main(void* const argument);
+
+static int32_t _open_endpoint(const server_config_s* const config);
+
+static void _serve(server_stats_s* const stats, const int32_t fd);
+
+static bool_t _write_all(const int32_t fd, const char_t* const data, const uint64_t size);
+
+static void _write_text(server_stats_s* const stats, const server_stats_worker_s* const total, FILE* const file);
+
+static void _write_prometheus(server_stats_s* const stats, const server_stats_worker_s* const total, FILE* const file);
+
+static void _write_summary(const char_t* const name, const char_t* const help, const common_histogram_s* const histogram, FILE* const file);
+
+static uint64_t _load(const server_stats_worker_s* const worker, const server_stats_e which);
+
+bool_t server_stats_create(server_stats_s* const stats, const server_config_s* const config, const uint64_t workers_count, server_cache_s* const cache, common_scheduler_s* const compute)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(config != NULL);
+	common_debug_assert(workers_count > 0);
+
+	*stats = (const server_stats_s)
+	{
+		.config        = config,
+		.workers_count = workers_count,
+		.cache         = cache,
+		.compute       = compute,
+		.listen_fd     = -1,
+		.wakeup_fd     = -1,
+		.start_ms      = common_timer_now_ms(),
+	};
+
+	// note: the statistics of every worker start on a cache line of their own,
+	// which plain malloc does not guarantee.
+	stats->workers = aligned_alloc(common_queue_cache_line, workers_count * sizeof(*stats->workers));
+
+	if (NULL == stats->workers)
+	{
+		common_logger_error("failed to allocate the statistics of %lu workers.", workers_count);
+		return false;
+	}
+
+	for (uint64_t index = 0; index < workers_count; ++index)
+	{
+		(void)memset(stats->workers[index].values, 0, sizeof(stats->workers[index].values));
+		common_histogram_create(&stats->workers[index].service);
+		common_histogram_create(&stats->workers[index].loop);
+	}
+
+	return true;
+}
+
+void server_stats_destroy(server_stats_s* const stats)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(!stats->started);
+
+	free(stats->workers);
+	stats->workers       = NULL;
+	stats->workers_count = 0;
+}
+
+server_stats_worker_s* server_stats_worker(server_stats_s* const stats, const uint64_t index)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(index < stats->workers_count);
+	return &stats->workers[index];
+}
+
+bool_t server_stats_start(server_stats_s* const stats)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(!stats->started);
+
+	const server_config_s* const config = stats->config;
+
+	if ((0 == config->stats_port) && (NULL == config->stats_socket))
+	{
+		return true;
+	}
+
+	stats->listen_fd = _open_endpoint(config);
+
+	if (stats->listen_fd < 0)
+	{
+		return false;
+	}
+
+	stats->wakeup_fd = eventfd(0, EFD_CLOEXEC);
+
+	if (stats->wakeup_fd < 0)
+	{
+		common_logger_error("failed to create the wakeup eventfd of the statistics: %s.", strerror(errno));
+		goto server_stats_start_failed;
+	}
+
+	const int32_t status = pthread_create(&stats->thread, NULL, _stats_main, stats);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to spawn the thread of the statistics: %s.", strerror(status));
+		goto server_stats_start_failed;
+	}
+
+	(void)pthread_setname_np(stats->thread, "mediantazy/stat");
+	stats->started = true;
+
+	if (config->stats_socket != NULL)
+	{
+		common_logger_note("serving statistics on %s.", config->stats_socket);
+	}
+	else
+	{
+		common_logger_note("serving statistics on %s:%u.", config->address, config->stats_port);
+	}
+
+	return true;
+
+server_stats_start_failed:
+	if (stats->wakeup_fd >= 0) { (void)close(stats->wakeup_fd); stats->wakeup_fd = -1; }
+	if (stats->listen_fd >= 0) { (void)close(stats->listen_fd); stats->listen_fd = -1; }
+
+	if (config->stats_socket != NULL)
+	{
+		(void)unlink(config->stats_socket);
+	}
+
+	return false;
+}
+
+void server_stats_stop(server_stats_s* const stats)
+{
+	common_debug_assert(stats != NULL);
+
+	if (!stats->started)
+	{
+		return;
+	}
+
+	const uint64_t value = 1;
+	(void)!write(stats->wakeup_fd, &value, sizeof(value));
+	(void)pthread_join(stats->thread, NULL);
+	stats->started = false;
+
+	(void)close(stats->wakeup_fd);
+	(void)close(stats->listen_fd);
+	stats->wakeup_fd = -1;
+	stats->listen_fd = -1;
+
+	if (stats->config->stats_socket != NULL)
+	{
+		(void)unlink(stats->config->stats_socket);
+	}
+}
+
+void server_stats_collect(server_stats_s* const stats, server_stats_worker_s* const total)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(total != NULL);
+
+	(void)memset(total->values, 0, sizeof(total->values));
+	common_histogram_create(&total->service);
+	common_histogram_create(&total->loop);
+
+	common_histogram_s snapshot;
+
+	for (uint64_t index = 0; index < stats->workers_count; ++index)
+	{
+		const server_stats_worker_s* const worker = &stats->workers[index];
+
+		for (uint64_t which = 0; which < server_stats_count; ++which)
+		{
+			total->values[which] += _load(worker, (server_stats_e)which);
+		}
+
+		common_histogram_snapshot(&worker->service, &snapshot);
+		common_histogram_merge(&total->service, &snapshot);
+		common_histogram_snapshot(&worker->loop, &snapshot);
+		common_histogram_merge(&total->loop, &snapshot);
+	}
+}
+
+void server_stats_write(server_stats_s* const stats, const server_stats_format_e format, FILE* const file)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(file != NULL);
+
+	server_stats_worker_s total;
+	server_stats_collect(stats, &total);
+
+	switch (format)
+	{
+		case server_stats_format_text:       { _write_text(stats, &total, file);       } break;
+		case server_stats_format_prometheus: { _write_prometheus(stats, &total, file); } break;
+		default:                             { common_debug_assert(0);                 } break;
+	}
+}
+
+void server_stats_add(server_stats_worker_s* const worker, const server_stats_e which, const uint64_t amount)
+{
+	common_debug_assert(worker != NULL);
+	common_debug_assert(which < server_stats_count);
+
+	uint64_t* const value = &worker->values[which];
+	__atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
+
+void server_stats_sub(server_stats_worker_s* const worker, const server_stats_e which, const uint64_t amount)
+{
+	common_debug_assert(worker != NULL);
+	common_debug_assert(which < server_stats_count);
+	common_debug_assert(_g_metrics[which].gauge);
+
+	uint64_t* const value = &worker->values[which];
+	__atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) - amount, __ATOMIC_RELAXED);
+}
+
+void server_stats_set(server_stats_worker_s* const worker, const server_stats_e which, const uint64_t value)
+{
+	common_debug_assert(worker != NULL);
+	common_debug_assert(which < server_stats_count);
+	common_debug_assert(_g_metrics[which].gauge);
+
+	__atomic_store_n(&worker->values[which], value, __ATOMIC_RELAXED);
+}
+
+static void* _stats_main(void* const argument)
+{
+	server_stats_s* const stats = (server_stats_s*)argument;
+	common_debug_assert(stats != NULL);
+
+	struct pollfd fds[2] =
+	{
+		{ .fd = stats->listen_fd, .events = POLLIN },
+		{ .fd = stats->wakeup_fd, .events = POLLIN },
+	};
+
+	while (true)
+	{
+		if (poll(fds, 2, -1) < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			common_logger_error("failed to wait for statistics requests: %s.", strerror(errno));
+			break;
+		}
+
+		if (fds[1].revents != 0)
+		{
+			break;
+		}
+
+		if (fds[0].revents != 0)
+		{
+			const int32_t fd = accept4(stats->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+
+			if (fd >= 0)
+			{
+				_serve(stats, fd);
+				(void)close(fd);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static int32_t _open_endpoint(const server_config_s* const config)
+{
+	common_debug_assert(config != NULL);
+
+	if (config->stats_socket != NULL)
+	{
+		struct sockaddr_un address = { .sun_family = AF_UNIX };
+		common_debug_assert(strlen(config->stats_socket) < sizeof(address.sun_path));
+		(void)strncpy(address.sun_path, config->stats_socket, sizeof(address.sun_path) - 1);
+
+		const int32_t fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+		if (fd < 0)
+		{
+			common_logger_error("failed to create the statistics socket: %s.", strerror(errno));
+			return -1;
+		}
+
+		// note: a socket left behind by a server that did not get to remove it
+		// is replaced, while anything else at the path is left alone.
+		struct stat status = {0};
+
+		if ((stat(config->stats_socket, &status) == 0) && S_ISSOCK(status.st_mode))
+		{
+			(void)unlink(config->stats_socket);
+		}
+
+		if ((bind(fd, (const struct sockaddr*)&address, sizeof(address)) < 0) || (listen(fd, 16) < 0))
+		{
+			common_logger_error("failed to listen on the statistics socket %s: %s.", config->stats_socket, strerror(errno));
+			(void)close(fd);
+			return -1;
+		}
+
+		return fd;
+	}
+
+	char_t port[8] = {0};
+	(void)snprintf(port, sizeof(port), "%u", config->stats_port);
+
+	const struct addrinfo hints =
+	{
+		.ai_family   = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+		.ai_flags    = AI_PASSIVE | AI_NUMERICHOST | AI_NUMERICSERV,
+	};
+
+	struct addrinfo* address = NULL;
+	const int32_t status = getaddrinfo(config->address, port, &hints, &address);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to resolve address %s:%s: %s.", config->address, port, gai_strerror(status));
+		return -1;
+	}
+
+	const int32_t fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+
+	if (fd < 0)
+	{
+		common_logger_error("failed to create the statistics socket: %s.", strerror(errno));
+		freeaddrinfo(address);
+		return -1;
+	}
+
+	const int32_t enable = 1;
+	(void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+	if ((bind(fd, address->ai_addr, address->ai_addrlen) < 0) || (listen(fd, 16) < 0))
+	{
+		common_logger_error("failed to listen for statistics on %s:%s: %s.", config->address, port, strerror(errno));
+		freeaddrinfo(address);
+		(void)close(fd);
+		return -1;
+	}
+
+	freeaddrinfo(address);
+	return fd;
+}
+
+static void _serve(server_stats_s* const stats, const int32_t fd)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(fd >= 0);
+
+	// note: the endpoint serves one client at a time, so a client that stalls
+	// only holds it up for as long as the timeout.
+	const struct timeval timeout =
+	{
+		.tv_sec  = (time_t)(server_stats_io_timeout / 1000),
+		.tv_usec = (suseconds_t)((server_stats_io_timeout % 1000) * 1000),
+	};
+
+	(void)setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	(void)setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	char_t request[server_stats_request_size] = {0};
+	uint64_t size = 0;
+
+	// note: the request is read up to the end of its first line, and for http
+	// up to the end of its headers, so that the client does not get reset for
+	// sending something that was never read.
+	while (size < (sizeof(request) - 1))
+	{
+		const ssize_t result = recv(fd, request + size, sizeof(request) - 1 - size, 0);
+
+		if (result <= 0)
+		{
+			break;
+		}
+
+		size += (uint64_t)result;
+		request[size] = '\0';
+
+		const bool_t http = (strncmp(request, "GET ", 4) == 0);
+
+		if ((http && (strstr(request, "\r\n\r\n") != NULL)) || (!http && (strchr(request, '\n') != NULL)))
+		{
+			break;
+		}
+	}
+
+	const bool_t http = (strncmp(request, "GET ", 4) == 0);
+	const char_t* const target = http ? (request + 4) : request;
+	const uint64_t length = strcspn(target, http ? " \r\n" : "\r\n");
+
+	bool_t found = true;
+	server_stats_format_e format = server_stats_format_text;
+
+	if (http && (((1 == length) && ('/' == target[0])) || ((6 == length) && (strncmp(target, "/stats", 6) == 0))))
+	{
+		format = server_stats_format_text;
+	}
+	else if (http && (8 == length) && (strncmp(target, "/metrics", 8) == 0))
+	{
+		format = server_stats_format_prometheus;
+	}
+	else if (!http && ((0 == length) || ((5 == length) && (strncmp(target, "stats", 5) == 0))))
+	{
+		format = server_stats_format_text;
+	}
+	else if (!http && (7 == length) && (strncmp(target, "metrics", 7) == 0))
+	{
+		format = server_stats_format_prometheus;
+	}
+	else
+	{
+		found = false;
+	}
+
+	char_t* body = NULL;
+	size_t body_size = 0;
+	FILE* const file = open_memstream(&body, &body_size);
+
+	if (NULL == file)
+	{
+		common_logger_warn("failed to open a stream for the statistics: %s.", strerror(errno));
+		return;
+	}
+
+	if (found)
+	{
+		server_stats_write(stats, format, file);
+	}
+	else
+	{
+		(void)fprintf(file, "unknown request, expected %s.\n", http ? "/stats or /metrics" : "stats or metrics");
+	}
+
+	if (fclose(file) != 0)
+	{
+		common_logger_warn("failed to write the statistics.");
+		free(body);
+		return;
+	}
+
+	if (http)
+	{
+		char_t header[256] = {0};
+		const int32_t header_size = snprintf(header, sizeof(header), "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n",
+			found ? "200 OK" : "404 Not Found", (found && (server_stats_format_prometheus == format)) ? "text/plain; version=0.0.4; charset=utf-8" : "text/plain; charset=utf-8",
+			(uint64_t)body_size);
+
+		if (!_write_all(fd, header, (uint64_t)header_size))
+		{
+			free(body);
+			return;
+		}
+	}
+
+	(void)_write_all(fd, body, (uint64_t)body_size);
+	(void)shutdown(fd, SHUT_WR);
+	free(body);
+}
+
+static bool_t _write_all(const int32_t fd, const char_t* const data, const uint64_t size)
+{
+	common_debug_assert(fd >= 0);
+	common_debug_assert((data != NULL) || (0 == size));
+
+	uint64_t written = 0;
+
+	while (written < size)
+	{
+		const ssize_t result = send(fd, data + written, size - written, MSG_NOSIGNAL);
+
+		if (result < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			common_logger_debug("failed to send the statistics: %s.", strerror(errno));
+			return false;
+		}
+
+		written += (uint64_t)result;
+	}
+
+	return true;
+}
+
+static void _write_text(server_stats_s* const stats, const server_stats_worker_s* const total, FILE* const file)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(total != NULL);
+	common_debug_assert(file != NULL);
+
+	(void)fprintf(file, "%-24s %.3f\n", "uptime_seconds", (double)(common_timer_now_ms() - stats->start_ms) / 1e3);
+	(void)fprintf(file, "%-24s %lu\n", "workers", stats->workers_count);
+
+	for (uint64_t which = 0; which < server_stats_count; ++which)
+	{
+		(void)fprintf(file, "%-24s %lu\n", _g_metrics[which].name, total->values[which]);
+	}
+
+	const uint64_t sends = total->values[server_stats_sends];
+	(void)fprintf(file, "%-24s %lu\n", "bytes_per_send", (sends > 0) ? (total->values[server_stats_bytes_sent] / sends) : 0);
+
+	if (stats->cache != NULL)
+	{
+		server_cache_stats_s cache = {0};
+		server_cache_stats(stats->cache, &cache);
+		(void)fprintf(file, "%-24s %lu\n", "cache_entries", cache.entries);
+		(void)fprintf(file, "%-24s %lu\n", "cache_bytes", cache.size);
+	}
+
+	if (stats->compute != NULL)
+	{
+		(void)fprintf(file, "%-24s %lu\n", "compute_pending", common_scheduler_pending(stats->compute));
+	}
+
+	const struct
+	{
+		const char_t* name;
+		const common_histogram_s* histogram;
+	} latencies[] =
+	{
+		{ "service_us", &total->service },
+		{ "loop_us",    &total->loop    },
+	};
+
+	for (uint64_t index = 0; index < (sizeof(latencies) / sizeof(*latencies)); ++index)
+	{
+		const common_histogram_s* const histogram = latencies[index].histogram;
+		(void)fprintf(file, "%-24s count=%lu mean=%.1f p50=%.1f p90=%.1f p99=%.1f p99.9=%.1f max=%.1f\n", latencies[index].name, histogram->count,
+			common_histogram_mean(histogram) / 1e3, (double)common_histogram_percentile(histogram, 50) / 1e3, (double)common_histogram_percentile(histogram, 90) / 1e3,
+			(double)common_histogram_percentile(histogram, 99) / 1e3, (double)common_histogram_percentile(histogram, 99.9) / 1e3, (double)histogram->max / 1e3);
+	}
+}
+
+static void _write_prometheus(server_stats_s* const stats, const server_stats_worker_s* const total, FILE* const file)
+{
+	common_debug_assert(stats != NULL);
+	common_debug_assert(total != NULL);
+	common_debug_assert(file != NULL);
+
+	(void)fprintf(file, "# HELP mediantazy_uptime_seconds Time since the server started.\n# TYPE mediantazy_uptime_seconds gauge\n");
+	(void)fprintf(file, "mediantazy_uptime_seconds %.3f\n", (double)(common_timer_now_ms() - stats->start_ms) / 1e3);
+	(void)fprintf(file, "# HELP mediantazy_workers Worker threads.\n# TYPE mediantazy_workers gauge\n");
+	(void)fprintf(file, "mediantazy_workers %lu\n", stats->workers_count);
+
+	// note: every series is broken down by worker, which shows an uneven
+	// spread of the load between them, and a sum over the label gives back
+	// the totals.
+	for (uint64_t which = 0; which < server_stats_count; ++which)
+	{
+		const _metric_s* const metric = &_g_metrics[which];
+		const char_t* const suffix = metric->gauge ? "" : "_total";
+
+		(void)fprintf(file, "# HELP mediantazy_%s%s %s\n# TYPE mediantazy_%s%s %s\n", metric->name, suffix, metric->help, metric->name, suffix,
+			metric->gauge ? "gauge" : "counter");
+
+		for (uint64_t index = 0; index < stats->workers_count; ++index)
+		{
+			(void)fprintf(file, "mediantazy_%s%s{worker=\"%lu\"} %lu\n", metric->name, suffix, index, _load(&stats->workers[index], (server_stats_e)which));
+		}
+	}
+
+	if (stats->cache != NULL)
+	{
+		server_cache_stats_s cache = {0};
+		server_cache_stats(stats->cache, &cache);
+		(void)fprintf(file, "# HELP mediantazy_cache_entries Segments held in the cache.\n# TYPE mediantazy_cache_entries gauge\n");
+		(void)fprintf(file, "mediantazy_cache_entries %lu\n", cache.entries);
+		(void)fprintf(file, "# HELP mediantazy_cache_bytes Bytes of segments held in the cache.\n# TYPE mediantazy_cache_bytes gauge\n");
+		(void)fprintf(file, "mediantazy_cache_bytes %lu\n", cache.size);
+	}
+
+	if (stats->compute != NULL)
+	{
+		(void)fprintf(file, "# HELP mediantazy_compute_pending Tasks waiting to run on the compute threads.\n# TYPE mediantazy_compute_pending gauge\n");
+		(void)fprintf(file, "mediantazy_compute_pending %lu\n", common_scheduler_pending(stats->compute));
+	}
+
+	_write_summary("service", "Time from picking up a request to queueing the last of its responses.", &total->service, file);
+	_write_summary("loop", "Time an iteration of an event loop spent busy.", &total->loop, file);
+}
+
+static void _write_summary(const char_t* const name, const char_t* const help, const common_histogram_s* const histogram, FILE* const file)
+{
+	common_debug_assert(name != NULL);
+	common_debug_assert(help != NULL);
+	common_debug_assert(histogram != NULL);
+	common_debug_assert(file != NULL);
+
+	static const double quantiles[] = { 50, 90, 99, 99.9, 100 };
+
+	(void)fprintf(file, "# HELP mediantazy_%s_seconds %s\n# TYPE mediantazy_%s_seconds summary\n", name, help, name);
+
+	for (uint64_t index = 0; index < (sizeof(quantiles) / sizeof(*quantiles)); ++index)
+	{
+		(void)fprintf(file, "mediantazy_%s_seconds{quantile=\"%g\"} %.9f\n", name, quantiles[index] / 100.0,
+			(double)common_histogram_percentile(histogram, quantiles[index]) / 1e9);
+	}
+
+	(void)fprintf(file, "mediantazy_%s_seconds_sum %.9f\n", name, (double)histogram->sum / 1e9);
+	(void)fprintf(file, "mediantazy_%s_seconds_count %lu\n", name, histogram->count);
+}
+
+static uint64_t _load(const server_stats_worker_s* const worker, const server_stats_e which)
+{
+	common_debug_assert(worker != NULL);
+	common_debug_assert(which < server_stats_count);
+	return __atomic_load_n(&worker->values[which], __ATOMIC_RELAXED);
+}
@@ -0,0 +1,90 @@
+
+/**
+ * @file worker.c
+ * 
+ * @copyright This file's a part of the "mediantazy" project and is distributed
+ * and licensed under "mediantazy gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-17
+ */
+
+#define common_logger_category common_logger_category_network
+
+#include "common/debug.h"
+#include "common/logger.h"
+#include "common/arena.h"
+
+#include "server/worker.h"
+
+#include <string.h>
+#include <stdio.h>
+
+static void* _worker_main(void* const argument);
+
+bool_t server_worker_create(server_worker_s* const worker, const server_config_s* const config, server_cache_s* const cache, server_live_s* const live, const uint64_t index,
+	server_stats_worker_s* const stats)
+{
+	common_debug_assert(worker != NULL);
+	common_debug_assert(config != NULL);
+
+	worker->index  = index;
+	worker->status = false;
+	return server_reactor_create(&worker->reactor, config, cache, live, stats);
+}
+
+void server_worker_destroy(server_worker_s* const worker)
+{
+	common_debug_assert(worker != NULL);
+	server_reactor_destroy(&worker->reactor);
+}
+
+bool_t server_worker_start(server_worker_s* const worker)
+{
+	common_debug_assert(worker != NULL);
+
+	const int32_t status = pthread_create(&worker->thread, NULL, _worker_main, worker);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to spawn worker %lu: %s.", worker->index, strerror(status));
+		return false;
+	}
+
+	char_t name[16] = {0};
+	(void)snprintf(name, sizeof(name), "mediantazy/%lu", worker->index);
+	(void)pthread_setname_np(worker->thread, name);
+	return true;
+}
+
+void server_worker_stop(server_worker_s* const worker)
+{
+	common_debug_assert(worker != NULL);
+	server_reactor_stop(&worker->reactor);
+}
+
+bool_t server_worker_join(server_worker_s* const worker)
+{
+	common_debug_assert(worker != NULL);
+
+	const int32_t status = pthread_join(worker->thread, NULL);
+
+	if (status != 0)
+	{
+		common_logger_error("failed to join worker %lu: %s.", worker->index, strerror(status));
+		return false;
+	}
+
+	return worker->status;
+}
+
+static void* _worker_main(void* const argument)
+{
+	server_worker_s* const worker = (server_worker_s*)argument;
+	common_debug_assert(worker != NULL);
+
+	worker->status = server_reactor_run(&worker->reactor);
+	common_arena_release_cache();
+	return NULL;
+}